@@ -1,5 +1,6 @@
 #include <cstddef>
 #include <iostream>
+#include <hayai.hpp>
 
 #ifndef __DELIVERY_MAN
 #define __DELIVERY_MAN
@@ -14,9 +15,8 @@ public:
     {
         // Waste some clock cycles here.
         std::size_t largeNumber = 10000u * distance / _speed;
-        volatile std::size_t targetNumber;
         while (largeNumber--)
-            targetNumber = largeNumber;
+            ::hayai::DoNotOptimize(largeNumber);
     }
 
 
@@ -6,6 +6,10 @@ BENCHMARK(DeliveryMan, DeliverPackage, 10, 100)
     DeliveryMan(1).DeliverPackage(100);
 }
 
+// Warm-up is looked up by fixture and benchmark name, so this also applies to
+// the instances of the parametrized DeliveryMan.DeliverPackage benchmark.
+BENCHMARK_WARM_UP(DeliveryMan, DeliverPackage, 2, 0);
+
 BENCHMARK(DeliveryMan, DISABLED_DeliverPackage, 10, 10000)
 {
     DeliveryMan(1).DeliverPackage(10000);
@@ -19,3 +19,12 @@ BENCHMARK_P(DeliveryMan, DeliverPackage, 10, 100,
 BENCHMARK_P_INSTANCE(DeliveryMan, DeliverPackage, (1, 10));
 BENCHMARK_P_INSTANCE(DeliveryMan, DeliverPackage, (5, 10));
 BENCHMARK_P_INSTANCE(DeliveryMan, DeliverPackage, (10, 10));
+
+/*
+ * Instances can also be generated from ranges and lists of values. The
+ * cartesian product registers one instance for each combination, here
+ * speeds of 2 and 10 over distances of 1, 2, 4, 8 and 16.
+ */
+BENCHMARK_P_GENERATE(DeliveryMan, DeliverPackage,
+                     ::hayai::Product(::hayai::Values(2)(10),
+                                      ::hayai::PowersOfTwo(1, 16)));
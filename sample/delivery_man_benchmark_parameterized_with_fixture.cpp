@@ -34,3 +34,10 @@ BENCHMARK_P_F(FastDeliveryManFixture, DeliverPackage, 10, 100,
 BENCHMARK_P_INSTANCE(FastDeliveryManFixture, DeliverPackage, (1));
 BENCHMARK_P_INSTANCE(FastDeliveryManFixture, DeliverPackage, (10));
 BENCHMARK_P_INSTANCE(FastDeliveryManFixture, DeliverPackage, (100));
+BENCHMARK_P_INSTANCE(FastDeliveryManFixture, DeliverPackage, (1000));
+
+/*
+ * The distance is the problem size, so the complexity of delivering a
+ * package is fitted once all instances have run.
+ */
+BENCHMARK_P_COMPLEXITY(FastDeliveryManFixture, DeliverPackage, distance);
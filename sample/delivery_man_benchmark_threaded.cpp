@@ -0,0 +1,18 @@
+#include <hayai.hpp>
+#include "delivery_man.hpp"
+
+// Every delivery man delivers their own packages, so the delivery men should
+// scale with the number of threads until they run out of processors.
+BENCHMARK_THREADED(DeliveryMan, DeliverPackagesConcurrently, 10, 100, 4)
+{
+    DeliveryMan(1).DeliverPackage(100);
+}
+
+BENCHMARK_THREADED(DeliveryMan,
+                   DeliverPackagesScaling,
+                   10,
+                   100,
+                   ::hayai::ThreadSweep)
+{
+    DeliveryMan(1).DeliverPackage(100);
+}
@@ -0,0 +1,77 @@
+#include <hayai.hpp>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <vector>
+
+#include "delivery_man.hpp"
+
+/*
+ * Benchmarks can be parameterized by type. The types are given as a
+ * typedef of ::hayai::Types, and the benchmark body refers to the type as
+ * TypeParam. One benchmark is registered for each type.
+ */
+typedef ::hayai::Types<std::vector<std::size_t>,
+                       std::deque<std::size_t>,
+                       std::list<std::size_t> > Vans;
+
+/*
+ * Types are described by their demangled names unless given a name.
+ */
+BENCHMARK_TYPE_NAME(std::vector<std::size_t>, "vector");
+BENCHMARK_TYPE_NAME(std::deque<std::size_t>, "deque");
+BENCHMARK_TYPE_NAME(std::list<std::size_t>, "list");
+
+BENCHMARK_T(DeliveryMan, LoadVan, 10, 100, Vans)
+{
+    TypeParam van;
+
+    for (std::size_t package = 0; package < 100; ++package)
+        van.push_back(package);
+
+    ::hayai::DoNotOptimize(van);
+}
+
+/*
+ * Fixtures of type-parameterized benchmarks are class templates taking the
+ * type, and can be combined with value parameters.
+ */
+template<typename Van>
+class LoadedVanFixture
+    :   public ::hayai::Fixture
+{
+public:
+    virtual void SetUp()
+    {
+        for (std::size_t package = 0; package < 1000; ++package)
+            this->Packages.push_back(package);
+    }
+
+    virtual void TearDown()
+    {
+        this->Packages.clear();
+    }
+
+    Van Packages;
+};
+
+BENCHMARK_T_P_F(LoadedVanFixture, UnloadPackages, 10, 100, Vans,
+                (std::size_t count))
+{
+    typename TypeParam::const_iterator package = this->Packages.begin();
+    std::size_t weight = 0;
+
+    while (count--)
+        weight += *package++;
+
+    ::hayai::DoNotOptimize(weight);
+}
+
+BENCHMARK_T_P_INSTANCE(LoadedVanFixture, UnloadPackages, (10));
+BENCHMARK_T_P_GENERATE(LoadedVanFixture, UnloadPackages,
+                       ::hayai::Values(100)(1000));
+
+/*
+ * The complexity is fitted separately for each type.
+ */
+BENCHMARK_P_COMPLEXITY(LoadedVanFixture, UnloadPackages, count);
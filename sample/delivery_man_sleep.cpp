@@ -1,4 +1,5 @@
 #include <hayai.hpp>
+#include "delivery_man.hpp"
 
 #ifdef _WIN32
 #ifndef NOMINMAX
@@ -43,3 +44,15 @@ BENCHMARK(SomeSleep, Sleep20ms, 5, 10)
 {
     msleep(20);
 }
+
+// The delivery man only gets paid for the time spent delivering.
+//
+// Sleep for 1 ms without timing before each delivery.
+BENCHMARK(SomeSleep, DeliverAfterSleep, 5, 10)
+{
+    PauseTiming();
+    msleep(1);
+    ResumeTiming();
+
+    DeliveryMan(1).DeliverPackage(10);
+}
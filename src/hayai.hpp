@@ -2,6 +2,7 @@
 #define __HAYAI
 
 #include "hayai_benchmarker.hpp"
+#include "hayai_do_not_optimize.hpp"
 #include "hayai_test.hpp"
 #include "hayai_default_test_factory.hpp"
 #include "hayai_fixture.hpp"
@@ -16,6 +17,15 @@
 #define BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name) \
     fixture_name ## _ ## benchmark_name ## _Benchmark
 
+// Iteration loop invoking the body without virtual dispatch, so that the
+// body can be inlined into the loop.
+#define BENCHMARK_ITERATION_LOOP_(body)                                 \
+    virtual void RunIterations(std::size_t iterations)                  \
+    {                                                                   \
+        while (iterations--)                                            \
+            body;                                                       \
+    }
+
 #define BENCHMARK_(fixture_name,                                        \
                    benchmark_name,                                      \
                    fixture_class_name,                                  \
@@ -31,6 +41,10 @@
         }                                                               \
     protected:                                                          \
         virtual void TestBody();                                        \
+        BENCHMARK_ITERATION_LOOP_(                                      \
+            this->BENCHMARK_CLASS_NAME_(fixture_name,                   \
+                                        benchmark_name)::TestBody()     \
+        )                                                               \
     private:                                                            \
         static const ::hayai::TestDescriptor* _descriptor;              \
     };                                                                  \
@@ -69,6 +83,90 @@
                runs,                                     \
                iterations)
 
+// Multi-threaded benchmarks.
+#define BENCHMARK_THREADED_(fixture_name,                               \
+                            benchmark_name,                             \
+                            fixture_class_name,                         \
+                            runs,                                       \
+                            iterations,                                 \
+                            threads)                                    \
+    class BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)           \
+        :   public fixture_class_name                                   \
+    {                                                                   \
+    public:                                                             \
+        BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)()           \
+        {                                                               \
+                                                                        \
+        }                                                               \
+    protected:                                                          \
+        virtual void TestBody();                                        \
+        BENCHMARK_ITERATION_LOOP_(                                      \
+            this->BENCHMARK_CLASS_NAME_(fixture_name,                   \
+                                        benchmark_name)::TestBody()     \
+        )                                                               \
+    private:                                                            \
+        static const ::hayai::TestDescriptor* _descriptor;              \
+    };                                                                  \
+                                                                        \
+    const ::hayai::TestDescriptor*                                      \
+    BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)::_descriptor =  \
+        ::hayai::Benchmarker::RegisterThreadedTest<                     \
+            BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)         \
+        >(                                                              \
+            #fixture_name,                                              \
+            #benchmark_name,                                            \
+            runs,                                                       \
+            iterations,                                                 \
+            threads);                                                   \
+                                                                        \
+    void BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)::TestBody()
+
+#define BENCHMARK_THREADED_F(fixture_name,               \
+                             benchmark_name,             \
+                             runs,                       \
+                             iterations,                 \
+                             threads)                    \
+    BENCHMARK_THREADED_(fixture_name,                    \
+                        benchmark_name,                  \
+                        fixture_name,                    \
+                        runs,                            \
+                        iterations,                      \
+                        threads)
+
+#define BENCHMARK_THREADED(fixture_name,                 \
+                           benchmark_name,               \
+                           runs,                         \
+                           iterations,                   \
+                           threads)                      \
+    BENCHMARK_THREADED_(fixture_name,                    \
+                        benchmark_name,                  \
+                        ::hayai::Test,                   \
+                        runs,                            \
+                        iterations,                      \
+                        threads)
+
+// Warm-up of a benchmark, including all instances of a parametrized benchmark.
+#define BENCHMARK_WARM_UP_CLASS_NAME_(fixture_name, benchmark_name)     \
+    fixture_name ## _ ## benchmark_name ## _WarmUp
+
+#define BENCHMARK_WARM_UP(fixture_name,                                 \
+                          benchmark_name,                               \
+                          runs,                                         \
+                          duration)                                     \
+    class BENCHMARK_WARM_UP_CLASS_NAME_(fixture_name, benchmark_name)   \
+    {                                                                   \
+    private:                                                            \
+        static const bool _registered;                                  \
+    };                                                                  \
+                                                                        \
+    const bool                                                          \
+    BENCHMARK_WARM_UP_CLASS_NAME_(fixture_name, benchmark_name)::       \
+        _registered = ::hayai::Benchmarker::SetTestWarmUp(              \
+            #fixture_name,                                              \
+            #benchmark_name,                                            \
+            runs,                                                       \
+            duration)
+
 // Parametrized benchmarks.
 #define BENCHMARK_P_(fixture_name,                                      \
                      benchmark_name,                                    \
@@ -112,6 +210,7 @@
         public BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name) {    \
     protected:                                                          \
         virtual void TestBody() { this->TestPayload arguments; }        \
+        BENCHMARK_ITERATION_LOOP_(this->TestPayload arguments)          \
     private:                                                            \
         static const ::hayai::TestDescriptor* _descriptor;              \
     };                                                                  \
@@ -132,5 +231,294 @@
 #define BENCHMARK_P_INSTANCE(fixture_name, benchmark_name, arguments)   \
     BENCHMARK_P_INSTANCE1(fixture_name, benchmark_name, arguments, BENCHMARK_P_ID_)
 
+// Parametrized benchmark instances generated from a grid of values.
+#define BENCHMARK_P_GENERATE1(fixture_name, benchmark_name, generator, id) \
+    class BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id):    \
+        public BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name) {    \
+    public:                                                             \
+        BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id)(      \
+            const std::vector<double>& arguments)                       \
+            :   _arguments(arguments) {}                                \
+    protected:                                                          \
+        virtual void TestBody() { RunIterations(1); }                   \
+        virtual void RunIterations(std::size_t iterations)              \
+        {                                                               \
+            ::hayai::InvokePayload(                                     \
+                *this,                                                  \
+                &BENCHMARK_P_CLASS_NAME_(fixture_name,                  \
+                                         benchmark_name,                \
+                                         id)::TestPayload,              \
+                _arguments,                                             \
+                iterations);                                            \
+        }                                                               \
+    private:                                                            \
+        std::vector<double> _arguments;                                 \
+        static const ::hayai::TestDescriptor* _descriptor;              \
+    };                                                                  \
+    const ::hayai::TestDescriptor* BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id)::_descriptor = \
+        ::hayai::Benchmarker::RegisterGeneratedTests<                   \
+            BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id)   \
+        >(                                                              \
+            #fixture_name, #benchmark_name,                             \
+            BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)::_runs, \
+            BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)::_iterations, \
+            BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)::_argumentsDeclaration(), \
+            generator)
+
+#define BENCHMARK_P_GENERATE(fixture_name, benchmark_name, generator)   \
+    BENCHMARK_P_GENERATE1(fixture_name, benchmark_name, generator, BENCHMARK_P_ID_)
+
+// Complexity of a parametrized benchmark.
+#define BENCHMARK_P_COMPLEXITY_CLASS_NAME_(fixture_name, benchmark_name) \
+    fixture_name ## _ ## benchmark_name ## _Complexity
+
+#define BENCHMARK_P_COMPLEXITY_(fixture_name,                           \
+                                benchmark_name,                         \
+                                parameter,                              \
+                                function,                               \
+                                function_name)                          \
+    class BENCHMARK_P_COMPLEXITY_CLASS_NAME_(fixture_name,              \
+                                             benchmark_name)            \
+    {                                                                   \
+    private:                                                            \
+        static const bool _registered;                                  \
+    };                                                                  \
+                                                                        \
+    const bool                                                          \
+    BENCHMARK_P_COMPLEXITY_CLASS_NAME_(fixture_name, benchmark_name)::  \
+        _registered = ::hayai::Benchmarker::SetTestComplexity(          \
+            #fixture_name,                                              \
+            #benchmark_name,                                            \
+            #parameter,                                                 \
+            function,                                                   \
+            function_name)
+
+#define BENCHMARK_P_COMPLEXITY(fixture_name,                            \
+                               benchmark_name,                          \
+                               parameter)                               \
+    BENCHMARK_P_COMPLEXITY_(fixture_name,                               \
+                            benchmark_name,                             \
+                            parameter,                                  \
+                            NULL,                                       \
+                            "f")
+
+#define BENCHMARK_P_COMPLEXITY_FUNCTION(fixture_name,                   \
+                                        benchmark_name,                 \
+                                        parameter,                      \
+                                        function)                       \
+    BENCHMARK_P_COMPLEXITY_(fixture_name,                               \
+                            benchmark_name,                             \
+                            parameter,                                  \
+                            function,                                   \
+                            #function)
+
+
+// Type-parametrized benchmarks.
+//
+// The type list must be a typedef of ::hayai::Types, and the benchmark body
+// refers to the type as TypeParam. Fixtures of type-parametrized benchmarks
+// are class templates taking the type, whose members are accessed through
+// this-> in the body.
+#define BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)          \
+    fixture_name ## _ ## benchmark_name ## _Traits
+
+#define BENCHMARK_T_(fixture_name,                                      \
+                     benchmark_name,                                    \
+                     fixture_class_name,                                \
+                     runs,                                              \
+                     iterations,                                        \
+                     types)                                             \
+    template<typename TypeParam>                                        \
+    class BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)           \
+        :   public fixture_class_name                                   \
+    {                                                                   \
+    public:                                                             \
+        BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)()           \
+        {                                                               \
+                                                                        \
+        }                                                               \
+    protected:                                                          \
+        virtual void TestBody();                                        \
+        BENCHMARK_ITERATION_LOOP_(                                      \
+            this->BENCHMARK_CLASS_NAME_(fixture_name,                   \
+                                        benchmark_name)::TestBody()     \
+        )                                                               \
+    };                                                                  \
+                                                                        \
+    class BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)        \
+    {                                                                   \
+    private:                                                            \
+        static const ::hayai::TestDescriptor* _descriptor;              \
+    };                                                                  \
+                                                                        \
+    const ::hayai::TestDescriptor*                                      \
+    BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_descriptor = \
+        ::hayai::Benchmarker::RegisterTypedTests<                       \
+            BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name),        \
+            types                                                       \
+        >(                                                              \
+            #fixture_name,                                              \
+            #benchmark_name,                                            \
+            runs,                                                       \
+            iterations,                                                 \
+            ::hayai::TestParametersDescriptor());                       \
+                                                                        \
+    template<typename TypeParam>                                        \
+    void BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)<TypeParam>:: \
+        TestBody()
+
+// Name of a type in the descriptions of type-parametrized benchmarks, eg.
+// BENCHMARK_TYPE_NAME(std::vector<int>, "vector"). Must be used outside of
+// any namespace. The trailing declaration only consumes the semicolon.
+#define BENCHMARK_TYPE_NAME(type, name)                                 \
+    namespace hayai                                                     \
+    {                                                                   \
+        template<>                                                      \
+        struct TypeName< type >                                         \
+        {                                                               \
+            static std::string Name()                                   \
+            {                                                           \
+                return name;                                            \
+            }                                                           \
+        };                                                              \
+    }                                                                   \
+    struct BENCHMARK_TYPE_NAME_Declaration
+
+#define BENCHMARK_T(fixture_name,                        \
+                    benchmark_name,                      \
+                    runs,                                \
+                    iterations,                          \
+                    types)                               \
+    BENCHMARK_T_(fixture_name,                           \
+                 benchmark_name,                         \
+                 ::hayai::Test,                          \
+                 runs,                                   \
+                 iterations,                             \
+                 types)
+
+#define BENCHMARK_T_F(fixture_name,                      \
+                      benchmark_name,                    \
+                      runs,                              \
+                      iterations,                        \
+                      types)                             \
+    BENCHMARK_T_(fixture_name,                           \
+                 benchmark_name,                         \
+                 fixture_name<TypeParam>,                \
+                 runs,                                   \
+                 iterations,                             \
+                 types)
+
+// Type- and value-parametrized benchmarks.
+#define BENCHMARK_T_P_(fixture_name,                                    \
+                       benchmark_name,                                  \
+                       fixture_class_name,                              \
+                       runs,                                            \
+                       iterations,                                      \
+                       types,                                           \
+                       arguments)                                       \
+    template<typename TypeParam>                                        \
+    class BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)           \
+        :   public fixture_class_name {                                 \
+    public:                                                             \
+        BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name) () {}       \
+        virtual ~ BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name) () {} \
+    protected:                                                          \
+        inline void TestPayload arguments;                              \
+    };                                                                  \
+    struct BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name) {     \
+        typedef types TypeList;                                         \
+        static const std::size_t _runs = runs;                          \
+        static const std::size_t _iterations = iterations;              \
+        static const char* _argumentsDeclaration() { return #arguments;  } \
+    };                                                                  \
+    template<typename TypeParam>                                        \
+    void BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)<TypeParam>::TestPayload arguments
+
+#define BENCHMARK_T_P(fixture_name,             \
+                      benchmark_name,           \
+                      runs,                     \
+                      iterations,               \
+                      types,                    \
+                      arguments)                \
+    BENCHMARK_T_P_(fixture_name,                \
+                   benchmark_name,              \
+                   ::hayai::Fixture,            \
+                   runs,                        \
+                   iterations,                  \
+                   types,                       \
+                   arguments)
+
+#define BENCHMARK_T_P_F(fixture_name, benchmark_name, runs, iterations, types, arguments) \
+        BENCHMARK_T_P_(fixture_name, benchmark_name, fixture_name<TypeParam>, runs, iterations, types, arguments)
+
+#define BENCHMARK_T_P_REGISTRATION_NAME_(fixture_name, benchmark_name, id) \
+        fixture_name ## _ ## benchmark_name ## _Registration_ ## id
+
+#define BENCHMARK_T_P_INSTANCE1(fixture_name, benchmark_name, arguments, id) \
+    template<typename TypeParam>                                        \
+    class BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id):    \
+        public BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)<TypeParam> { \
+    protected:                                                          \
+        virtual void TestBody() { this->TestPayload arguments; }        \
+        BENCHMARK_ITERATION_LOOP_(this->TestPayload arguments)          \
+    };                                                                  \
+    class BENCHMARK_T_P_REGISTRATION_NAME_(fixture_name, benchmark_name, id) { \
+    private:                                                            \
+        static const ::hayai::TestDescriptor* _descriptor;              \
+    };                                                                  \
+    const ::hayai::TestDescriptor* BENCHMARK_T_P_REGISTRATION_NAME_(fixture_name, benchmark_name, id)::_descriptor = \
+        ::hayai::Benchmarker::RegisterTypedTests<                       \
+            BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id),  \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::TypeList \
+        >(                                                              \
+            #fixture_name, #benchmark_name,                             \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_runs, \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_iterations, \
+            ::hayai::TestParametersDescriptor(BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_argumentsDeclaration(), #arguments))
+
+#define BENCHMARK_T_P_INSTANCE(fixture_name, benchmark_name, arguments) \
+    BENCHMARK_T_P_INSTANCE1(fixture_name, benchmark_name, arguments, BENCHMARK_P_ID_)
+
+#define BENCHMARK_T_P_GENERATE1(fixture_name, benchmark_name, generator, id) \
+    template<typename TypeParam>                                        \
+    class BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id):    \
+        public BENCHMARK_CLASS_NAME_(fixture_name, benchmark_name)<TypeParam> { \
+    public:                                                             \
+        BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id)(      \
+            const std::vector<double>& arguments)                       \
+            :   _arguments(arguments) {}                                \
+    protected:                                                          \
+        virtual void TestBody() { RunIterations(1); }                   \
+        virtual void RunIterations(std::size_t iterations)              \
+        {                                                               \
+            ::hayai::InvokePayload(                                     \
+                *this,                                                  \
+                &BENCHMARK_P_CLASS_NAME_(fixture_name,                  \
+                                         benchmark_name,                \
+                                         id)::TestPayload,              \
+                _arguments,                                             \
+                iterations);                                            \
+        }                                                               \
+    private:                                                            \
+        std::vector<double> _arguments;                                 \
+    };                                                                  \
+    class BENCHMARK_T_P_REGISTRATION_NAME_(fixture_name, benchmark_name, id) { \
+    private:                                                            \
+        static const ::hayai::TestDescriptor* _descriptor;              \
+    };                                                                  \
+    const ::hayai::TestDescriptor* BENCHMARK_T_P_REGISTRATION_NAME_(fixture_name, benchmark_name, id)::_descriptor = \
+        ::hayai::Benchmarker::RegisterTypedGeneratedTests<              \
+            BENCHMARK_P_CLASS_NAME_(fixture_name, benchmark_name, id),  \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::TypeList \
+        >(                                                              \
+            #fixture_name, #benchmark_name,                             \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_runs, \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_iterations, \
+            BENCHMARK_T_TRAITS_NAME_(fixture_name, benchmark_name)::_argumentsDeclaration(), \
+            generator)
+
+#define BENCHMARK_T_P_GENERATE(fixture_name, benchmark_name, generator) \
+    BENCHMARK_T_P_GENERATE1(fixture_name, benchmark_name, generator, BENCHMARK_P_ID_)
+
 
 #endif
@@ -0,0 +1,594 @@
+//
+// Comparison with baseline results.
+//
+// Implementation notes:
+//
+// Baseline results are read from a file written by the JSON outputter. Only
+// the parts of the file needed for the comparison are extracted, ie. the
+// name and parameters of each benchmark, the number of iterations per run
+// and the duration of each run, and everything else is skipped, so the
+// reader does not need to be kept in sync with every addition to the JSON
+// format.
+//
+// Benchmarks are matched by their canonical name, which is the name the
+// outputters print, eg. "DeliveryMan.DeliverPackage(std::size_t speed = 1)".
+// The runs are compared per iteration, so that results with different
+// numbers of iterations per run can be compared.
+//
+// Whether a benchmark has changed is decided by a Mann-Whitney U test on the
+// times per iteration, which does not assume normally distributed times.
+// The change of the median is reported with a bootstrap confidence interval,
+// and a change is only classified as an improvement or regression if the
+// interval excludes zero as well.
+//
+#ifndef __HAYAI_BASELINE
+#define __HAYAI_BASELINE
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "hayai_statistics.hpp"
+#include "hayai_test_descriptor.hpp"
+#include "hayai_test_result.hpp"
+
+
+/// Significance level of baseline comparisons.
+#ifndef HAYAI_BASELINE_SIGNIFICANCE
+#   define HAYAI_BASELINE_SIGNIFICANCE 0.05
+#endif
+
+/// Number of bootstrap resamples of baseline comparisons.
+#ifndef HAYAI_BASELINE_RESAMPLES
+#   define HAYAI_BASELINE_RESAMPLES 2000
+#endif
+
+
+namespace hayai
+{
+    /// Baseline results.
+    class Baseline
+    {
+    public:
+        /// Load baseline results.
+
+        /// @param path Path of a file written by the JSON outputter.
+        /// @throws std::runtime_error if the file cannot be read or parsed.
+        void Load(const std::string& path)
+        {
+            std::ifstream stream(path.c_str());
+
+            if (!stream)
+                throw std::runtime_error("failed to open baseline " + path);
+
+            std::stringstream buffer;
+            buffer << stream.rdbuf();
+
+            _text = buffer.str();
+            _position = 0;
+            _iterationTimes.clear();
+            _durations.clear();
+
+            ParseRoot();
+
+            _text.clear();
+        }
+
+
+        /// Number of benchmarks with baseline results.
+        inline std::size_t Size() const
+        {
+            return _iterationTimes.size();
+        }
+
+
+        /// Canonical name of a benchmark.
+
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param parameters Parameters of the test.
+        static std::string CanonicalName(
+            const std::string& fixtureName,
+            const std::string& testName,
+            const TestParametersDescriptor& parameters
+        )
+        {
+            std::string name = fixtureName + "." + testName;
+            const std::vector<TestParameterDescriptor>& descs =
+                parameters.Parameters();
+
+            if (descs.empty())
+                return name;
+
+            name += "(";
+
+            for (std::size_t i = 0; i < descs.size(); ++i)
+            {
+                if (i)
+                    name += ", ";
+
+                name += descs[i].Declaration + " = " + descs[i].Value;
+            }
+
+            return name + ")";
+        }
+
+
+        /// Duration of the baseline runs of a benchmark.
+
+        /// Serves as an estimate of how long the benchmark takes to run.
+        ///
+        /// @param name Canonical name of the benchmark.
+        /// @returns the total duration of the baseline runs in nanoseconds,
+        /// or 0 if the baseline holds no result for the benchmark.
+        double Duration(const std::string& name) const
+        {
+            std::map<std::string, double>::const_iterator it =
+                _durations.find(name);
+
+            return (it == _durations.end() ? 0.0 : it->second);
+        }
+
+
+        /// Compare a test result with its baseline result.
+
+        /// @param name Canonical name of the benchmark.
+        /// @param result Test result.
+        /// @param comparison Comparison on success.
+        /// @returns true if a baseline result with at least one run exists
+        /// for the benchmark.
+        bool Compare(const std::string& name,
+                     const TestResult& result,
+                     BaselineComparison& comparison) const
+        {
+            std::map<std::string, std::vector<double> >::const_iterator it =
+                _iterationTimes.find(name);
+
+            if ((it == _iterationTimes.end()) ||
+                (it->second.empty()) ||
+                (result.RunTimes().empty()))
+                return false;
+
+            const std::vector<double>& baseline = it->second;
+            std::vector<double> current;
+            current.reserve(result.RunTimes().size());
+
+            for (std::size_t run = 0; run < result.RunTimes().size(); ++run)
+                current.push_back(double(result.RunTimes()[run]) /
+                                  double(result.RunIterations(run)));
+
+            std::vector<double> sortedBaseline(baseline);
+            std::vector<double> sortedCurrent(current);
+            std::sort(sortedBaseline.begin(), sortedBaseline.end());
+            std::sort(sortedCurrent.begin(), sortedCurrent.end());
+
+            comparison = BaselineComparison();
+            comparison.BaselineMedian =
+                Statistics::SortedMedian(sortedBaseline);
+            comparison.Median = Statistics::SortedMedian(sortedCurrent);
+
+            if (comparison.BaselineMedian > 0.0)
+                comparison.RelativeChange =
+                    comparison.Median / comparison.BaselineMedian - 1.0;
+
+            Statistics::BootstrapRelativeMedianChange(
+                baseline,
+                current,
+                1.0 - HAYAI_BASELINE_SIGNIFICANCE,
+                HAYAI_BASELINE_RESAMPLES,
+                0,
+                comparison.RelativeChangeLower,
+                comparison.RelativeChangeUpper
+            );
+
+            comparison.PValue = Statistics::MannWhitneyU(baseline, current);
+
+            // Only classify a change if the confidence interval agrees
+            // with the test on its direction.
+            if ((comparison.PValue < HAYAI_BASELINE_SIGNIFICANCE) &&
+                ((comparison.RelativeChangeLower > 0.0) ||
+                 (comparison.RelativeChangeUpper < 0.0)))
+                comparison.Change = (comparison.RelativeChange > 0.0 ?
+                                     BaselineRegressed :
+                                     BaselineImproved);
+
+            return true;
+        }
+    private:
+        /// Benchmark read from the baseline.
+        struct Benchmark
+        {
+            Benchmark()
+                :   Iterations(1)
+            {
+
+            }
+
+
+            std::string Fixture;
+            std::string Name;
+            TestParametersDescriptor Parameters;
+            double Iterations;
+            std::vector<double> Durations;
+            std::vector<double> RunIterations;
+        };
+
+
+        /// Throw a parse error at the current position.
+        void Fail(const std::string& message) const
+        {
+            std::stringstream error;
+            error << "invalid baseline at offset " << _position << ": "
+                  << message;
+            throw std::runtime_error(error.str());
+        }
+
+
+        /// Skip whitespace.
+        void SkipWhitespace()
+        {
+            while ((_position < _text.size()) &&
+                   ((_text[_position] == ' ') ||
+                    (_text[_position] == '\t') ||
+                    (_text[_position] == '\r') ||
+                    (_text[_position] == '\n')))
+                ++_position;
+        }
+
+
+        /// Consume a character if it is next.
+
+        /// @returns true if the character was consumed.
+        bool Accept(char c)
+        {
+            SkipWhitespace();
+
+            if ((_position < _text.size()) && (_text[_position] == c))
+            {
+                ++_position;
+                return true;
+            }
+
+            return false;
+        }
+
+
+        /// Consume a character that must be next.
+        void Expect(char c)
+        {
+            if (!Accept(c))
+                Fail(std::string("expected '") + c + "'");
+        }
+
+
+        /// Parse a string.
+        std::string ParseString()
+        {
+            Expect('"');
+
+            std::string value;
+
+            while (true)
+            {
+                if (_position >= _text.size())
+                    Fail("unterminated string");
+
+                char c = _text[_position++];
+
+                if (c == '"')
+                    break;
+
+                if (c == '\\')
+                {
+                    if (_position >= _text.size())
+                        Fail("unterminated string");
+
+                    c = _text[_position++];
+
+                    switch (c)
+                    {
+                    case 'b':
+                        c = '\b';
+                        break;
+
+                    case 'f':
+                        c = '\f';
+                        break;
+
+                    case 'n':
+                        c = '\n';
+                        break;
+
+                    case 'r':
+                        c = '\r';
+                        break;
+
+                    case 't':
+                        c = '\t';
+                        break;
+
+                    case 'u':
+                        // Names are ASCII, so escaped code points are
+                        // replaced.
+                        _position += 4;
+                        c = '?';
+                        break;
+
+                    default:
+                        break;
+                    }
+                }
+
+                value += c;
+            }
+
+            return value;
+        }
+
+
+        /// Parse a number.
+        double ParseNumber()
+        {
+            SkipWhitespace();
+
+            const char* start = _text.c_str() + _position;
+            char* end;
+            const double value = strtod(start, &end);
+
+            if (end == start)
+                Fail("expected a number");
+
+            _position += std::size_t(end - start);
+            return value;
+        }
+
+
+        /// Skip a value of any type.
+        void SkipValue()
+        {
+            SkipWhitespace();
+
+            if (_position >= _text.size())
+                Fail("unexpected end of file");
+
+            const char c = _text[_position];
+
+            if (c == '"')
+                ParseString();
+            else if (c == '{')
+            {
+                Expect('{');
+
+                if (!Accept('}'))
+                {
+                    do
+                    {
+                        ParseString();
+                        Expect(':');
+                        SkipValue();
+                    }
+                    while (Accept(','));
+
+                    Expect('}');
+                }
+            }
+            else if (c == '[')
+            {
+                Expect('[');
+
+                if (!Accept(']'))
+                {
+                    do
+                        SkipValue();
+                    while (Accept(','));
+
+                    Expect(']');
+                }
+            }
+            else if ((c == 't') || (c == 'f') || (c == 'n'))
+            {
+                while ((_position < _text.size()) &&
+                       (_text[_position] >= 'a') &&
+                       (_text[_position] <= 'z'))
+                    ++_position;
+            }
+            else
+                ParseNumber();
+        }
+
+
+        /// Parse the root object.
+        void ParseRoot()
+        {
+            Expect('{');
+
+            if (Accept('}'))
+                return;
+
+            do
+            {
+                const std::string key = ParseString();
+                Expect(':');
+
+                if (key == "benchmarks")
+                {
+                    Expect('[');
+
+                    if (!Accept(']'))
+                    {
+                        do
+                            ParseBenchmark();
+                        while (Accept(','));
+
+                        Expect(']');
+                    }
+                }
+                else
+                    SkipValue();
+            }
+            while (Accept(','));
+
+            Expect('}');
+        }
+
+
+        /// Parse a benchmark object.
+        void ParseBenchmark()
+        {
+            Benchmark benchmark;
+
+            Expect('{');
+
+            if (!Accept('}'))
+            {
+                do
+                {
+                    const std::string key = ParseString();
+                    Expect(':');
+
+                    if (key == "fixture")
+                        benchmark.Fixture = ParseString();
+                    else if (key == "name")
+                        benchmark.Name = ParseString();
+                    else if (key == "iterations_per_run")
+                        benchmark.Iterations = ParseNumber();
+                    else if (key == "parameters")
+                        ParseParameters(benchmark.Parameters);
+                    else if (key == "runs")
+                        ParseRuns(benchmark.Durations,
+                                  benchmark.RunIterations);
+                    else
+                        SkipValue();
+                }
+                while (Accept(','));
+
+                Expect('}');
+            }
+
+            if ((benchmark.Durations.empty()) || (benchmark.Iterations <= 0.0))
+                return;
+
+            // Durations are given in milliseconds per run, and runs with
+            // linearly increasing iteration counts give their own count.
+            const std::string name = CanonicalName(benchmark.Fixture,
+                                                   benchmark.Name,
+                                                   benchmark.Parameters);
+            std::vector<double>& iterationTimes = _iterationTimes[name];
+            double& duration = _durations[name];
+            iterationTimes.clear();
+            duration = 0.0;
+
+            for (std::size_t run = 0; run < benchmark.Durations.size(); ++run)
+            {
+                duration += benchmark.Durations[run] * 1000000.0;
+                iterationTimes.push_back(
+                    benchmark.Durations[run] * 1000000.0 /
+                    (benchmark.RunIterations[run] > 0.0 ?
+                     benchmark.RunIterations[run] :
+                     benchmark.Iterations)
+                );
+            }
+        }
+
+
+        /// Parse a parameters array.
+        void ParseParameters(TestParametersDescriptor& parameters)
+        {
+            Expect('[');
+
+            if (Accept(']'))
+                return;
+
+            do
+            {
+                std::string declaration;
+                std::string value;
+
+                Expect('{');
+
+                if (!Accept('}'))
+                {
+                    do
+                    {
+                        const std::string key = ParseString();
+                        Expect(':');
+
+                        if (key == "declaration")
+                            declaration = ParseString();
+                        else if (key == "value")
+                            value = ParseString();
+                        else
+                            SkipValue();
+                    }
+                    while (Accept(','));
+
+                    Expect('}');
+                }
+
+                parameters.AddParameter(declaration, value);
+            }
+            while (Accept(','));
+
+            Expect(']');
+        }
+
+
+        /// Parse a runs array.
+
+        /// @param durations Duration of each run.
+        /// @param iterations Number of iterations of each run, or 0 if the
+        /// run does not give its own number of iterations.
+        void ParseRuns(std::vector<double>& durations,
+                       std::vector<double>& iterations)
+        {
+            Expect('[');
+
+            if (Accept(']'))
+                return;
+
+            do
+            {
+                double duration = 0.0;
+                double runIterations = 0.0;
+
+                Expect('{');
+
+                if (!Accept('}'))
+                {
+                    do
+                    {
+                        const std::string key = ParseString();
+                        Expect(':');
+
+                        if (key == "duration")
+                            duration = ParseNumber();
+                        else if (key == "iterations")
+                            runIterations = ParseNumber();
+                        else
+                            SkipValue();
+                    }
+                    while (Accept(','));
+
+                    Expect('}');
+                }
+
+                durations.push_back(duration);
+                iterations.push_back(runIterations);
+            }
+            while (Accept(','));
+
+            Expect(']');
+        }
+
+
+        std::string _text;
+        std::size_t _position;
+        std::map<std::string, std::vector<double> > _iterationTimes;
+        std::map<std::string, double> _durations;
+    };
+}
+#endif
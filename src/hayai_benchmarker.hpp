@@ -1,6 +1,9 @@
 #ifndef __HAYAI_BENCHMARKER
 #define __HAYAI_BENCHMARKER
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
 #include <vector>
 #include <limits>
 #include <iomanip>
@@ -9,13 +12,43 @@
 #endif
 #include <string>
 #include <cstring>
-
+#include <sstream>
+#include <stdexcept>
+
+#include "hayai_baseline.hpp"
+#include "hayai_calibration_cache.hpp"
+#include "hayai_complexity.hpp"
+#include "hayai_cpu_topology.hpp"
+#include "hayai_default_test_factory.hpp"
+#include "hayai_isolation.hpp"
+#include "hayai_parameter_generator.hpp"
+#include "hayai_performance_counters.hpp"
+#include "hayai_scheduling.hpp"
+#include "hayai_statistics.hpp"
 #include "hayai_test_factory.hpp"
+#include "hayai_threading.hpp"
 #include "hayai_test_descriptor.hpp"
 #include "hayai_test_result.hpp"
+#include "hayai_types.hpp"
 #include "hayai_console_outputter.hpp"
 
 
+/// Default minimum run time in nanoseconds for automatic iteration counts.
+#ifndef HAYAI_DEFAULT_MINIMUM_RUN_TIME
+#   define HAYAI_DEFAULT_MINIMUM_RUN_TIME 10000000
+#endif
+
+/// Confidence level for adaptive run counts.
+#ifndef HAYAI_ADAPTIVE_CONFIDENCE_LEVEL
+#   define HAYAI_ADAPTIVE_CONFIDENCE_LEVEL 0.95
+#endif
+
+/// Confidence level of the slope of linearly sampled runs.
+#ifndef HAYAI_LINEAR_SAMPLING_CONFIDENCE_LEVEL
+#   define HAYAI_LINEAR_SAMPLING_CONFIDENCE_LEVEL 0.95
+#endif
+
+
 namespace hayai
 {
     /// Benchmarking execution controller singleton.
@@ -40,6 +73,9 @@ namespace hayai
         /// @param runs Number of runs for the test.
         /// @param iterations Number of iterations per run.
         /// @param testFactory Test factory implementation for the test.
+        /// @param parameters Parametrized test parameters.
+        /// @param threads Number of threads to run the test on, or 0 to run
+        /// the test on the calling thread only.
         /// @returns a pointer to a @ref TestDescriptor instance
         /// representing the given test.
         static TestDescriptor* RegisterTest(
@@ -48,7 +84,8 @@ namespace hayai
             std::size_t runs,
             std::size_t iterations,
             TestFactory* testFactory,
-            TestParametersDescriptor parameters
+            TestParametersDescriptor parameters,
+            std::size_t threads = 0
         )
         {
             // Determine if the test has been disabled.
@@ -66,7 +103,8 @@ namespace hayai
                                                             iterations,
                                                             testFactory,
                                                             parameters,
-                                                            isDisabled);
+                                                            isDisabled,
+                                                            threads);
 
             Instance()._tests.push_back(descriptor);
 
@@ -74,6 +112,226 @@ namespace hayai
         }
 
 
+        /// Register a multi-threaded test with the benchmarker instance.
+
+        /// The number of threads is described to the outputters as a
+        /// "threads" parameter of the test.
+        ///
+        /// @tparam T Test class.
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param runs Number of runs for the test.
+        /// @param iterations Number of iterations per run for each thread.
+        /// @param threads Number of threads to run the test on, or
+        /// @ref ThreadSweep to register the test once for each thread count
+        /// of a sweep.
+        /// @returns a pointer to the first @ref TestDescriptor instance
+        /// registered for the given test.
+        template<class T>
+        static TestDescriptor* RegisterThreadedTest(const char* fixtureName,
+                                                    const char* testName,
+                                                    std::size_t runs,
+                                                    std::size_t iterations,
+                                                    std::size_t threads)
+        {
+            std::vector<std::size_t> threadCounts;
+
+            if (threads != ThreadSweep)
+                threadCounts.push_back(threads);
+            else
+            {
+                const std::size_t hardwareThreads = HardwareConcurrency();
+
+                for (std::size_t count = 1;
+                     count < hardwareThreads;
+                     count *= 2)
+                    threadCounts.push_back(count);
+
+                threadCounts.push_back(hardwareThreads);
+            }
+
+            TestDescriptor* first = NULL;
+
+            for (std::size_t index = 0; index < threadCounts.size(); ++index)
+            {
+                std::stringstream value;
+                value << "(" << threadCounts[index] << ")";
+
+                TestDescriptor* descriptor = RegisterTest(
+                    fixtureName,
+                    testName,
+                    runs,
+                    iterations,
+                    new TestFactoryDefault<T>(),
+                    TestParametersDescriptor("(std::size_t threads)",
+                                             value.str().c_str()),
+                    threadCounts[index]
+                );
+
+                if (!first)
+                    first = descriptor;
+            }
+
+            return first;
+        }
+
+
+        /// Register a parametrized test for each combination of a grid.
+
+        /// @tparam T Test class, constructible from the arguments of a
+        /// combination.
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param runs Number of runs for the test.
+        /// @param iterations Number of iterations per run.
+        /// @param argumentsDeclaration Declaration of the test parameters as
+        /// "(type name, ..)".
+        /// @param grid Values of the parameters.
+        /// @param leading Parameters described before the generated
+        /// parameters, eg. the type of a type-parametrized test.
+        /// @returns a pointer to the first @ref TestDescriptor instance
+        /// registered for the given test, or NULL if the grid is empty. If
+        /// the number of parameters of the grid and the test differ, a
+        /// single test is registered that fails with the error when run, as
+        /// tests are registered during static initialization where an
+        /// exception would terminate the program.
+        template<class T>
+        static TestDescriptor* RegisterGeneratedTests(
+            const char* fixtureName,
+            const char* testName,
+            std::size_t runs,
+            std::size_t iterations,
+            const char* argumentsDeclaration,
+            const ParameterGrid& grid,
+            const TestParametersDescriptor& leading =
+                TestParametersDescriptor()
+        )
+        {
+            // Parse the declarations once for all combinations.
+            const std::vector<TestParameterDescriptor> declarations =
+                TestParametersDescriptor(argumentsDeclaration, "()")
+                .Parameters();
+
+            if (declarations.size() != grid.Dimensions())
+            {
+                std::stringstream error;
+                error << "parameter grid of " << fixtureName << "."
+                      << testName << " has " << grid.Dimensions()
+                      << " parameters instead of " << declarations.size();
+
+                TestDescriptor* descriptor = RegisterTest(
+                    fixtureName,
+                    testName,
+                    runs,
+                    iterations,
+                    new TestFactoryArguments<T>(std::vector<double>()),
+                    leading
+                );
+                descriptor->Error = error.str();
+                return descriptor;
+            }
+
+            const std::vector<std::vector<double> > combinations =
+                grid.Combinations();
+            TestDescriptor* first = NULL;
+
+            for (std::size_t index = 0; index < combinations.size(); ++index)
+            {
+                TestParametersDescriptor parameters(leading);
+
+                for (std::size_t i = 0; i < declarations.size(); ++i)
+                    parameters.AddParameter(
+                        declarations[i].Declaration,
+                        ParameterValues::Format(combinations[index][i])
+                    );
+
+                TestDescriptor* descriptor = RegisterTest(
+                    fixtureName,
+                    testName,
+                    runs,
+                    iterations,
+                    new TestFactoryArguments<T>(combinations[index]),
+                    parameters
+                );
+
+                if (!first)
+                    first = descriptor;
+            }
+
+            return first;
+        }
+
+
+        /// Register a test for each type of a type list.
+
+        /// The name of the type is described to the outputters as a
+        /// "typename TypeParam" parameter preceding the parameters of the
+        /// test.
+        ///
+        /// @tparam TestTemplate Test class template taking the type.
+        /// @tparam TypeList @ref Types to instantiate the test for.
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param runs Number of runs for the test.
+        /// @param iterations Number of iterations per run.
+        /// @param parameters Parametrized test parameters.
+        /// @returns a pointer to the first @ref TestDescriptor instance
+        /// registered for the given test, or NULL if the list is empty.
+        template<template<typename> class TestTemplate, class TypeList>
+        static TestDescriptor* RegisterTypedTests(
+            const char* fixtureName,
+            const char* testName,
+            std::size_t runs,
+            std::size_t iterations,
+            const TestParametersDescriptor& parameters
+        )
+        {
+            return RegisterTypes<TestTemplate>(TypeList(),
+                                               fixtureName,
+                                               testName,
+                                               runs,
+                                               iterations,
+                                               parameters);
+        }
+
+
+        /// Register a test for each type of a type list and each
+        /// combination of a grid.
+
+        /// @tparam TestTemplate Test class template taking the type,
+        /// constructible from the arguments of a combination.
+        /// @tparam TypeList @ref Types to instantiate the test for.
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param runs Number of runs for the test.
+        /// @param iterations Number of iterations per run.
+        /// @param argumentsDeclaration Declaration of the test parameters as
+        /// "(type name, ..)".
+        /// @param grid Values of the parameters.
+        /// @returns a pointer to the first @ref TestDescriptor instance
+        /// registered for the given test, or NULL if the list or grid is
+        /// empty. If the number of parameters of the grid and the test
+        /// differ, the tests fail with the error when run.
+        template<template<typename> class TestTemplate, class TypeList>
+        static TestDescriptor* RegisterTypedGeneratedTests(
+            const char* fixtureName,
+            const char* testName,
+            std::size_t runs,
+            std::size_t iterations,
+            const char* argumentsDeclaration,
+            const ParameterGrid& grid
+        )
+        {
+            return RegisterGeneratedTypes<TestTemplate>(TypeList(),
+                                                        fixtureName,
+                                                        testName,
+                                                        runs,
+                                                        iterations,
+                                                        argumentsDeclaration,
+                                                        grid);
+        }
+
+
         /// Add an outputter.
 
         /// @param outputter Outputter. The caller must ensure that the
@@ -84,353 +342,2541 @@ namespace hayai
         }
 
 
-        /// Apply a pattern filter to the tests.
+        /// Enable performance counters.
 
-        /// --gtest_filter-compatible pattern:
+        /// The events are probed by opening a counter group. Events that
+        /// cannot be opened are left out when running the tests.
         ///
-        /// https://code.google.com/p/googletest/wiki/AdvancedGuide
+        /// @param events Events to count for each run.
+        /// @param errors Optional pointer to vector to hold the reasons for
+        /// events that could not be opened.
+        /// @returns true if at least one of the events can be counted, in
+        /// which case counters are collected for each run.
+        static bool EnablePerformanceCounters(
+            const std::vector<PerformanceCounterEvent>& events,
+            std::vector<std::string>* errors = NULL
+        )
+        {
+            Benchmarker& instance = Instance();
+            PerformanceCounterGroup probe(events);
+
+            instance._counterEvents = events;
+            instance._countersEnabled = probe.Open();
+
+            if (errors)
+                *errors = probe.Errors();
+
+            return instance._countersEnabled;
+        }
+
+
+        /// Set the minimum run time.
+
+        /// If set, the number of iterations of every test is calibrated so
+        /// that a single run takes at least the given time, overriding the
+        /// number of iterations given for the test. Otherwise, only tests
+        /// registered with @ref AutoIterations are calibrated, against a
+        /// default of 10 ms.
         ///
-        /// @param pattern Filter pattern compatible with gtest.
-        static void ApplyPatternFilter(const char* pattern)
+        /// @param nanoseconds Minimum run time in nanoseconds, or 0 to
+        /// only calibrate tests registered with @ref AutoIterations.
+        static void SetMinimumRunTime(uint64_t nanoseconds)
+        {
+            Instance()._minimumRunTime = nanoseconds;
+        }
+
+
+        /// Enable adaptive run counts.
+
+        /// Instead of performing the number of runs given for each test,
+        /// runs are performed until the 95 % confidence interval of the
+        /// chosen statistic is narrow enough, the maximum number of runs is
+        /// reached or the time budget is exhausted.
+        ///
+        /// @param targetRelativeWidth Width of the confidence interval
+        /// relative to the estimate at which to stop, eg. 0.01.
+        /// @param statistic Statistic to determine the confidence interval
+        /// for.
+        /// @param minimumRuns Minimum number of runs. At least 2.
+        /// @param maximumRuns Maximum number of runs.
+        /// @param timeBudget Maximum time in nanoseconds to spend on the runs
+        /// of each test. The run in progress when the budget is exhausted
+        /// is completed.
+        static void EnableAdaptiveRuns(double targetRelativeWidth,
+                                       Statistic statistic,
+                                       std::size_t minimumRuns,
+                                       std::size_t maximumRuns,
+                                       uint64_t timeBudget)
         {
             Benchmarker& instance = Instance();
 
-            // Split the filter at '-' if it exists.
-            const char* const dash = strchr(pattern, '-');
+            instance._adaptiveRuns = true;
+            instance._adaptiveTarget = targetRelativeWidth;
+            instance._adaptiveStatistic = statistic;
+            instance._adaptiveMinimumRuns = std::max<std::size_t>(minimumRuns,
+                                                                  2);
+            instance._adaptiveMaximumRuns =
+                std::max(maximumRuns, instance._adaptiveMinimumRuns);
+            instance._adaptiveTimeBudget = timeBudget;
+        }
 
-            std::string positive;
-            std::string negative;
 
-            if (dash == NULL)
-                positive = pattern;
-            else
-            {
-                positive = std::string(pattern, dash);
-                negative = std::string(dash + 1);
-                if (positive.empty())
-                    positive = "*";
-            }
+        /// Set the calibration cache file.
 
-            // Iterate across all tests and test them against the patterns.
-            std::size_t index = 0;
-            while (index < instance._tests.size())
-            {
-                TestDescriptor* desc = instance._tests[index];
+        /// The calibration model is loaded from the cache file if it holds
+        /// an entry for the host, processor, clock backend and executable,
+        /// and stored in it otherwise. No cache is used unless set, eg. to
+        /// @ref CalibrationCache::DefaultPath as the main runner does.
+        ///
+        /// @param path Path of the cache file, or an empty string to always
+        /// calibrate without caching the result.
+        static void SetCalibrationCache(const std::string& path)
+        {
+            Instance()._calibrationCachePath = path;
+        }
+
+
+        /// Force recalibration.
+
+        /// The calibration model is determined even if the cache holds an
+        /// entry, and the entry is replaced.
+        static void Recalibrate()
+        {
+            Instance()._recalibrate = true;
+        }
+
+
+        /// Set the precision of result histograms.
+
+        /// @param significantDigits Number of significant decimal digits to
+        /// which the run times in the result histograms are preserved.
+        /// Between 1 and 5.
+        static void SetHistogramSignificantDigits(int significantDigits)
+        {
+            Instance()._histogramSignificantDigits = significantDigits;
+        }
+
+
+        /// Enable sampling of individual iterations.
+
+        /// Every @p interval th iteration of single-threaded tests is timed
+        /// on its own, with the overhead of timing it subtracted, and the
+        /// distribution of the samples is reported in addition to the run
+        /// times. Timing iterations adds the overhead of reading the clock
+        /// twice per sample to the run times, so sparse sampling distorts
+        /// the run times less.
+        ///
+        /// @param interval Interval of the timed iterations, or 0 to disable
+        /// sampling.
+        static void SetIterationSampling(std::size_t interval)
+        {
+            Instance()._sampleInterval = interval;
+        }
+
+
+        /// Run tests open-loop at a fixed rate.
+
+        /// Single-threaded tests start their iterations at fixed intervals
+        /// instead of back to back, and the latency of each iteration is
+        /// measured from its intended start time. See
+        /// @ref Test::RunOpenLoop.
+        ///
+        /// If the number of iterations of a test is calibrated, it is
+        /// chosen so that a run at the rate takes the minimum run time.
+        ///
+        /// @param rate Offered load in iterations per second, or 0 to run
+        /// tests closed-loop.
+        static void SetOpenLoop(double rate)
+        {
+            Benchmarker& instance = Instance();
+
+            instance._openLoopRates.clear();
+            if (rate > 0.0)
+                instance._openLoopRates.push_back(rate);
+        }
+
+
+        /// Run tests open-loop at increasing rates.
+
+        /// Each single-threaded test is run at geometrically spaced offered
+        /// loads from the minimum to the maximum rate, reported as separate
+        /// results with the rate as an additional parameter. The sweep of a
+        /// test stops at the first rate at which the test is saturated, ie.
+        /// it achieves less than 90 % of the offered load or its 99th
+        /// percentile latency exceeds ten times the latency at the lowest
+        /// rate. The highest throughput achieved below that rate is reported
+        /// as the saturation throughput.
+        ///
+        /// @param minimumRate Lowest offered load in iterations per second.
+        /// @param maximumRate Highest offered load in iterations per second.
+        /// @param steps Number of rates. At least 2.
+        static void SetOpenLoopSweep(double minimumRate,
+                                     double maximumRate,
+                                     std::size_t steps)
+        {
+            Benchmarker& instance = Instance();
+
+            steps = std::max<std::size_t>(steps, 2);
+            instance._openLoopRates.clear();
+
+            for (std::size_t step = 0; step < steps; ++step)
+                instance._openLoopRates.push_back(
+                    minimumRate * std::pow(maximumRate / minimumRate,
+                                           double(step) / double(steps - 1))
+                );
+        }
+
+
+        /// Compare test results with baseline results.
+
+        /// Each test result for which the baseline holds a result with the
+        /// same name and parameters is compared with the baseline result.
+        ///
+        /// @param baseline Baseline results. Must outlive the benchmarker
+        /// runs.
+        /// @param regressionThreshold Relative change of the median time
+        /// per iteration above which a significant regression is counted,
+        /// eg. 0.05 for 5 %.
+        static void SetBaseline(const Baseline& baseline,
+                                double regressionThreshold)
+        {
+            Benchmarker& instance = Instance();
+            instance._baseline = &baseline;
+            instance._regressionThreshold = regressionThreshold;
+        }
+
+
+        /// Number of regressions.
+
+        /// @returns the number of test results of the last run of all tests
+        /// that are significantly slower than their baseline result by more
+        /// than the regression threshold.
+        static std::size_t Regressions()
+        {
+            return Instance()._regressions;
+        }
+
+
+        /// Run each test in its own process.
+
+        /// The runs of each test, or of each offered load of an open-loop
+        /// sweep, are performed in a child process forked for them, so that
+        /// the state left behind by earlier tests in the heap, caches and
+        /// lazily initialized libraries does not bias later tests. The
+        /// result is sent back to the benchmarker, which reports it to the
+        /// outputters as usual. A test whose process crashes, exits early or
+        /// exceeds the timeout is reported as failed, and the remaining tests
+        /// are run.
+        ///
+        /// @param enabled Whether to isolate tests.
+        /// @param timeout Time in nanoseconds an isolated test may take
+        /// before its process is killed, or 0 for no limit.
+        /// @returns false if isolation was requested but is not supported on
+        /// this platform, in which case tests are run in process.
+        static bool SetIsolation(bool enabled, uint64_t timeout = 0)
+        {
+            Benchmarker& instance = Instance();
+
+            instance._isolate = ((enabled) && (IsolatedProcess::IsSupported()));
+            instance._isolationTimeout = timeout;
+
+            return ((!enabled) || (instance._isolate));
+        }
+
+
+        /// Number of failures.
+
+        /// @returns the number of tests of the last run of all tests that
+        /// failed to produce a result.
+        static std::size_t Failures()
+        {
+            return Instance()._failures;
+        }
+
+
+        /// Run isolated tests in parallel.
+
+        /// Up to the given number of isolated tests are run at the same
+        /// time, each in its own process pinned to its own processor. The
+        /// processors are picked to share as few cores and caches as
+        /// possible, but concurrent tests still compete for memory bandwidth
+        /// and the caches shared by all cores. Tests are started in
+        /// decreasing order of their duration in the baseline results, if
+        /// set, after the tests without a baseline result, so that long tests
+        /// do not end up running alone at the end. Multi-threaded tests are
+        /// run one at a time after all others, without pinning. The results
+        /// are reported to the outputters in the order the tests are
+        /// registered in, as soon as the results of all earlier tests are
+        /// in.
+        ///
+        /// Only takes effect if isolation is enabled, see
+        /// @ref SetIsolation.
+        ///
+        /// @param jobs Maximum number of tests to run at the same time.
+        /// @returns the number of tests that will be run at the same time,
+        /// which is limited to the number of processors available to the
+        /// process if it can be determined.
+        static std::size_t SetJobs(std::size_t jobs)
+        {
+            Benchmarker& instance = Instance();
+
+            instance._jobs = std::max(jobs, std::size_t(1));
+            instance._jobCpus =
+                CpuTopology::Detect().Spread(instance._jobs);
+
+            if (!instance._jobCpus.empty())
+                instance._jobs = instance._jobCpus.size();
 
-                if ((!FilterMatchesString(positive.c_str(),
-                                          desc->CanonicalName)) ||
-                    (FilterMatchesString(negative.c_str(),
-                                         desc->CanonicalName)))
+            return instance._jobs;
+        }
+
+
+        /// Place the threads of multi-threaded tests.
+
+        /// Pins each thread of a multi-threaded test to a processor for its
+        /// runs, picked by the placement policy among the processors the
+        /// benchmarker may run on when this is called.
+        ///
+        /// @param placement Placement policy.
+        /// @returns false if the processor topology cannot be determined, in
+        /// which case the threads are placed by the operating system.
+        static bool SetThreadPlacement(ThreadPlacement placement)
+        {
+            Benchmarker& instance = Instance();
+
+            instance._threadTopology = CpuTopology::Detect();
+            instance._threadPlacement =
+                (instance._threadTopology.Cpus().empty() ?
+                 ThreadPlacementNone :
+                 placement);
+            instance._threadCpus.clear();
+
+            return ((placement == ThreadPlacementNone) ||
+                    (instance._threadPlacement != ThreadPlacementNone));
+        }
+
+
+        /// Lock the memory of the benchmarks.
+
+        /// Locks all current and future pages of the benchmarker, and of the
+        /// processes of isolated tests, into memory, so that timed runs do
+        /// not incur page faults from pages being swapped out.
+        ///
+        /// @param error Optional string to hold the reason of a failure.
+        /// @returns false if the memory could not be locked.
+        static bool LockMemory(std::string* error = NULL)
+        {
+            if (!Scheduling::LockMemory(error))
+                return false;
+
+            Instance()._lockMemory = true;
+            return true;
+        }
+
+
+        /// Add metadata to describe the benchmarks with.
+
+        /// The metadata is passed to the outputters before the first test,
+        /// eg. to record the settings the benchmarks were run with.
+        ///
+        /// @param name Name of the entry, which replaces an entry with the
+        /// same name.
+        /// @param value Value of the entry.
+        static void AddMetadata(const std::string& name,
+                                const std::string& value)
+        {
+            std::vector<std::pair<std::string, std::string> >& metadata =
+                Instance()._metadata;
+
+            for (std::size_t index = 0; index < metadata.size(); ++index)
+            {
+                if (metadata[index].first == name)
                 {
-                    instance._tests.erase(
-                        instance._tests.begin() +
-                        std::vector<TestDescriptor*>::difference_type(index)
-                    );
-                    delete desc;
+                    metadata[index].second = value;
+                    return;
                 }
-                else
-                    ++index;
+            }
+
+            metadata.push_back(std::make_pair(name, value));
+        }
+
+
+        /// Perform runs with linearly increasing iteration counts.
+
+        /// The k-th run of each test performs k times a fixed number of
+        /// iterations, chosen so that the runs perform the configured number
+        /// of iterations on average. The time per iteration is then
+        /// estimated as the slope of a least-squares fit of the run times on
+        /// the iteration counts, which separates it from the fixed time of
+        /// each run. With adaptive run counts, the iteration counts increase
+        /// over the maximum number of runs, and the stopping criterion is
+        /// evaluated on the times per iteration. Multi-threaded and
+        /// open-loop tests are not affected.
+        ///
+        /// @param enabled Whether to perform linearly sampled runs.
+        static void SetLinearSampling(bool enabled)
+        {
+            Instance()._linearSampling = enabled;
+        }
+
+
+        /// Estimate bootstrap confidence intervals of the results.
+
+        /// @param resamples Number of resamples, or 0 to not estimate
+        /// confidence intervals.
+        /// @param level Confidence level, eg. 0.95.
+        /// @param seed Seed of the resampling, so that intervals are
+        /// reproducible.
+        /// @param threads Number of threads to resample on.
+        static void SetBootstrap(std::size_t resamples,
+                                 double level = HAYAI_BOOTSTRAP_LEVEL,
+                                 uint64_t seed = HAYAI_BOOTSTRAP_SEED,
+                                 std::size_t threads = 1)
+        {
+            Instance()._bootstrap =
+                Bootstrap(resamples, level, seed, threads);
+        }
+
+
+        /// Set the warm-up for all tests.
+
+        /// Warm-up runs are performed before the runs of each test and are
+        /// discarded, so that effects like cold caches, page faults on fresh
+        /// memory and processor frequency ramp-up do not distort the
+        /// results. Warm-up runs are performed until both the number of runs
+        /// has been performed and the duration has elapsed.
+        ///
+        /// @param runs Minimum number of warm-up runs.
+        /// @param duration Minimum duration in nanoseconds of the warm-up.
+        static void SetWarmUp(std::size_t runs, uint64_t duration)
+        {
+            Instance()._warmUp = WarmUp(runs, duration);
+        }
+
+
+        /// Set the warm-up for a test.
+
+        /// Overrides the warm-up set by @ref SetWarmUp for all tests with the
+        /// given name. As the test is identified by its fixture and test name
+        /// only, the warm-up applies to every instance of a parametrized
+        /// test.
+        ///
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param runs Minimum number of warm-up runs.
+        /// @param duration Minimum duration in nanoseconds of the warm-up.
+        /// @returns true.
+        static bool SetTestWarmUp(const char* fixtureName,
+                                  const char* testName,
+                                  std::size_t runs,
+                                  uint64_t duration)
+        {
+            Instance()._testWarmUps[std::string(fixtureName) + "." +
+                                    testName] = WarmUp(runs, duration);
+            return true;
+        }
+
+
+        /// Fit the complexity of a parametrized test.
+
+        /// Once all instances of the test have run, the time per iteration
+        /// of each instance is fitted against O(1), O(log n), O(n),
+        /// O(n log n), O(n^2) and the given function of the problem size,
+        /// and the best fit is reported to the outputters. Instances without
+        /// a numeric value of the parameter are left out of the fit.
+        ///
+        /// @param fixtureName Name of the fixture.
+        /// @param testName Name of the test.
+        /// @param parameter Name of the parameter that describes the problem
+        /// size.
+        /// @param function Function of the problem size to fit in addition
+        /// to the standard orders, or NULL.
+        /// @param functionName Name of the function.
+        /// @returns true.
+        static bool SetTestComplexity(const char* fixtureName,
+                                      const char* testName,
+                                      const char* parameter,
+                                      ComplexityFunction function = NULL,
+                                      const char* functionName = "f")
+        {
+            Instance()._testComplexities[std::string(fixtureName) + "." +
+                                         testName] =
+                Complexity(parameter, function, functionName);
+            return true;
+        }
+
+
+        /// Apply a pattern filter to the tests.
+
+        /// --gtest_filter-compatible pattern:
+        ///
+        /// https://code.google.com/p/googletest/wiki/AdvancedGuide
+        ///
+        /// @param pattern Filter pattern compatible with gtest.
+        static void ApplyPatternFilter(const char* pattern)
+        {
+            Benchmarker& instance = Instance();
+
+            // Iterate across all tests and test them against the pattern.
+            std::size_t index = 0;
+            while (index < instance._tests.size())
+            {
+                TestDescriptor* desc = instance._tests[index];
+
+                if (!PatternMatches(pattern, desc->CanonicalName))
+                {
+                    instance._tests.erase(
+                        instance._tests.begin() +
+                        std::vector<TestDescriptor*>::difference_type(index)
+                    );
+                    delete desc;
+                }
+                else
+                    ++index;
+            }
+        }
+
+
+        /// Run all benchmarking tests.
+        static void RunAllTests()
+        {
+            ConsoleOutputter defaultOutputter;
+            std::vector<Outputter*> defaultOutputters;
+            defaultOutputters.push_back(&defaultOutputter);
+
+            Benchmarker& instance = Instance();
+
+            RunTests("*",
+                     (instance._outputters.empty() ?
+                      defaultOutputters :
+                      instance._outputters));
+        }
+
+
+        /// Run the benchmarking tests matching a pattern filter.
+
+        /// Unlike @ref ApplyPatternFilter, the tests that do not match are
+        /// kept, so that different tests can be run one after another.
+        ///
+        /// @param pattern Filter pattern compatible with gtest.
+        /// @param selectedOutputters Outputters to report to instead of the
+        /// added outputters.
+        static void RunTests(const char* pattern,
+                             const std::vector<Outputter*>& selectedOutputters)
+        {
+            Benchmarker& instance = Instance();
+            std::vector<Outputter*> outputters(selectedOutputters);
+
+            // Get the tests for execution.
+            std::vector<TestDescriptor*> tests;
+
+            for (std::size_t index = 0; index < instance._tests.size(); ++index)
+                if (PatternMatches(pattern,
+                                   instance._tests[index]->CanonicalName))
+                    tests.push_back(instance._tests[index]);
+
+            const std::size_t totalCount = tests.size();
+            std::size_t disabledCount = 0;
+
+            std::vector<TestDescriptor*>::const_iterator testsIt =
+                tests.begin();
+
+            while (testsIt != tests.end())
+            {
+                if ((*testsIt)->IsDisabled)
+                    ++disabledCount;
+                ++testsIt;
+            }
+
+            const std::size_t enabledCount = totalCount - disabledCount;
+
+            instance._regressions = 0;
+            instance._failures = 0;
+
+            // Complexity fits in progress.
+            std::map<std::string, ComplexityFit> fits;
+
+            // The calibration model is determined once the first test is
+            // about to run.
+            CalibrationModel* calibrationModel = NULL;
+
+            // Smallest meaningful latency of open-loop sweeps, determined
+            // once the first sweep needs it.
+            double latencyFloor = 0.0;
+
+            // Start running isolated tests in parallel. Their results are
+            // collected in order as the tests are reported.
+            ParallelRunner* parallelRunner = NULL;
+            std::size_t jobIndex = 0;
+
+            if ((instance._isolate) && (instance._jobs > 1))
+            {
+                std::vector<ParallelJob> jobs;
+
+                for (std::size_t testIndex = 0;
+                     testIndex < tests.size();
+                     ++testIndex)
+                {
+                    const TestDescriptor* descriptor = tests[testIndex];
+
+                    if ((descriptor->IsDisabled) ||
+                        (!descriptor->Error.empty()))
+                        continue;
+
+                    const std::vector<double> rates =
+                        instance.GetRates(*descriptor);
+
+                    for (std::size_t rateIndex = 0;
+                         rateIndex < rates.size();
+                         ++rateIndex)
+                    {
+                        const TestParametersDescriptor parameters =
+                            GetRateParameters(*descriptor,
+                                              rates,
+                                              rates[rateIndex]);
+
+                        jobs.push_back(ParallelJob(
+                            descriptor,
+                            parameters,
+                            rates[rateIndex],
+                            (instance._baseline ?
+                             instance._baseline->Duration(
+                                 Baseline::CanonicalName(
+                                     descriptor->FixtureName,
+                                     descriptor->TestName,
+                                     parameters
+                                 )
+                             ) :
+                             0.0)
+                        ));
+                    }
+                }
+
+                if (!jobs.empty())
+                {
+                    calibrationModel =
+                        new CalibrationModel(GetCachedCalibrationModel());
+                    parallelRunner =
+                        new ParallelRunner(jobs,
+                                           *calibrationModel,
+                                           instance._jobs,
+                                           instance._jobCpus,
+                                           instance._isolationTimeout);
+                }
+            }
+
+            // Begin output.
+            for (std::size_t outputterIndex = 0;
+                 outputterIndex < outputters.size();
+                 outputterIndex++)
+            {
+                outputters[outputterIndex]->Begin(enabledCount, disabledCount);
+
+                if (!instance._metadata.empty())
+                    outputters[outputterIndex]->Metadata(instance._metadata);
+            }
+
+            // Run through all the tests in ascending order.
+            std::size_t index = 0;
+
+            while (index < tests.size())
+            {
+                // Get the test descriptor.
+                TestDescriptor* descriptor = tests[index++];
+
+                // Check if test is not disabled.
+                if (descriptor->IsDisabled)
+                {
+                    for (std::size_t outputterIndex = 0;
+                         outputterIndex < outputters.size();
+                         outputterIndex++)
+                        outputters[outputterIndex]->SkipDisabledTest(
+                            descriptor->FixtureName,
+                            descriptor->TestName,
+                            descriptor->Parameters,
+                            descriptor->Runs,
+                            descriptor->Iterations
+                        );
+
+                    continue;
+                }
+
+                // Report a test that could not be registered as failed.
+                // Failures are reported within a begun test like the
+                // failures of isolated tests.
+                if (!descriptor->Error.empty())
+                {
+                    ++instance._failures;
+
+                    for (std::size_t outputterIndex = 0;
+                         outputterIndex < outputters.size();
+                         outputterIndex++)
+                    {
+                        outputters[outputterIndex]->BeginTest(
+                            descriptor->FixtureName,
+                            descriptor->TestName,
+                            descriptor->Parameters,
+                            descriptor->Runs,
+                            descriptor->Iterations
+                        );
+                        outputters[outputterIndex]->FailTest(
+                            descriptor->FixtureName,
+                            descriptor->TestName,
+                            descriptor->Parameters,
+                            descriptor->Error
+                        );
+                    }
+
+                    continue;
+                }
+
+                // Calibrate the tests.
+                if (!calibrationModel)
+                    calibrationModel =
+                        new CalibrationModel(GetCachedCalibrationModel());
+
+                // Determine the offered loads.
+                const std::vector<double> rates =
+                    instance.GetRates(*descriptor);
+
+                double baselineLatency = 0.0;
+                double saturationRate = 0.0;
+
+                // Instances of a test with a problem size are fitted in
+                // groups with equal values of the other parameters.
+                std::map<std::string, Complexity>::const_iterator complexity =
+                    instance._testComplexities.find(descriptor->CanonicalName);
+                std::string complexityGroup;
+
+                if (complexity != instance._testComplexities.end())
+                    complexityGroup = ComplexityGroup(
+                        *descriptor,
+                        complexity->second.Parameter
+                    );
+
+                std::size_t rateIndex = 0;
+
+                for (; rateIndex < rates.size(); ++rateIndex)
+                {
+                    const double rate = rates[rateIndex];
+                    const TestParametersDescriptor parameters =
+                        GetRateParameters(*descriptor, rates, rate);
+
+                    // Perform the runs, in a child process if isolated.
+                    std::string failure;
+                    TestResult testResult =
+                        (parallelRunner ?
+                         parallelRunner->Collect(jobIndex + rateIndex,
+                                                 outputters,
+                                                 failure) :
+                         instance._isolate ?
+                         RunIsolatedTestRuns(*descriptor,
+                                             parameters,
+                                             *calibrationModel,
+                                             outputters,
+                                             rate,
+                                             failure) :
+                         RunTestRuns(*descriptor,
+                                     parameters,
+                                     *calibrationModel,
+                                     outputters,
+                                     rate));
+
+                    // Report a failure and leave the test, including the
+                    // remaining rates of a sweep.
+                    if (!failure.empty())
+                    {
+                        ++instance._failures;
+
+                        for (std::size_t outputterIndex = 0;
+                             outputterIndex < outputters.size();
+                             outputterIndex++)
+                            outputters[outputterIndex]->FailTest(
+                                descriptor->FixtureName,
+                                descriptor->TestName,
+                                parameters,
+                                failure
+                            );
+
+                        break;
+                    }
+
+                    testResult.EstimateConfidenceIntervals(
+                        instance._bootstrap
+                    );
+
+                    // Stop a sweep once the test is saturated.
+                    bool saturated = false;
+
+                    if (rates.size() > 1)
+                    {
+                        const double latency =
+                            double(testResult.LatencyHistogram()
+                                   .ValueAtPercentile(99.0));
+
+                        if (!rateIndex)
+                            baselineLatency = latency;
+
+                        // Latencies below the resolution of the clock or
+                        // the overhead of timing an iteration are noise, so
+                        // a baseline of 0 does not make every later rate
+                        // saturated.
+                        if (!latencyFloor)
+                            latencyFloor = double(std::max(
+                                MeasureClockResolution(),
+                                calibrationModel->SampleOverhead
+                            ));
+
+                        saturated = testResult.IsBeyondKnee(baselineLatency,
+                                                            latencyFloor);
+
+                        if (saturated)
+                            testResult.SetSaturationRate(
+                                saturationRate > 0.0 ?
+                                saturationRate :
+                                testResult.AchievedRate()
+                            );
+                        else
+                            saturationRate =
+                                std::max(saturationRate,
+                                         testResult.AchievedRate());
+                    }
+
+                    // Compare with the baseline.
+                    BaselineComparison comparison;
+
+                    if ((instance._baseline) &&
+                        (instance._baseline->Compare(
+                            Baseline::CanonicalName(descriptor->FixtureName,
+                                                    descriptor->TestName,
+                                                    parameters),
+                            testResult,
+                            comparison
+                        )))
+                    {
+                        testResult.SetBaselineComparison(comparison);
+
+                        if ((comparison.Change == BaselineRegressed) &&
+                            (comparison.RelativeChange >
+                             instance._regressionThreshold))
+                            ++instance._regressions;
+                    }
+
+                    // Describe the end of the run.
+                    for (std::size_t outputterIndex = 0;
+                         outputterIndex < outputters.size();
+                         outputterIndex++)
+                        outputters[outputterIndex]->EndTest(
+                            descriptor->FixtureName,
+                            descriptor->TestName,
+                            parameters,
+                            testResult
+                        );
+
+                    // Collect the problem size and time per iteration for
+                    // the complexity fit. Load sweeps are left out.
+                    double size;
+
+                    if ((complexity != instance._testComplexities.end()) &&
+                        (rates.size() == 1) &&
+                        (ComplexityFit::ProblemSize(
+                            parameters,
+                            complexity->second.Parameter,
+                            size
+                        )))
+                    {
+                        std::map<std::string, ComplexityFit>::iterator fit =
+                            fits.find(complexityGroup);
+
+                        if (fit == fits.end())
+                            fit = fits.insert(std::make_pair(
+                                complexityGroup,
+                                ComplexityFit(
+                                    complexity->second.Parameter,
+                                    ComplexityFit::OtherParameters(
+                                        descriptor->Parameters,
+                                        complexity->second.Parameter
+                                    )
+                                )
+                            )).first;
+
+                        fit->second.AddPoint(
+                            size,
+                            (testResult.IsLinear() ?
+                             testResult.IterationTimeRegression().Slope :
+                             testResult.IterationTimeMedian())
+                        );
+                    }
+
+                    if (saturated)
+                        break;
+                }
+
+                // Cancel the parallel runs of the offered loads left out.
+                if (parallelRunner)
+                {
+                    while (++rateIndex < rates.size())
+                        parallelRunner->Cancel(jobIndex + rateIndex);
+
+                    jobIndex += rates.size();
+                }
+
+                // Fit the complexity once the last instance of the group
+                // has run.
+                if (complexity == instance._testComplexities.end())
+                    continue;
+
+                std::map<std::string, ComplexityFit>::iterator fit =
+                    fits.find(complexityGroup);
+
+                if ((fit != fits.end()) &&
+                    (!HasPendingInstance(tests,
+                                         index,
+                                         complexityGroup,
+                                         complexity->second.Parameter)))
+                {
+                    if (fit->second.Fit(complexity->second.Function,
+                                        complexity->second.FunctionName))
+                        for (std::size_t outputterIndex = 0;
+                             outputterIndex < outputters.size();
+                             outputterIndex++)
+                            outputters[outputterIndex]->Complexity(
+                                descriptor->FixtureName,
+                                descriptor->TestName,
+                                fit->second
+                            );
+
+                    fits.erase(fit);
+                }
+            }
+
+            // End output.
+            for (std::size_t outputterIndex = 0;
+                 outputterIndex < outputters.size();
+                 outputterIndex++)
+                outputters[outputterIndex]->End(enabledCount,
+                                                disabledCount);
+
+            delete parallelRunner;
+            delete calibrationModel;
+        }
+
+
+        /// List tests.
+        static std::vector<const TestDescriptor*> ListTests()
+        {
+            std::vector<const TestDescriptor*> tests;
+            Benchmarker& instance = Instance();
+
+            std::size_t index = 0;
+            while (index < instance._tests.size())
+                tests.push_back(instance._tests[index++]);
+
+            return tests;
+        }
+
+
+        /// Shuffle tests.
+
+        /// Randomly shuffles the order of tests.
+        static void ShuffleTests()
+        {
+            Benchmarker& instance = Instance();
+#if __cplusplus > 201100L
+            std::random_device rd;
+            std::mt19937 g(rd());
+            std::shuffle(instance._tests.begin(),
+                         instance._tests.end(),
+                         g);
+#else
+            std::random_shuffle(instance._tests.begin(),
+                                instance._tests.end());
+#endif
+        }
+    private:
+        /// Calibration model.
+
+        /// Describes a linear calibration model for test runs.
+        struct CalibrationModel
+        {
+        public:
+            CalibrationModel(std::size_t scale,
+                             uint64_t slope,
+                             uint64_t yIntercept,
+                             uint64_t pauseOverhead,
+                             uint64_t sampleOverhead)
+                :   Scale(scale),
+                    Slope(slope),
+                    YIntercept(yIntercept),
+                    PauseOverhead(pauseOverhead),
+                    SampleOverhead(sampleOverhead)
+            {
+
+            }
+
+            
+            /// Scale.
+
+            /// Number of iterations per slope unit.
+            const std::size_t Scale;
+
+
+            /// Slope.
+            const uint64_t Slope;
+
+
+            /// Y-intercept;
+            const uint64_t YIntercept;
+
+
+            /// Pause overhead.
+
+            /// Overhead of a pair of calls to @ref Test::PauseTiming and
+            /// @ref Test::ResumeTiming not covered by the paused interval.
+            const uint64_t PauseOverhead;
+
+
+            /// Sample overhead.
+
+            /// Overhead of timing a single iteration of an empty test body
+            /// with @ref Test::RunSampled.
+            const uint64_t SampleOverhead;
+
+
+            /// Get calibration value for a run.
+            int64_t GetCalibration(std::size_t iterations) const
+            {
+                return YIntercept + (iterations * Slope) / Scale;
+            }
+        };
+
+        
+        /// Calibration test.
+
+        /// Empty test with an iteration loop of the same shape as the one
+        /// generated by the benchmark macros.
+        class CalibrationTest
+            :   public Test
+        {
+        protected:
+            virtual void TestBody()
+            {
+
+            }
+
+
+            virtual void RunIterations(std::size_t iterations)
+            {
+                while (iterations--)
+                    this->CalibrationTest::TestBody();
+            }
+        };
+
+
+        /// Pause calibration test.
+
+        /// Test pausing and immediately resuming timing in each iteration.
+        class PauseCalibrationTest
+            :   public Test
+        {
+        protected:
+            virtual void TestBody()
+            {
+                PauseTiming();
+                ResumeTiming();
+            }
+
+
+            virtual void RunIterations(std::size_t iterations)
+            {
+                while (iterations--)
+                    this->PauseCalibrationTest::TestBody();
+            }
+        };
+
+
+        /// Warm-up settings.
+        struct WarmUp
+        {
+        public:
+            WarmUp(std::size_t runs = 0, uint64_t duration = 0)
+                :   Runs(runs),
+                    Duration(duration)
+            {
+
+            }
+
+
+            /// Minimum number of warm-up runs.
+            std::size_t Runs;
+
+
+            /// Minimum duration of the warm-up in nanoseconds.
+            uint64_t Duration;
+        };
+
+
+        /// Complexity settings.
+        struct Complexity
+        {
+        public:
+            Complexity(const std::string& parameter = std::string(),
+                       ComplexityFunction function = NULL,
+                       const std::string& functionName = std::string())
+                :   Parameter(parameter),
+                    Function(function),
+                    FunctionName(functionName)
+            {
+
+            }
+
+
+            /// Name of the problem size parameter.
+            std::string Parameter;
+
+
+            /// User-supplied function of the problem size, or NULL.
+            ComplexityFunction Function;
+
+
+            /// Name of the user-supplied function.
+            std::string FunctionName;
+        };
+
+
+        /// Runs of a test in a child process.
+        struct IsolatedRuns
+        {
+        public:
+            IsolatedRuns(uint64_t timeout)
+                :   Process(timeout),
+                    Result(std::vector<uint64_t>(), 0),
+                    Began(false),
+                    Runs(0),
+                    Iterations(0),
+                    Received(false)
+            {
+
+            }
+
+
+            /// Child process performing the runs.
+            IsolatedProcess Process;
+
+
+            /// Result received from the child.
+            TestResult Result;
+
+
+            /// Whether the child has begun the runs.
+            bool Began;
+
+
+            /// Number of runs the child has begun.
+            std::size_t Runs;
+
+
+            /// Number of iterations per run the child has begun.
+            std::size_t Iterations;
+
+
+            /// Whether the result has been received.
+            bool Received;
+
+
+            /// Error reported by the child or found in its messages.
+            std::string Error;
+
+
+            /// Description of the failure if the runs did not produce a
+            /// result.
+            std::string Failure;
+        private:
+            IsolatedRuns(const IsolatedRuns&);
+            IsolatedRuns& operator =(const IsolatedRuns&);
+        };
+
+
+        /// Runs of a test to be performed in parallel.
+        struct ParallelJob
+        {
+        public:
+            ParallelJob(const TestDescriptor* descriptor,
+                        const TestParametersDescriptor& parameters,
+                        double rate,
+                        double expectedDuration)
+                :   Descriptor(descriptor),
+                    Parameters(parameters),
+                    Rate(rate),
+                    ExpectedDuration(expectedDuration)
+            {
+
+            }
+
+
+            /// Test descriptor.
+            const TestDescriptor* Descriptor;
+
+
+            /// Parameters to describe the test with.
+            TestParametersDescriptor Parameters;
+
+
+            /// Offered load, or 0 to run the test closed-loop.
+            double Rate;
+
+
+            /// Expected duration in nanoseconds, or 0 if unknown.
+            double ExpectedDuration;
+        };
+
+
+        /// Runner of isolated tests in parallel.
+
+        /// Keeps up to a given number of child processes busy with the
+        /// jobs, while the results are collected in the order of the jobs.
+        class ParallelRunner
+        {
+        public:
+            /// Initialize the runner.
+
+            /// @param jobs Jobs in the order their results are collected in.
+            /// @param calibrationModel Calibration model. Must outlive the
+            /// runner.
+            /// @param workers Maximum number of jobs to run at the same time.
+            /// @param cpus Processors to pin the jobs to, one per worker, or
+            /// empty to not pin them.
+            /// @param timeout Timeout of each job in nanoseconds, or 0 for
+            /// no limit.
+            ParallelRunner(const std::vector<ParallelJob>& jobs,
+                           const CalibrationModel& calibrationModel,
+                           std::size_t workers,
+                           const std::vector<int>& cpus,
+                           uint64_t timeout)
+                :   _jobs(jobs),
+                    _calibrationModel(calibrationModel),
+                    _timeout(timeout),
+                    _states(jobs.size(), JobPending),
+                    _runs(jobs.size(), static_cast<IsolatedRuns*>(NULL)),
+                    _cpus(cpus),
+                    _workers(workers, jobs.size()),
+                    _next(0),
+                    _running(0),
+                    _exclusive(false)
+            {
+                for (std::size_t job = 0; job < _jobs.size(); ++job)
+                    _order.push_back(job);
+
+                std::stable_sort(_order.begin(),
+                                 _order.end(),
+                                 JobOrder(_jobs));
+            }
+
+
+            /// Kill the jobs still running.
+            ~ParallelRunner()
+            {
+                for (std::size_t job = 0; job < _runs.size(); ++job)
+                    delete _runs[job];
+            }
+
+
+            /// Collect the result of a job.
+
+            /// Waits for the job to finish, keeping the workers busy with
+            /// the other jobs in the meantime, and describes the beginning
+            /// of its runs to the outputters.
+            ///
+            /// @param job Index of the job.
+            /// @param outputters Outputters.
+            /// @param failure Description of the failure if the job did not
+            /// produce a result.
+            /// @returns the result of the job, or an empty result on failure.
+            TestResult Collect(std::size_t job,
+                               std::vector<Outputter*>& outputters,
+                               std::string& failure)
+            {
+                while (_states[job] != JobDone)
+                    Progress();
+
+                const TestDescriptor& descriptor = *_jobs[job].Descriptor;
+                IsolatedRuns& runs = *_runs[job];
+
+                for (std::size_t outputterIndex = 0;
+                     outputterIndex < outputters.size();
+                     outputterIndex++)
+                    outputters[outputterIndex]->BeginTest(
+                        descriptor.FixtureName,
+                        descriptor.TestName,
+                        _jobs[job].Parameters,
+                        (runs.Began ? runs.Runs : descriptor.Runs),
+                        (runs.Began ? runs.Iterations : descriptor.Iterations)
+                    );
+
+                failure = runs.Failure;
+                const TestResult result = runs.Result;
+
+                delete _runs[job];
+                _runs[job] = NULL;
+                _states[job] = JobCollected;
+
+                return result;
+            }
+
+
+            /// Cancel a job whose result is not needed.
+
+            /// Kills the job if it is running.
+            void Cancel(std::size_t job)
+            {
+                if (_states[job] == JobRunning)
+                    Release(job);
+
+                delete _runs[job];
+                _runs[job] = NULL;
+                _states[job] = JobCancelled;
+            }
+        private:
+            /// State of a job.
+            enum JobState
+            {
+                JobPending,
+                JobRunning,
+                JobDone,
+                JobCollected,
+                JobCancelled
+            };
+
+
+            /// Order in which to start the jobs.
+
+            /// Multi-threaded jobs go last, and jobs with an unknown
+            /// duration before the others, which go in decreasing order of
+            /// their expected duration.
+            struct JobOrder
+            {
+            public:
+                JobOrder(const std::vector<ParallelJob>& jobs)
+                    :   _jobs(&jobs)
+                {
+
+                }
+
+
+                bool operator ()(std::size_t a, std::size_t b) const
+                {
+                    const ParallelJob& jobA = (*_jobs)[a];
+                    const ParallelJob& jobB = (*_jobs)[b];
+
+                    if ((!jobA.Descriptor->Threads) !=
+                        (!jobB.Descriptor->Threads))
+                        return (!jobA.Descriptor->Threads);
+
+                    if ((jobA.ExpectedDuration > 0.0) !=
+                        (jobB.ExpectedDuration > 0.0))
+                        return (jobA.ExpectedDuration <= 0.0);
+
+                    return (jobA.ExpectedDuration > jobB.ExpectedDuration);
+                }
+            private:
+                const std::vector<ParallelJob>* _jobs;
+            };
+
+
+            /// Start jobs on idle workers, handle the messages of the
+            /// running jobs and wait for more if nothing happened.
+            void Progress()
+            {
+                Start();
+
+                bool progressed = false;
+                std::vector<IsolatedProcess*> processes;
+
+                for (std::size_t worker = 0;
+                     worker < _workers.size();
+                     ++worker)
+                {
+                    const std::size_t job = _workers[worker];
+
+                    if (job == _jobs.size())
+                        continue;
+
+                    IsolatedRuns& runs = *_runs[job];
+                    IsolationMessage tag;
+                    std::string payload;
+
+                    while (runs.Process.Receive(tag, payload, false))
+                    {
+                        ReceiveIsolatedMessage(runs, tag, payload);
+                        progressed = true;
+                    }
+
+                    if (runs.Process.Finished())
+                    {
+                        FinishIsolatedTestRuns(runs);
+                        Release(job);
+                        _states[job] = JobDone;
+                        progressed = true;
+                    }
+                    else
+                        processes.push_back(&runs.Process);
+                }
+
+                if (!progressed)
+                    IsolatedProcess::WaitForAny(processes);
+            }
+
+
+            /// Start pending jobs on the idle workers.
+
+            /// A multi-threaded job is only started once all other jobs
+            /// have finished, and no other job is started while it runs.
+            void Start()
+            {
+                while ((_next < _order.size()) && (!_exclusive))
+                {
+                    const std::size_t job = _order[_next];
+
+                    if (_states[job] != JobPending)
+                    {
+                        ++_next;
+                        continue;
+                    }
+
+                    const bool exclusive =
+                        (_jobs[job].Descriptor->Threads > 0);
+
+                    if ((exclusive) && (_running))
+                        return;
+
+                    const std::size_t worker =
+                        std::size_t(std::find(_workers.begin(),
+                                              _workers.end(),
+                                              _jobs.size()) -
+                                    _workers.begin());
+
+                    if (worker == _workers.size())
+                        return;
+
+                    ++_next;
+
+                    _runs[job] = new IsolatedRuns(_timeout);
+                    _states[job] = JobRunning;
+                    _workers[worker] = job;
+                    _exclusive = exclusive;
+                    ++_running;
+
+                    StartIsolatedTestRuns(
+                        *_runs[job],
+                        *_jobs[job].Descriptor,
+                        _jobs[job].Parameters,
+                        _calibrationModel,
+                        _jobs[job].Rate,
+                        (((exclusive) || (worker >= _cpus.size())) ?
+                         -1 :
+                         _cpus[worker])
+                    );
+
+                    // A job that could not be started is done.
+                    if (!_runs[job]->Failure.empty())
+                    {
+                        Release(job);
+                        _states[job] = JobDone;
+                    }
+                }
+            }
+
+
+            /// Free the worker of a running job.
+            void Release(std::size_t job)
+            {
+                std::replace(_workers.begin(),
+                             _workers.end(),
+                             job,
+                             _jobs.size());
+                _exclusive = false;
+                --_running;
+            }
+
+
+            std::vector<ParallelJob> _jobs;
+            const CalibrationModel& _calibrationModel;
+            uint64_t _timeout;
+            std::vector<JobState> _states;
+            std::vector<IsolatedRuns*> _runs;
+            std::vector<int> _cpus;
+            std::vector<std::size_t> _workers; ///< Job of each worker.
+            std::vector<std::size_t> _order; ///< Jobs in starting order.
+            std::size_t _next; ///< Next job to start in the order.
+            std::size_t _running;
+            bool _exclusive; ///< Whether a multi-threaded job is running.
+        };
+
+
+        /// Private constructor.
+        Benchmarker()
+            :   _countersEnabled(false),
+                _minimumRunTime(0),
+                _adaptiveRuns(false),
+                _adaptiveTarget(0.0),
+                _adaptiveStatistic(StatisticMedian),
+                _adaptiveMinimumRuns(0),
+                _adaptiveMaximumRuns(0),
+                _adaptiveTimeBudget(0),
+                _calibrationCachePath(),
+                _recalibrate(false),
+                _histogramSignificantDigits(HAYAI_HISTOGRAM_SIGNIFICANT_DIGITS),
+                _sampleInterval(0),
+                _baseline(NULL),
+                _regressionThreshold(0.0),
+                _regressions(0),
+                _bootstrap(0),
+                _linearSampling(false),
+                _isolate(false),
+                _isolationTimeout(0),
+                _failures(0),
+                _jobs(1),
+                _threadPlacement(ThreadPlacementNone),
+                _lockMemory(false)
+        {
+
+        }
+
+
+        /// Private destructor.
+        ~Benchmarker()
+        {
+            // Release all test descriptors.
+            std::size_t index = _tests.size();
+            while (index--)
+                delete _tests[index];
+        }
+
+
+        /// Register the tests of the empty type list.
+        template<template<typename> class TestTemplate>
+        static TestDescriptor* RegisterTypes(Types<>,
+                                             const char*,
+                                             const char*,
+                                             std::size_t,
+                                             std::size_t,
+                                             const TestParametersDescriptor&)
+        {
+            return NULL;
+        }
+
+
+        /// Register a test for each type of a type list.
+        template<template<typename> class TestTemplate, class TypeList>
+        static TestDescriptor* RegisterTypes(
+            TypeList,
+            const char* fixtureName,
+            const char* testName,
+            std::size_t runs,
+            std::size_t iterations,
+            const TestParametersDescriptor& parameters
+        )
+        {
+            typedef typename TypeList::Head Type;
+
+            TestParametersDescriptor typed = TypeParameter<Type>();
+            const std::vector<TestParameterDescriptor>& descs =
+                parameters.Parameters();
+
+            for (std::size_t i = 0; i < descs.size(); ++i)
+                typed.AddParameter(descs[i].Declaration, descs[i].Value);
+
+            TestDescriptor* first = RegisterTest(
+                fixtureName,
+                testName,
+                runs,
+                iterations,
+                new TestFactoryDefault< TestTemplate<Type> >(),
+                typed
+            );
+
+            RegisterTypes<TestTemplate>(typename TypeList::Tail(),
+                                        fixtureName,
+                                        testName,
+                                        runs,
+                                        iterations,
+                                        parameters);
+
+            return first;
+        }
+
+
+        /// Register the generated tests of the empty type list.
+        template<template<typename> class TestTemplate>
+        static TestDescriptor* RegisterGeneratedTypes(Types<>,
+                                                      const char*,
+                                                      const char*,
+                                                      std::size_t,
+                                                      std::size_t,
+                                                      const char*,
+                                                      const ParameterGrid&)
+        {
+            return NULL;
+        }
+
+
+        /// Register the tests of a grid for each type of a type list.
+        template<template<typename> class TestTemplate, class TypeList>
+        static TestDescriptor* RegisterGeneratedTypes(
+            TypeList,
+            const char* fixtureName,
+            const char* testName,
+            std::size_t runs,
+            std::size_t iterations,
+            const char* argumentsDeclaration,
+            const ParameterGrid& grid
+        )
+        {
+            typedef typename TypeList::Head Type;
+
+            TestDescriptor* first =
+                RegisterGeneratedTests< TestTemplate<Type> >(
+                    fixtureName,
+                    testName,
+                    runs,
+                    iterations,
+                    argumentsDeclaration,
+                    grid,
+                    TypeParameter<Type>()
+                );
+
+            TestDescriptor* rest = RegisterGeneratedTypes<TestTemplate>(
+                typename TypeList::Tail(),
+                fixtureName,
+                testName,
+                runs,
+                iterations,
+                argumentsDeclaration,
+                grid
+            );
+
+            return (first ? first : rest);
+        }
+
+
+        /// Parameters describing the type of a type-parametrized test.
+        template<class Type>
+        static TestParametersDescriptor TypeParameter()
+        {
+            TestParametersDescriptor parameters;
+            parameters.AddParameter("typename TypeParam",
+                                    TypeName<Type>::Name());
+            return parameters;
+        }
+
+
+        /// Complexity group of a test.
+
+        /// @param descriptor Test descriptor.
+        /// @param parameter Name of the problem size parameter.
+        /// @returns the canonical name of the test with all parameters but
+        /// the problem size.
+        static std::string ComplexityGroup(const TestDescriptor& descriptor,
+                                           const std::string& parameter)
+        {
+            return Baseline::CanonicalName(
+                descriptor.FixtureName,
+                descriptor.TestName,
+                ComplexityFit::OtherParameters(descriptor.Parameters,
+                                               parameter)
+            );
+        }
+
+
+        /// Test if an instance of a complexity group remains to be run.
+
+        /// @param tests Tests to be executed.
+        /// @param index Index of the next test to be executed.
+        /// @param group Complexity group.
+        /// @param parameter Name of the problem size parameter.
+        static bool HasPendingInstance(
+            const std::vector<TestDescriptor*>& tests,
+            std::size_t index,
+            const std::string& group,
+            const std::string& parameter
+        )
+        {
+            while (index < tests.size())
+            {
+                const TestDescriptor* descriptor = tests[index++];
+
+                if ((!descriptor->IsDisabled) &&
+                    (ComplexityGroup(*descriptor, parameter) == group))
+                    return true;
+            }
+
+            return false;
+        }
+
+
+        /// Get the warm-up settings for a test.
+        WarmUp GetWarmUp(const TestDescriptor& descriptor) const
+        {
+            std::map<std::string, WarmUp>::const_iterator it =
+                _testWarmUps.find(descriptor.CanonicalName);
+
+            return (it != _testWarmUps.end() ? it->second : _warmUp);
+        }
+
+
+        /// Get the processors to pin the threads of a test to.
+
+        /// @param threads Number of threads.
+        /// @returns the processor of each thread, or an empty vector if the
+        /// threads are not to be pinned.
+        const std::vector<int>& GetThreadCpus(std::size_t threads)
+        {
+            std::map<std::size_t, std::vector<int> >::iterator it =
+                _threadCpus.find(threads);
+
+            if (it == _threadCpus.end())
+                it = _threadCpus.insert(std::make_pair(
+                    threads,
+                    _threadTopology.Place(_threadPlacement, threads)
+                )).first;
+
+            return it->second;
+        }
+
+
+        /// Get the offered loads to run a test at.
+
+        /// Closed-loop and multi-threaded tests are run once, at an offered
+        /// load of 0.
+        std::vector<double> GetRates(const TestDescriptor& descriptor) const
+        {
+            if ((_openLoopRates.empty()) || (descriptor.Threads))
+                return std::vector<double>(1, 0.0);
+
+            return _openLoopRates;
+        }
+
+
+        /// Get the parameters to describe a test at an offered load with.
+
+        /// The offered load of a sweep is described as a parameter.
+        ///
+        /// @param descriptor Test descriptor.
+        /// @param rates Offered loads the test is run at.
+        /// @param rate Offered load.
+        static TestParametersDescriptor GetRateParameters(
+            const TestDescriptor& descriptor,
+            const std::vector<double>& rates,
+            double rate
+        )
+        {
+            TestParametersDescriptor parameters = descriptor.Parameters;
+
+            if (rates.size() > 1)
+            {
+                std::stringstream value;
+                value << std::fixed << std::setprecision(0) << rate;
+                parameters.AddParameter("double rate", value.str());
+            }
+
+            return parameters;
+        }
+
+
+        /// Measure the resolution of the clock.
+
+        /// @returns the smallest nonzero duration between consecutive time
+        /// points over a few attempts, in nanoseconds.
+        static uint64_t MeasureClockResolution()
+        {
+            uint64_t resolution = 0;
+
+            for (std::size_t attempt = 0; attempt < 10; ++attempt)
+            {
+                const Clock::TimePoint startTime = Clock::Now();
+                uint64_t duration;
+
+                do
+                    duration = Clock::Duration(startTime, Clock::Now());
+                while (!duration);
+
+                if ((!resolution) || (duration < resolution))
+                    resolution = duration;
+            }
+
+            return resolution;
+        }
+
+
+        /// Test if a pattern filter matches a test name.
+
+        /// @param pattern Filter pattern compatible with gtest, ie. positive
+        /// patterns optionally followed by '-' and negative patterns.
+        /// @param name Canonical name of the test.
+        static bool PatternMatches(const char* pattern, const std::string& name)
+        {
+            // Split the filter at '-' if it exists.
+            const char* const dash = strchr(pattern, '-');
+
+            std::string positive;
+            std::string negative;
+
+            if (dash == NULL)
+                positive = pattern;
+            else
+            {
+                positive = std::string(pattern, dash);
+                negative = std::string(dash + 1);
+                if (positive.empty())
+                    positive = "*";
+            }
+
+            return ((FilterMatchesString(positive.c_str(), name)) &&
+                    (!FilterMatchesString(negative.c_str(), name)));
+        }
+
+
+        /// Test if a filter matches a string.
+
+        /// Adapted from gtest. All rights reserved by original authors.
+        static bool FilterMatchesString(const char* filter,
+                                        const std::string& str)
+        {
+            const char *patternStart = filter;
+
+            while (true)
+            {
+                if (PatternMatchesString(patternStart, str.c_str()))
+                    return true;
+
+                // Finds the next pattern in the filter.
+                patternStart = strchr(patternStart, ':');
+
+                // Returns if no more pattern can be found.
+                if (!patternStart)
+                    return false;
+
+                // Skips the pattern separater (the ':' character).
+                patternStart++;
+            }
+        }
+
+
+        /// Test if pattern matches a string.
+
+        /// Adapted from gtest. All rights reserved by original authors.
+        static bool PatternMatchesString(const char* pattern, const char *str)
+        {
+            switch (*pattern)
+            {
+            case '\0':
+            case ':':
+                return (*str == '\0');
+            case '?':  // Matches any single character.
+                return ((*str != '\0') &&
+                        (PatternMatchesString(pattern + 1, str + 1)));
+            case '*':  // Matches any string (possibly empty) of characters.
+                return (((*str != '\0') &&
+                         (PatternMatchesString(pattern, str + 1))) ||
+                        (PatternMatchesString(pattern + 1, str)));
+            default:
+                return ((*pattern == *str) &&
+                        (PatternMatchesString(pattern + 1, str + 1)));
             }
         }
 
 
-        /// Run all benchmarking tests.
-        static void RunAllTests()
-        {
-            ConsoleOutputter defaultOutputter;
-            std::vector<Outputter*> defaultOutputters;
-            defaultOutputters.push_back(&defaultOutputter);
-
-            Benchmarker& instance = Instance();
-            std::vector<Outputter*>& outputters =
-                (instance._outputters.empty() ?
-                 defaultOutputters :
-                 instance._outputters);
-
-            // Get the tests for execution.
-            std::vector<TestDescriptor*> tests = instance.GetTests();
+        /// Run a test once.
 
-            const std::size_t totalCount = tests.size();
-            std::size_t disabledCount = 0;
+        /// Constructs a test instance, runs it on the number of threads of
+        /// the test and disposes of it.
+        ///
+        /// @param descriptor Test descriptor.
+        /// @param iterations Number of iterations per run.
+        /// @param pauseOverhead Overhead of pausing and resuming timing.
+        /// @param counters Optional open performance counter group.
+        /// @param threadTimes Optional vector to hold the time of each thread
+        /// of a multi-threaded test.
+        /// @param samples Optional vector to hold the time of individual
+        /// iterations of a single-threaded test.
+        /// @param sampleInterval Interval of the timed iterations if
+        /// @p samples is given.
+        /// @param sampleOverhead Overhead of timing a single iteration.
+        /// @param rate Offered load of a single-threaded open-loop run, in
+        /// which case @p samples holds the latency of every iteration, or 0
+        /// for a closed-loop run.
+        /// @param resourceUsage Optional probe to sample the resource usage
+        /// of the iterations with.
+        /// @returns the number of nanoseconds the run took.
+        static uint64_t RunTest(const TestDescriptor& descriptor,
+                                std::size_t iterations,
+                                uint64_t pauseOverhead,
+                                PerformanceCounterGroup* counters = NULL,
+                                std::vector<uint64_t>* threadTimes = NULL,
+                                std::vector<uint64_t>* samples = NULL,
+                                std::size_t sampleInterval = 1,
+                                uint64_t sampleOverhead = 0,
+                                double rate = 0.0,
+                                ResourceUsageProbe* resourceUsage = NULL)
+        {
+            // Construct a test instance.
+            Test* test = descriptor.Factory->CreateTest();
+            test->SetPauseOverhead(pauseOverhead);
+            test->SetResourceUsageProbe(resourceUsage);
 
-            std::vector<TestDescriptor*>::const_iterator testsIt =
-                tests.begin();
+            // Run the test.
+            uint64_t time;
 
-            while (testsIt != tests.end())
+            if (descriptor.Threads)
             {
-                if ((*testsIt)->IsDisabled)
-                    ++disabledCount;
-                ++testsIt;
+                std::vector<uint64_t> ignoredThreadTimes;
+                time = test->RunThreaded(iterations,
+                                         descriptor.Threads,
+                                         (threadTimes ?
+                                          *threadTimes :
+                                          ignoredThreadTimes),
+                                         Instance().GetThreadCpus(
+                                             descriptor.Threads
+                                         ));
             }
+            else if ((samples) && (rate > 0.0))
+                time = test->RunOpenLoop(iterations,
+                                         rate,
+                                         sampleOverhead,
+                                         *samples,
+                                         counters);
+            else if (samples)
+                time = test->RunSampled(iterations,
+                                        sampleInterval,
+                                        sampleOverhead,
+                                        *samples,
+                                        counters);
+            else
+                time = test->Run(iterations, counters);
 
-            const std::size_t enabledCount = totalCount - disabledCount;
+            // Dispose of the test instance.
+            delete test;
 
-            // Calibrate the tests.
-            const CalibrationModel calibrationModel = GetCalibrationModel();
+            return time;
+        }
 
-            // Begin output.
+
+        /// Perform the runs of a test.
+
+        /// Describes the beginning of the test to the outputters, performs
+        /// the warm-up and the runs, and summarizes the runs.
+        ///
+        /// @param descriptor Test descriptor.
+        /// @param parameters Parameters to describe the test with.
+        /// @param calibrationModel Calibration model.
+        /// @param outputters Outputters.
+        /// @param rate Offered load in iterations per second of an
+        /// open-loop test, or 0 to run the test closed-loop.
+        /// @returns the result of the test.
+        static TestResult RunTestRuns(
+            const TestDescriptor& descriptor,
+            const TestParametersDescriptor& parameters,
+            const CalibrationModel& calibrationModel,
+            std::vector<Outputter*>& outputters,
+            double rate
+        )
+        {
+            Benchmarker& instance = Instance();
+            const bool openLoop = ((rate > 0.0) && (!descriptor.Threads));
+
+            // Determine the number of iterations per run. Open-loop runs
+            // take a known time for a number of iterations.
+            std::size_t iterations = descriptor.Iterations;
+
+            if ((openLoop) &&
+                ((instance._minimumRunTime) ||
+                 (iterations == AutoIterations)))
+                iterations = std::max<std::size_t>(
+                    std::size_t(rate *
+                                double(instance._minimumRunTime ?
+                                       instance._minimumRunTime :
+                                       HAYAI_DEFAULT_MINIMUM_RUN_TIME) /
+                                1000000000.0),
+                    1
+                );
+            else if ((instance._minimumRunTime) ||
+                     (iterations == AutoIterations))
+                iterations = CalibrateIterations(
+                    descriptor,
+                    (instance._minimumRunTime ?
+                     instance._minimumRunTime :
+                     HAYAI_DEFAULT_MINIMUM_RUN_TIME)
+                );
+
+            // Determine the number of runs. With adaptive run counts,
+            // this is the upper bound.
+            const bool adaptive = instance._adaptiveRuns;
+            const std::size_t runs = (adaptive ?
+                                      instance._adaptiveMaximumRuns :
+                                      descriptor.Runs);
+
+            // Describe the beginning of the run.
             for (std::size_t outputterIndex = 0;
                  outputterIndex < outputters.size();
                  outputterIndex++)
-                outputters[outputterIndex]->Begin(enabledCount, disabledCount);
+                outputters[outputterIndex]->BeginTest(
+                    descriptor.FixtureName,
+                    descriptor.TestName,
+                    parameters,
+                    runs,
+                    iterations
+                );
+
+            // Perform the warm-up runs, whose results are discarded.
+            const WarmUp warmUp = instance.GetWarmUp(descriptor);
+            const Clock::TimePoint warmUpStartTime = Clock::Now();
+            std::size_t warmUpRuns = 0;
+
+            while ((warmUpRuns < warmUp.Runs) ||
+                   ((warmUp.Duration) &&
+                    (Clock::Duration(warmUpStartTime, Clock::Now()) <
+                     warmUp.Duration)))
+            {
+                RunTest(descriptor,
+                        iterations,
+                        calibrationModel.PauseOverhead);
+                ++warmUpRuns;
+            }
 
-            // Run through all the tests in ascending order.
-            std::size_t index = 0;
+            // Open the performance counters if requested. As counters
+            // only count the calling thread, they are not collected for
+            // multi-threaded tests.
+            PerformanceCounterGroup* counters = NULL;
+            std::vector<std::vector<uint64_t> > counterValues;
 
-            while (index < tests.size())
+            if ((instance._countersEnabled) && (!descriptor.Threads))
             {
-                // Get the test descriptor.
-                TestDescriptor* descriptor = tests[index++];
+                counters =
+                    new PerformanceCounterGroup(instance._counterEvents);
 
-                // Check if test matches include filters
-                if (instance._include.size() > 0)
+                if (counters->Open())
+                    counterValues.reserve(runs);
+                else
                 {
-                    bool included = false;
-                    std::string name =
-                        descriptor->FixtureName + "." +
-                        descriptor->TestName;
+                    delete counters;
+                    counters = NULL;
+                }
+            }
 
-                    for (std::size_t i = 0; i < instance._include.size(); i++)
-                    {
-                        if (name.find(instance._include[i]) !=
-                            std::string::npos)
-                        {
-                            included = true;
-                            break;
-                        }
-                    }
+            // Sample individual iterations if requested. Iterations of
+            // multi-threaded tests are not sampled, and the latency of every
+            // iteration of open-loop tests is recorded instead.
+            const std::size_t sampleInterval =
+                ((descriptor.Threads) || (openLoop) ?
+                 0 :
+                 instance._sampleInterval);
+            std::vector<uint64_t> samples;
+            Histogram iterationSamples(
+                instance._histogramSignificantDigits
+            );
+
+            // With linear sampling, the k-th run performs k steps of
+            // iterations, so that the runs perform the nominal number of
+            // iterations per run on average. The ramp spans the maximum
+            // number of runs, and restarts if that exceeds twice the
+            // nominal number of iterations, so that no run performs more
+            // than twice the nominal number of iterations.
+            const std::size_t linearRamp =
+                std::min(runs,
+                         std::max<std::size_t>(2 * iterations, 2) - 1);
+            const std::size_t linearStep =
+                ((instance._linearSampling) &&
+                 (!descriptor.Threads) &&
+                 (!openLoop) ?
+                 std::max<std::size_t>(
+                     2 * iterations / (linearRamp + 1),
+                     1
+                 ) :
+                 0);
+            std::vector<std::size_t> runIterations;
+            uint64_t linearIterations = 0;
+
+            // Run times scaled to the nominal number of iterations, which
+            // the stopping criterion of linearly sampled runs is evaluated
+            // on, as runs of different lengths cannot be compared directly.
+            std::vector<uint64_t> normalizedRunTimes;
+
+            // Execute each individual run.
+            std::vector<uint64_t> runTimes;
+            std::vector<std::vector<uint64_t> > threadRunTimes;
+            runTimes.reserve(runs);
+
+            // The resource usage of a multi-threaded test is that of the
+            // process, as the usage of the threads it joins is accounted to
+            // the process. The peak resident set size is only sampled around
+            // all runs.
+            std::vector<ResourceUsage> resourceUsage;
+            ResourceUsageProbe resourceUsageProbe(descriptor.Threads != 0);
+            bool resourceUsageAvailable = true;
+            resourceUsage.reserve(runs);
+            const uint64_t peakResidentSetSizeStart =
+                ResourceUsage::SamplePeakResidentSetSize();
+            uint64_t overheadCalibration =
+                calibrationModel.GetCalibration(iterations);
+
+            const Clock::TimePoint startTime = Clock::Now();
+            bool converged = false;
+            double relativeWidth = 0.0;
+
+            while (runTimes.size() < runs)
+            {
+                // Determine the iterations of a linearly sampled run.
+                std::size_t runIterationCount = iterations;
 
-                    if (!included)
-                        continue;
+                if (linearStep)
+                {
+                    runIterationCount =
+                        linearStep * (runTimes.size() % linearRamp + 1);
+                    runIterations.push_back(runIterationCount);
+                    linearIterations += runIterationCount;
+                    overheadCalibration =
+                        calibrationModel.GetCalibration(runIterationCount);
                 }
 
-                // Check if test is not disabled.
-                if (descriptor->IsDisabled)
+                // Run the test.
+                std::vector<uint64_t>* threadTimesPointer = NULL;
+
+                if (descriptor.Threads)
                 {
-                    for (std::size_t outputterIndex = 0;
-                         outputterIndex < outputters.size();
-                         outputterIndex++)
-                        outputters[outputterIndex]->SkipDisabledTest(
-                            descriptor->FixtureName,
-                            descriptor->TestName,
-                            descriptor->Parameters,
-                            descriptor->Runs,
-                            descriptor->Iterations
+                    threadRunTimes.push_back(std::vector<uint64_t>());
+                    threadTimesPointer = &threadRunTimes.back();
+                }
+
+                uint64_t time = RunTest(descriptor,
+                                        runIterationCount,
+                                        calibrationModel.PauseOverhead,
+                                        counters,
+                                        threadTimesPointer,
+                                        ((sampleInterval) || (openLoop) ?
+                                         &samples :
+                                         NULL),
+                                        sampleInterval,
+                                        calibrationModel.SampleOverhead,
+                                        (openLoop ? rate : 0.0),
+                                        &resourceUsageProbe);
+
+                resourceUsageAvailable = ((resourceUsageAvailable) &&
+                                          (resourceUsageProbe.IsAvailable()));
+
+                if (resourceUsageAvailable)
+                    resourceUsage.push_back(resourceUsageProbe.Usage());
+
+                for (std::size_t sample = 0;
+                     sample < samples.size();
+                     ++sample)
+                    iterationSamples.Record(samples[sample]);
+
+                if (threadTimesPointer)
+                {
+                    std::vector<uint64_t>& threadTimes =
+                        *threadTimesPointer;
+
+                    for (std::size_t thread = 0;
+                         thread < threadTimes.size();
+                         ++thread)
+                        threadTimes[thread] =
+                            (threadTimes[thread] > overheadCalibration ?
+                             threadTimes[thread] - overheadCalibration :
+                             0);
+                }
+
+                if (counters)
+                {
+                    counterValues.push_back(std::vector<uint64_t>());
+                    counters->Read(counterValues.back());
+                }
+
+                // Store the test time.
+                runTimes.push_back(time > overheadCalibration ?
+                                   time - overheadCalibration :
+                                   0);
+
+                if (linearStep)
+                    normalizedRunTimes.push_back(uint64_t(
+                        double(runTimes.back()) * double(iterations) /
+                        double(runIterationCount) + 0.5
+                    ));
+
+                // Stop once the confidence interval has converged or the
+                // time budget has been exhausted.
+                if ((adaptive) &&
+                    (runTimes.size() >= instance._adaptiveMinimumRuns))
+                {
+                    relativeWidth =
+                        Statistics::RelativeConfidenceIntervalWidth(
+                            (linearStep ? normalizedRunTimes : runTimes),
+                            instance._adaptiveStatistic,
+                            HAYAI_ADAPTIVE_CONFIDENCE_LEVEL
                         );
 
-                    continue;
+                    if (relativeWidth <= instance._adaptiveTarget)
+                    {
+                        converged = true;
+                        break;
+                    }
+
+                    if (Clock::Duration(startTime, Clock::Now()) >=
+                        instance._adaptiveTimeBudget)
+                        break;
                 }
+            }
 
-                // Describe the beginning of the run.
-                for (std::size_t outputterIndex = 0;
-                     outputterIndex < outputters.size();
-                     outputterIndex++)
-                    outputters[outputterIndex]->BeginTest(
-                        descriptor->FixtureName,
-                        descriptor->TestName,
-                        descriptor->Parameters,
-                        descriptor->Runs,
-                        descriptor->Iterations
-                    );
+            const uint64_t peakResidentSetSizeEnd =
+                ResourceUsage::SamplePeakResidentSetSize();
+
+            // Calculate the test result. Linearly sampled runs are
+            // summarized by their average number of iterations.
+            if ((linearStep) && (!runTimes.empty()))
+                iterations = std::max<std::size_t>(
+                    std::size_t((linearIterations + runTimes.size() / 2) /
+                                runTimes.size()),
+                    1
+                );
+
+            TestResult testResult(runTimes,
+                                  iterations,
+                                  instance._histogramSignificantDigits);
+
+            if (linearStep)
+                testResult.SetRunIterations(
+                    runIterations,
+                    HAYAI_LINEAR_SAMPLING_CONFIDENCE_LEVEL
+                );
+            testResult.SetWarmUpRuns(warmUpRuns);
+
+            if (adaptive)
+                testResult.SetConvergence(converged,
+                                          relativeWidth,
+                                          instance._adaptiveTarget);
+
+            if (sampleInterval)
+                testResult.SetIterationSamples(iterationSamples,
+                                               sampleInterval);
+
+            if (openLoop)
+                testResult.SetOpenLoop(rate, iterationSamples);
+
+            if (descriptor.Threads)
+                testResult.SetThreads(descriptor.Threads,
+                                      threadRunTimes);
+
+            if (resourceUsageAvailable)
+                testResult.SetResourceUsage(
+                    resourceUsage,
+                    (peakResidentSetSizeEnd > peakResidentSetSizeStart ?
+                     peakResidentSetSizeEnd - peakResidentSetSizeStart :
+                     0)
+                );
+
+            if (counters)
+            {
+                testResult.SetPerformanceCounters(counters->Names(),
+                                                  counterValues);
+                delete counters;
+            }
 
-                // Execute each individual run.
-                std::vector<uint64_t> runTimes(descriptor->Runs);
-                uint64_t overheadCalibration =
-                    calibrationModel.GetCalibration(descriptor->Iterations);
+            return testResult;
+        }
 
-                std::size_t run = 0;
-                while (run < descriptor->Runs)
-                {
-                    // Construct a test instance.
-                    Test* test = descriptor->Factory->CreateTest();
 
-                    // Run the test.
-                    uint64_t time = test->Run(descriptor->Iterations);
+        /// Perform the runs of a test in a child process.
 
-                    // Store the test time.
-                    runTimes[run] = (time > overheadCalibration ?
-                                     time - overheadCalibration :
-                                     0);
+        /// The child performs the runs like @ref RunTestRuns and sends the
+        /// beginning of the runs and the result back, which are described
+        /// to the outputters as they arrive. If the child fails, the
+        /// beginning of the runs is described with the nominal numbers of
+        /// runs and iterations if the child did not get that far.
+        ///
+        /// @param descriptor Test descriptor.
+        /// @param parameters Parameters to describe the test with.
+        /// @param calibrationModel Calibration model.
+        /// @param outputters Outputters.
+        /// @param rate Offered load in iterations per second of an
+        /// open-loop test, or 0 to run the test closed-loop.
+        /// @param failure Description of the failure if the child did not
+        /// produce a result.
+        /// @returns the result of the test, or an empty result on failure.
+        static TestResult RunIsolatedTestRuns(
+            const TestDescriptor& descriptor,
+            const TestParametersDescriptor& parameters,
+            const CalibrationModel& calibrationModel,
+            std::vector<Outputter*>& outputters,
+            double rate,
+            std::string& failure
+        )
+        {
+            IsolatedRuns runs(Instance()._isolationTimeout);
+            StartIsolatedTestRuns(runs,
+                                  descriptor,
+                                  parameters,
+                                  calibrationModel,
+                                  rate,
+                                  -1);
+
+            // Receive the messages of the child.
+            bool began = false;
+            IsolationMessage tag;
+            std::string payload;
+
+            while ((runs.Failure.empty()) &&
+                   (runs.Process.Receive(tag, payload)))
+            {
+                ReceiveIsolatedMessage(runs, tag, payload);
 
-                    // Dispose of the test instance.
-                    delete test;
+                if ((runs.Began) && (!began))
+                {
+                    for (std::size_t outputterIndex = 0;
+                         outputterIndex < outputters.size();
+                         outputterIndex++)
+                        outputters[outputterIndex]->BeginTest(
+                            descriptor.FixtureName,
+                            descriptor.TestName,
+                            parameters,
+                            runs.Runs,
+                            runs.Iterations
+                        );
 
-                    ++run;
+                    began = true;
                 }
+            }
 
-                // Calculate the test result.
-                TestResult testResult(runTimes, descriptor->Iterations);
+            FinishIsolatedTestRuns(runs);
 
-                // Describe the end of the run.
+            if (!began)
                 for (std::size_t outputterIndex = 0;
                      outputterIndex < outputters.size();
                      outputterIndex++)
-                    outputters[outputterIndex]->EndTest(
-                        descriptor->FixtureName,
-                        descriptor->TestName,
-                        descriptor->Parameters,
-                        testResult
+                    outputters[outputterIndex]->BeginTest(
+                        descriptor.FixtureName,
+                        descriptor.TestName,
+                        parameters,
+                        descriptor.Runs,
+                        descriptor.Iterations
                     );
 
-            }
-
-            // End output.
-            for (std::size_t outputterIndex = 0;
-                 outputterIndex < outputters.size();
-                 outputterIndex++)
-                outputters[outputterIndex]->End(enabledCount,
-                                                disabledCount);
-        }
-
-
-        /// List tests.
-        static std::vector<const TestDescriptor*> ListTests()
-        {
-            std::vector<const TestDescriptor*> tests;
-            Benchmarker& instance = Instance();
-
-            std::size_t index = 0;
-            while (index < instance._tests.size())
-                tests.push_back(instance._tests[index++]);
-
-            return tests;
+            failure = runs.Failure;
+            return runs.Result;
         }
 
 
-        /// Shuffle tests.
+        /// Start the runs of a test in a child process.
 
-        /// Randomly shuffles the order of tests.
-        static void ShuffleTests()
+        /// In the child, performs the runs like @ref RunTestRuns, sends the
+        /// beginning of the runs and the result to the parent and exits.
+        ///
+        /// @param runs Isolated runs to start. The failure is set if the
+        /// child cannot be forked.
+        /// @param descriptor Test descriptor.
+        /// @param parameters Parameters to describe the test with.
+        /// @param calibrationModel Calibration model.
+        /// @param rate Offered load in iterations per second of an
+        /// open-loop test, or 0 to run the test closed-loop.
+        /// @param cpu Processor to pin the child to, or -1 to not pin it.
+        static void StartIsolatedTestRuns(
+            IsolatedRuns& runs,
+            const TestDescriptor& descriptor,
+            const TestParametersDescriptor& parameters,
+            const CalibrationModel& calibrationModel,
+            double rate,
+            int cpu
+        )
         {
-            Benchmarker& instance = Instance();
-#if __cplusplus > 201100L
-            std::random_device rd;
-            std::mt19937 g(rd());
-            std::shuffle(instance._tests.begin(),
-                         instance._tests.end(),
-                         g);
-#else
-            std::random_shuffle(instance._tests.begin(),
-                                instance._tests.end());
-#endif
-        }
-    private:
-        /// Calibration model.
+            bool child;
 
-        /// Describes a linear calibration model for test runs.
-        struct CalibrationModel
-        {
-        public:
-            CalibrationModel(std::size_t scale,
-                             uint64_t slope,
-                             uint64_t yIntercept)
-                :   Scale(scale),
-                    Slope(slope),
-                    YIntercept(yIntercept)
+            try
             {
-
+                child = runs.Process.Fork();
+            }
+            catch (std::exception& e)
+            {
+                runs.Failure = e.what();
+                child = false;
             }
 
-            
-            /// Scale.
-
-            /// Number of iterations per slope unit.
-            const std::size_t Scale;
-
-
-            /// Slope.
-            const uint64_t Slope;
+            if (!child)
+                return;
 
+            // Perform the runs in the child and send the result. Memory
+            // locks are not inherited.
+            if (cpu >= 0)
+                CpuTopology::Pin(cpu);
 
-            /// Y-intercept;
-            const uint64_t YIntercept;
+            if (Instance()._lockMemory)
+                Scheduling::LockMemory();
 
+            IsolationOutputter isolationOutputter(runs.Process);
+            std::vector<Outputter*> childOutputters;
+            childOutputters.push_back(&isolationOutputter);
 
-            /// Get calibration value for a run.
-            int64_t GetCalibration(std::size_t iterations) const
+            try
             {
-                return YIntercept + (iterations * Slope) / Scale;
+                IsolationEncoder message;
+                message.WriteResult(RunTestRuns(descriptor,
+                                                parameters,
+                                                calibrationModel,
+                                                childOutputters,
+                                                rate));
+                runs.Process.Send(IsolationResult, message);
+                runs.Process.Exit(EXIT_SUCCESS);
+            }
+            catch (std::exception& e)
+            {
+                IsolationEncoder message;
+                message.WriteString(e.what());
+                runs.Process.Send(IsolationError, message);
+            }
+            catch (...)
+            {
+                IsolationEncoder message;
+                message.WriteString("unknown exception");
+                runs.Process.Send(IsolationError, message);
             }
-        };
-
-        
-        /// Private constructor.
-        Benchmarker()
-        {
 
+            runs.Process.Exit(EXIT_FAILURE);
         }
 
 
-        /// Private destructor.
-        ~Benchmarker()
+        /// Handle a message from the child performing isolated runs.
+        static void ReceiveIsolatedMessage(IsolatedRuns& runs,
+                                           IsolationMessage tag,
+                                           const std::string& payload)
         {
-            // Release all test descriptors.
-            std::size_t index = _tests.size();
-            while (index--)
-                delete _tests[index];
+            try
+            {
+                IsolationDecoder decoder(payload);
+
+                switch (tag)
+                {
+                case IsolationBegin:
+                    runs.Runs = std::size_t(decoder.ReadUnsigned());
+                    runs.Iterations = std::size_t(decoder.ReadUnsigned());
+                    runs.Began = true;
+                    break;
+
+                case IsolationResult:
+                    runs.Result = decoder.ReadResult();
+                    runs.Received = true;
+                    break;
+
+                case IsolationError:
+                    runs.Error = "exception: " + decoder.ReadString();
+                    break;
+
+                default:
+                    runs.Error = "unknown message";
+                    break;
+                }
+            }
+            catch (std::exception& e)
+            {
+                runs.Error = std::string("invalid message: ") + e.what();
+            }
         }
 
 
-        /// Get the tests to be executed.
-        std::vector<TestDescriptor*> GetTests() const
+        /// Wait for the child performing isolated runs to exit.
+
+        /// A result only counts if the child exited cleanly after sending
+        /// it. Otherwise, the failure is set.
+        static void FinishIsolatedTestRuns(IsolatedRuns& runs)
         {
-            std::vector<TestDescriptor*> tests;
+            if (!runs.Failure.empty())
+                return;
 
-            std::size_t index = 0;
-            while (index < _tests.size())
-                tests.push_back(_tests[index++]);
+            const std::string status = runs.Process.Wait();
 
-            return tests;
+            if (!runs.Error.empty())
+                runs.Failure = runs.Error;
+            else if (!status.empty())
+                runs.Failure = status;
+            else if (!runs.Received)
+                runs.Failure = "exited without a result";
         }
 
 
-        /// Test if a filter matches a string.
+        /// Calibrate the number of iterations for a test.
 
-        /// Adapted from gtest. All rights reserved by original authors.
-        static bool FilterMatchesString(const char* filter,
-                                        const std::string& str)
+        /// Performs pilot runs with a geometrically growing number of
+        /// iterations until a single run takes at least the minimum run time.
+        /// The growth is extrapolated from the previous pilot run once it
+        /// is long enough to be meaningful, aiming 40 % above the target,
+        /// but never by more than a factor of 10 at a time.
+        ///
+        /// @param descriptor Test descriptor.
+        /// @param minimumRunTime Minimum run time in nanoseconds.
+        /// @returns the number of iterations of the first pilot run that took
+        /// at least the minimum run time.
+        static std::size_t CalibrateIterations(const TestDescriptor& descriptor,
+                                               uint64_t minimumRunTime)
         {
-            const char *patternStart = filter;
+            const std::size_t maximumIterations = 1000000000;
+            std::size_t iterations = 1;
 
             while (true)
             {
-                if (PatternMatchesString(patternStart, str.c_str()))
-                    return true;
+                uint64_t time = RunTest(descriptor, iterations, 0);
 
-                // Finds the next pattern in the filter.
-                patternStart = strchr(patternStart, ':');
+                if ((time >= minimumRunTime) ||
+                    (iterations >= maximumIterations))
+                    return iterations;
 
-                // Returns if no more pattern can be found.
-                if (!patternStart)
-                    return false;
+                double multiplier = 10.0;
+                if (time > minimumRunTime / 10)
+                    multiplier = std::min(
+                        multiplier,
+                        1.4 * double(minimumRunTime) / double(time)
+                    );
 
-                // Skips the pattern separater (the ':' character).
-                patternStart++;
+                std::size_t next =
+                    std::size_t(double(iterations) * multiplier);
+
+                iterations = std::min(maximumIterations,
+                                      std::max(next, iterations + 1));
             }
         }
 
 
-        /// Test if pattern matches a string.
+        /// Get calibration model from the cache.
 
-        /// Adapted from gtest. All rights reserved by original authors.
-        static bool PatternMatchesString(const char* pattern, const char *str)
+        /// Falls back to determining the calibration model if the cache does
+        /// not hold a plausible entry for the current process, or if
+        /// recalibration has been requested, in which case the cache is
+        /// updated with the new model if it is plausible.
+        static CalibrationModel GetCachedCalibrationModel()
         {
-            switch (*pattern)
-            {
-            case '\0':
-            case ':':
-                return (*str == '\0');
-            case '?':  // Matches any single character.
-                return ((*str != '\0') &&
-                        (PatternMatchesString(pattern + 1, str + 1)));
-            case '*':  // Matches any string (possibly empty) of characters.
-                return (((*str != '\0') &&
-                         (PatternMatchesString(pattern, str + 1))) ||
-                        (PatternMatchesString(pattern + 1, str)));
-            default:
-                return ((*pattern == *str) &&
-                        (PatternMatchesString(pattern + 1, str + 1)));
-            }
+            Benchmarker& instance = Instance();
+            const std::string& path = instance._calibrationCachePath;
+
+            if (path.empty())
+                return GetCalibrationModel();
+
+            const std::string key = CalibrationCache::Key();
+            std::vector<uint64_t> values;
+
+            if ((!instance._recalibrate) &&
+                (CalibrationCache::Load(path, key, values)))
+                return CalibrationModel(std::size_t(values[0]),
+                                        values[1],
+                                        values[2],
+                                        values[3],
+                                        values[4]);
+
+            const CalibrationModel model = GetCalibrationModel();
+
+            values.clear();
+            values.push_back(model.Scale);
+            values.push_back(model.Slope);
+            values.push_back(model.YIntercept);
+            values.push_back(model.PauseOverhead);
+            values.push_back(model.SampleOverhead);
+            CalibrationCache::Store(path, key, values);
+
+            return model;
         }
 
 
@@ -459,13 +2905,20 @@ namespace hayai
             // a negative y-intercept if we do not fix the y-intercept. This
             // intercept is therefore fixed by a large number of runs of 0
             // iterations.
-            ::hayai::Test* test = new Test();
+            //
+            // The empty test body is inlined into the iteration loop like
+            // the bodies of the benchmark macros, so the slope only reflects
+            // the overhead of the loop itself, which an optimizing compiler
+            // may well eliminate entirely.
+            ::hayai::Test* test = new CalibrationTest();
 
 #define HAYAI_CALIBRATION_INTERESECT_RUNS 10000
 
 #define HAYAI_CALIBRATION_RUNS 10
 #define HAYAI_CALIBRATION_SCALE 1000000
 #define HAYAI_CALIBRATION_PPR 6
+#define HAYAI_CALIBRATION_PAUSES 10000
+#define HAYAI_CALIBRATION_SAMPLES 10000
 
             // Determine the intercept.
             uint64_t
@@ -517,36 +2970,129 @@ namespace hayai
             // fitting the sample points will be
             // $\frac {\sum_{i=1}^{n} x_n \cdot (y_n - b)}
             //  {\sum_{i=1}^{n} {x_n}^2}$.
-            uint64_t
-                sumProducts = 0,
-                sumXSquared = 0;
+            //
+            // If the loop has been eliminated, the sample points are only
+            // noise around the intercept, so the residuals are signed and a
+            // negative slope is clamped at 0.
+            int64_t sumProducts = 0;
+            uint64_t sumXSquared = 0;
 
             std::size_t p = x.size();
             while (p--)
             {
                 sumXSquared += x[p] * x[p];
-                sumProducts += x[p] * (t[p] - interceptAvg);
+                sumProducts += int64_t(x[p]) *
+                               (int64_t(t[p]) - int64_t(interceptAvg));
+            }
+
+            const uint64_t slope =
+                (sumProducts > 0 ?
+                 uint64_t(sumProducts) / sumXSquared :
+                 0);
+
+            delete test;
+
+            // Determine the overhead of pausing and resuming timing. Only the
+            // parts of the calls outside the paused interval, ie. up to
+            // reading the clock when pausing and from reading the clock when
+            // resuming, remain in the run time. The overhead is taken as the
+            // minimum across several runs, as it is a lower bound disturbed
+            // only by noise.
+            ::hayai::Test* pauseTest = new PauseCalibrationTest();
+            uint64_t pauseOverhead = std::numeric_limits<uint64_t>::max();
+
+            for (std::size_t run = 0; run < HAYAI_CALIBRATION_RUNS; ++run)
+            {
+                const uint64_t time =
+                    pauseTest->Run(HAYAI_CALIBRATION_PAUSES);
+                const uint64_t loop =
+                    interceptAvg +
+                    (uint64_t(HAYAI_CALIBRATION_PAUSES) * slope) /
+                    HAYAI_CALIBRATION_SCALE;
+                const uint64_t overhead =
+                    (time > loop ? time - loop : 0) /
+                    HAYAI_CALIBRATION_PAUSES;
+
+                if (overhead < pauseOverhead)
+                    pauseOverhead = overhead;
             }
 
-            uint64_t slope = sumProducts / sumXSquared;
+            delete pauseTest;
+
+            // Determine the overhead of timing a single iteration as the
+            // smallest median time of timing every iteration of the empty
+            // test body.
+            test = new CalibrationTest();
+            uint64_t sampleOverhead = std::numeric_limits<uint64_t>::max();
+            std::vector<uint64_t> samples;
+
+            for (std::size_t run = 0; run < HAYAI_CALIBRATION_RUNS; ++run)
+            {
+                test->RunSampled(HAYAI_CALIBRATION_SAMPLES, 1, 0, samples);
+
+                std::nth_element(samples.begin(),
+                                 samples.begin() + samples.size() / 2,
+                                 samples.end());
+
+                if (samples[samples.size() / 2] < sampleOverhead)
+                    sampleOverhead = samples[samples.size() / 2];
+            }
 
             delete test;
 
             return CalibrationModel(HAYAI_CALIBRATION_SCALE,
                                     slope,
-                                    interceptAvg);
+                                    interceptAvg,
+                                    pauseOverhead,
+                                    sampleOverhead);
 
 #undef HAYAI_CALIBRATION_INTERESECT_RUNS
 
 #undef HAYAI_CALIBRATION_RUNS
 #undef HAYAI_CALIBRATION_SCALE
 #undef HAYAI_CALIBRATION_PPR
+#undef HAYAI_CALIBRATION_PAUSES
+#undef HAYAI_CALIBRATION_SAMPLES
         }
 
 
         std::vector<Outputter*> _outputters; ///< Registered outputters.
         std::vector<TestDescriptor*> _tests; ///< Registered tests.
-        std::vector<std::string> _include; ///< Test filters.
+        std::vector<PerformanceCounterEvent> _counterEvents; ///< Counted events.
+        bool _countersEnabled; ///< Collect performance counters.
+        uint64_t _minimumRunTime; ///< Minimum run time in nanoseconds.
+        bool _adaptiveRuns; ///< Determine the number of runs adaptively.
+        double _adaptiveTarget; ///< Target relative interval width.
+        Statistic _adaptiveStatistic; ///< Statistic for adaptive runs.
+        std::size_t _adaptiveMinimumRuns; ///< Minimum adaptive runs.
+        std::size_t _adaptiveMaximumRuns; ///< Maximum adaptive runs.
+        uint64_t _adaptiveTimeBudget; ///< Adaptive time budget per test.
+        WarmUp _warmUp; ///< Warm-up for all tests.
+        std::map<std::string, WarmUp> _testWarmUps; ///< Warm-up per test.
+        std::map<std::string, Complexity>
+            _testComplexities; ///< Complexity settings per test.
+        std::string _calibrationCachePath; ///< Calibration cache file.
+        bool _recalibrate; ///< Ignore the calibration cache.
+        int _histogramSignificantDigits; ///< Histogram precision.
+        std::size_t _sampleInterval; ///< Iteration sampling interval.
+        std::vector<double> _openLoopRates; ///< Open-loop offered loads.
+        const Baseline* _baseline; ///< Baseline results.
+        double _regressionThreshold; ///< Relative regression threshold.
+        std::size_t _regressions; ///< Regressions in the last run.
+        Bootstrap _bootstrap; ///< Bootstrap of confidence intervals.
+        bool _linearSampling; ///< Linearly increasing iteration counts.
+        bool _isolate; ///< Run each test in its own process.
+        uint64_t _isolationTimeout; ///< Timeout of isolated tests.
+        std::size_t _failures; ///< Failures in the last run.
+        std::size_t _jobs; ///< Isolated tests to run at the same time.
+        std::vector<int> _jobCpus; ///< Processors of parallel tests.
+        ThreadPlacement _threadPlacement; ///< Placement of test threads.
+        CpuTopology _threadTopology; ///< Processors to place threads on.
+        std::map<std::size_t, std::vector<int> >
+            _threadCpus; ///< Processors of threads by number of threads.
+        bool _lockMemory; ///< Lock the memory of isolated tests.
+        std::vector<std::pair<std::string, std::string> >
+            _metadata; ///< Metadata for the outputters.
     };
 }
 #endif
@@ -0,0 +1,292 @@
+//
+// Bootstrap confidence intervals.
+//
+// Implementation notes:
+//
+// The percentile bootstrap makes no assumption about the distribution of the
+// run times, which are typically skewed and often multi-modal, so that the
+// intervals remain meaningful where an interval derived from the standard
+// deviation is not.
+//
+// Each resample draws as many values with replacement as there are runs, and
+// the mean and median of every resample are stored in two contiguous arrays
+// from which the percentiles are selected in linear time. The values are
+// copied into a contiguous array of doubles once, each resample accumulates
+// the mean while filling a reusable buffer, and the median is selected with
+// std::nth_element rather than by sorting, so a resample costs linear time
+// and touches no memory but the values, the buffer and its output slots.
+//
+// Resamples are drawn in fixed blocks, each with a generator seeded from the
+// seed and the index of the block. The blocks are distributed over the
+// threads, so the intervals only depend on the seed and not on the number of
+// threads.
+//
+#ifndef __HAYAI_BOOTSTRAP
+#define __HAYAI_BOOTSTRAP
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+#include "hayai_statistics.hpp"
+#include "hayai_threading.hpp"
+
+
+/// Default number of bootstrap resamples.
+#ifndef HAYAI_BOOTSTRAP_RESAMPLES
+#   define HAYAI_BOOTSTRAP_RESAMPLES 10000
+#endif
+
+/// Default confidence level of bootstrap intervals.
+#ifndef HAYAI_BOOTSTRAP_LEVEL
+#   define HAYAI_BOOTSTRAP_LEVEL 0.95
+#endif
+
+/// Default seed of bootstrap resampling.
+#ifndef HAYAI_BOOTSTRAP_SEED
+#   define HAYAI_BOOTSTRAP_SEED 0
+#endif
+
+/// Number of resamples drawn from one generator.
+#ifndef HAYAI_BOOTSTRAP_BLOCK
+#   define HAYAI_BOOTSTRAP_BLOCK 256
+#endif
+
+
+namespace hayai
+{
+    /// Confidence interval.
+    struct ConfidenceInterval
+    {
+        /// Initialize a confidence interval.
+
+        /// @param lower Lower bound.
+        /// @param upper Upper bound.
+        ConfidenceInterval(double lower = 0.0, double upper = 0.0)
+            :   Lower(lower),
+                Upper(upper)
+        {
+
+        }
+
+
+        /// Lower bound.
+        double Lower;
+
+
+        /// Upper bound.
+        double Upper;
+    };
+
+
+    /// Percentile bootstrap of the mean and median.
+    class Bootstrap
+    {
+    public:
+        /// Initialize a bootstrap.
+
+        /// @param resamples Number of resamples.
+        /// @param level Confidence level, eg. 0.95.
+        /// @param seed Seed of the pseudo-random number generators.
+        /// @param threads Number of threads to resample on.
+        Bootstrap(std::size_t resamples = HAYAI_BOOTSTRAP_RESAMPLES,
+                  double level = HAYAI_BOOTSTRAP_LEVEL,
+                  uint64_t seed = HAYAI_BOOTSTRAP_SEED,
+                  std::size_t threads = 1)
+            :   _resamples(resamples),
+                _level(level),
+                _seed(seed),
+                _threads(threads ? threads : 1)
+        {
+
+        }
+
+
+        /// Number of resamples.
+        inline std::size_t Resamples() const
+        {
+            return _resamples;
+        }
+
+
+        /// Confidence level.
+        inline double Level() const
+        {
+            return _level;
+        }
+
+
+        /// Seed.
+        inline uint64_t Seed() const
+        {
+            return _seed;
+        }
+
+
+        /// Number of threads.
+        inline std::size_t Threads() const
+        {
+            return _threads;
+        }
+
+
+        /// Estimate confidence intervals of the mean and median.
+
+        /// @param values Sample values. Must not be empty.
+        /// @param mean Confidence interval of the mean.
+        /// @param median Confidence interval of the median.
+        void Estimate(const std::vector<uint64_t>& values,
+                      ConfidenceInterval& mean,
+                      ConfidenceInterval& median) const
+        {
+            Job job;
+            job.Values.assign(values.begin(), values.end());
+            job.Seed = _seed;
+            job.Means.resize(_resamples);
+            job.Medians.resize(_resamples);
+            job.Blocks = (_resamples + HAYAI_BOOTSTRAP_BLOCK - 1) /
+                HAYAI_BOOTSTRAP_BLOCK;
+
+            // Resample on the worker threads and the calling thread.
+            std::size_t threads = std::min(_threads, job.Blocks);
+            if (!threads)
+                threads = 1;
+
+            std::vector<Worker> workers(threads);
+            std::vector<Thread*> started;
+
+            for (std::size_t worker = 0; worker < threads; ++worker)
+            {
+                workers[worker].Work = &job;
+                workers[worker].First = worker;
+                workers[worker].Stride = threads;
+            }
+
+            for (std::size_t worker = 1; worker < threads; ++worker)
+            {
+                try
+                {
+                    started.push_back(new Thread(&Bootstrap::Run,
+                                                 &workers[worker]));
+                }
+                catch (...)
+                {
+                    // Resample the remaining blocks on the calling thread.
+                    for (std::size_t rest = worker; rest < threads; ++rest)
+                        Run(&workers[rest]);
+                    break;
+                }
+            }
+
+            Run(&workers[0]);
+
+            for (std::size_t thread = 0; thread < started.size(); ++thread)
+            {
+                started[thread]->Join();
+                delete started[thread];
+            }
+
+            mean = Interval(job.Means);
+            median = Interval(job.Medians);
+        }
+    private:
+        /// Resampling job.
+        struct Job
+        {
+            std::vector<double> Values;
+            uint64_t Seed;
+            std::vector<double> Means;
+            std::vector<double> Medians;
+            std::size_t Blocks;
+        };
+
+
+        /// Share of a resampling job.
+        struct Worker
+        {
+            Job* Work;
+            std::size_t First;
+            std::size_t Stride;
+        };
+
+
+        /// Resample every block of a share.
+        static void Run(void* argument)
+        {
+            const Worker& worker = *static_cast<Worker*>(argument);
+            Job& job = *worker.Work;
+            const std::vector<double>& values = job.Values;
+            const std::size_t size = values.size();
+            const std::size_t half = size / 2;
+            std::vector<double> buffer(size);
+
+            for (std::size_t block = worker.First;
+                 block < job.Blocks;
+                 block += worker.Stride)
+            {
+                Random random(Random(job.Seed ^ uint64_t(block)).Next());
+                const std::size_t first = block * HAYAI_BOOTSTRAP_BLOCK;
+                const std::size_t last =
+                    std::min(first + HAYAI_BOOTSTRAP_BLOCK, job.Means.size());
+
+                for (std::size_t resample = first; resample < last; ++resample)
+                {
+                    double sum = 0.0;
+
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        const double value = values[random.Index(size)];
+                        buffer[i] = value;
+                        sum += value;
+                    }
+
+                    job.Means[resample] = sum / double(size);
+
+                    std::nth_element(buffer.begin(),
+                                     buffer.begin() + half,
+                                     buffer.end());
+
+                    job.Medians[resample] = ((size % 2) ?
+                                             buffer[half] :
+                                             (*std::max_element(
+                                                 buffer.begin(),
+                                                 buffer.begin() + half
+                                             ) + buffer[half]) / 2.0);
+                }
+            }
+        }
+
+
+        /// Percentile interval of resampled estimates.
+        ConfidenceInterval Interval(std::vector<double>& estimates) const
+        {
+            if (estimates.empty())
+                return ConfidenceInterval();
+
+            const double tail = (1.0 - _level) / 2.0;
+            const std::size_t last = estimates.size() - 1;
+            const std::size_t lower =
+                std::size_t(tail * double(last) + 0.5);
+            const std::size_t upper =
+                std::size_t((1.0 - tail) * double(last) + 0.5);
+
+            std::nth_element(estimates.begin(),
+                             estimates.begin() + lower,
+                             estimates.end());
+            const double lowerValue = estimates[lower];
+
+            std::nth_element(estimates.begin() + lower,
+                             estimates.begin() + upper,
+                             estimates.end());
+
+            return ConfidenceInterval(lowerValue, estimates[upper]);
+        }
+
+
+        std::size_t _resamples;
+        double _level;
+        uint64_t _seed;
+        std::size_t _threads;
+    };
+}
+#endif
@@ -0,0 +1,526 @@
+//
+// Persistent cache of the calibration model.
+//
+// Implementation notes:
+//
+// Calibrating the overhead of the benchmark loop takes a noticeable amount of
+// time, so the result is kept in a small text file and reused by later
+// invocations. Each line of the file holds one entry: the time the entry was
+// written, the key and the calibration values, separated by tabs. The key
+// describes everything the calibration depends on:
+//
+//  - the host name,
+//  - the processor model,
+//  - the clock backend and
+//  - the build of the benchmark binary, identified by the GNU build ID of
+//    the executable on Linux, the modification time and size of the
+//    executable elsewhere on POSIX systems, and the build time of the
+//    translation unit running the benchmarks otherwise.
+//
+// The values are the scale, slope and intercept of the calibration model
+// and the overheads of pausing timing and of timing a single iteration, in
+// nanoseconds. Values that no plausible calibration can produce, eg. the
+// slope of a fit that went wrong, are neither stored nor loaded, so that a
+// bad calibration cannot distort the results of later invocations.
+//
+// Entries expire after a week, and the file is limited to a number of
+// entries to avoid unbounded growth when many binaries share it. The file is
+// rewritten through a temporary file that is renamed into place, so that
+// concurrent invocations never observe a partially written file.
+//
+// By default, the file is "hayai/calibration" in $XDG_CACHE_HOME or
+// ~/.cache on POSIX systems, and in %LOCALAPPDATA% on Windows.
+//
+#ifndef __HAYAI_CALIBRATIONCACHE
+#define __HAYAI_CALIBRATIONCACHE
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <link.h>
+#elif defined(__APPLE__) && defined(__MACH__)
+#include <mach-o/dyld.h>
+#include <sys/sysctl.h>
+#endif
+
+#include "hayai_clock.hpp"
+
+
+/// Maximum age in seconds of calibration cache entries.
+#ifndef HAYAI_CALIBRATION_CACHE_LIFETIME
+#   define HAYAI_CALIBRATION_CACHE_LIFETIME 604800
+#endif
+
+/// Maximum number of calibration cache entries.
+#ifndef HAYAI_CALIBRATION_CACHE_ENTRIES
+#   define HAYAI_CALIBRATION_CACHE_ENTRIES 32
+#endif
+
+/// Maximum plausible calibrated overhead of a single iteration in
+/// nanoseconds.
+#ifndef HAYAI_CALIBRATION_MAXIMUM_ITERATION_OVERHEAD
+#   define HAYAI_CALIBRATION_MAXIMUM_ITERATION_OVERHEAD 1000
+#endif
+
+/// Maximum plausible calibrated overhead of a run, a pause or a timed
+/// iteration in nanoseconds.
+#ifndef HAYAI_CALIBRATION_MAXIMUM_OVERHEAD
+#   define HAYAI_CALIBRATION_MAXIMUM_OVERHEAD 1000000
+#endif
+
+
+namespace hayai
+{
+    /// Persistent calibration cache.
+    class CalibrationCache
+    {
+    public:
+        /// Default cache file path.
+
+        /// @returns the default path of the cache file, or an empty string if
+        /// no suitable directory exists.
+        static std::string DefaultPath()
+        {
+#if defined(_WIN32)
+            const char* base = getenv("LOCALAPPDATA");
+            if ((!base) || (!*base))
+                return std::string();
+
+            return std::string(base) + "\\hayai\\calibration";
+#else
+            std::string base;
+            const char* cache = getenv("XDG_CACHE_HOME");
+            const char* home = getenv("HOME");
+
+            if ((cache) && (*cache))
+                base = cache;
+            else if ((home) && (*home))
+                base = std::string(home) + "/.cache";
+            else
+                return std::string();
+
+            return base + "/hayai/calibration";
+#endif
+        }
+
+
+        /// Key describing the current process.
+
+        /// @returns a key that differs whenever the calibration of the
+        /// current process may differ.
+        static std::string Key()
+        {
+            std::stringstream key;
+            key << HostName() << "|"
+                << ProcessorModel() << "|"
+                << (Clock::Backend() == ClockBackendTsc ? "tsc" : "system")
+                << "|" << BuildId();
+
+            // Tabs and line breaks are used as separators in the file.
+            std::string result = key.str();
+
+            for (std::string::iterator it = result.begin();
+                 it != result.end();
+                 ++it)
+                if ((*it == '\t') || (*it == '\n') || (*it == '\r'))
+                    *it = ' ';
+
+            return result;
+        }
+
+
+        /// Load calibration values.
+
+        /// @param path Cache file path.
+        /// @param key Key of the entry.
+        /// @param values Vector to hold the values on success.
+        /// @returns true if a plausible entry that has not expired exists for
+        /// the key.
+        static bool Load(const std::string& path,
+                         const std::string& key,
+                         std::vector<uint64_t>& values)
+        {
+            std::vector<Entry> entries = ReadEntries(path);
+
+            for (std::size_t index = 0; index < entries.size(); ++index)
+            {
+                if ((entries[index].Key == key) &&
+                    (IsPlausible(entries[index].Values)))
+                {
+                    values = entries[index].Values;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+
+        /// Store calibration values.
+
+        /// Replaces any existing entry for the key. Implausible values and
+        /// failure to write the cache file are silently ignored, as the
+        /// cache is only an optimization.
+        ///
+        /// @param path Cache file path.
+        /// @param key Key of the entry.
+        /// @param values Values.
+        static void Store(const std::string& path,
+                          const std::string& key,
+                          const std::vector<uint64_t>& values)
+        {
+            if (!IsPlausible(values))
+                return;
+
+            std::vector<Entry> entries = ReadEntries(path);
+
+            Entry entry;
+            entry.Time = uint64_t(time(NULL));
+            entry.Key = key;
+            entry.Values = values;
+
+            // Write the new entry first, followed by the most recent other
+            // entries.
+            if (!CreateParentDirectories(path))
+                return;
+
+            std::stringstream temporaryPath;
+            temporaryPath << path << ".tmp." << ProcessId();
+
+            {
+                std::ofstream stream(temporaryPath.str().c_str());
+                if (!stream)
+                    return;
+
+                WriteEntry(stream, entry);
+
+                std::size_t written = 1;
+                for (std::size_t index = 0;
+                     ((index < entries.size()) &&
+                      (written < HAYAI_CALIBRATION_CACHE_ENTRIES));
+                     ++index)
+                {
+                    if (entries[index].Key == key)
+                        continue;
+
+                    WriteEntry(stream, entries[index]);
+                    ++written;
+                }
+
+                if (!stream)
+                {
+                    stream.close();
+                    remove(temporaryPath.str().c_str());
+                    return;
+                }
+            }
+
+#if defined(_WIN32)
+            if (!MoveFileExA(temporaryPath.str().c_str(),
+                             path.c_str(),
+                             MOVEFILE_REPLACE_EXISTING))
+#else
+            if (rename(temporaryPath.str().c_str(), path.c_str()))
+#endif
+                remove(temporaryPath.str().c_str());
+        }
+
+
+        /// Check calibration values for plausibility.
+
+        /// @param values Scale, slope, intercept, pause overhead and sample
+        /// overhead.
+        /// @returns true if the values may result from a calibration.
+        static bool IsPlausible(const std::vector<uint64_t>& values)
+        {
+            if ((values.size() != 5) || (!values[0]))
+                return false;
+
+            if (double(values[1]) / double(values[0]) >
+                HAYAI_CALIBRATION_MAXIMUM_ITERATION_OVERHEAD)
+                return false;
+
+            for (std::size_t index = 2; index < values.size(); ++index)
+                if (values[index] > HAYAI_CALIBRATION_MAXIMUM_OVERHEAD)
+                    return false;
+
+            return true;
+        }
+    private:
+        /// Cache entry.
+        struct Entry
+        {
+            uint64_t Time;
+            std::string Key;
+            std::vector<uint64_t> Values;
+        };
+
+
+        /// Read the entries that have not expired.
+        static std::vector<Entry> ReadEntries(const std::string& path)
+        {
+            std::vector<Entry> entries;
+            std::ifstream stream(path.c_str());
+            std::string line;
+            const uint64_t now = uint64_t(time(NULL));
+
+            while (std::getline(stream, line))
+            {
+                const std::string::size_type keyStart = line.find('\t');
+                const std::string::size_type keyEnd =
+                    (keyStart == std::string::npos ?
+                     std::string::npos :
+                     line.find('\t', keyStart + 1));
+
+                if (keyEnd == std::string::npos)
+                    continue;
+
+                Entry entry;
+                std::stringstream timeStream(line.substr(0, keyStart));
+                std::stringstream valuesStream(line.substr(keyEnd + 1));
+                uint64_t value;
+
+                if (!(timeStream >> entry.Time))
+                    continue;
+
+                entry.Key = line.substr(keyStart + 1, keyEnd - keyStart - 1);
+
+                while (valuesStream >> value)
+                    entry.Values.push_back(value);
+
+                if ((entry.Values.empty()) ||
+                    (entry.Time > now) ||
+                    (now - entry.Time > HAYAI_CALIBRATION_CACHE_LIFETIME))
+                    continue;
+
+                entries.push_back(entry);
+            }
+
+            return entries;
+        }
+
+
+        /// Write an entry.
+        static void WriteEntry(std::ostream& stream, const Entry& entry)
+        {
+            stream << entry.Time << "\t" << entry.Key << "\t";
+
+            for (std::size_t index = 0; index < entry.Values.size(); ++index)
+                stream << (index ? " " : "") << entry.Values[index];
+
+            stream << "\n";
+        }
+
+
+        /// Create the parent directories of a path.
+
+        /// @returns true if the parent directory exists.
+        static bool CreateParentDirectories(const std::string& path)
+        {
+            std::string::size_type separator = 0;
+
+            while (true)
+            {
+                separator = path.find_first_of("/\\", separator + 1);
+                if (separator == std::string::npos)
+                    return true;
+
+                const std::string directory = path.substr(0, separator);
+#if defined(_WIN32)
+                if ((!CreateDirectoryA(directory.c_str(), NULL)) &&
+                    (GetLastError() != ERROR_ALREADY_EXISTS))
+                    return false;
+#else
+                struct stat status;
+                if ((stat(directory.c_str(), &status)) &&
+                    (mkdir(directory.c_str(), 0755)))
+                    return false;
+#endif
+            }
+        }
+
+
+        /// Process ID.
+        static unsigned long ProcessId()
+        {
+#if defined(_WIN32)
+            return (unsigned long)(GetCurrentProcessId());
+#else
+            return (unsigned long)(getpid());
+#endif
+        }
+
+
+        /// Host name.
+        static std::string HostName()
+        {
+            char name[256];
+#if defined(_WIN32)
+            DWORD size = sizeof(name);
+            if (!GetComputerNameA(name, &size))
+                return "unknown";
+#else
+            if (gethostname(name, sizeof(name)))
+                return "unknown";
+            name[sizeof(name) - 1] = 0;
+#endif
+            return name;
+        }
+
+
+        /// Processor model.
+        static std::string ProcessorModel()
+        {
+#if defined(__linux__)
+            std::ifstream stream("/proc/cpuinfo");
+            std::string line;
+
+            while (std::getline(stream, line))
+            {
+                if ((line.compare(0, 10, "model name")) &&
+                    (line.compare(0, 9, "Processor")) &&
+                    (line.compare(0, 8, "cpu mode")))
+                    continue;
+
+                const std::string::size_type start =
+                    line.find_first_not_of(" \t", line.find(':') + 1);
+                if ((line.find(':') != std::string::npos) &&
+                    (start != std::string::npos))
+                    return line.substr(start);
+            }
+#elif defined(__APPLE__) && defined(__MACH__)
+            char model[256];
+            std::size_t size = sizeof(model);
+
+            if (!sysctlbyname("machdep.cpu.brand_string",
+                              model,
+                              &size,
+                              NULL,
+                              0))
+                return std::string(model, size ? size - 1 : 0);
+#elif defined(_WIN32)
+            const char* identifier = getenv("PROCESSOR_IDENTIFIER");
+            if (identifier)
+                return identifier;
+#endif
+            return "unknown";
+        }
+
+
+#if defined(__linux__)
+        /// Find the GNU build ID of the executable.
+        static int FindBuildId(struct dl_phdr_info* info,
+                               std::size_t size,
+                               void* data)
+        {
+            (void)size;
+
+            // The executable is the first object reported.
+            std::string& buildId = *static_cast<std::string*>(data);
+
+            for (ElfW(Half) index = 0; index < info->dlpi_phnum; ++index)
+            {
+                const ElfW(Phdr)& header = info->dlpi_phdr[index];
+
+                if (header.p_type != PT_NOTE)
+                    continue;
+
+                const char* note = reinterpret_cast<const char*>(
+                    info->dlpi_addr + header.p_vaddr
+                );
+                const char* end = note + header.p_memsz;
+
+                while (note + sizeof(ElfW(Nhdr)) <= end)
+                {
+                    const ElfW(Nhdr)* noteHeader =
+                        reinterpret_cast<const ElfW(Nhdr)*>(note);
+                    const char* name = note + sizeof(ElfW(Nhdr));
+                    const unsigned char* desc =
+                        reinterpret_cast<const unsigned char*>(
+                            name + ((noteHeader->n_namesz + 3) & ~3u)
+                        );
+
+                    if ((noteHeader->n_type == NT_GNU_BUILD_ID) &&
+                        (noteHeader->n_namesz == 4) &&
+                        (!memcmp(name, "GNU", 4)))
+                    {
+                        std::stringstream stream;
+                        stream << std::hex;
+
+                        for (ElfW(Word) byte = 0;
+                             byte < noteHeader->n_descsz;
+                             ++byte)
+                            stream << ((desc[byte] >> 4) & 0xf)
+                                   << (desc[byte] & 0xf);
+
+                        buildId = stream.str();
+                        return 1;
+                    }
+
+                    note = reinterpret_cast<const char*>(desc) +
+                        ((noteHeader->n_descsz + 3) & ~3u);
+                }
+            }
+
+            return 1;
+        }
+#endif
+
+
+        /// Build identifier of the executable.
+        static std::string BuildId()
+        {
+            std::string executable;
+
+#if defined(__linux__)
+            std::string buildId;
+            dl_iterate_phdr(&CalibrationCache::FindBuildId, &buildId);
+
+            if (!buildId.empty())
+                return buildId;
+
+            executable = "/proc/self/exe";
+#elif defined(__APPLE__) && defined(__MACH__)
+            char path[4096];
+            uint32_t size = sizeof(path);
+
+            if (!_NSGetExecutablePath(path, &size))
+                executable = path;
+#endif
+
+#if !defined(_WIN32)
+            struct stat status;
+
+            if ((!executable.empty()) &&
+                (!stat(executable.c_str(), &status)))
+            {
+                std::stringstream stream;
+                stream << "mtime " << uint64_t(status.st_mtime)
+                       << " size " << uint64_t(status.st_size);
+                return stream.str();
+            }
+#endif
+
+            return "built " __DATE__ " " __TIME__;
+        }
+    };
+}
+#endif
@@ -31,6 +31,18 @@
 // measurements. Therefore, we are much better off having full control of what
 // mechanism we use to obtain the system clock.
 //
+// TSC backend:
+//
+// On x86 and x86-64 with GCC-compatible compilers, an alternative backend
+// reading the time stamp counter through rdtscp is available. The counter is
+// only used if the processor reports an invariant TSC (and rdtscp) through
+// CPUID, in which case the tick rate is calibrated against the system clock
+// once when the backend is activated. The backend is enabled either by
+// defining HAYAI_CLOCK_TSC at compile time or by calling
+// Clock::SetBackend(ClockBackendTsc), eg. through --clock tsc. If the check
+// fails, the system clock described above is used instead. Defining
+// HAYAI_NO_TSC_CLOCK removes the backend entirely.
+//
 // Note on durations: it is assumed that end times passed to the clock methods
 // are all after the start time. Wrap-around of clocks is not tested, as
 // nanosecond precision of unsigned 64-bit integers would require an uptime of
@@ -80,13 +92,26 @@
 
 #include <stdexcept>
 #include <stdint.h>
+#include <string>
+
+// TSC
+#if !defined(HAYAI_NO_TSC_CLOCK) && \
+    (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(_WIN32)
+#   define HAYAI_TSC_CLOCK_AVAILABLE
+#   include <cpuid.h>
+#   include <algorithm>
+#   include <iomanip>
+#   include <sstream>
+#endif
 
 
 namespace hayai
 {
 // Win32
 #if defined(_WIN32)
-    class Clock
+    class SystemClock
     {
     public:
         /// Time point.
@@ -143,7 +168,7 @@ namespace hayai
 
 // Mach kernel.
 #elif defined(__APPLE__) && defined(__MACH__)
-    class Clock
+    class SystemClock
     {
     public:
         /// Time point.
@@ -191,7 +216,7 @@ namespace hayai
 
 // gethrtime
 #   if (defined(__hpux) || defined(hpux)) || ((defined(__sun__) || defined(__sun) || defined(sun)) && (defined(__SVR4) || defined(__svr4__)))
-    class Clock
+    class SystemClock
     {
     public:
         /// Time point.
@@ -234,7 +259,7 @@ namespace hayai
 
 // clock_gettime
 #   elif defined(_POSIX_TIMERS) && (_POSIX_TIMERS > 0)
-    class Clock
+    class SystemClock
     {
     public:
         /// Time point.
@@ -307,7 +332,7 @@ namespace hayai
 
 // gettimeofday
 #   else
-    class Clock
+    class SystemClock
     {
     public:
         /// Time point.
@@ -363,5 +388,287 @@ namespace hayai
     };
 #   endif
 #endif
+
+
+    /// Clock backend.
+    enum ClockBackend
+    {
+        /// System clock.
+
+        /// The platform specific clock described by @ref SystemClock.
+        ClockBackendSystem,
+
+
+        /// Time stamp counter.
+
+        /// Only available on x86 processors with an invariant TSC.
+        ClockBackendTsc
+    };
+
+
+#if defined(HAYAI_TSC_CLOCK_AVAILABLE)
+    /// Time stamp counter clock.
+
+    /// Reads the time stamp counter of the executing core. Only meaningful if
+    /// @ref IsSupported returns true, in which case the counter runs at a
+    /// constant rate across cores and power states.
+    class TscClock
+    {
+    public:
+        /// Time point.
+
+        /// Time stamp counter ticks.
+        typedef uint64_t TimePoint;
+
+
+        /// Get the current time as a time point.
+
+        /// rdtscp waits for all preceding instructions to execute before
+        /// reading the counter, and the trailing lfence prevents subsequent
+        /// instructions from starting before the counter has been read. This
+        /// makes the same sequence suitable for both ends of a measurement.
+        ///
+        /// @returns the current time point.
+        static TimePoint Now() __hayai_noexcept
+        {
+            uint32_t low, high;
+            __asm__ __volatile__("rdtscp\n\t"
+                                 "lfence"
+                                 : "=a" (low), "=d" (high)
+                                 :
+                                 : "%ecx", "memory");
+            return (static_cast<uint64_t>(high) << 32) | low;
+        }
+
+
+        /// Test if the time stamp counter is usable.
+
+        /// @returns true if the processor supports rdtscp and reports an
+        /// invariant time stamp counter.
+        static bool IsSupported()
+        {
+            unsigned int eax, ebx, ecx, edx;
+
+            if ((!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx)) ||
+                (eax < 0x80000007))
+                return false;
+
+            // RDTSCP: CPUID.80000001H:EDX[27].
+            __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx);
+            if (!(edx & (1u << 27)))
+                return false;
+
+            // Invariant TSC: CPUID.80000007H:EDX[8].
+            __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+            return ((edx & (1u << 8)) != 0);
+        }
+
+
+        /// Measure the tick rate against the system clock.
+
+        /// Performs three measurements of 10 ms each and uses the median.
+        ///
+        /// @returns the number of nanoseconds per tick.
+        static double CalibrateNanosecondsPerTick()
+        {
+            double samples[3];
+
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                SystemClock::TimePoint systemStart, systemEnd;
+                TimePoint tscStart, tscEnd;
+                uint64_t elapsed;
+
+                systemStart = SystemClock::Now();
+                tscStart = Now();
+
+                do
+                {
+                    systemEnd = SystemClock::Now();
+                    tscEnd = Now();
+                    elapsed = SystemClock::Duration(systemStart, systemEnd);
+                }
+                while (elapsed < 10000000);
+
+                samples[i] = double(elapsed) / double(tscEnd - tscStart);
+            }
+
+            std::sort(samples, samples + 3);
+            return samples[1];
+        }
+    };
+#endif
+
+
+    /// Clock.
+
+    /// Front for the active clock backend. Time points are expressed in
+    /// backend specific units and must only be compared through
+    /// @ref Duration.
+#if defined(HAYAI_TSC_CLOCK_AVAILABLE)
+    class Clock
+    {
+    public:
+        /// Time point.
+
+        /// Opaque representation of a point in time.
+        typedef uint64_t TimePoint;
+
+
+        /// Get the current time as a time point.
+
+        /// @returns the current time point.
+        static TimePoint Now() __hayai_noexcept
+        {
+            if (Active<void>::State.Backend == ClockBackendTsc)
+                return TscClock::Now();
+
+            return SystemClock::Duration(SystemClock::TimePoint(),
+                                         SystemClock::Now());
+        }
+
+
+        /// Get the duration between two time points.
+
+        /// @param startTime Start time point.
+        /// @param endTime End time point.
+        /// @returns the number of nanoseconds elapsed between the two time
+        /// points.
+        static uint64_t Duration(const TimePoint& startTime,
+                                 const TimePoint& endTime) __hayai_noexcept
+        {
+            const BackendState& state = Active<void>::State;
+
+            if (state.Backend == ClockBackendTsc)
+                return static_cast<uint64_t>(
+                    double(endTime - startTime) * state.NanosecondsPerTick
+                );
+
+            return endTime - startTime;
+        }
+
+
+        /// Select the clock backend.
+
+        /// Selecting @ref ClockBackendTsc calibrates the time stamp counter
+        /// against the system clock, which takes around 30 ms. Must not be
+        /// called while other threads are reading the clock.
+        ///
+        /// @param backend Requested backend.
+        /// @returns true if the backend is in use, or false if it is not
+        /// supported, in which case the system clock is used.
+        static bool SetBackend(ClockBackend backend)
+        {
+            Active<void>::State = Resolve(backend);
+            return (Active<void>::State.Backend == backend);
+        }
+
+
+        /// Active clock backend.
+        static ClockBackend Backend()
+        {
+            return Active<void>::State.Backend;
+        }
+
+
+        /// Clock implementation description.
+
+        /// @returns a description of the clock implementation used.
+        static std::string Description()
+        {
+            const BackendState& state = Active<void>::State;
+
+            if (state.Backend != ClockBackendTsc)
+                return SystemClock::Description();
+
+            std::ostringstream stream;
+            stream << "rdtscp (invariant TSC, " << std::fixed
+                   << std::setprecision(3)
+                   << (1.0 / state.NanosecondsPerTick) << " GHz)";
+            return stream.str();
+        }
+    private:
+        /// Backend state.
+        struct BackendState
+        {
+            ClockBackend Backend;
+            double NanosecondsPerTick;
+        };
+
+
+        /// Active backend state.
+
+        /// A static member of a class template, so that the header can
+        /// define it. The backend is resolved once during static
+        /// initialization rather than checked on every reading of the clock.
+        template<typename Dummy>
+        struct Active
+        {
+            static BackendState State;
+        };
+
+
+        /// Resolve the state of a backend.
+
+        /// @param backend Requested backend.
+        /// @returns the state of the backend, or of the system clock if the
+        /// backend is not supported.
+        static BackendState Resolve(ClockBackend backend)
+        {
+            BackendState state = { ClockBackendSystem, 0.0 };
+
+            if ((backend == ClockBackendTsc) && (TscClock::IsSupported()))
+            {
+                state.NanosecondsPerTick =
+                    TscClock::CalibrateNanosecondsPerTick();
+                state.Backend = ClockBackendTsc;
+            }
+
+            return state;
+        }
+    };
+
+
+    // The default system backend is constant initialized, so that the clock
+    // can be read during the static initialization of other units.
+    template<typename Dummy>
+    Clock::BackendState Clock::Active<Dummy>::State =
+#   if defined(HAYAI_CLOCK_TSC)
+        Clock::Resolve(ClockBackendTsc);
+#   else
+        { ClockBackendSystem, 0.0 };
+#   endif
+#else
+    class Clock
+        :   public SystemClock
+    {
+    public:
+        /// Select the clock backend.
+
+        /// @param backend Requested backend.
+        /// @returns true if the backend is in use. Only the system clock is
+        /// available on this platform.
+        static bool SetBackend(ClockBackend backend)
+        {
+            return (backend == ClockBackendSystem);
+        }
+
+
+        /// Active clock backend.
+        static ClockBackend Backend()
+        {
+            return ClockBackendSystem;
+        }
+
+
+        /// Clock implementation description.
+
+        /// @returns a description of the clock implementation used.
+        static std::string Description()
+        {
+            return SystemClock::Description();
+        }
+    };
+#endif
 }
 #endif
@@ -0,0 +1,386 @@
+//
+// Asymptotic complexity fitting.
+//
+// Implementation notes:
+//
+// The time per iteration of each instance of a parametrized benchmark is
+// paired with the value of the parameter that describes the problem size,
+// and each candidate function g(n) is fitted to these points by least
+// squares through the origin, ie. the coefficient c minimizes the sum of
+// (t - c g(n))^2 and is the sum of t g(n) divided by the sum of g(n)^2.
+//
+// The candidates are compared by their root mean square error relative to
+// the mean time, so that the error does not depend on the unit of the times,
+// and the candidate with the lowest error is the best fit. As the fits do
+// not have an intercept, a fixed cost per iteration that dominates at small
+// sizes favours the slower growing candidates, so the sizes should span at
+// least two orders of magnitude.
+//
+#ifndef __HAYAI_COMPLEXITY
+#define __HAYAI_COMPLEXITY
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "hayai_test_descriptor.hpp"
+
+
+namespace hayai
+{
+    /// Function of the problem size.
+    typedef double (*ComplexityFunction)(double n);
+
+
+    /// Order of complexity.
+    enum ComplexityOrder
+    {
+        /// O(1).
+        ComplexityConstant,
+
+
+        /// O(log n).
+        ComplexityLogarithmic,
+
+
+        /// O(n).
+        ComplexityLinear,
+
+
+        /// O(n log n).
+        ComplexityLinearithmic,
+
+
+        /// O(n^2).
+        ComplexityQuadratic,
+
+
+        /// User-supplied function.
+        ComplexityUser
+    };
+
+
+    /// Fit of a complexity function.
+    struct ComplexityCandidate
+    {
+        ComplexityCandidate(ComplexityOrder order = ComplexityConstant,
+                            const std::string& name = std::string())
+            :   Order(order),
+                Name(name),
+                Coefficient(0.0),
+                RmsError(0.0)
+        {
+
+        }
+
+
+        /// Order of complexity.
+        ComplexityOrder Order;
+
+
+        /// Name, eg. "O(n log n)".
+        std::string Name;
+
+
+        /// Coefficient of the function in nanoseconds.
+        double Coefficient;
+
+
+        /// Root mean square error relative to the mean time.
+        double RmsError;
+    };
+
+
+    /// Complexity fit over the instances of a parametrized benchmark.
+    class ComplexityFit
+    {
+    public:
+        /// Initialize a complexity fit.
+
+        /// @param parameter Name of the parameter that describes the problem
+        /// size.
+        /// @param parameters Other parameters shared by the instances.
+        ComplexityFit(const std::string& parameter = std::string(),
+                      const TestParametersDescriptor& parameters =
+                          TestParametersDescriptor())
+            :   _parameter(parameter),
+                _parameters(parameters),
+                _best(0)
+        {
+
+        }
+
+
+        /// Add the result of an instance.
+
+        /// @param size Problem size.
+        /// @param time Time per iteration in nanoseconds.
+        void AddPoint(double size, double time)
+        {
+            _sizes.push_back(size);
+            _times.push_back(time);
+        }
+
+
+        /// Fit the candidate functions to the points.
+
+        /// @param function User-supplied function of the problem size to fit
+        /// in addition to the standard orders, or NULL.
+        /// @param functionName Name of the user-supplied function.
+        /// @returns true if the points span at least two problem sizes and
+        /// at least one candidate could be fitted.
+        bool Fit(ComplexityFunction function = NULL,
+                 const std::string& functionName = "f")
+        {
+            _candidates.clear();
+            _best = 0;
+
+            bool distinct = false;
+            for (std::size_t i = 1; i < _sizes.size(); ++i)
+                if (_sizes[i] != _sizes[0])
+                    distinct = true;
+
+            if (!distinct)
+                return false;
+
+            AddCandidate(ComplexityConstant, "O(1)", Constant);
+            AddCandidate(ComplexityLogarithmic, "O(log n)", Logarithmic);
+            AddCandidate(ComplexityLinear, "O(n)", Linear);
+            AddCandidate(ComplexityLinearithmic, "O(n log n)", Linearithmic);
+            AddCandidate(ComplexityQuadratic, "O(n^2)", Quadratic);
+
+            if (function)
+                AddCandidate(ComplexityUser,
+                             "O(" + functionName + "(n))",
+                             function);
+
+            // The simplest of equally good candidates is preferred.
+            for (std::size_t i = 1; i < _candidates.size(); ++i)
+                if (_candidates[i].RmsError < _candidates[_best].RmsError)
+                    _best = i;
+
+            return !_candidates.empty();
+        }
+
+
+        /// Name of the parameter that describes the problem size.
+        inline const std::string& Parameter() const
+        {
+            return _parameter;
+        }
+
+
+        /// Other parameters shared by the instances.
+        inline const TestParametersDescriptor& Parameters() const
+        {
+            return _parameters;
+        }
+
+
+        /// Problem sizes of the instances.
+        inline const std::vector<double>& Sizes() const
+        {
+            return _sizes;
+        }
+
+
+        /// Times per iteration of the instances in nanoseconds.
+        inline const std::vector<double>& Times() const
+        {
+            return _times;
+        }
+
+
+        /// Fitted candidates.
+        inline const std::vector<ComplexityCandidate>& Candidates() const
+        {
+            return _candidates;
+        }
+
+
+        /// Best fit.
+
+        /// Only valid if @ref Fit succeeded.
+        inline const ComplexityCandidate& Best() const
+        {
+            return _candidates[_best];
+        }
+
+
+        /// Problem size of an instance.
+
+        /// @param parameters Parameters of the instance.
+        /// @param parameter Name of the parameter that describes the problem
+        /// size.
+        /// @param size Problem size on success.
+        /// @returns true if the instance has the parameter and its value is
+        /// a number.
+        static bool ProblemSize(const TestParametersDescriptor& parameters,
+                                const std::string& parameter,
+                                double& size)
+        {
+            const std::vector<TestParameterDescriptor>& descs =
+                parameters.Parameters();
+
+            for (std::size_t i = 0; i < descs.size(); ++i)
+            {
+                if (!IsParameter(descs[i], parameter))
+                    continue;
+
+                // Integer suffixes are allowed after the number.
+                const char* value = descs[i].Value.c_str();
+                char* valueEnd;
+                size = strtod(value, &valueEnd);
+
+                if (valueEnd == value)
+                    return false;
+
+                while ((*valueEnd == 'u') || (*valueEnd == 'U') ||
+                       (*valueEnd == 'l') || (*valueEnd == 'L'))
+                    ++valueEnd;
+
+                return (*valueEnd == '\0');
+            }
+
+            return false;
+        }
+
+
+        /// Parameters of an instance other than the problem size.
+
+        /// @param parameters Parameters of the instance.
+        /// @param parameter Name of the parameter that describes the problem
+        /// size.
+        static TestParametersDescriptor OtherParameters(
+            const TestParametersDescriptor& parameters,
+            const std::string& parameter
+        )
+        {
+            const std::vector<TestParameterDescriptor>& descs =
+                parameters.Parameters();
+            TestParametersDescriptor others;
+
+            for (std::size_t i = 0; i < descs.size(); ++i)
+                if (!IsParameter(descs[i], parameter))
+                    others.AddParameter(descs[i].Declaration, descs[i].Value);
+
+            return others;
+        }
+    private:
+        /// Test if a parameter has a name.
+
+        /// The name is the last identifier of the declaration.
+        static bool IsParameter(const TestParameterDescriptor& desc,
+                                const std::string& name)
+        {
+            const std::string& declaration = desc.Declaration;
+            std::size_t end = declaration.size();
+
+            while ((end > 0) && (!IsIdentifier(declaration[end - 1])))
+                --end;
+
+            std::size_t start = end;
+
+            while ((start > 0) && (IsIdentifier(declaration[start - 1])))
+                --start;
+
+            return (!declaration.compare(start, end - start, name));
+        }
+
+
+        static double Constant(double n)
+        {
+            (void)n;
+            return 1.0;
+        }
+
+
+        static double Logarithmic(double n)
+        {
+            return std::log(n) / std::log(2.0);
+        }
+
+
+        static double Linear(double n)
+        {
+            return n;
+        }
+
+
+        static double Linearithmic(double n)
+        {
+            return n * Logarithmic(n);
+        }
+
+
+        static double Quadratic(double n)
+        {
+            return n * n;
+        }
+
+
+        static bool IsIdentifier(char c)
+        {
+            return (((c >= 'a') && (c <= 'z')) ||
+                    ((c >= 'A') && (c <= 'Z')) ||
+                    ((c >= '0') && (c <= '9')) ||
+                    (c == '_'));
+        }
+
+
+        /// Fit a candidate function and add it if it is defined for every
+        /// problem size.
+        void AddCandidate(ComplexityOrder order,
+                          const std::string& name,
+                          ComplexityFunction function)
+        {
+            const std::size_t count = _sizes.size();
+            std::vector<double> values(count);
+            double sumProducts = 0.0;
+            double sumSquares = 0.0;
+            double sumTimes = 0.0;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                values[i] = function(_sizes[i]);
+
+                // Reject non-finite values.
+                if (!(values[i] - values[i] == 0.0))
+                    return;
+
+                sumProducts += _times[i] * values[i];
+                sumSquares += values[i] * values[i];
+                sumTimes += _times[i];
+            }
+
+            if ((sumSquares <= 0.0) || (sumTimes <= 0.0))
+                return;
+
+            ComplexityCandidate candidate(order, name);
+            candidate.Coefficient = sumProducts / sumSquares;
+
+            double sumErrors = 0.0;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const double error =
+                    _times[i] - candidate.Coefficient * values[i];
+                sumErrors += error * error;
+            }
+
+            candidate.RmsError = std::sqrt(sumErrors / double(count)) /
+                (sumTimes / double(count));
+
+            _candidates.push_back(candidate);
+        }
+
+
+        std::string _parameter;
+        TestParametersDescriptor _parameters;
+        std::vector<double> _sizes;
+        std::vector<double> _times;
+        std::vector<ComplexityCandidate> _candidates;
+        std::size_t _best;
+    };
+}
+#endif
@@ -1,7 +1,18 @@
 #ifndef __HAYAI_CONSOLEOUTPUTTER
 #define __HAYAI_CONSOLEOUTPUTTER
+#include <algorithm>
+#include <sstream>
+
 #include "hayai_outputter.hpp"
 #include "hayai_console.hpp"
+#include "hayai_environment.hpp"
+
+
+/// Fraction of outlying runs above which the console outputter warns about a
+/// noisy machine.
+#ifndef HAYAI_OUTLIER_WARNING_FRACTION
+#   define HAYAI_OUTLIER_WARNING_FRACTION 0.1
+#endif
 
 
 namespace hayai
@@ -68,6 +79,27 @@ namespace hayai
         }
 
 
+        virtual void Metadata(const std::vector<
+                                  std::pair<std::string, std::string>
+                              >& metadata)
+        {
+            for (std::size_t index = 0; index < metadata.size(); ++index)
+                _stream << Console::TextBlue << "[ METADATA ]"
+                        << Console::TextDefault << " "
+                        << metadata[index].first << ": "
+                        << metadata[index].second << std::endl;
+
+            // Warn about settings likely to distort the results.
+            const std::vector<std::string> warnings =
+                Environment::Warnings(metadata);
+
+            for (std::size_t index = 0; index < warnings.size(); ++index)
+                _stream << Console::TextRed << "[ WARNING  ]"
+                        << Console::TextDefault << " " << warnings[index]
+                        << std::endl;
+        }
+
+
         inline void BeginOrSkipTest(const std::string& fixtureName,
                                     const std::string& testName,
                                     const TestParametersDescriptor& parameters,
@@ -178,6 +210,37 @@ namespace hayai
                     << (result.TimeTotal() / 1000000.0) << " ms)"
                     << std::endl;
 
+            if (result.WarmUpRuns())
+                _stream << Console::TextBlue << "[ WARM UP  ]"
+                        << Console::TextDefault << " Discarded "
+                        << result.WarmUpRuns()
+                        << (result.WarmUpRuns() == 1 ?
+                            " warm-up run" :
+                            " warm-up runs")
+                        << std::endl;
+
+            if (result.IsAdaptive())
+            {
+                const std::size_t runs = result.RunTimes().size();
+
+                if (result.Converged())
+                    _stream << Console::TextBlue << "[ ADAPTIVE ]"
+                            << Console::TextDefault << " Converged after ";
+                else
+                    _stream << Console::TextRed << "[ UNSTABLE ]"
+                            << Console::TextDefault
+                            << " Did not converge after ";
+
+                _stream << runs << (runs == 1 ? " run" : " runs")
+                        << " (confidence interval width: "
+                        << std::setprecision(2)
+                        << (result.RelativeConfidenceIntervalWidth() * 100.0)
+                        << (result.Converged() ? " % <= " : " % > ")
+                        << (result.TargetRelativeConfidenceIntervalWidth() *
+                            100.0)
+                        << " %)" << std::endl;
+            }
+
             _stream << Console::TextBlue << "[   RUNS   ] "
                     << Console::TextDefault
                     << "       Average time: "
@@ -202,6 +265,19 @@ namespace hayai
                 result.RunTimeQuartile1() / 1000.0 << " us | 3rd quartile: " <<
                 result.RunTimeQuartile3() / 1000.0 << " us" <<
                 Console::TextDefault << ")");
+            PAD("Percentile times: " <<
+                Console::TextCyan << "p50: " <<
+                result.RunTimePercentile(50.0) / 1000.0 << " | p90: " <<
+                result.RunTimePercentile(90.0) / 1000.0 << " | p99: " <<
+                result.RunTimePercentile(99.0) / 1000.0 << " | p99.9: " <<
+                result.RunTimePercentile(99.9) / 1000.0 << " | max: " <<
+                result.RunTimeMaximum() / 1000.0 << " us" <<
+                Console::TextDefault);
+
+            if (result.HasConfidenceIntervals())
+                WriteConfidenceIntervals(result.RunTimeAverageInterval(),
+                                         result.RunTimeMedianInterval(),
+                                         result.ConfidenceLevel());
 
             _stream << std::setprecision(5);
 
@@ -249,6 +325,26 @@ namespace hayai
                 " us | 3rd quartile: " <<
                 result.IterationTimeQuartile3() / 1000.0 << " us" <<
                 Console::TextDefault << ")");
+            if (!result.IsSampled())
+                PAD("Percentile times: " <<
+                    Console::TextCyan << "p50: " <<
+                    result.IterationTimePercentile(50.0) / 1000.0 <<
+                    " | p90: " <<
+                    result.IterationTimePercentile(90.0) / 1000.0 <<
+                    " | p99: " <<
+                    result.IterationTimePercentile(99.0) / 1000.0 <<
+                    " | p99.9: " <<
+                    result.IterationTimePercentile(99.9) / 1000.0 <<
+                    " | max: " <<
+                    result.IterationTimeMaximum() / 1000.0 << " us" <<
+                    Console::TextDefault);
+
+            if (result.HasConfidenceIntervals())
+                WriteConfidenceIntervals(
+                    result.IterationTimeAverageInterval(),
+                    result.IterationTimeMedianInterval(),
+                    result.ConfidenceLevel()
+                );
 
             _stream << std::setprecision(5);
 
@@ -272,12 +368,416 @@ namespace hayai
                 result.IterationsPerSecondQuartile3() <<
                 Console::TextDefault << ")");
 
+            // Regression on linearly increasing iteration counts.
+            if (result.IsLinear())
+            {
+                const LinearRegression& regression =
+                    result.IterationTimeRegression();
+                std::stringstream confidence;
+                confidence << result.RegressionConfidenceLevel() * 100.0
+                           << " % confidence";
+                std::size_t minimumIterations = result.RunIterations(0);
+                std::size_t maximumIterations = minimumIterations;
+
+                for (std::size_t run = 1;
+                     run < result.RunTimes().size();
+                     ++run)
+                {
+                    minimumIterations = std::min(minimumIterations,
+                                                 result.RunIterations(run));
+                    maximumIterations = std::max(maximumIterations,
+                                                 result.RunIterations(run));
+                }
+
+                PAD("");
+                _stream << std::setprecision(3)
+                        << Console::TextBlue << "[  LINEAR  ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Iterations: " << minimumIterations
+                        << " to " << maximumIterations
+                        << " per run (run statistics scaled to "
+                        << result.Iterations() << ")" << std::endl;
+                PAD("Time per iteration: " <<
+                    regression.Slope / 1000.0 << " us (" <<
+                    Console::TextCyan << regression.SlopeLower / 1000.0 <<
+                    " to " << regression.SlopeUpper / 1000.0 << " us, " <<
+                    confidence.str() << Console::TextDefault << ")");
+                PAD("Fixed time per run: " <<
+                    regression.Intercept / 1000.0 << " us");
+                PAD("Coefficient of determination: " <<
+                    (regression.RSquared < 0.9 ?
+                     Console::TextRed :
+                     Console::TextDefault) <<
+                    std::setprecision(4) << regression.RSquared <<
+                    Console::TextDefault);
+                _stream << std::setprecision(5);
+            }
+
+            // Outliers.
+            const std::size_t outliers =
+                result.MildOutliers() + result.SevereOutliers();
+
+            if ((outliers) || (result.MadOutliers()))
+            {
+                const bool noisy =
+                    (result.OutlierFraction() >
+                     HAYAI_OUTLIER_WARNING_FRACTION);
+
+                PAD("");
+                _stream << (noisy ? Console::TextRed : Console::TextBlue)
+                        << "[ OUTLIERS ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Outliers: " << outliers << " of "
+                        << result.RunTimes().size() << " runs ("
+                        << Console::TextCyan
+                        << result.MildOutliers() << " mild | "
+                        << result.SevereOutliers() << " severe | "
+                        << result.MadOutliers() << " by MAD"
+                        << Console::TextDefault << ")" << std::endl
+                        << std::setprecision(3);
+                PAD("Trimmed average time: " <<
+                    result.IterationTimeTrimmedAverage() / 1000.0 <<
+                    " us (" << Console::TextBlue << "~" <<
+                    result.IterationTimeTrimmedStdDev() / 1000.0 <<
+                    " us" << Console::TextDefault << ")");
+
+                if (noisy)
+                    PAD("Warning: " << Console::TextRed <<
+                        std::setprecision(1) <<
+                        result.OutlierFraction() * 100.0 <<
+                        " % of the runs are outliers, which suggests a " <<
+                        "noisy machine" << Console::TextDefault);
+
+                _stream << std::setprecision(5);
+            }
+
+            // Sampled iterations.
+            if (result.IsSampled())
+            {
+                const Histogram& samples = result.IterationTimeHistogram();
+
+                PAD("");
+                _stream << Console::TextBlue << "[ SAMPLES  ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Samples: " << samples.TotalCount()
+                        << " (";
+
+                if (result.SampleInterval() == 1)
+                    _stream << "every iteration)";
+                else
+                    _stream << "1 in " << result.SampleInterval()
+                            << " iterations)";
+
+                _stream << std::endl << std::setprecision(3);
+
+                WriteHistogramSummary("Average time: ",
+                                      "Percentile times: ",
+                                      samples);
+
+                _stream << std::setprecision(5);
+            }
+
+            // Open-loop load.
+            if (result.IsOpenLoop())
+            {
+                PAD("");
+                _stream << Console::TextBlue << "[ LOAD     ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Offered load: " << result.OfferedRate()
+                        << " iterations/s" << std::endl;
+                PAD("Achieved throughput: " <<
+                    (result.AchievedRate() <
+                     result.OfferedRate() * 0.99 ?
+                     Console::TextRed :
+                     Console::TextDefault) <<
+                    result.AchievedRate() << " iterations/s" <<
+                    Console::TextDefault);
+
+                _stream << std::setprecision(3);
+                WriteHistogramSummary("Average latency: ",
+                                      "Percentile latencies: ",
+                                      result.LatencyHistogram());
+                _stream << std::setprecision(5);
+
+                if (result.IsSaturated())
+                    _stream << Console::TextRed << "[ KNEE     ]"
+                            << Console::TextDefault
+                            << " Saturated at this load, saturation "
+                            << "throughput: " << result.SaturationRate()
+                            << " iterations/s" << std::endl;
+            }
+
+            // Threads.
+            if (result.IsThreaded())
+            {
+                double fastest = 0.0;
+                double slowest = 0.0;
+
+                for (std::size_t thread = 0;
+                     thread < result.Threads();
+                     ++thread)
+                {
+                    const double performance =
+                        result.ThreadIterationsPerSecondAverage(thread);
+
+                    if ((!thread) || (performance > fastest))
+                        fastest = performance;
+                    if ((!thread) || (performance < slowest))
+                        slowest = performance;
+                }
+
+                PAD("");
+                _stream << Console::TextBlue << "[ THREADS  ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Threads: " << result.Threads() << std::endl;
+                PAD("Aggregate performance: " <<
+                    result.AggregateIterationsPerSecondAverage() <<
+                    " iterations/s");
+                PAD_DEVIATION("Fastest thread: ",
+                              fastest,
+                              (result.IterationsPerSecondAverage()),
+                              "iterations/s");
+                PAD_DEVIATION("Slowest thread: ",
+                              slowest,
+                              (result.IterationsPerSecondAverage()),
+                              "iterations/s");
+            }
+
+            // Performance counters.
+            const std::vector<std::string>& counterNames =
+                result.PerformanceCounterNames();
+
+            if (!counterNames.empty())
+            {
+                std::size_t cycles = counterNames.size();
+                std::size_t instructions = counterNames.size();
+
+                PAD("");
+                _stream << std::setprecision(3);
+
+                for (std::size_t counter = 0;
+                     counter < counterNames.size();
+                     ++counter)
+                {
+                    if (counterNames[counter] == "cycles")
+                        cycles = counter;
+                    else if (counterNames[counter] == "instructions")
+                        instructions = counter;
+
+                    if (counter == 0)
+                        _stream << Console::TextBlue << "[ COUNTERS ] "
+                                << Console::TextDefault << std::setw(21);
+                    else
+                        _stream << std::setw(34);
+
+                    _stream << (counterNames[counter] + ": ")
+                            << result.PerformanceCounterIterationAverage(
+                                counter
+                            )
+                            << " per iteration" << std::endl;
+                }
+
+                if ((cycles < counterNames.size()) &&
+                    (instructions < counterNames.size()))
+                    PAD("Instructions per cycle: " <<
+                        result.PerformanceCounterIterationAverage(
+                            instructions
+                        ) /
+                        result.PerformanceCounterIterationAverage(cycles));
+            }
+
+            // Resource usage per run.
+            if (result.HasResourceUsage())
+            {
+                const ResourceUsage usage = result.TotalResourceUsage();
+                const double runs = double(result.RunResourceUsage().size());
+
+                PAD("");
+                _stream << std::setprecision(1)
+                        << Console::TextBlue << "[ RESOURCE ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Page faults: "
+                        << double(usage.MinorFaults) / runs << " minor | "
+                        << (usage.MajorFaults ?
+                            Console::TextRed :
+                            Console::TextDefault)
+                        << double(usage.MajorFaults) / runs << " major"
+                        << Console::TextDefault << " per run" << std::endl;
+                PAD("Context switches: " <<
+                    double(usage.VoluntaryContextSwitches) / runs <<
+                    " voluntary | " <<
+                    double(usage.InvoluntaryContextSwitches) / runs <<
+                    " involuntary per run");
+                PAD("CPU time: " << std::setprecision(3) <<
+                    double(usage.UserTime) / runs / 1000.0 << " us user | " <<
+                    double(usage.SystemTime) / runs / 1000.0 <<
+                    " us system per run");
+                PAD("Peak RSS growth: " <<
+                    usage.PeakResidentSetSize / 1024 << " kB");
+                _stream << std::setprecision(5);
+            }
+
+            // Baseline comparison.
+            if (result.HasBaselineComparison())
+            {
+                const BaselineComparison& comparison =
+                    result.BaselineComparisonResult();
+
+                PAD("");
+                _stream << std::setprecision(3)
+                        << Console::TextBlue << "[ BASELINE ] "
+                        << Console::TextDefault << std::setw(21)
+                        << "Baseline median: "
+                        << comparison.BaselineMedian / 1000.0
+                        << " us/iteration" << std::endl;
+                PAD("Median: " << comparison.Median / 1000.0 <<
+                    " us/iteration");
+
+                _stream << std::setw(34) << "Change: ";
+
+                switch (comparison.Change)
+                {
+                case BaselineImproved:
+                    _stream << Console::TextGreen << "improved";
+                    break;
+
+                case BaselineRegressed:
+                    _stream << Console::TextRed << "regressed";
+                    break;
+
+                default:
+                    _stream << "unchanged";
+                    break;
+                }
+
+                _stream << Console::TextDefault << " ("
+                        << std::showpos << std::setprecision(3)
+                        << comparison.RelativeChange * 100.0 << " %, "
+                        << Console::TextBlue << "CI: "
+                        << comparison.RelativeChangeLower * 100.0 << " % to "
+                        << comparison.RelativeChangeUpper * 100.0 << " %"
+                        << std::noshowpos << ", p = "
+                        << comparison.PValue
+                        << Console::TextDefault << ")" << std::endl;
+            }
+
 #undef PAD_DEVIATION_INVERSE
 #undef PAD_DEVIATION
 #undef PAD
         }
 
 
+        virtual void FailTest(const std::string& fixtureName,
+                              const std::string& testName,
+                              const TestParametersDescriptor& parameters,
+                              const std::string& reason)
+        {
+            _stream << Console::TextRed << "[  FAILED  ]"
+                    << Console::TextYellow << " ";
+            WriteTestNameToStream(_stream, fixtureName, testName, parameters);
+            _stream << Console::TextDefault << " (" << reason << ")"
+                    << std::endl;
+        }
+
+
+        virtual void Complexity(const std::string& fixtureName,
+                                const std::string& testName,
+                                const ComplexityFit& fit)
+        {
+            const ComplexityCandidate& best = fit.Best();
+            const std::vector<ComplexityCandidate>& candidates =
+                fit.Candidates();
+
+            // Format the coefficient without the fixed precision of the
+            // stream, as it spans many orders of magnitude.
+            std::stringstream coefficient;
+            coefficient << best.Coefficient << " ns";
+
+            _stream << Console::TextGreen << "[COMPLEXITY]"
+                    << Console::TextYellow << " ";
+            WriteTestNameToStream(_stream,
+                                  fixtureName,
+                                  testName,
+                                  fit.Parameters());
+            _stream << Console::TextDefault << " ("
+                    << fit.Sizes().size() << " instances over "
+                    << fit.Parameter() << ")" << std::endl
+                    << std::setprecision(2)
+                    << std::setw(34) << "Best fit: "
+                    << Console::TextGreen << best.Name
+                    << Console::TextDefault << std::endl
+                    << std::setw(34) << "Coefficient: "
+                    << coefficient.str() << std::endl
+                    << std::setw(34) << "RMS error: "
+                    << best.RmsError * 100.0 << " %" << std::endl
+                    << std::setw(34) << "RMS error of all fits: "
+                    << Console::TextCyan;
+
+            for (std::size_t i = 0; i < candidates.size(); ++i)
+                _stream << (i ? " | " : "") << candidates[i].Name << ": "
+                        << candidates[i].RmsError * 100.0 << " %";
+
+            _stream << Console::TextDefault << std::endl
+                    << std::setprecision(5);
+        }
+
+
+    private:
+        /// Write bootstrap confidence intervals of the average and median.
+
+        /// @param average Confidence interval of the average in nanoseconds.
+        /// @param median Confidence interval of the median in nanoseconds.
+        /// @param level Confidence level.
+        void WriteConfidenceIntervals(const ConfidenceInterval& average,
+                                      const ConfidenceInterval& median,
+                                      double level)
+        {
+            // Format the level without the fixed precision of the stream.
+            std::stringstream confidence;
+            confidence << level * 100.0 << " % confidence";
+
+            _stream << std::setw(34) << "Average time interval: "
+                    << average.Lower / 1000.0 << " to "
+                    << average.Upper / 1000.0 << " us ("
+                    << Console::TextCyan << confidence.str()
+                    << Console::TextDefault << ")" << std::endl
+                    << std::setw(34) << "Median time interval: "
+                    << median.Lower / 1000.0 << " to "
+                    << median.Upper / 1000.0 << " us ("
+                    << Console::TextCyan << confidence.str()
+                    << Console::TextDefault << ")" << std::endl;
+        }
+
+
+        /// Write the mean and percentiles of a histogram of durations.
+
+        /// @param averageDescription Description of the mean.
+        /// @param percentilesDescription Description of the percentiles.
+        /// @param histogram Histogram of durations in nanoseconds.
+        void WriteHistogramSummary(const char* averageDescription,
+                                   const char* percentilesDescription,
+                                   const Histogram& histogram)
+        {
+            _stream << std::setw(34) << averageDescription
+                    << histogram.Mean() / 1000.0 << " us ("
+                    << Console::TextBlue << "~"
+                    << histogram.StdDev() / 1000.0 << " us"
+                    << Console::TextDefault << ")" << std::endl
+                    << std::setw(34) << percentilesDescription
+                    << Console::TextCyan << "p50: "
+                    << double(histogram.ValueAtPercentile(50.0)) / 1000.0
+                    << " | p90: "
+                    << double(histogram.ValueAtPercentile(90.0)) / 1000.0
+                    << " | p99: "
+                    << double(histogram.ValueAtPercentile(99.0)) / 1000.0
+                    << " | p99.9: "
+                    << double(histogram.ValueAtPercentile(99.9)) / 1000.0
+                    << " | max: "
+                    << double(histogram.Maximum()) / 1000.0 << " us"
+                    << Console::TextDefault << std::endl;
+        }
+
+
         std::ostream& _stream;
     };
 }
@@ -0,0 +1,449 @@
+//
+// CPU topology.
+//
+// Implementation notes:
+//
+// On Linux, the processors and the resources they share are read from
+// sysfs: cpuN/topology/thread_siblings_list lists the hardware threads of
+// the core of a processor, and cpuN/cache/indexK/shared_cpu_list the
+// processors sharing the cache whose level is given by
+// cpuN/cache/indexK/level.
+// Each core and cache is identified by the lowest-numbered processor
+// sharing it. Only the processors in the affinity mask of the process are
+// considered, so that restrictions imposed by taskset(1) or cgroups are
+// honoured.
+//
+// Processors are spread by repeatedly picking the processor that shares the
+// fewest resources with the processors picked so far, comparing the number
+// of picked processors on the same core first, then the number sharing its
+// L2 cache and then the number sharing its L3 cache, with ties going to the
+// lowest-numbered processor. Hardware threads of a core are thus only picked
+// once every core has been, and cores sharing an L2 or L3 cache only once
+// every cache domain has been.
+//
+// The threads of multi-threaded tests are placed by cycling through the
+// processors in an order given by the placement policy: compact placement
+// orders them by L3 cache, L2 cache and core, so that consecutive threads
+// share as much as possible, scatter placement in the order they are spread
+// in, and placement on cores in the order they are spread in but with only
+// the first hardware thread of each core.
+//
+// Elsewhere, the topology is empty and processes are not pinned.
+//
+#ifndef __HAYAI_CPU_TOPOLOGY
+#define __HAYAI_CPU_TOPOLOGY
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+
+/// Root of the sysfs processor tree.
+#ifndef HAYAI_CPU_TOPOLOGY_ROOT
+#   define HAYAI_CPU_TOPOLOGY_ROOT "/sys/devices/system/cpu"
+#endif
+
+
+namespace hayai
+{
+    /// Placement of the threads of multi-threaded tests.
+    enum ThreadPlacement
+    {
+        /// Threads are placed by the operating system.
+        ThreadPlacementNone,
+
+
+        /// Threads are packed onto as few cores and caches as possible.
+        ThreadPlacementCompact,
+
+
+        /// Threads are spread over as many cores and caches as possible.
+        ThreadPlacementScatter,
+
+
+        /// Threads are placed on one hardware thread of each core.
+        ThreadPlacementCores
+    };
+
+
+    /// Processor of a CPU topology.
+    struct CpuDescriptor
+    {
+    public:
+        CpuDescriptor(int id = 0,
+                      int core = 0,
+                      int l2Cache = 0,
+                      int l3Cache = 0)
+            :   Id(id),
+                Core(core),
+                L2Cache(l2Cache),
+                L3Cache(l3Cache)
+        {
+
+        }
+
+
+        /// Processor number.
+        int Id;
+
+
+        /// Lowest processor number on the same core.
+        int Core;
+
+
+        /// Lowest processor number sharing the L2 cache.
+        int L2Cache;
+
+
+        /// Lowest processor number sharing the L3 cache.
+        int L3Cache;
+    };
+
+
+    /// Processors available to the process and the resources they share.
+    class CpuTopology
+    {
+    public:
+        /// Detect the topology of the processors available to the process.
+
+        /// @param root Root of the sysfs processor tree.
+        /// @returns the topology, which is empty if it cannot be determined.
+        static CpuTopology Detect(const std::string& root =
+                                      HAYAI_CPU_TOPOLOGY_ROOT)
+        {
+            CpuTopology topology;
+#if defined(__linux__)
+            std::string online;
+            std::vector<int> cpus;
+
+            if ((!ReadFile(root + "/online", online)) ||
+                (!ParseCpuList(online, cpus)))
+                return topology;
+
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+
+            const bool restricted =
+                (!sched_getaffinity(0, sizeof(allowed), &allowed));
+
+            for (std::size_t index = 0; index < cpus.size(); ++index)
+            {
+                const int id = cpus[index];
+
+                if ((restricted) &&
+                    ((id >= CPU_SETSIZE) || (!CPU_ISSET(id, &allowed))))
+                    continue;
+
+                std::stringstream path;
+                path << root << "/cpu" << id;
+
+                CpuDescriptor cpu(id,
+                                  LowestCpu(path.str() +
+                                            "/topology/thread_siblings_list",
+                                            id),
+                                  id,
+                                  id);
+
+                // Find the unified or data caches by level.
+                for (int cacheIndex = 0; ; ++cacheIndex)
+                {
+                    std::stringstream cachePath;
+                    cachePath << path.str() << "/cache/index" << cacheIndex;
+
+                    std::string level;
+                    std::string type;
+
+                    if (!ReadFile(cachePath.str() + "/level", level))
+                        break;
+
+                    if ((ReadFile(cachePath.str() + "/type", type)) &&
+                        (type == "Instruction"))
+                        continue;
+
+                    const int lowest =
+                        LowestCpu(cachePath.str() + "/shared_cpu_list", id);
+
+                    if (level == "2")
+                        cpu.L2Cache = lowest;
+                    else if (level == "3")
+                        cpu.L3Cache = lowest;
+                }
+
+                topology.AddCpu(cpu);
+            }
+#else
+            (void)root;
+#endif
+
+            return topology;
+        }
+
+
+        /// Add a processor.
+        void AddCpu(const CpuDescriptor& cpu)
+        {
+            _cpus.push_back(cpu);
+        }
+
+
+        /// Processors.
+        inline const std::vector<CpuDescriptor>& Cpus() const
+        {
+            return _cpus;
+        }
+
+
+        /// Spread processes over the processors.
+
+        /// @param count Number of processors to pick.
+        /// @returns the numbers of up to @p count processors sharing as few
+        /// cores and caches as possible, in the order picked.
+        std::vector<int> Spread(std::size_t count) const
+        {
+            std::vector<int> picked;
+            std::vector<bool> used(_cpus.size(), false);
+
+            while (picked.size() < std::min(count, _cpus.size()))
+            {
+                std::size_t best = _cpus.size();
+                std::size_t bestShared[3] = {0, 0, 0};
+
+                for (std::size_t index = 0; index < _cpus.size(); ++index)
+                {
+                    if (used[index])
+                        continue;
+
+                    const CpuDescriptor& cpu = _cpus[index];
+                    std::size_t shared[3] = {0, 0, 0};
+
+                    for (std::size_t other = 0;
+                         other < _cpus.size();
+                         ++other)
+                    {
+                        if (!used[other])
+                            continue;
+
+                        shared[0] += (_cpus[other].Core == cpu.Core);
+                        shared[1] += (_cpus[other].L2Cache == cpu.L2Cache);
+                        shared[2] += (_cpus[other].L3Cache == cpu.L3Cache);
+                    }
+
+                    if ((best == _cpus.size()) ||
+                        (std::lexicographical_compare(shared,
+                                                      shared + 3,
+                                                      bestShared,
+                                                      bestShared + 3)) ||
+                        ((std::equal(shared, shared + 3, bestShared)) &&
+                         (cpu.Id < _cpus[best].Id)))
+                    {
+                        best = index;
+                        std::copy(shared, shared + 3, bestShared);
+                    }
+                }
+
+                used[best] = true;
+                picked.push_back(_cpus[best].Id);
+            }
+
+            return picked;
+        }
+
+
+        /// Place the threads of a multi-threaded test.
+
+        /// @param placement Placement policy.
+        /// @param count Number of threads.
+        /// @returns the number of the processor to pin each thread to, which
+        /// repeat if there are more threads than processors, or an empty
+        /// vector if the threads are not to be pinned.
+        std::vector<int> Place(ThreadPlacement placement,
+                               std::size_t count) const
+        {
+            std::vector<int> order;
+
+            switch (placement)
+            {
+            case ThreadPlacementCompact:
+            {
+                std::vector<CpuDescriptor> cpus(_cpus);
+                std::sort(cpus.begin(), cpus.end(), &IsCompactlyBefore);
+
+                for (std::size_t index = 0; index < cpus.size(); ++index)
+                    order.push_back(cpus[index].Id);
+
+                break;
+            }
+
+            case ThreadPlacementScatter:
+                order = Spread(_cpus.size());
+                break;
+
+            case ThreadPlacementCores:
+            {
+                const std::vector<int> spread = Spread(_cpus.size());
+                std::vector<int> cores;
+
+                for (std::size_t index = 0; index < spread.size(); ++index)
+                {
+                    const int core = Find(spread[index]).Core;
+
+                    if (std::find(cores.begin(), cores.end(), core) ==
+                        cores.end())
+                    {
+                        cores.push_back(core);
+                        order.push_back(spread[index]);
+                    }
+                }
+
+                break;
+            }
+
+            default:
+                break;
+            }
+
+            std::vector<int> cpus;
+
+            for (std::size_t thread = 0;
+                 (!order.empty()) && (thread < count);
+                 ++thread)
+                cpus.push_back(order[thread % order.size()]);
+
+            return cpus;
+        }
+
+
+        /// Parse a processor list.
+
+        /// @param list List in the format of sysfs, eg. "0-3,8,10-11".
+        /// @param cpus Processor numbers on success.
+        /// @returns true if the list is valid.
+        static bool ParseCpuList(const std::string& list,
+                                 std::vector<int>& cpus)
+        {
+            cpus.clear();
+            const char* str = list.c_str();
+
+            while ((*str) && (*str != '\n'))
+            {
+                char* end;
+                const long first = strtol(str, &end, 10);
+                long last = first;
+
+                if ((end == str) || (first < 0))
+                    return false;
+
+                if (*end == '-')
+                {
+                    str = end + 1;
+                    last = strtol(str, &end, 10);
+
+                    if ((end == str) || (last < first))
+                        return false;
+                }
+
+                for (long cpu = first; cpu <= last; ++cpu)
+                    cpus.push_back(int(cpu));
+
+                str = end;
+
+                if (*str == ',')
+                    ++str;
+                else if ((*str) && (*str != '\n'))
+                    return false;
+            }
+
+            return true;
+        }
+
+
+        /// Pin the calling thread to a processor.
+
+        /// Threads and processes created by the thread afterwards inherit
+        /// the pinning.
+        ///
+        /// @param cpu Processor number.
+        /// @returns true if the thread has been pinned.
+        static bool Pin(int cpu)
+        {
+#if defined(__linux__)
+            if ((cpu < 0) || (cpu >= CPU_SETSIZE))
+                return false;
+
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+
+            return (!sched_setaffinity(0, sizeof(set), &set));
+#else
+            (void)cpu;
+            return false;
+#endif
+        }
+    private:
+        /// Order of processors for compact placement.
+        static bool IsCompactlyBefore(const CpuDescriptor& a,
+                                      const CpuDescriptor& b)
+        {
+            if (a.L3Cache != b.L3Cache)
+                return (a.L3Cache < b.L3Cache);
+            if (a.L2Cache != b.L2Cache)
+                return (a.L2Cache < b.L2Cache);
+            if (a.Core != b.Core)
+                return (a.Core < b.Core);
+
+            return (a.Id < b.Id);
+        }
+
+
+        /// Find a processor by number.
+        const CpuDescriptor& Find(int id) const
+        {
+            std::size_t index = 0;
+
+            while ((index + 1 < _cpus.size()) && (_cpus[index].Id != id))
+                ++index;
+
+            return _cpus[index];
+        }
+
+
+        /// Read the first line of a file.
+        static bool ReadFile(const std::string& path, std::string& contents)
+        {
+            std::ifstream stream(path.c_str());
+            std::getline(stream, contents);
+
+            return (!stream.fail());
+        }
+
+
+        /// Lowest processor number of a processor list file.
+
+        /// @returns the lowest number, or @p fallback if the file cannot be
+        /// read or parsed.
+        static int LowestCpu(const std::string& path, int fallback)
+        {
+            std::string list;
+            std::vector<int> cpus;
+
+            if ((!ReadFile(path, list)) ||
+                (!ParseCpuList(list, cpus)) ||
+                (cpus.empty()))
+                return fallback;
+
+            return *std::min_element(cpus.begin(), cpus.end());
+        }
+
+
+        std::vector<CpuDescriptor> _cpus;
+    };
+}
+#endif
@@ -0,0 +1,89 @@
+#ifndef __HAYAI_DONOTOPTIMIZE
+#define __HAYAI_DONOTOPTIMIZE
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace hayai
+{
+#if defined(__GNUC__) || defined(__clang__)
+    /// Prevent the compiler from optimizing away a value.
+
+    /// Forces the value to be computed and treated as if it was read by an
+    /// opaque operation, without emitting any instructions beyond what is
+    /// needed to materialize the value in a register or in memory.
+    ///
+    /// @param value Value.
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        __asm__ __volatile__("" : : "r,m"(value) : "memory");
+    }
+
+
+    /// Prevent the compiler from optimizing away a value.
+
+    /// In addition to the value being treated as read, it is treated as
+    /// written, so the compiler cannot assume anything about the value after
+    /// the call, eg. to hoist computations depending on it out of a loop.
+    ///
+    /// @param value Value.
+    template<typename T>
+    inline void DoNotOptimize(T& value)
+    {
+#if defined(__clang__)
+        __asm__ __volatile__("" : "+r,m"(value) : : "memory");
+#else
+        // GCC may miscompile multiple alternatives for in-out operands, so
+        // the value is always kept in memory.
+        __asm__ __volatile__("" : "+m"(value) : : "memory");
+#endif
+    }
+
+
+    /// Force all pending memory writes to be performed.
+
+    /// Acts as a compiler barrier, ie. writes to memory cannot be eliminated
+    /// or moved across the call. No fence instruction is emitted.
+    inline void ClobberMemory()
+    {
+        __asm__ __volatile__("" : : : "memory");
+    }
+#else
+    /// Sink for values passed to @ref DoNotOptimize.
+    inline const volatile void*& DoNotOptimizeSink()
+    {
+        static const volatile void* sink = 0;
+        return sink;
+    }
+
+
+    /// Force all pending memory writes to be performed.
+
+    /// Acts as a compiler barrier, ie. writes to memory cannot be eliminated
+    /// or moved across the call. No fence instruction is emitted.
+    inline void ClobberMemory()
+    {
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#endif
+    }
+
+
+    /// Prevent the compiler from optimizing away a value.
+
+    /// Without inline assembly, the value is forced into memory by letting
+    /// its address escape through a volatile store.
+    ///
+    /// @param value Value.
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        DoNotOptimizeSink() = &value;
+        ClobberMemory();
+    }
+#endif
+}
+#endif
@@ -0,0 +1,565 @@
+//
+// Environment capture.
+//
+// Implementation notes:
+//
+// The environment is recorded as metadata entries so that results from
+// different machines, kernels or builds are not compared by mistake.
+// Entries that cannot be determined are left out.
+//
+// On Linux, the processor model and the load average are read from procfs,
+// and the processors, cache sizes, scaling governors, frequencies and turbo
+// and SMT states from sysfs. Only the processors in the affinity mask of the
+// process are described, as by CpuTopology, and the caches are those of the
+// first of them. Turbo is reported disabled if either intel_pstate/no_turbo
+// is 1 or cpufreq/boost is 0. The kernel is described by uname(2) on all
+// POSIX systems.
+//
+// The compiler, its target instruction sets and whether the build is
+// optimized are determined from the predefined macros of the translation
+// unit collecting the environment, ie. usually the one running the
+// benchmarks. Build systems may describe the build further by defining
+// HAYAI_BUILD_TYPE and HAYAI_COMPILER_FLAGS as string literals, which the
+// CMake build does for hayai_main.
+//
+// Warnings are derived from the entries rather than collected separately,
+// so that outputters only given the metadata can warn too.
+//
+#ifndef __HAYAI_ENVIRONMENT
+#define __HAYAI_ENVIRONMENT
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hayai_clock.hpp"
+#include "hayai_cpu_topology.hpp"
+#include "hayai_scheduling.hpp"
+
+#if !defined(_WIN32)
+#include <sys/utsname.h>
+#endif
+
+
+/// Root of procfs.
+#ifndef HAYAI_PROC_ROOT
+#   define HAYAI_PROC_ROOT "/proc"
+#endif
+
+
+/// One-minute load average per available processor above which the
+/// environment is reported as busy.
+#ifndef HAYAI_LOAD_AVERAGE_WARNING
+#   define HAYAI_LOAD_AVERAGE_WARNING 0.5
+#endif
+
+
+namespace hayai
+{
+    /// Environment the benchmarks are run in.
+    class Environment
+    {
+    public:
+        /// Metadata entries.
+        typedef std::vector<std::pair<std::string, std::string> > Entries;
+
+
+        /// Collect the environment.
+
+        /// @param cpuRoot Root of the sysfs processor tree.
+        /// @param procRoot Root of procfs.
+        /// @returns the names and values of the metadata entries describing
+        /// the environment.
+        static Entries Collect(const std::string& cpuRoot =
+                                   HAYAI_CPU_TOPOLOGY_ROOT,
+                               const std::string& procRoot =
+                                   HAYAI_PROC_ROOT)
+        {
+            Entries entries;
+
+            CollectHost(entries, cpuRoot, procRoot);
+            CollectBuild(entries);
+            entries.push_back(Entry("clock", Clock::Description()));
+
+            return entries;
+        }
+
+
+        /// Warn about performance-hostile settings.
+
+        /// @param metadata Metadata entries, including those collected by
+        /// @ref Collect.
+        /// @returns a description of each setting likely to distort the
+        /// results.
+        static std::vector<std::string> Warnings(const Entries& metadata)
+        {
+            std::vector<std::string> warnings;
+            std::string governors;
+            std::string cpus;
+            std::string load;
+            std::string buildType;
+
+            for (std::size_t index = 0; index < metadata.size(); ++index)
+            {
+                const std::string& name = metadata[index].first;
+                const std::string& value = metadata[index].second;
+
+                if (name == "scaling_governor")
+                    governors = value;
+                else if (name == "cpus")
+                    cpus = value;
+                else if (name == "load_average")
+                    load = value;
+                else if (name == "build_type")
+                    buildType = value;
+            }
+
+            // Any governor but performance or a fixed userspace frequency
+            // lets the frequency change during the runs.
+            std::stringstream governorStream(governors);
+            std::string governor;
+
+            while (std::getline(governorStream, governor, ','))
+            {
+                governor.erase(0, governor.find_first_not_of(' '));
+
+                if ((governor != "performance") && (governor != "userspace"))
+                {
+                    warnings.push_back("CPU frequency scaling governor is " +
+                                       governor + ", timings may vary with "
+                                       "the frequency; use performance");
+                    break;
+                }
+            }
+
+            const double loadAverage = atof(load.c_str());
+            const long available = atol(cpus.c_str());
+
+            if ((available > 0) &&
+                (loadAverage > HAYAI_LOAD_AVERAGE_WARNING * available))
+                warnings.push_back("load average is " + load +
+                                   ", other processes may interfere with "
+                                   "the benchmarks");
+
+            std::string lowerBuildType(buildType);
+            std::transform(lowerBuildType.begin(),
+                           lowerBuildType.end(),
+                           lowerBuildType.begin(),
+                           ::tolower);
+
+            if ((lowerBuildType.find("debug") == 0) ||
+                (lowerBuildType.find("unoptimized") == 0))
+                warnings.push_back("benchmarks are built as " + buildType +
+                                   ", timings do not reflect optimized "
+                                   "code");
+
+            return warnings;
+        }
+    private:
+        /// Make an entry.
+        static std::pair<std::string, std::string> Entry(
+            const std::string& name,
+            const std::string& value
+        )
+        {
+            return std::make_pair(name, value);
+        }
+
+
+        /// Collect the processors, kernel and load.
+        static void CollectHost(Entries& entries,
+                                const std::string& cpuRoot,
+                                const std::string& procRoot)
+        {
+            std::string model;
+            std::string machine;
+            std::string kernel;
+
+#if !defined(_WIN32)
+            struct utsname name;
+
+            if (!uname(&name))
+            {
+                machine = name.machine;
+                kernel = std::string(name.sysname) + " " + name.release;
+            }
+#else
+            kernel = "Windows";
+#endif
+
+#if defined(__linux__)
+            model = CpuModel(procRoot + "/cpuinfo");
+#endif
+
+            if (!model.empty())
+                entries.push_back(Entry("cpu_model", model));
+            else if (!machine.empty())
+                entries.push_back(Entry("cpu_model", machine));
+
+#if defined(__linux__)
+            const CpuTopology topology = CpuTopology::Detect(cpuRoot);
+            const std::vector<CpuDescriptor>& cpus = topology.Cpus();
+
+            if (!cpus.empty())
+            {
+                std::vector<int> ids;
+                std::vector<int> cores;
+                std::vector<int> l3Caches;
+
+                for (std::size_t index = 0; index < cpus.size(); ++index)
+                {
+                    ids.push_back(cpus[index].Id);
+                    AddUnique(cores, cpus[index].Core);
+                    AddUnique(l3Caches, cpus[index].L3Cache);
+                }
+
+                std::stringstream available;
+                available << ids.size() << " ("
+                          << Scheduling::FormatCpuList(ids) << ")";
+                entries.push_back(Entry("cpus", available.str()));
+
+                std::stringstream layout;
+                layout << cores.size()
+                       << (cores.size() == 1 ? " core, " : " cores, ")
+                       << ids.size()
+                       << (ids.size() == 1 ?
+                           " hardware thread, " :
+                           " hardware threads, ")
+                       << l3Caches.size()
+                       << (l3Caches.size() == 1 ?
+                           " last-level cache" :
+                           " last-level caches");
+                entries.push_back(Entry("topology", layout.str()));
+
+                // SMT state, falling back to whether any core is shared.
+                std::string control;
+                std::string smt;
+
+                if (ReadFile(cpuRoot + "/smt/control", control))
+                    smt = (control == "on" ?
+                           "enabled" :
+                           (control == "off") || (control == "forceoff") ?
+                           "disabled" :
+                           "not supported");
+                else
+                    smt = (cores.size() < ids.size() ?
+                           "enabled" :
+                           "not in use");
+
+                entries.push_back(Entry("smt", smt));
+
+                std::stringstream first;
+                first << cpuRoot << "/cpu" << ids[0];
+                const std::string caches = Caches(first.str());
+
+                if (!caches.empty())
+                    entries.push_back(Entry("caches", caches));
+
+                CollectFrequencies(entries, cpuRoot, ids);
+            }
+
+            // Turbo state.
+            std::string noTurbo;
+            std::string boost;
+
+            if (ReadFile(cpuRoot + "/intel_pstate/no_turbo", noTurbo))
+                entries.push_back(Entry("turbo",
+                                        noTurbo == "0" ?
+                                        "enabled" :
+                                        "disabled"));
+            else if (ReadFile(cpuRoot + "/cpufreq/boost", boost))
+                entries.push_back(Entry("turbo",
+                                        boost == "0" ?
+                                        "disabled" :
+                                        "enabled"));
+#else
+            (void)cpuRoot;
+#endif
+
+            if (!kernel.empty())
+                entries.push_back(Entry("kernel", kernel));
+
+#if defined(__linux__)
+            std::string loadAverage;
+
+            if (ReadFile(procRoot + "/loadavg", loadAverage))
+            {
+                // Keep the 1, 5 and 15 minute averages.
+                std::stringstream stream(loadAverage);
+                std::string averages[3];
+
+                if (stream >> averages[0] >> averages[1] >> averages[2])
+                    entries.push_back(Entry("load_average",
+                                            averages[0] + " " +
+                                            averages[1] + " " +
+                                            averages[2]));
+            }
+#else
+            (void)procRoot;
+#endif
+        }
+
+
+        /// Collect the scaling governors and frequencies of processors.
+        static void CollectFrequencies(Entries& entries,
+                                       const std::string& cpuRoot,
+                                       const std::vector<int>& ids)
+        {
+            std::vector<std::string> governors;
+            long minimum = 0;
+            long maximum = 0;
+            long limit = 0;
+
+            for (std::size_t index = 0; index < ids.size(); ++index)
+            {
+                std::stringstream path;
+                path << cpuRoot << "/cpu" << ids[index] << "/cpufreq/";
+
+                std::string governor;
+                std::string frequency;
+
+                if ((ReadFile(path.str() + "scaling_governor", governor)) &&
+                    (std::find(governors.begin(), governors.end(), governor) ==
+                     governors.end()))
+                    governors.push_back(governor);
+
+                if (ReadFile(path.str() + "scaling_cur_freq", frequency))
+                {
+                    const long current = atol(frequency.c_str());
+
+                    if ((!minimum) || (current < minimum))
+                        minimum = current;
+                    if (current > maximum)
+                        maximum = current;
+                }
+
+                if (ReadFile(path.str() + "cpuinfo_max_freq", frequency))
+                    limit = std::max(limit, atol(frequency.c_str()));
+            }
+
+            if (!governors.empty())
+            {
+                std::string list = governors[0];
+
+                for (std::size_t index = 1; index < governors.size(); ++index)
+                    list += ", " + governors[index];
+
+                entries.push_back(Entry("scaling_governor", list));
+            }
+
+            if (maximum > 0)
+            {
+                // Frequencies are given in kHz.
+                std::stringstream frequency;
+                frequency << "current " << minimum / 1000;
+
+                if (maximum / 1000 != minimum / 1000)
+                    frequency << "-" << maximum / 1000;
+
+                frequency << " MHz";
+
+                if (limit > 0)
+                    frequency << ", maximum " << limit / 1000 << " MHz";
+
+                entries.push_back(Entry("cpu_frequency", frequency.str()));
+            }
+        }
+
+
+        /// Collect the compiler and build.
+        static void CollectBuild(Entries& entries)
+        {
+            std::stringstream compiler;
+
+#if defined(__clang__)
+            compiler << "clang " << __clang_major__ << "."
+                     << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined(__INTEL_COMPILER)
+            compiler << "icc " << __INTEL_COMPILER;
+#elif defined(__GNUC__)
+            compiler << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "."
+                     << __GNUC_PATCHLEVEL__;
+#elif defined(_MSC_VER)
+            compiler << "MSVC " << _MSC_FULL_VER;
+#else
+            compiler << "unknown compiler";
+#endif
+
+            compiler << ", C++ " << long(__cplusplus);
+            entries.push_back(Entry("compiler", compiler.str()));
+
+#if defined(HAYAI_COMPILER_FLAGS)
+            entries.push_back(Entry("compiler_flags", HAYAI_COMPILER_FLAGS));
+#endif
+
+            std::string instructionSets;
+#if defined(__SSE4_2__)
+            instructionSets += " SSE4.2";
+#endif
+#if defined(__AVX__)
+            instructionSets += " AVX";
+#endif
+#if defined(__AVX2__)
+            instructionSets += " AVX2";
+#endif
+#if defined(__FMA__)
+            instructionSets += " FMA";
+#endif
+#if defined(__AVX512F__)
+            instructionSets += " AVX-512F";
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+            instructionSets += " NEON";
+#endif
+#if defined(__ARM_FEATURE_SVE)
+            instructionSets += " SVE";
+#endif
+
+            if (!instructionSets.empty())
+                entries.push_back(Entry("instruction_sets",
+                                        instructionSets.substr(1)));
+
+            std::string buildType;
+#if defined(HAYAI_BUILD_TYPE)
+            buildType = HAYAI_BUILD_TYPE;
+#endif
+
+            if (buildType.empty())
+            {
+#if defined(__OPTIMIZE__) || (defined(_MSC_VER) && !defined(_DEBUG))
+                buildType = "optimized";
+#else
+                buildType = "unoptimized";
+#endif
+#if !defined(NDEBUG)
+                buildType += " with assertions";
+#endif
+            }
+
+            entries.push_back(Entry("build_type", buildType));
+        }
+
+
+        /// Processor model from a cpuinfo file.
+
+        /// @returns the model, or an empty string if it cannot be found.
+        static std::string CpuModel(const std::string& path)
+        {
+            // Keys naming the model on x86, ARM and POWER respectively, in
+            // order of preference.
+            static const char* const keys[] = {
+                "model name", "Hardware", "cpu"
+            };
+            static const std::size_t keyCount = sizeof(keys) / sizeof(*keys);
+
+            std::ifstream stream(path.c_str());
+            std::string line;
+            std::string values[keyCount];
+
+            while (std::getline(stream, line))
+            {
+                const std::string::size_type colon = line.find(':');
+
+                if (colon == std::string::npos)
+                    continue;
+
+                std::string key = line.substr(0, colon);
+                key.erase(key.find_last_not_of(" \t") + 1);
+
+                for (std::size_t index = 0; index < keyCount; ++index)
+                {
+                    if ((key != keys[index]) || (!values[index].empty()))
+                        continue;
+
+                    values[index] = line.substr(colon + 1);
+                    values[index].erase(
+                        0,
+                        values[index].find_first_not_of(" \t")
+                    );
+                }
+            }
+
+            for (std::size_t index = 0; index < keyCount; ++index)
+                if (!values[index].empty())
+                    return values[index];
+
+            return std::string();
+        }
+
+
+        /// Caches of a processor.
+
+        /// @param path Path of the processor in sysfs.
+        /// @returns the caches, eg. "L1d 32K, L1i 32K, L2 1024K, L3 32768K
+        /// shared by 8", or an empty string if they cannot be determined.
+        static std::string Caches(const std::string& path)
+        {
+            std::string caches;
+
+            for (int cacheIndex = 0; ; ++cacheIndex)
+            {
+                std::stringstream cachePath;
+                cachePath << path << "/cache/index" << cacheIndex;
+
+                std::string level;
+                std::string type;
+                std::string size;
+                std::string shared;
+                std::vector<int> sharing;
+
+                if (!ReadFile(cachePath.str() + "/level", level))
+                    break;
+
+                if (!ReadFile(cachePath.str() + "/size", size))
+                    continue;
+
+                ReadFile(cachePath.str() + "/type", type);
+
+                if (!caches.empty())
+                    caches += ", ";
+
+                caches += "L" + level +
+                          (type == "Data" ?
+                           "d" :
+                           type == "Instruction" ? "i" : "") +
+                          " " + size;
+
+                if ((ReadFile(cachePath.str() + "/shared_cpu_list",
+                              shared)) &&
+                    (CpuTopology::ParseCpuList(shared, sharing)) &&
+                    (sharing.size() > 1))
+                {
+                    std::stringstream count;
+                    count << sharing.size();
+                    caches += " shared by " + count.str();
+                }
+            }
+
+            return caches;
+        }
+
+
+        /// Add a value to a vector unless it is already in it.
+        static void AddUnique(std::vector<int>& values, int value)
+        {
+            if (std::find(values.begin(), values.end(), value) ==
+                values.end())
+                values.push_back(value);
+        }
+
+
+        /// Read the first line of a file.
+        static bool ReadFile(const std::string& path, std::string& contents)
+        {
+            std::ifstream stream(path.c_str());
+            std::getline(stream, contents);
+
+            return (!stream.fail());
+        }
+    };
+}
+#endif
@@ -0,0 +1,421 @@
+//
+// High dynamic range histogram.
+//
+// Implementation notes:
+//
+// Values are recorded in buckets whose width grows with the magnitude of the
+// values, so that every recorded value can be recovered with a fixed
+// relative precision given as a number of significant decimal digits. This is
+// the layout of the HdrHistogram by Gil Tene: values are split into buckets
+// by their power of two magnitude, and each bucket is split into a fixed
+// number of linear sub-buckets. The index of the counter for a value is
+// derived from the position of its highest set bit and a shift, so recording
+// a value takes constant time.
+//
+// The counters are only allocated up to the highest value recorded so far,
+// so the memory used is bounded by the magnitude of the largest value: with
+// 3 significant digits, recording nanosecond durations of up to one second
+// uses about 170 KiB.
+//
+// Histograms with the same precision are merged by adding their counters,
+// which loses no information compared to recording all values in a single
+// histogram.
+//
+#ifndef __HAYAI_HISTOGRAM
+#define __HAYAI_HISTOGRAM
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+
+/// Default number of significant decimal digits of histograms.
+#ifndef HAYAI_HISTOGRAM_SIGNIFICANT_DIGITS
+#   define HAYAI_HISTOGRAM_SIGNIFICANT_DIGITS 3
+#endif
+
+
+namespace hayai
+{
+    /// High dynamic range histogram of unsigned integer values.
+    class Histogram
+    {
+    public:
+        /// Initialize an empty histogram.
+
+        /// @param significantDigits Number of significant decimal digits to
+        /// which recorded values are preserved. Between 1 and 5.
+        /// @throws std::invalid_argument if @p significantDigits is out of
+        /// range.
+        Histogram(int significantDigits = HAYAI_HISTOGRAM_SIGNIFICANT_DIGITS)
+            :   _significantDigits(significantDigits),
+                _totalCount(0),
+                _minimum(0),
+                _maximum(0),
+                _total(0.0),
+                _totalSquares(0.0)
+        {
+            if ((significantDigits < 1) || (significantDigits > 5))
+                throw std::invalid_argument(
+                    "histogram significant digits must be between 1 and 5"
+                );
+
+            // Determine the number of sub-buckets required to distinguish
+            // values to the given precision within each power of two.
+            uint64_t largestSingleUnitResolution = 2;
+            for (int digit = 0; digit < significantDigits; ++digit)
+                largestSingleUnitResolution *= 10;
+
+            _subBucketCountMagnitude = 0;
+            while ((uint64_t(1) << _subBucketCountMagnitude) <
+                   largestSingleUnitResolution)
+                ++_subBucketCountMagnitude;
+
+            _subBucketHalfCountMagnitude = _subBucketCountMagnitude - 1;
+            _subBucketCount = uint64_t(1) << _subBucketCountMagnitude;
+            _subBucketHalfCount = _subBucketCount / 2;
+            _subBucketMask = _subBucketCount - 1;
+        }
+
+
+        /// Record a value.
+
+        /// @param value Value.
+        /// @param count Number of times to record the value.
+        void Record(uint64_t value, uint64_t count = 1)
+        {
+            if (!count)
+                return;
+
+            const std::size_t index = CountsIndex(value);
+            if (index >= _counts.size())
+                _counts.resize(index + 1, 0);
+
+            _counts[index] += count;
+
+            if ((!_totalCount) || (value < _minimum))
+                _minimum = value;
+            if ((!_totalCount) || (value > _maximum))
+                _maximum = value;
+
+            _totalCount += count;
+            _total += double(value) * double(count);
+            _totalSquares += double(value) * double(value) * double(count);
+        }
+
+
+        /// Merge another histogram into this histogram.
+
+        /// The result is identical to having recorded the values of both
+        /// histograms in this histogram.
+        ///
+        /// @param other Histogram to merge.
+        /// @throws std::invalid_argument if the histograms differ in
+        /// precision.
+        void Merge(const Histogram& other)
+        {
+            if (other._significantDigits != _significantDigits)
+                throw std::invalid_argument(
+                    "cannot merge histograms of different precision"
+                );
+
+            if (!other._totalCount)
+                return;
+
+            if (other._counts.size() > _counts.size())
+                _counts.resize(other._counts.size(), 0);
+
+            for (std::size_t index = 0; index < other._counts.size(); ++index)
+                _counts[index] += other._counts[index];
+
+            if ((!_totalCount) || (other._minimum < _minimum))
+                _minimum = other._minimum;
+            if ((!_totalCount) || (other._maximum > _maximum))
+                _maximum = other._maximum;
+
+            _totalCount += other._totalCount;
+            _total += other._total;
+            _totalSquares += other._totalSquares;
+        }
+
+
+        /// Remove all recorded values.
+        void Reset()
+        {
+            _counts.clear();
+            _totalCount = 0;
+            _minimum = 0;
+            _maximum = 0;
+            _total = 0.0;
+            _totalSquares = 0.0;
+        }
+
+
+        /// Number of significant decimal digits.
+        inline int SignificantDigits() const
+        {
+            return _significantDigits;
+        }
+
+
+        /// Number of recorded values.
+        inline uint64_t TotalCount() const
+        {
+            return _totalCount;
+        }
+
+
+        /// Smallest recorded value.
+
+        /// Exact, as opposed to the values at percentiles. 0 if no values
+        /// have been recorded.
+        inline uint64_t Minimum() const
+        {
+            return _minimum;
+        }
+
+
+        /// Largest recorded value.
+
+        /// Exact, as opposed to the values at percentiles. 0 if no values
+        /// have been recorded.
+        inline uint64_t Maximum() const
+        {
+            return _maximum;
+        }
+
+
+        /// Mean of the recorded values.
+
+        /// Exact, as opposed to the values at percentiles. 0 if no values
+        /// have been recorded.
+        inline double Mean() const
+        {
+            return (_totalCount ? _total / double(_totalCount) : 0.0);
+        }
+
+
+        /// Sum of the recorded values.
+        inline double Sum() const
+        {
+            return _total;
+        }
+
+
+        /// Sum of the squares of the recorded values.
+        inline double SumOfSquares() const
+        {
+            return _totalSquares;
+        }
+
+
+        /// Sample standard deviation of the recorded values.
+        double StdDev() const
+        {
+            if (_totalCount < 2)
+                return 0.0;
+
+            const double count = double(_totalCount);
+            const double variance =
+                (_totalSquares - _total * _total / count) / (count - 1.0);
+
+            return (variance > 0.0 ? std::sqrt(variance) : 0.0);
+        }
+
+
+        /// Value at a percentile.
+
+        /// @param percentile Percentile between 0 and 100, eg. 99.9.
+        /// @returns the highest value equivalent to the smallest recorded
+        /// value that is greater than or equal to the given percentage of
+        /// the recorded values, limited to the range of the recorded values.
+        /// 0 if no values have been recorded.
+        uint64_t ValueAtPercentile(double percentile) const
+        {
+            if (!_totalCount)
+                return 0;
+
+            if (percentile <= 0.0)
+                return _minimum;
+            if (percentile >= 100.0)
+                return _maximum;
+
+            uint64_t countAtPercentile = uint64_t(
+                std::ceil(percentile / 100.0 * double(_totalCount))
+            );
+            if (countAtPercentile < 1)
+                countAtPercentile = 1;
+
+            uint64_t cumulative = 0;
+
+            for (std::size_t index = 0; index < _counts.size(); ++index)
+            {
+                cumulative += _counts[index];
+
+                if (cumulative >= countAtPercentile)
+                {
+                    const uint64_t value =
+                        HighestEquivalentValue(ValueFromIndex(index));
+
+                    if (value < _minimum)
+                        return _minimum;
+                    return (value > _maximum ? _maximum : value);
+                }
+            }
+
+            return _maximum;
+        }
+
+
+        /// Recorded buckets.
+
+        /// Recording each value the given number of times in an empty
+        /// histogram of the same precision reproduces this histogram apart
+        /// from the exact minimum, maximum, mean and standard deviation.
+        ///
+        /// @returns the lowest value equivalent to each bucket holding
+        /// values, paired with the number of values in the bucket, in
+        /// ascending order of the values.
+        std::vector<std::pair<uint64_t, uint64_t> > Buckets() const
+        {
+            std::vector<std::pair<uint64_t, uint64_t> > buckets;
+
+            for (std::size_t index = 0; index < _counts.size(); ++index)
+                if (_counts[index])
+                    buckets.push_back(std::make_pair(ValueFromIndex(index),
+                                                     _counts[index]));
+
+            return buckets;
+        }
+
+
+        /// Restore a histogram from its buckets and exact statistics.
+
+        /// Replaces the recorded values, so that a histogram can be
+        /// reproduced exactly from its @ref Buckets, @ref Minimum,
+        /// @ref Maximum, @ref Sum and @ref SumOfSquares.
+        ///
+        /// @param buckets Lowest value equivalent to each bucket holding
+        /// values, paired with the number of values in the bucket.
+        /// @param minimum Smallest recorded value.
+        /// @param maximum Largest recorded value.
+        /// @param sum Sum of the recorded values.
+        /// @param sumOfSquares Sum of the squares of the recorded values.
+        void Restore(const std::vector<std::pair<uint64_t, uint64_t> >& buckets,
+                     uint64_t minimum,
+                     uint64_t maximum,
+                     double sum,
+                     double sumOfSquares)
+        {
+            Reset();
+
+            for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+                Record(buckets[bucket].first, buckets[bucket].second);
+
+            if (!_totalCount)
+                return;
+
+            _minimum = minimum;
+            _maximum = maximum;
+            _total = sum;
+            _totalSquares = sumOfSquares;
+        }
+
+
+        /// Lowest value equivalent to a value.
+
+        /// @returns the lowest value that is recorded in the same bucket as
+        /// @p value.
+        inline uint64_t LowestEquivalentValue(uint64_t value) const
+        {
+            return ValueFromIndex(CountsIndex(value));
+        }
+
+
+        /// Highest value equivalent to a value.
+
+        /// @returns the highest value that is recorded in the same bucket as
+        /// @p value.
+        uint64_t HighestEquivalentValue(uint64_t value) const
+        {
+            const int bucket = BucketIndex(value);
+            const uint64_t subBucket = value >> bucket;
+            const int rangeMagnitude =
+                (subBucket >= _subBucketCount ? bucket + 1 : bucket);
+            const uint64_t lowest = subBucket << bucket;
+
+            return lowest + ((uint64_t(1) << rangeMagnitude) - 1);
+        }
+    private:
+        /// Position of the highest set bit of a non-zero value.
+        static int HighestBit(uint64_t value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - __builtin_clzll(value);
+#else
+            int bit = 0;
+
+            while (value >>= 1)
+                ++bit;
+
+            return bit;
+#endif
+        }
+
+
+        /// Index of the power of two bucket of a value.
+        inline int BucketIndex(uint64_t value) const
+        {
+            return HighestBit(value | _subBucketMask) -
+                _subBucketHalfCountMagnitude;
+        }
+
+
+        /// Index of the counter of a value.
+        inline std::size_t CountsIndex(uint64_t value) const
+        {
+            const int bucket = BucketIndex(value);
+            const uint64_t subBucket = value >> bucket;
+
+            return std::size_t(
+                (uint64_t(bucket + 1) << _subBucketHalfCountMagnitude) +
+                (subBucket - _subBucketHalfCount)
+            );
+        }
+
+
+        /// Lowest value of the counter with an index.
+        inline uint64_t ValueFromIndex(std::size_t index) const
+        {
+            int bucket = int(index >> _subBucketHalfCountMagnitude) - 1;
+            uint64_t subBucket =
+                (uint64_t(index) & (_subBucketHalfCount - 1)) +
+                _subBucketHalfCount;
+
+            if (bucket < 0)
+            {
+                subBucket -= _subBucketHalfCount;
+                bucket = 0;
+            }
+
+            return subBucket << bucket;
+        }
+
+
+        int _significantDigits;
+        int _subBucketCountMagnitude;
+        int _subBucketHalfCountMagnitude;
+        uint64_t _subBucketCount;
+        uint64_t _subBucketHalfCount;
+        uint64_t _subBucketMask;
+        std::vector<uint64_t> _counts;
+        uint64_t _totalCount;
+        uint64_t _minimum;
+        uint64_t _maximum;
+        double _total;
+        double _totalSquares;
+    };
+}
+#endif
@@ -0,0 +1,968 @@
+//
+// Process isolation.
+//
+// Implementation notes:
+//
+// An isolated test is run in a child process forked from the benchmarker,
+// which inherits the registered tests, the settings and the calibration
+// model, so only the outcome has to be sent back. The child reports to the
+// parent over a pipe as a sequence of messages, each a tag character
+// followed by the length of the payload and the payload. Unsigned integers
+// are encoded as LEB128 varints, ie. seven bits per byte starting with the
+// least significant bits, with the high bit set on all but the last byte, so
+// the run times and counts that make up most of a result take a few bytes
+// each. Doubles are encoded as the eight bytes of their IEEE 754
+// representation in little-endian order, and strings and sequences are
+// preceded by their length.
+//
+// A result is encoded as the measurements it was constructed from, ie. the
+// run times, iteration counts, histograms, thread times, counter values and
+// resource usage, and is reconstructed by the parent through the same
+// setters, so the derived statistics are computed once and cannot diverge.
+// Histograms are encoded as their buckets and exact statistics.
+//
+// The parent waits for the messages with poll(2), so that a child that does
+// not finish within the timeout can be killed. The child leaves with _exit(2)
+// so that neither static destructors nor the buffers of the output streams
+// inherited from the parent are run or flushed a second time, which is also
+// why the parent flushes the standard streams before forking.
+//
+// Isolation relies on fork(2) and is therefore not available on Windows.
+//
+#ifndef __HAYAI_ISOLATION
+#define __HAYAI_ISOLATION
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+#if !defined(_WIN32)
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "hayai_clock.hpp"
+#include "hayai_histogram.hpp"
+#include "hayai_outputter.hpp"
+#include "hayai_test_result.hpp"
+
+
+namespace hayai
+{
+    /// Tags of the messages of an isolated process.
+    enum IsolationMessage
+    {
+        /// Beginning of the runs, with the number of runs and iterations.
+        IsolationBegin = 'B',
+
+
+        /// Result of the runs.
+        IsolationResult = 'R',
+
+
+        /// Description of an exception thrown by the test.
+        IsolationError = 'E'
+    };
+
+
+    /// Encoder of the messages of an isolated process.
+    class IsolationEncoder
+    {
+    public:
+        /// Write an unsigned integer.
+        void WriteUnsigned(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                _buffer += char((value & 0x7f) | 0x80);
+                value >>= 7;
+            }
+
+            _buffer += char(value);
+        }
+
+
+        /// Write a double.
+        void WriteDouble(double value)
+        {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+
+            for (std::size_t byte = 0; byte < 8; ++byte)
+                _buffer += char((bits >> (8 * byte)) & 0xff);
+        }
+
+
+        /// Write a string.
+        void WriteString(const std::string& value)
+        {
+            WriteUnsigned(value.size());
+            _buffer += value;
+        }
+
+
+        /// Write a sequence of unsigned integers.
+        template<class T>
+        void WriteUnsignedVector(const std::vector<T>& values)
+        {
+            WriteUnsigned(values.size());
+
+            for (std::size_t i = 0; i < values.size(); ++i)
+                WriteUnsigned(uint64_t(values[i]));
+        }
+
+
+        /// Write a histogram.
+        void WriteHistogram(const Histogram& histogram)
+        {
+            const std::vector<std::pair<uint64_t, uint64_t> > buckets =
+                histogram.Buckets();
+
+            WriteUnsigned(uint64_t(histogram.SignificantDigits()));
+            WriteUnsigned(buckets.size());
+
+            for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+            {
+                WriteUnsigned(buckets[bucket].first);
+                WriteUnsigned(buckets[bucket].second);
+            }
+
+            WriteUnsigned(histogram.Minimum());
+            WriteUnsigned(histogram.Maximum());
+            WriteDouble(histogram.Sum());
+            WriteDouble(histogram.SumOfSquares());
+        }
+
+
+        /// Write a test result.
+
+        /// Baseline comparisons, saturation rates and confidence intervals
+        /// are not written, as they are determined by the benchmarker after
+        /// the runs.
+        void WriteResult(const TestResult& result)
+        {
+            WriteUnsigned(uint64_t(result.RunTimeHistogram()
+                                   .SignificantDigits()));
+            WriteUnsignedVector(result.RunTimes());
+            WriteUnsigned(result.Iterations());
+            WriteUnsigned(result.WarmUpRuns());
+
+            // Iteration counts of linearly sampled runs.
+            std::vector<std::size_t> runIterations;
+
+            if (result.IsLinear())
+                for (std::size_t run = 0;
+                     run < result.RunTimes().size();
+                     ++run)
+                    runIterations.push_back(result.RunIterations(run));
+
+            WriteUnsignedVector(runIterations);
+            WriteDouble(result.RegressionConfidenceLevel());
+
+            // Outcome of an adaptive run count.
+            WriteUnsigned(result.IsAdaptive() ? 1 : 0);
+            WriteUnsigned(result.Converged() ? 1 : 0);
+            WriteDouble(result.RelativeConfidenceIntervalWidth());
+            WriteDouble(result.TargetRelativeConfidenceIntervalWidth());
+
+            // Sampled iterations.
+            WriteUnsigned(result.SampleInterval());
+            if (result.IsSampled())
+                WriteHistogram(result.IterationTimeHistogram());
+
+            // Open-loop load and latencies.
+            WriteUnsigned(result.IsOpenLoop() ? 1 : 0);
+            if (result.IsOpenLoop())
+            {
+                WriteDouble(result.OfferedRate());
+                WriteHistogram(result.LatencyHistogram());
+            }
+
+            // Thread run times.
+            const std::vector<std::vector<uint64_t> >& threadRunTimes =
+                result.ThreadRunTimes();
+
+            WriteUnsigned(result.Threads());
+            WriteUnsigned(threadRunTimes.size());
+
+            for (std::size_t run = 0; run < threadRunTimes.size(); ++run)
+                WriteUnsignedVector(threadRunTimes[run]);
+
+            // Performance counters.
+            const std::vector<std::string>& counterNames =
+                result.PerformanceCounterNames();
+            const std::vector<std::vector<uint64_t> >& counterValues =
+                result.PerformanceCounterValues();
+
+            WriteUnsigned(counterNames.size());
+
+            for (std::size_t counter = 0;
+                 counter < counterNames.size();
+                 ++counter)
+                WriteString(counterNames[counter]);
+
+            WriteUnsigned(counterValues.size());
+
+            for (std::size_t run = 0; run < counterValues.size(); ++run)
+                WriteUnsignedVector(counterValues[run]);
+
+            // Resource usage.
+            const std::vector<ResourceUsage>& resourceUsage =
+                result.RunResourceUsage();
+
+            WriteUnsigned(resourceUsage.size());
+
+            for (std::size_t run = 0; run < resourceUsage.size(); ++run)
+            {
+                const ResourceUsage& usage = resourceUsage[run];
+
+                WriteUnsigned(usage.MinorFaults);
+                WriteUnsigned(usage.MajorFaults);
+                WriteUnsigned(usage.VoluntaryContextSwitches);
+                WriteUnsigned(usage.InvoluntaryContextSwitches);
+                WriteUnsigned(usage.UserTime);
+                WriteUnsigned(usage.SystemTime);
+            }
+
+            WriteUnsigned(result.TotalResourceUsage().PeakResidentSetSize);
+        }
+
+
+        /// Encoded bytes.
+        inline const std::string& Buffer() const
+        {
+            return _buffer;
+        }
+    private:
+        std::string _buffer;
+    };
+
+
+    /// Decoder of the messages of an isolated process.
+    class IsolationDecoder
+    {
+    public:
+        /// Initialize a decoder.
+
+        /// @param buffer Encoded bytes. Must outlive the decoder.
+        IsolationDecoder(const std::string& buffer)
+            :   _buffer(buffer),
+                _position(0)
+        {
+
+        }
+
+
+        /// Read an unsigned integer.
+
+        /// @throws std::runtime_error if the buffer is exhausted.
+        uint64_t ReadUnsigned()
+        {
+            uint64_t value = 0;
+
+            for (int shift = 0; ; shift += 7)
+            {
+                if ((_position >= _buffer.size()) || (shift >= 64))
+                    Fail();
+
+                const unsigned char byte =
+                    static_cast<unsigned char>(_buffer[_position++]);
+                value |= uint64_t(byte & 0x7f) << shift;
+
+                if (!(byte & 0x80))
+                    return value;
+            }
+        }
+
+
+        /// Read a double.
+
+        /// @throws std::runtime_error if the buffer is exhausted.
+        double ReadDouble()
+        {
+            if (_buffer.size() - _position < 8)
+                Fail();
+
+            uint64_t bits = 0;
+
+            for (std::size_t byte = 0; byte < 8; ++byte)
+                bits |= uint64_t(static_cast<unsigned char>(
+                    _buffer[_position++]
+                )) << (8 * byte);
+
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+
+        /// Read a string.
+
+        /// @throws std::runtime_error if the buffer is exhausted.
+        std::string ReadString()
+        {
+            const std::size_t length = ReadCount();
+            const std::string value = _buffer.substr(_position, length);
+            _position += length;
+            return value;
+        }
+
+
+        /// Read a sequence of unsigned integers.
+
+        /// @throws std::runtime_error if the buffer is exhausted.
+        template<class T>
+        std::vector<T> ReadUnsignedVector()
+        {
+            std::vector<T> values(ReadCount());
+
+            for (std::size_t i = 0; i < values.size(); ++i)
+                values[i] = T(ReadUnsigned());
+
+            return values;
+        }
+
+
+        /// Read a histogram.
+
+        /// @throws std::runtime_error if the buffer is exhausted.
+        /// @throws std::invalid_argument if the precision is invalid.
+        Histogram ReadHistogram()
+        {
+            const int significantDigits = int(ReadUnsigned());
+            Histogram histogram(significantDigits);
+            std::vector<std::pair<uint64_t, uint64_t> > buckets(ReadCount());
+
+            for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+            {
+                buckets[bucket].first = ReadUnsigned();
+                buckets[bucket].second = ReadUnsigned();
+            }
+
+            const uint64_t minimum = ReadUnsigned();
+            const uint64_t maximum = ReadUnsigned();
+            const double sum = ReadDouble();
+            const double sumOfSquares = ReadDouble();
+
+            histogram.Restore(buckets, minimum, maximum, sum, sumOfSquares);
+            return histogram;
+        }
+
+
+        /// Read a test result.
+
+        /// @throws std::runtime_error if the buffer is exhausted.
+        /// @throws std::invalid_argument if a histogram precision is
+        /// invalid.
+        TestResult ReadResult()
+        {
+            const int significantDigits = int(ReadUnsigned());
+            const std::vector<uint64_t> runTimes =
+                ReadUnsignedVector<uint64_t>();
+            const std::size_t iterations = std::size_t(ReadUnsigned());
+
+            TestResult result(runTimes, iterations, significantDigits);
+            result.SetWarmUpRuns(std::size_t(ReadUnsigned()));
+
+            const std::vector<std::size_t> runIterations =
+                ReadUnsignedVector<std::size_t>();
+            const double regressionLevel = ReadDouble();
+
+            if (!runIterations.empty())
+                result.SetRunIterations(runIterations, regressionLevel);
+
+            const bool adaptive = (ReadUnsigned() != 0);
+            const bool converged = (ReadUnsigned() != 0);
+            const double relativeWidth = ReadDouble();
+            const double targetRelativeWidth = ReadDouble();
+
+            if (adaptive)
+                result.SetConvergence(converged,
+                                      relativeWidth,
+                                      targetRelativeWidth);
+
+            const std::size_t sampleInterval = std::size_t(ReadUnsigned());
+
+            if (sampleInterval)
+                result.SetIterationSamples(ReadHistogram(), sampleInterval);
+
+            if (ReadUnsigned())
+            {
+                const double offeredRate = ReadDouble();
+                result.SetOpenLoop(offeredRate, ReadHistogram());
+            }
+
+            const std::size_t threads = std::size_t(ReadUnsigned());
+            std::vector<std::vector<uint64_t> > threadRunTimes(ReadCount());
+
+            for (std::size_t run = 0; run < threadRunTimes.size(); ++run)
+                threadRunTimes[run] = ReadUnsignedVector<uint64_t>();
+
+            if (!threadRunTimes.empty())
+                result.SetThreads(threads, threadRunTimes);
+
+            std::vector<std::string> counterNames(ReadCount());
+
+            for (std::size_t counter = 0;
+                 counter < counterNames.size();
+                 ++counter)
+                counterNames[counter] = ReadString();
+
+            std::vector<std::vector<uint64_t> > counterValues(ReadCount());
+
+            for (std::size_t run = 0; run < counterValues.size(); ++run)
+                counterValues[run] = ReadUnsignedVector<uint64_t>();
+
+            if (!counterNames.empty())
+                result.SetPerformanceCounters(counterNames, counterValues);
+
+            std::vector<ResourceUsage> resourceUsage(ReadCount());
+
+            for (std::size_t run = 0; run < resourceUsage.size(); ++run)
+            {
+                ResourceUsage& usage = resourceUsage[run];
+
+                usage.MinorFaults = ReadUnsigned();
+                usage.MajorFaults = ReadUnsigned();
+                usage.VoluntaryContextSwitches = ReadUnsigned();
+                usage.InvoluntaryContextSwitches = ReadUnsigned();
+                usage.UserTime = ReadUnsigned();
+                usage.SystemTime = ReadUnsigned();
+            }
+
+            const uint64_t peakResidentSetSizeGrowth = ReadUnsigned();
+
+            if (!resourceUsage.empty())
+                result.SetResourceUsage(resourceUsage,
+                                        peakResidentSetSizeGrowth);
+
+            return result;
+        }
+
+
+        /// Number of bytes read.
+        inline std::size_t Position() const
+        {
+            return _position;
+        }
+
+
+        /// Whether all bytes have been read.
+        inline bool AtEnd() const
+        {
+            return (_position >= _buffer.size());
+        }
+    private:
+        /// Read the length of a string or sequence.
+
+        /// Every element takes at least one byte, so lengths beyond the end
+        /// of the buffer are rejected before anything is allocated.
+        std::size_t ReadCount()
+        {
+            const uint64_t count = ReadUnsigned();
+
+            if (count > _buffer.size() - _position)
+                Fail();
+
+            return std::size_t(count);
+        }
+
+
+        /// Throw a decoding error.
+        void Fail() const
+        {
+            throw std::runtime_error("truncated message");
+        }
+
+
+        const std::string& _buffer;
+        std::size_t _position;
+    };
+
+
+    /// Child process running an isolated test.
+    class IsolatedProcess
+    {
+    public:
+        /// Initialize an isolated process.
+
+        /// @param timeout Time in nanoseconds the child may take from being
+        /// forked to exiting before it is killed, or 0 for no limit.
+        IsolatedProcess(uint64_t timeout = 0)
+            :   _timeout(timeout),
+                _startTime(Clock::Now()),
+                _pid(-1),
+                _fd(-1),
+                _ended(false),
+                _timedOut(false)
+        {
+
+        }
+
+
+        /// Kill the child if it is still running and release the pipe.
+        ~IsolatedProcess()
+        {
+#if !defined(_WIN32)
+            if (_fd >= 0)
+                close(_fd);
+
+            if (_pid > 0)
+            {
+                kill(_pid, SIGKILL);
+                Reap();
+            }
+#endif
+        }
+
+
+        /// Whether isolation is supported on this platform.
+        static bool IsSupported()
+        {
+#if defined(_WIN32)
+            return false;
+#else
+            return true;
+#endif
+        }
+
+
+        /// Fork the child process.
+
+        /// @returns true in the child and false in the parent.
+        /// @throws std::runtime_error if the pipe or the process cannot be
+        /// created.
+        bool Fork()
+        {
+#if defined(_WIN32)
+            throw std::runtime_error("process isolation is not supported");
+#else
+            int fds[2];
+
+            if (pipe(fds))
+                throw std::runtime_error(std::string("failed to create "
+                                                     "pipe: ") +
+                                         strerror(errno));
+
+            // Flush the standard streams so that their buffered output is
+            // not written by both processes.
+            std::cout.flush();
+            std::cerr.flush();
+            fflush(NULL);
+
+            _startTime = Clock::Now();
+            _pid = fork();
+
+            if (_pid < 0)
+            {
+                const int error = errno;
+                close(fds[0]);
+                close(fds[1]);
+                throw std::runtime_error(std::string("failed to fork: ") +
+                                         strerror(error));
+            }
+
+            if (!_pid)
+            {
+                close(fds[0]);
+                _fd = fds[1];
+                return true;
+            }
+
+            close(fds[1]);
+            _fd = fds[0];
+            return false;
+#endif
+        }
+
+
+        /// Send a message to the parent.
+
+        /// Only valid in the child.
+        ///
+        /// @param tag Tag of the message.
+        /// @param payload Payload of the message.
+        /// @returns true if the message was written in full.
+        bool Send(IsolationMessage tag, const IsolationEncoder& payload)
+        {
+            IsolationEncoder frame;
+            frame.WriteUnsigned(uint64_t(tag));
+            frame.WriteString(payload.Buffer());
+
+#if defined(_WIN32)
+            return false;
+#else
+            const std::string& buffer = frame.Buffer();
+            std::size_t written = 0;
+
+            while (written < buffer.size())
+            {
+                const ssize_t count = write(_fd,
+                                            buffer.data() + written,
+                                            buffer.size() - written);
+
+                if (count < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    return false;
+                }
+
+                written += std::size_t(count);
+            }
+
+            return true;
+#endif
+        }
+
+
+        /// Exit the child.
+
+        /// Flushes the standard streams and exits without running static
+        /// destructors. Only valid in the child.
+        ///
+        /// @param status Exit status.
+        void Exit(int status)
+        {
+            std::cout.flush();
+            std::cerr.flush();
+            fflush(NULL);
+
+#if !defined(_WIN32)
+            _exit(status);
+#else
+            (void)status;
+#endif
+        }
+
+
+        /// Receive a message from the child.
+
+        /// Only valid in the parent.
+        ///
+        /// @param tag Tag of the message on success.
+        /// @param payload Payload of the message on success.
+        /// @param block Whether to wait for a message to arrive.
+        /// @returns true if a message was received, or false if the child
+        /// closed the pipe, the timeout expired or, if not blocking, no
+        /// complete message has arrived yet.
+        bool Receive(IsolationMessage& tag,
+                     std::string& payload,
+                     bool block = true)
+        {
+#if defined(_WIN32)
+            (void)tag;
+            (void)payload;
+            (void)block;
+            return false;
+#else
+            while (true)
+            {
+                if (ExtractMessage(tag, payload))
+                    return true;
+
+                if ((_ended) || (_timedOut))
+                    return false;
+
+                // Wait for data until the timeout expires.
+                const int pollTimeout = PollTimeout();
+
+                if (!pollTimeout)
+                {
+                    _timedOut = true;
+                    return false;
+                }
+
+                struct pollfd descriptor;
+                descriptor.fd = _fd;
+                descriptor.events = POLLIN;
+                descriptor.revents = 0;
+
+                const int ready =
+                    poll(&descriptor, 1, (block ? pollTimeout : 0));
+
+                if (ready < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    _ended = true;
+                    continue;
+                }
+
+                if (!ready)
+                {
+                    if (!block)
+                        return false;
+
+                    continue;
+                }
+
+                char buffer[4096];
+                const ssize_t count = read(_fd, buffer, sizeof(buffer));
+
+                if (count > 0)
+                    _received.append(buffer, std::size_t(count));
+                else if ((count == 0) || (errno != EINTR))
+                    _ended = true;
+            }
+#endif
+        }
+
+
+        /// Whether the child closed the pipe or timed out.
+
+        /// Once finished, @ref Receive returns the remaining messages without
+        /// blocking.
+        inline bool Finished() const
+        {
+            return ((_ended) || (_timedOut));
+        }
+
+
+        /// Wait until any of a set of children can make progress.
+
+        /// Returns once a child has sent data, closed its pipe or reached its
+        /// timeout, so that @ref Receive can then be called on each child
+        /// without blocking. Only valid in the parent.
+        ///
+        /// @param processes Children to wait for.
+        static void WaitForAny(const std::vector<IsolatedProcess*>& processes)
+        {
+#if !defined(_WIN32)
+            std::vector<struct pollfd> descriptors;
+            int pollTimeout = -1;
+
+            for (std::size_t index = 0; index < processes.size(); ++index)
+            {
+                const IsolatedProcess& process = *processes[index];
+
+                if ((process._fd < 0) || (process.Finished()))
+                    continue;
+
+                struct pollfd descriptor;
+                descriptor.fd = process._fd;
+                descriptor.events = POLLIN;
+                descriptor.revents = 0;
+                descriptors.push_back(descriptor);
+
+                const int processTimeout = process.PollTimeout();
+
+                if ((processTimeout >= 0) &&
+                    ((pollTimeout < 0) || (processTimeout < pollTimeout)))
+                    pollTimeout = processTimeout;
+            }
+
+            if (descriptors.empty())
+                return;
+
+            while ((poll(&descriptors[0],
+                         nfds_t(descriptors.size()),
+                         pollTimeout) < 0) &&
+                   (errno == EINTR))
+                ;
+#else
+            (void)processes;
+#endif
+        }
+
+
+        /// Wait for the child to exit.
+
+        /// Kills the child if it timed out or is still running. Only valid in
+        /// the parent.
+        ///
+        /// @returns a description of how the child failed, or an empty
+        /// string if it exited successfully.
+        std::string Wait()
+        {
+            std::stringstream failure;
+
+#if !defined(_WIN32)
+            if (_pid <= 0)
+                return "not started";
+
+            if ((_timedOut) || (!_ended))
+                kill(_pid, SIGKILL);
+
+            const int status = Reap();
+
+            if (_timedOut)
+                failure << "timed out after "
+                        << double(_timeout) / 1000000000.0 << " s";
+            else if (WIFSIGNALED(status))
+                failure << "terminated by signal " << WTERMSIG(status)
+                        << " (" << strsignal(WTERMSIG(status)) << ")";
+            else if ((WIFEXITED(status)) && (WEXITSTATUS(status)))
+                failure << "exited with status " << WEXITSTATUS(status);
+#else
+            failure << "process isolation is not supported";
+#endif
+
+            return failure.str();
+        }
+    private:
+        /// Extract a complete message from the received bytes.
+        bool ExtractMessage(IsolationMessage& tag, std::string& payload)
+        {
+            if (_received.empty())
+                return false;
+
+            try
+            {
+                IsolationDecoder decoder(_received);
+                tag = IsolationMessage(decoder.ReadUnsigned());
+                payload = decoder.ReadString();
+
+                _received.erase(0, decoder.Position());
+                return true;
+            }
+            catch (std::runtime_error&)
+            {
+                // The message is incomplete.
+                return false;
+            }
+        }
+
+
+        /// Time to wait for data from the child.
+
+        /// @returns the remaining time until the timeout in milliseconds,
+        /// rounded up, 0 if the timeout has expired or -1 if there is no
+        /// timeout.
+        int PollTimeout() const
+        {
+            if (!_timeout)
+                return -1;
+
+            const uint64_t elapsed = Clock::Duration(_startTime, Clock::Now());
+
+            if (elapsed >= _timeout)
+                return 0;
+
+            const uint64_t remaining = (_timeout - elapsed) / 1000000 + 1;
+
+            return (remaining > 0x7fffffff ? 0x7fffffff : int(remaining));
+        }
+
+
+#if !defined(_WIN32)
+        /// Wait for the child to exit and release it.
+
+        /// @returns the status of the child.
+        int Reap()
+        {
+            int status = 0;
+
+            while ((waitpid(_pid, &status, 0) < 0) && (errno == EINTR))
+                ;
+
+            _pid = -1;
+            return status;
+        }
+#endif
+
+
+        uint64_t _timeout;
+        Clock::TimePoint _startTime;
+#if !defined(_WIN32)
+        pid_t _pid;
+#else
+        int _pid;
+#endif
+        int _fd;
+        bool _ended;
+        bool _timedOut;
+        std::string _received;
+    };
+
+
+    /// Outputter forwarding the beginning of isolated runs to the parent.
+    class IsolationOutputter
+        :   public Outputter
+    {
+    public:
+        /// Initialize the outputter.
+
+        /// @param process Isolated child process. Must outlive the
+        /// outputter.
+        IsolationOutputter(IsolatedProcess& process)
+            :   _process(process)
+        {
+
+        }
+
+
+        virtual void Begin(const std::size_t& enabledCount,
+                           const std::size_t& disabledCount)
+        {
+            (void)enabledCount;
+            (void)disabledCount;
+        }
+
+
+        virtual void End(const std::size_t& executedCount,
+                         const std::size_t& disabledCount)
+        {
+            (void)executedCount;
+            (void)disabledCount;
+        }
+
+
+        virtual void BeginTest(const std::string& fixtureName,
+                               const std::string& testName,
+                               const TestParametersDescriptor& parameters,
+                               const std::size_t& runsCount,
+                               const std::size_t& iterationsCount)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+
+            IsolationEncoder message;
+            message.WriteUnsigned(runsCount);
+            message.WriteUnsigned(iterationsCount);
+            _process.Send(IsolationBegin, message);
+        }
+
+
+        virtual void EndTest(const std::string& fixtureName,
+                             const std::string& testName,
+                             const TestParametersDescriptor& parameters,
+                             const TestResult& result)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+            (void)result;
+        }
+
+
+        virtual void SkipDisabledTest(const std::string& fixtureName,
+                                      const std::string& testName,
+                                      const TestParametersDescriptor&
+                                          parameters,
+                                      const std::size_t& runsCount,
+                                      const std::size_t& iterationsCount)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+            (void)runsCount;
+            (void)iterationsCount;
+        }
+    private:
+        IsolatedProcess& _process;
+    };
+}
+#endif
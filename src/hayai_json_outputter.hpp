@@ -2,6 +2,7 @@
 #define __HAYAI_JSONOUTPUTTER
 #include <iomanip>
 #include <ostream>
+#include <sstream>
 
 #include "hayai_outputter.hpp"
 
@@ -26,6 +27,12 @@ namespace hayai
     ///
     /// {
     ///     "format_version": 1,
+    ///     "metadata": {
+    ///         "affinity": "0-3",
+    ///         "cpu_model": "Intel(R) Xeon(R) Gold 6230 CPU @ 2.10GHz",
+    ///         "scaling_governor": "performance",
+    ///         ..
+    ///     },
     ///     "benchmarks": [{
     ///         "fixture": "DeliveryMan",
     ///         "name": "DeliverPackage",
@@ -35,9 +42,43 @@ namespace hayai
     ///         },
     ///         "iterations_per_run": 10,
     ///         "disabled": false,
+    ///         "warm_up_runs": 0,
     ///         "runs": [{
-    ///             "duration": 3801.889831
-    ///         }, ..]
+    ///             "duration": 3801.889831,
+    ///             "thread_durations": [3801.889831, ..],
+    ///             "counters": {
+    ///                 "cycles": 8204721
+    ///             },
+    ///             "resource_usage": {
+    ///                 "minor_faults": 0,
+    ///                 ..
+    ///             }
+    ///         }, ..],
+    ///         "resource_usage": {
+    ///             "minor_faults": 12,
+    ///             "major_faults": 0,
+    ///             "voluntary_context_switches": 0,
+    ///             "involuntary_context_switches": 3,
+    ///             "user_time": 37.9,
+    ///             "system_time": 0.1,
+    ///             "peak_rss_growth": 4096
+    ///         },
+    ///         "counters_per_iteration": {
+    ///             "cycles": 82047.21
+    ///         },
+    ///         "mean": 3801.889831,
+    ///         ..
+    ///         "percentiles": {
+    ///             "p50": 3799.0,
+    ///             "p90": 3821.0,
+    ///             "p99": 3839.0,
+    ///             "p99.9": 3839.0,
+    ///             "max": 3839.002117
+    ///         },
+    ///         "histogram": {
+    ///             "significant_digits": 3,
+    ///             "buckets": [[3797000, 1], [3799000, 4], ..]
+    ///         }
     ///     }, {
     ///         "fixture": "DeliveryMan",
     ///         "name": "DisabledTest",
@@ -46,7 +87,70 @@ namespace hayai
     ///     }, ..]
     /// }
     ///
-    /// All durations are represented as milliseconds.
+    /// All durations are represented as milliseconds. Performance counters are
+    /// only present if they have been collected. "resource_usage" gives the
+    /// page faults, context switches and CPU times of the iterations of each
+    /// run and in total, and the growth of the peak resident set size in
+    /// bytes over all runs, and is only present where resource usage is
+    /// available. If the number of runs was
+    /// determined adaptively, "converged" and
+    /// "relative_confidence_interval_width" describe the outcome. For
+    /// multi-threaded benchmarks, the duration of each thread is given per
+    /// run, and "threads" and "aggregate_iterations_per_second" are added.
+    ///
+    /// The percentiles of the run times follow the convention of the median,
+    /// so that "p50" equals the median. The histogram holds the run times in
+    /// nanoseconds as pairs of the lowest value of each bucket and the
+    /// number of runs in it, so that histograms of several result files can
+    /// be merged without loss by recording the buckets in a @ref Histogram
+    /// of the same precision. If
+    /// individual iterations were sampled, "iteration_samples" holds the
+    /// sampling interval, the number of samples and their statistics,
+    /// percentiles and histogram. For open-loop tests, "open_loop" holds the
+    /// offered load, the achieved throughput and the latencies measured from
+    /// the intended start times, in the same form, and "saturation_rate" if
+    /// the test was saturated at the offered load.
+    ///
+    /// If runs were performed with linearly increasing iteration counts, each
+    /// run gives its number of "iterations", and "linear_regression" holds
+    /// the least-squares fit of the run times on the iteration counts: the
+    /// "slope" is the time per iteration with its confidence interval, and
+    /// the "intercept" the fixed time per run. The statistics of the runs
+    /// are then calculated from the run times scaled to
+    /// "iterations_per_run", the average number of iterations per run.
+    ///
+    /// "outliers" holds the number of mild and severe outliers by the Tukey
+    /// fences and of outliers by their modified z-score, the median absolute
+    /// deviation, and the mean and standard deviation of the runs within the
+    /// inner fences.
+    ///
+    /// If bootstrap confidence intervals were estimated,
+    /// "confidence_intervals" holds their confidence level, the number of
+    /// resamples, and the lower and upper bounds of the mean and median time
+    /// per run and per iteration.
+    ///
+    /// If results were compared with a baseline, "baseline" holds the
+    /// classification of the change, the median times per iteration of the
+    /// baseline and the test, and the relative change of the median with its
+    /// 95 % confidence interval and the p-value of the Mann-Whitney U test.
+    ///
+    /// Once all instances of a parametrized benchmark with a problem size
+    /// parameter have run, an additional entry with the fixture, name and
+    /// other parameters of the instances holds the "complexity" fit: the
+    /// name of the "parameter", the "points" as pairs of the problem size and
+    /// the median time per iteration, the best "fit" with its "coefficient"
+    /// and "rms_error" relative to the mean time, and all "candidates" in the
+    /// same form.
+    ///
+    /// "metadata" describes the settings the benchmarks were run with and,
+    /// when run through the main entry point, the environment they were run
+    /// in as collected by @ref Environment: the processors, caches,
+    /// frequency scaling, kernel, load, compiler, build and clock. It is
+    /// only present if there is any.
+    ///
+    /// If a benchmark failed to produce a result, eg. because its isolated
+    /// process crashed or timed out, its entry has no runs and "failure"
+    /// holds the reason.
     class JsonOutputter
         :   public Outputter
     {
@@ -74,13 +178,7 @@ namespace hayai
 
                 JSON_STRING_BEGIN "format_version" JSON_STRING_END
                 JSON_NAME_SEPARATOR
-                "1"
-
-                JSON_VALUE_SEPARATOR
-
-                JSON_STRING_BEGIN "benchmarks" JSON_STRING_END
-                JSON_NAME_SEPARATOR
-                JSON_ARRAY_BEGIN;
+                "1";
         }
 
 
@@ -90,12 +188,40 @@ namespace hayai
             (void)executedCount;
             (void)disabledCount;
 
+            if (_firstTest)
+                BeginBenchmarks();
+
             _stream <<
                 JSON_ARRAY_END
                 JSON_OBJECT_END;
         }
 
 
+        virtual void Metadata(const std::vector<
+                                  std::pair<std::string, std::string>
+                              >& metadata)
+        {
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "metadata" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_OBJECT_BEGIN;
+
+            for (std::size_t index = 0; index < metadata.size(); ++index)
+            {
+                if (index)
+                    _stream << JSON_VALUE_SEPARATOR;
+
+                WriteString(metadata[index].first);
+                _stream << JSON_NAME_SEPARATOR;
+                WriteString(metadata[index].second);
+            }
+
+            _stream << JSON_OBJECT_END;
+        }
+
+
         virtual void BeginTest(const std::string& fixtureName,
                                const std::string& testName,
                                const TestParametersDescriptor& parameters,
@@ -139,17 +265,26 @@ namespace hayai
             _stream <<
                 JSON_VALUE_SEPARATOR
 
+                JSON_STRING_BEGIN "warm_up_runs" JSON_STRING_END
+                JSON_NAME_SEPARATOR << result.WarmUpRuns() <<
+
+                JSON_VALUE_SEPARATOR
+
                 JSON_STRING_BEGIN "runs" JSON_STRING_END
                 JSON_NAME_SEPARATOR
                 JSON_ARRAY_BEGIN;
 
             const std::vector<uint64_t>& runTimes = result.RunTimes();
-
-            for (std::vector<uint64_t>::const_iterator it = runTimes.begin();
-                 it != runTimes.end();
-                 ++it)
+            const std::vector<std::string>& counterNames =
+                result.PerformanceCounterNames();
+            const std::vector<std::vector<uint64_t> >& counterValues =
+                result.PerformanceCounterValues();
+            const std::vector<std::vector<uint64_t> >& threadRunTimes =
+                result.ThreadRunTimes();
+
+            for (std::size_t run = 0; run < runTimes.size(); ++run)
             {
-                if (it != runTimes.begin())
+                if (run)
                     _stream << JSON_VALUE_SEPARATOR;
 
                 _stream << JSON_OBJECT_BEGIN
@@ -157,21 +292,527 @@ namespace hayai
                            JSON_NAME_SEPARATOR
                         << std::fixed
                         << std::setprecision(6)
-                        << (double(*it) / 1000000.0)
-                        << JSON_OBJECT_END;
+                        << (double(runTimes[run]) / 1000000.0);
+
+                if (result.IsLinear())
+                    _stream <<
+                        JSON_VALUE_SEPARATOR
+
+                        JSON_STRING_BEGIN "iterations" JSON_STRING_END
+                        JSON_NAME_SEPARATOR << result.RunIterations(run);
+
+                if (!threadRunTimes.empty())
+                {
+                    _stream <<
+                        JSON_VALUE_SEPARATOR
+
+                        JSON_STRING_BEGIN "thread_durations" JSON_STRING_END
+                        JSON_NAME_SEPARATOR
+                        JSON_ARRAY_BEGIN;
+
+                    for (std::size_t thread = 0;
+                         thread < threadRunTimes[run].size();
+                         ++thread)
+                    {
+                        if (thread)
+                            _stream << JSON_VALUE_SEPARATOR;
+
+                        _stream << (double(threadRunTimes[run][thread]) /
+                                    1000000.0);
+                    }
+
+                    _stream <<
+                        JSON_ARRAY_END;
+                }
+
+                if (!counterNames.empty())
+                {
+                    _stream <<
+                        JSON_VALUE_SEPARATOR
+
+                        JSON_STRING_BEGIN "counters" JSON_STRING_END
+                        JSON_NAME_SEPARATOR
+                        JSON_OBJECT_BEGIN;
+
+                    for (std::size_t counter = 0;
+                         counter < counterNames.size();
+                         ++counter)
+                    {
+                        if (counter)
+                            _stream << JSON_VALUE_SEPARATOR;
+
+                        WriteString(counterNames[counter]);
+                        _stream << JSON_NAME_SEPARATOR
+                                << counterValues[run][counter];
+                    }
+
+                    _stream <<
+                        JSON_OBJECT_END;
+                }
+
+                if (result.HasResourceUsage())
+                    WriteResourceUsage(result.RunResourceUsage()[run], false);
+
+                _stream <<
+                    JSON_OBJECT_END;
             }
 
             _stream <<
                 JSON_ARRAY_END;
 
+            if (result.HasResourceUsage())
+                WriteResourceUsage(result.TotalResourceUsage(), true);
+
+            if (!counterNames.empty())
+            {
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "counters_per_iteration" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN;
+
+                for (std::size_t counter = 0;
+                     counter < counterNames.size();
+                     ++counter)
+                {
+                    if (counter)
+                        _stream << JSON_VALUE_SEPARATOR;
+
+                    WriteString(counterNames[counter]);
+                    _stream << JSON_NAME_SEPARATOR
+                            << std::fixed
+                            << std::setprecision(6)
+                            << result.PerformanceCounterIterationAverage(
+                                counter
+                            );
+                }
+
+                _stream <<
+                    JSON_OBJECT_END;
+            }
+
             WriteDoubleProperty("mean", result.RunTimeAverage());
             WriteDoubleProperty("std_dev", result.RunTimeStdDev());
             WriteDoubleProperty("median", result.RunTimeMedian());
             WriteDoubleProperty("quartile_1", result.RunTimeQuartile1());
             WriteDoubleProperty("quartile_3", result.RunTimeQuartile3());
 
+            // Regression of the run times on linearly increasing iteration
+            // counts.
+            if (result.IsLinear())
+            {
+                const LinearRegression& regression =
+                    result.IterationTimeRegression();
+
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "linear_regression" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "level" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << result.RegressionConfidenceLevel() <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "r_squared" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << regression.RSquared;
+
+                WriteDoubleProperty("slope", regression.Slope);
+                WriteIntervalProperty(
+                    "slope_interval",
+                    ConfidenceInterval(regression.SlopeLower,
+                                       regression.SlopeUpper)
+                );
+                WriteDoubleProperty("intercept", regression.Intercept);
+
+                _stream <<
+                    JSON_OBJECT_END;
+            }
+
+            // Outliers and the statistics of the remaining runs.
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "outliers" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_OBJECT_BEGIN
+
+                JSON_STRING_BEGIN "mild" JSON_STRING_END
+                JSON_NAME_SEPARATOR << result.MildOutliers() <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "severe" JSON_STRING_END
+                JSON_NAME_SEPARATOR << result.SevereOutliers() <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "mad" JSON_STRING_END
+                JSON_NAME_SEPARATOR << result.MadOutliers();
+
+            WriteDoubleProperty("median_absolute_deviation",
+                                result.RunTimeMedianAbsoluteDeviation());
+            WriteDoubleProperty("trimmed_mean",
+                                result.RunTimeTrimmedAverage());
+            WriteDoubleProperty("trimmed_std_dev",
+                                result.RunTimeTrimmedStdDev());
+
+            _stream <<
+                JSON_OBJECT_END;
+
+            // Bootstrap confidence intervals.
+            if (result.HasConfidenceIntervals())
+            {
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "confidence_intervals" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "level" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << result.ConfidenceLevel() <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "resamples" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << result.BootstrapResamples();
+
+                WriteIntervalProperty("mean",
+                                      result.RunTimeAverageInterval());
+                WriteIntervalProperty("median",
+                                      result.RunTimeMedianInterval());
+                WriteIntervalProperty("iteration_mean",
+                                      result.IterationTimeAverageInterval());
+                WriteIntervalProperty("iteration_median",
+                                      result.IterationTimeMedianInterval());
+
+                _stream <<
+                    JSON_OBJECT_END;
+            }
+
+            // Percentiles of the run times, and their histogram.
+            WritePercentiles(result.RunTimePercentile(50.0),
+                             result.RunTimePercentile(90.0),
+                             result.RunTimePercentile(99.0),
+                             result.RunTimePercentile(99.9),
+                             result.RunTimeMaximum());
+            WriteHistogram(result.RunTimeHistogram());
+
+            // Sampled iterations.
+            if (result.IsSampled())
+            {
+                const Histogram& samples = result.IterationTimeHistogram();
+
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "iteration_samples" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "interval" JSON_STRING_END
+                    JSON_NAME_SEPARATOR << result.SampleInterval() <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "count" JSON_STRING_END
+                    JSON_NAME_SEPARATOR << samples.TotalCount();
+
+                WriteDoubleProperty("mean", samples.Mean());
+                WriteDoubleProperty("std_dev", samples.StdDev());
+                WritePercentiles(samples);
+                WriteHistogram(samples);
+
+                _stream <<
+                    JSON_OBJECT_END;
+            }
+
+            // Open-loop load and latencies.
+            if (result.IsOpenLoop())
+            {
+                const Histogram& latencies = result.LatencyHistogram();
+
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "open_loop" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "offered_rate" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << result.OfferedRate() <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "achieved_rate" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << result.AchievedRate();
+
+                if (result.IsSaturated())
+                    _stream <<
+                        JSON_VALUE_SEPARATOR
+
+                        JSON_STRING_BEGIN "saturation_rate" JSON_STRING_END
+                        JSON_NAME_SEPARATOR
+                            << result.SaturationRate();
+
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "latency" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "count" JSON_STRING_END
+                    JSON_NAME_SEPARATOR << latencies.TotalCount();
+
+                WriteDoubleProperty("mean", latencies.Mean());
+                WriteDoubleProperty("std_dev", latencies.StdDev());
+                WritePercentiles(latencies);
+                WriteHistogram(latencies);
+
+                _stream <<
+                    JSON_OBJECT_END
+                    JSON_OBJECT_END;
+            }
+
+            if (result.IsAdaptive())
+            {
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "converged" JSON_STRING_END
+                    JSON_NAME_SEPARATOR <<
+                    (result.Converged() ? JSON_TRUE : JSON_FALSE) <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "relative_confidence_interval_width"
+                    JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << result.RelativeConfidenceIntervalWidth();
+            }
+
+            if (result.IsThreaded())
+            {
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "threads" JSON_STRING_END
+                    JSON_NAME_SEPARATOR << result.Threads() <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "aggregate_iterations_per_second"
+                    JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << result.AggregateIterationsPerSecondAverage();
+            }
+
+            // Comparison with the baseline.
+            if (result.HasBaselineComparison())
+            {
+                const BaselineComparison& comparison =
+                    result.BaselineComparisonResult();
+
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "baseline" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "change" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_STRING_BEGIN <<
+                    (comparison.Change == BaselineImproved ? "improved" :
+                     comparison.Change == BaselineRegressed ? "regressed" :
+                     "unchanged") <<
+                    JSON_STRING_END;
+
+                WriteDoubleProperty("baseline_median",
+                                    comparison.BaselineMedian);
+                WriteDoubleProperty("median", comparison.Median);
+
+                _stream <<
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "relative_change" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << comparison.RelativeChange <<
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "relative_change_interval"
+                    JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                    JSON_ARRAY_BEGIN
+                        << comparison.RelativeChangeLower <<
+                    JSON_VALUE_SEPARATOR
+                        << comparison.RelativeChangeUpper <<
+                    JSON_ARRAY_END
+
+                    JSON_VALUE_SEPARATOR
+
+                    JSON_STRING_BEGIN "p_value" JSON_STRING_END
+                    JSON_NAME_SEPARATOR
+                        << comparison.PValue <<
+
+                    JSON_OBJECT_END;
+            }
+
+            EndTestObject();
+        }
+
+
+        virtual void FailTest(const std::string& fixtureName,
+                              const std::string& testName,
+                              const TestParametersDescriptor& parameters,
+                              const std::string& reason)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "failure" JSON_STRING_END
+                JSON_NAME_SEPARATOR;
+
+            WriteString(reason);
             EndTestObject();
         }
+
+
+        virtual void Complexity(const std::string& fixtureName,
+                                const std::string& testName,
+                                const ComplexityFit& fit)
+        {
+            const ComplexityCandidate& best = fit.Best();
+            const std::vector<ComplexityCandidate>& candidates =
+                fit.Candidates();
+
+            BeginEntry();
+
+            _stream <<
+                JSON_OBJECT_BEGIN
+
+                JSON_STRING_BEGIN "fixture" JSON_STRING_END
+                JSON_NAME_SEPARATOR;
+
+            WriteString(fixtureName);
+
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "name" JSON_STRING_END
+                JSON_NAME_SEPARATOR;
+
+            WriteString(testName);
+
+            _stream <<
+                JSON_VALUE_SEPARATOR;
+
+            WriteParameters(fit.Parameters());
+
+            _stream <<
+                JSON_STRING_BEGIN "complexity" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_OBJECT_BEGIN
+
+                JSON_STRING_BEGIN "parameter" JSON_STRING_END
+                JSON_NAME_SEPARATOR;
+
+            WriteString(fit.Parameter());
+
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "points" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_ARRAY_BEGIN;
+
+            for (std::size_t i = 0; i < fit.Sizes().size(); ++i)
+            {
+                if (i)
+                    _stream << JSON_VALUE_SEPARATOR;
+
+                // Sizes are written in the shortest exact form.
+                std::stringstream size;
+                size << std::setprecision(17) << fit.Sizes()[i];
+
+                _stream << JSON_ARRAY_BEGIN
+                        << size.str()
+                        << JSON_VALUE_SEPARATOR
+                        << std::fixed
+                        << std::setprecision(6)
+                        << (fit.Times()[i] / 1000000.0)
+                        << JSON_ARRAY_END;
+            }
+
+            _stream <<
+                JSON_ARRAY_END
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "fit" JSON_STRING_END
+                JSON_NAME_SEPARATOR;
+
+            WriteString(best.Name);
+            WriteCandidateProperties(best);
+
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "candidates" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_ARRAY_BEGIN;
+
+            for (std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                if (i)
+                    _stream << JSON_VALUE_SEPARATOR;
+
+                _stream <<
+                    JSON_OBJECT_BEGIN
+
+                    JSON_STRING_BEGIN "fit" JSON_STRING_END
+                    JSON_NAME_SEPARATOR;
+
+                WriteString(candidates[i].Name);
+                WriteCandidateProperties(candidates[i]);
+
+                _stream <<
+                    JSON_OBJECT_END;
+            }
+
+            _stream <<
+                JSON_ARRAY_END
+                JSON_OBJECT_END
+                JSON_OBJECT_END;
+        }
     private:
         void BeginTestObject(const std::string& fixtureName,
                              const std::string& testName,
@@ -182,10 +823,7 @@ namespace hayai
         {
             (void)runsCount;
 
-            if (_firstTest)
-                _firstTest = false;
-            else
-                _stream << JSON_VALUE_SEPARATOR;
+            BeginEntry();
 
             _stream <<
                 JSON_OBJECT_BEGIN
@@ -206,6 +844,61 @@ namespace hayai
             _stream <<
                 JSON_VALUE_SEPARATOR;
 
+            WriteParameters(parameters);
+
+            _stream <<
+                JSON_STRING_BEGIN "iterations_per_run" JSON_STRING_END
+                JSON_NAME_SEPARATOR << iterationsCount <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "disabled" JSON_STRING_END
+                JSON_NAME_SEPARATOR << (disabled ? JSON_TRUE : JSON_FALSE);
+        }
+
+
+        /// Begin the benchmarks array.
+        void BeginBenchmarks()
+        {
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "benchmarks" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_ARRAY_BEGIN;
+        }
+
+
+        /// Begin an entry of the benchmarks array.
+
+        /// The array is begun before the first entry, so that the metadata
+        /// precedes it.
+        void BeginEntry()
+        {
+            if (_firstTest)
+            {
+                BeginBenchmarks();
+                _firstTest = false;
+            }
+            else
+                _stream << JSON_VALUE_SEPARATOR;
+        }
+
+
+        inline void EndTestObject()
+        {
+            _stream <<
+                JSON_OBJECT_END;
+        }
+
+
+        /// Write the parameters property followed by a value separator.
+
+        /// Nothing is written if there are no parameters.
+        ///
+        /// @param parameters Test parameters.
+        void WriteParameters(const TestParametersDescriptor& parameters)
+        {
             const std::vector<TestParameterDescriptor>& descs =
                 parameters.Parameters();
 
@@ -247,22 +940,6 @@ namespace hayai
                     JSON_ARRAY_END
                     JSON_VALUE_SEPARATOR;
             }
-
-            _stream <<
-                JSON_STRING_BEGIN "iterations_per_run" JSON_STRING_END
-                JSON_NAME_SEPARATOR << iterationsCount <<
-
-                JSON_VALUE_SEPARATOR
-
-                JSON_STRING_BEGIN "disabled" JSON_STRING_END
-                JSON_NAME_SEPARATOR << (disabled ? JSON_TRUE : JSON_FALSE);
-        }
-
-
-        inline void EndTestObject()
-        {
-            _stream <<
-                JSON_OBJECT_END;
         }
 
 
@@ -319,6 +996,168 @@ namespace hayai
         }
 
 
+        /// Write the percentiles property of a histogram.
+
+        /// @param histogram Histogram of durations in nanoseconds.
+        void WritePercentiles(const Histogram& histogram)
+        {
+            WritePercentiles(double(histogram.ValueAtPercentile(50.0)),
+                             double(histogram.ValueAtPercentile(90.0)),
+                             double(histogram.ValueAtPercentile(99.0)),
+                             double(histogram.ValueAtPercentile(99.9)),
+                             double(histogram.Maximum()));
+        }
+
+
+        /// Write the percentiles property.
+
+        /// @param p50 50th percentile in nanoseconds.
+        /// @param p90 90th percentile in nanoseconds.
+        /// @param p99 99th percentile in nanoseconds.
+        /// @param p999 99.9th percentile in nanoseconds.
+        /// @param maximum Maximum in nanoseconds.
+        void WritePercentiles(double p50,
+                              double p90,
+                              double p99,
+                              double p999,
+                              double maximum)
+        {
+            _stream <<
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "percentiles" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                JSON_OBJECT_BEGIN
+
+                JSON_STRING_BEGIN "p50" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                    << std::fixed
+                    << std::setprecision(6)
+                    << (p50 / 1000000.0) <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "p90" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                    << (p90 / 1000000.0) <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "p99" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                    << (p99 / 1000000.0) <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "p99.9" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                    << (p999 / 1000000.0) <<
+
+                JSON_VALUE_SEPARATOR
+
+                JSON_STRING_BEGIN "max" JSON_STRING_END
+                JSON_NAME_SEPARATOR
+                    << (maximum / 1000000.0) <<
+
+                JSON_OBJECT_END;
+        }
+
+
+        /// Write the histogram property of a histogram.
+
+        /// @param histogram Histogram.
+        void WriteHistogram(const Histogram& histogram)
+        {
+            const std::vector<std::pair<uint64_t, uint64_t> > buckets =
+                histogram.Buckets();
+
+            _stream << JSON_VALUE_SEPARATOR
+                       JSON_STRING_BEGIN "histogram" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                       JSON_OBJECT_BEGIN
+
+                       JSON_STRING_BEGIN "significant_digits" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << histogram.SignificantDigits()
+                    << JSON_VALUE_SEPARATOR
+
+                       JSON_STRING_BEGIN "buckets" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                       JSON_ARRAY_BEGIN;
+
+            for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+            {
+                if (bucket)
+                    _stream << JSON_VALUE_SEPARATOR;
+
+                _stream << JSON_ARRAY_BEGIN
+                        << buckets[bucket].first
+                        << JSON_VALUE_SEPARATOR
+                        << buckets[bucket].second
+                        << JSON_ARRAY_END;
+            }
+
+            _stream << JSON_ARRAY_END
+                    << JSON_OBJECT_END;
+        }
+
+
+        /// Write the resource usage property of a run or a test.
+
+        /// @param usage Resource usage.
+        /// @param peak Whether to write the growth of the peak resident set
+        /// size, which is only sampled for a test as a whole.
+        void WriteResourceUsage(const ResourceUsage& usage, bool peak)
+        {
+            _stream << JSON_VALUE_SEPARATOR
+                       JSON_STRING_BEGIN "resource_usage" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                       JSON_OBJECT_BEGIN
+
+                       JSON_STRING_BEGIN "minor_faults" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << usage.MinorFaults
+                    << JSON_VALUE_SEPARATOR
+
+                       JSON_STRING_BEGIN "major_faults" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << usage.MajorFaults
+                    << JSON_VALUE_SEPARATOR
+
+                       JSON_STRING_BEGIN "voluntary_context_switches"
+                       JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << usage.VoluntaryContextSwitches
+                    << JSON_VALUE_SEPARATOR
+
+                       JSON_STRING_BEGIN "involuntary_context_switches"
+                       JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << usage.InvoluntaryContextSwitches
+                    << JSON_VALUE_SEPARATOR
+
+                       JSON_STRING_BEGIN "user_time" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << std::fixed
+                    << std::setprecision(6)
+                    << (double(usage.UserTime) / 1000000.0)
+                    << JSON_VALUE_SEPARATOR
+
+                       JSON_STRING_BEGIN "system_time" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << (double(usage.SystemTime) / 1000000.0);
+
+            if (peak)
+                _stream << JSON_VALUE_SEPARATOR
+
+                           JSON_STRING_BEGIN "peak_rss_growth" JSON_STRING_END
+                           JSON_NAME_SEPARATOR
+                        << usage.PeakResidentSetSize;
+
+            _stream << JSON_OBJECT_END;
+        }
+
+
         /// Write a property with a double value.
 
         /// @param key Property key.
@@ -336,6 +1175,48 @@ namespace hayai
         }
 
 
+        /// Write a property with a confidence interval of durations.
+
+        /// @param key Property key.
+        /// @param interval Confidence interval in nanoseconds.
+        void WriteIntervalProperty(const std::string& key,
+                                   const ConfidenceInterval& interval)
+        {
+            _stream << JSON_VALUE_SEPARATOR
+                    << JSON_STRING_BEGIN
+                    << key
+                    << JSON_STRING_END
+                    << JSON_NAME_SEPARATOR
+                    << JSON_ARRAY_BEGIN
+                    << std::fixed
+                    << std::setprecision(6)
+                    << (interval.Lower / 1000000.0)
+                    << JSON_VALUE_SEPARATOR
+                    << (interval.Upper / 1000000.0)
+                    << JSON_ARRAY_END;
+        }
+
+
+        /// Write the coefficient and error properties of a complexity fit.
+
+        /// @param candidate Complexity fit.
+        void WriteCandidateProperties(const ComplexityCandidate& candidate)
+        {
+            _stream << JSON_VALUE_SEPARATOR
+                       JSON_STRING_BEGIN "coefficient" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << std::scientific
+                    << std::setprecision(9)
+                    << (candidate.Coefficient / 1000000.0)
+                    << JSON_VALUE_SEPARATOR
+                       JSON_STRING_BEGIN "rms_error" JSON_STRING_END
+                       JSON_NAME_SEPARATOR
+                    << std::fixed
+                    << std::setprecision(6)
+                    << candidate.RmsError;
+        }
+
+
         std::ostream& _stream;
         bool _firstTest;
     };
@@ -5,6 +5,7 @@
 #include <vector>
 #include <sstream>
 #include <map>
+#include <utility>
 
 #include "hayai_outputter.hpp"
 
@@ -23,7 +24,9 @@ namespace hayai
             TestCase(const std::string& fixtureName,
                      const std::string& testName,
                      const TestParametersDescriptor& parameters,
-                     const TestResult* result)
+                     const TestResult* result,
+                     const std::string& failure = std::string())
+                :   Failure(failure)
             {
                 // Derive a pretty name.
                 std::stringstream nameStream;
@@ -34,7 +37,7 @@ namespace hayai
                 Name = nameStream.str();
 
                 // Derive the result.
-                Skipped = !result;
+                Skipped = ((!result) && (failure.empty()));
 
                 if (result)
                 {
@@ -43,6 +46,340 @@ namespace hayai
                                << std::setprecision(9)
                                << (result->IterationTimeAverage() / 1e9);
                     Time = timeStream.str();
+
+                    // Percentiles of the time per iteration, from the
+                    // sampled iterations if available.
+                    static const double percentiles[] = {
+                        50.0, 90.0, 99.0, 99.9
+                    };
+                    static const char* percentileNames[] = {
+                        "p50", "p90", "p99", "p99.9"
+                    };
+
+                    for (std::size_t percentile = 0;
+                         percentile < 4;
+                         ++percentile)
+                    {
+                        std::stringstream valueStream;
+                        valueStream << std::fixed
+                                    << std::setprecision(9)
+                                    << (result->IterationTimePercentile(
+                                            percentiles[percentile]
+                                        ) / 1e9);
+                        Properties.push_back(std::make_pair(
+                            std::string("time_") +
+                                percentileNames[percentile],
+                            valueStream.str()
+                        ));
+                    }
+
+                    {
+                        std::stringstream valueStream;
+                        valueStream << std::fixed
+                                    << std::setprecision(9)
+                                    << (result->IterationTimeMaximum() / 1e9);
+                        Properties.push_back(std::make_pair(
+                            std::string("time_max"),
+                            valueStream.str()
+                        ));
+                    }
+
+                    // Regression on linearly increasing iteration counts.
+                    if (result->IsLinear())
+                    {
+                        const LinearRegression& regression =
+                            result->IterationTimeRegression();
+                        const double values[] = {
+                            regression.Slope / 1e9,
+                            regression.SlopeLower / 1e9,
+                            regression.SlopeUpper / 1e9,
+                            regression.Intercept / 1e9,
+                            regression.RSquared
+                        };
+                        static const char* names[] = {
+                            "time_slope",
+                            "time_slope_lower",
+                            "time_slope_upper",
+                            "run_overhead",
+                            "r_squared"
+                        };
+
+                        for (std::size_t value = 0; value < 5; ++value)
+                        {
+                            std::stringstream valueStream;
+                            valueStream << std::fixed
+                                        << std::setprecision(9)
+                                        << values[value];
+                            Properties.push_back(std::make_pair(
+                                std::string(names[value]),
+                                valueStream.str()
+                            ));
+                        }
+                    }
+
+                    // Outliers and the trimmed time per iteration.
+                    {
+                        std::stringstream mildStream;
+                        std::stringstream severeStream;
+                        std::stringstream trimmedStream;
+
+                        mildStream << result->MildOutliers();
+                        severeStream << result->SevereOutliers();
+                        trimmedStream << std::fixed
+                                      << std::setprecision(9)
+                                      << (result->
+                                          IterationTimeTrimmedAverage() /
+                                          1e9);
+
+                        Properties.push_back(std::make_pair(
+                            std::string("outliers_mild"),
+                            mildStream.str()
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("outliers_severe"),
+                            severeStream.str()
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("time_trimmed_mean"),
+                            trimmedStream.str()
+                        ));
+                    }
+
+                    // Bootstrap confidence intervals of the time per
+                    // iteration.
+                    if (result->HasConfidenceIntervals())
+                    {
+                        const ConfidenceInterval intervals[] = {
+                            result->IterationTimeAverageInterval(),
+                            result->IterationTimeMedianInterval()
+                        };
+                        static const char* intervalNames[] = {
+                            "time_mean", "time_median"
+                        };
+
+                        for (std::size_t interval = 0;
+                             interval < 2;
+                             ++interval)
+                        {
+                            std::stringstream lowerStream;
+                            std::stringstream upperStream;
+                            lowerStream << std::fixed
+                                        << std::setprecision(9)
+                                        << (intervals[interval].Lower / 1e9);
+                            upperStream << std::fixed
+                                        << std::setprecision(9)
+                                        << (intervals[interval].Upper / 1e9);
+
+                            Properties.push_back(std::make_pair(
+                                std::string(intervalNames[interval]) +
+                                    "_lower",
+                                lowerStream.str()
+                            ));
+                            Properties.push_back(std::make_pair(
+                                std::string(intervalNames[interval]) +
+                                    "_upper",
+                                upperStream.str()
+                            ));
+                        }
+                    }
+
+                    // Sampling interval of the percentiles.
+                    if (result->IsSampled())
+                    {
+                        std::stringstream valueStream;
+                        valueStream << result->SampleInterval();
+                        Properties.push_back(std::make_pair(
+                            std::string("sample_interval"),
+                            valueStream.str()
+                        ));
+                    }
+
+                    // Open-loop load and latencies.
+                    if (result->IsOpenLoop())
+                    {
+                        const Histogram& latencies =
+                            result->LatencyHistogram();
+                        std::stringstream offeredStream;
+                        std::stringstream achievedStream;
+                        std::stringstream latencyStream;
+
+                        offeredStream << std::fixed
+                                      << std::setprecision(6)
+                                      << result->OfferedRate();
+                        achievedStream << std::fixed
+                                       << std::setprecision(6)
+                                       << result->AchievedRate();
+                        latencyStream << std::fixed
+                                      << std::setprecision(9)
+                                      << (double(latencies.ValueAtPercentile(
+                                              99.0
+                                          )) / 1e9);
+
+                        Properties.push_back(std::make_pair(
+                            std::string("offered_rate"),
+                            offeredStream.str()
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("achieved_rate"),
+                            achievedStream.str()
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("latency_p99"),
+                            latencyStream.str()
+                        ));
+
+                        if (result->IsSaturated())
+                        {
+                            std::stringstream valueStream;
+                            valueStream << std::fixed
+                                        << std::setprecision(6)
+                                        << result->SaturationRate();
+                            Properties.push_back(std::make_pair(
+                                std::string("saturation_rate"),
+                                valueStream.str()
+                            ));
+                        }
+                    }
+
+                    // Warm-up runs.
+                    if (result->WarmUpRuns())
+                    {
+                        std::stringstream valueStream;
+                        valueStream << result->WarmUpRuns();
+                        Properties.push_back(std::make_pair(
+                            std::string("warm_up_runs"),
+                            valueStream.str()
+                        ));
+                    }
+
+                    // Adaptive run count outcome.
+                    if (result->IsAdaptive())
+                        Properties.push_back(std::make_pair(
+                            std::string("converged"),
+                            std::string(result->Converged() ?
+                                        "true" :
+                                        "false")
+                        ));
+
+                    // Aggregate performance of multi-threaded tests.
+                    if (result->IsThreaded())
+                    {
+                        std::stringstream valueStream;
+                        valueStream << std::fixed
+                                    << std::setprecision(6)
+                                    << result->
+                                        AggregateIterationsPerSecondAverage();
+                        Properties.push_back(std::make_pair(
+                            std::string("aggregate_iterations_per_second"),
+                            valueStream.str()
+                        ));
+                    }
+
+                    // Comparison with the baseline.
+                    if (result->HasBaselineComparison())
+                    {
+                        const BaselineComparison& comparison =
+                            result->BaselineComparisonResult();
+                        std::stringstream changeStream;
+                        std::stringstream pStream;
+
+                        changeStream << std::fixed
+                                     << std::setprecision(6)
+                                     << comparison.RelativeChange;
+                        pStream << std::fixed
+                                << std::setprecision(6)
+                                << comparison.PValue;
+
+                        Properties.push_back(std::make_pair(
+                            std::string("baseline_change"),
+                            std::string(
+                                comparison.Change == BaselineImproved ?
+                                "improved" :
+                                comparison.Change == BaselineRegressed ?
+                                "regressed" :
+                                "unchanged"
+                            )
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("baseline_relative_change"),
+                            changeStream.str()
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("baseline_p_value"),
+                            pStream.str()
+                        ));
+                    }
+
+                    // Performance counters per iteration.
+                    const std::vector<std::string>& counterNames =
+                        result->PerformanceCounterNames();
+
+                    for (std::size_t counter = 0;
+                         counter < counterNames.size();
+                         ++counter)
+                    {
+                        std::stringstream valueStream;
+                        valueStream << std::fixed
+                                    << std::setprecision(6)
+                                    << result->
+                                        PerformanceCounterIterationAverage(
+                                            counter
+                                        );
+                        Properties.push_back(std::make_pair(
+                            counterNames[counter] + "_per_iteration",
+                            valueStream.str()
+                        ));
+                    }
+
+                    // Total resource usage of the runs, with the CPU times in
+                    // seconds.
+                    if (result->HasResourceUsage())
+                    {
+                        const ResourceUsage usage =
+                            result->TotalResourceUsage();
+                        const uint64_t counts[] = {
+                            usage.MinorFaults,
+                            usage.MajorFaults,
+                            usage.VoluntaryContextSwitches,
+                            usage.InvoluntaryContextSwitches,
+                            usage.PeakResidentSetSize
+                        };
+                        const char* const countNames[] = {
+                            "minor_faults",
+                            "major_faults",
+                            "voluntary_context_switches",
+                            "involuntary_context_switches",
+                            "peak_rss_growth"
+                        };
+
+                        for (std::size_t count = 0; count < 5; ++count)
+                        {
+                            std::stringstream valueStream;
+                            valueStream << counts[count];
+                            Properties.push_back(std::make_pair(
+                                std::string(countNames[count]),
+                                valueStream.str()
+                            ));
+                        }
+
+                        std::stringstream userStream;
+                        std::stringstream systemStream;
+                        userStream << std::fixed
+                                   << std::setprecision(9)
+                                   << (double(usage.UserTime) / 1e9);
+                        systemStream << std::fixed
+                                     << std::setprecision(9)
+                                     << (double(usage.SystemTime) / 1e9);
+
+                        Properties.push_back(std::make_pair(
+                            std::string("user_time"),
+                            userStream.str()
+                        ));
+                        Properties.push_back(std::make_pair(
+                            std::string("system_time"),
+                            systemStream.str()
+                        ));
+                    }
                 }
             }
 
@@ -50,6 +387,8 @@ namespace hayai
             std::string Name;
             std::string Time;
             bool Skipped;
+            std::string Failure;
+            std::vector<std::pair<std::string, std::string> > Properties;
         };
 
 
@@ -95,6 +434,25 @@ namespace hayai
                         << "\" tests=\"" << testSuiteIt->second.size() << "\">"
                         << std::endl;
 
+                // Write out the metadata as the properties of the suite.
+                if (!_metadata.empty())
+                {
+                    _stream << "        <properties>" << std::endl;
+
+                    for (std::size_t index = 0;
+                         index < _metadata.size();
+                         ++index)
+                    {
+                        _stream << "            <property name=\"";
+                        WriteEscapedString(_metadata[index].first);
+                        _stream << "\" value=\"";
+                        WriteEscapedString(_metadata[index].second);
+                        _stream << "\" />" << std::endl;
+                    }
+
+                    _stream << "        </properties>" << std::endl;
+                }
+
                 // Write out each test case.
                 for (std::vector<TestCase>::iterator testCaseIt =
                          testSuiteIt->second.begin();
@@ -105,9 +463,41 @@ namespace hayai
                     WriteEscapedString(testCaseIt->Name);
                     _stream << "\"";
 
-                    if (!testCaseIt->Skipped)
+                    if (!testCaseIt->Failure.empty())
+                    {
+                        _stream << ">" << std::endl
+                                << "            <failure message=\"";
+                        WriteEscapedString(testCaseIt->Failure);
+                        _stream << "\" />" << std::endl
+                                << "        </testcase>" << std::endl;
+                    }
+                    else if ((!testCaseIt->Skipped) &&
+                             (testCaseIt->Properties.empty()))
                         _stream << " time=\"" << testCaseIt->Time << "\" />"
                                 << std::endl;
+                    else if (!testCaseIt->Skipped)
+                    {
+                        _stream << " time=\"" << testCaseIt->Time << "\">"
+                                << std::endl
+                                << "            <properties>" << std::endl;
+
+                        for (std::vector<
+                                 std::pair<std::string, std::string>
+                             >::iterator propertyIt =
+                                 testCaseIt->Properties.begin();
+                             propertyIt != testCaseIt->Properties.end();
+                             ++propertyIt)
+                        {
+                            _stream << "                <property name=\"";
+                            WriteEscapedString(propertyIt->first);
+                            _stream << "\" value=\"";
+                            WriteEscapedString(propertyIt->second);
+                            _stream << "\" />" << std::endl;
+                        }
+
+                        _stream << "            </properties>" << std::endl
+                                << "        </testcase>" << std::endl;
+                    }
                     else
                     {
                         _stream << ">" << std::endl
@@ -208,6 +598,27 @@ namespace hayai
             EndTestObject();
             */
         }
+
+
+        virtual void Metadata(const std::vector<
+                                  std::pair<std::string, std::string>
+                              >& metadata)
+        {
+            _metadata = metadata;
+        }
+
+
+        virtual void FailTest(const std::string& fixtureName,
+                              const std::string& testName,
+                              const TestParametersDescriptor& parameters,
+                              const std::string& reason)
+        {
+            _testSuites[fixtureName].push_back(TestCase(fixtureName,
+                                                        testName,
+                                                        parameters,
+                                                        NULL,
+                                                        reason));
+        }
     private:
         /// Write an escaped string.
 
@@ -254,6 +665,7 @@ namespace hayai
 
         std::ostream& _stream;
         TestSuiteMap _testSuites;
+        std::vector<std::pair<std::string, std::string> > _metadata;
     };
 }
 
@@ -26,6 +26,9 @@
 #define HAYAI_MAIN_FORMAT_ERROR(_desc)                                  \
     ::hayai::Console::TextRed << "Error:" <<                            \
         ::hayai::Console::TextDefault << " " << _desc
+#define HAYAI_MAIN_FORMAT_WARNING(_desc)                                \
+    ::hayai::Console::TextYellow << "Warning:" <<                       \
+        ::hayai::Console::TextDefault << " " << _desc
 #define HAYAI_MAIN_USAGE_ERROR(_desc)                                   \
     {                                                                   \
         std::cerr << HAYAI_MAIN_FORMAT_ERROR(_desc) << std::endl        \
@@ -146,6 +149,34 @@ namespace hayai
         MainRunner()
             :   ExecutionMode(MainRunBenchmarks),
                 ShuffleBenchmarks(false),
+                Isolate(false),
+                IsolationTimeout(0),
+                Jobs(1),
+                RealtimePriority(0),
+                LockMemory(false),
+                ThreadPlacement(::hayai::ThreadPlacementNone),
+                PerformanceCounters(false),
+                MinimumRunTime(0),
+                AdaptiveTarget(0.0),
+                AdaptiveStatistic(StatisticMedian),
+                AdaptiveMinimumRuns(5),
+                AdaptiveMaximumRuns(1000),
+                AdaptiveTimeBudget(10000000000ULL),
+                WarmUpRuns(0),
+                WarmUpTime(0),
+                Recalibrate(false),
+                CalibrationCacheSet(false),
+                HistogramSignificantDigits(HAYAI_HISTOGRAM_SIGNIFICANT_DIGITS),
+                SampleInterval(0),
+                OpenLoopRate(0.0),
+                OpenLoopMaximumRate(0.0),
+                OpenLoopSteps(8),
+                LinearSampling(false),
+                BootstrapResamples(0),
+                BootstrapLevel(HAYAI_BOOTSTRAP_LEVEL),
+                BootstrapSeed(HAYAI_BOOTSTRAP_SEED),
+                BootstrapThreads(1),
+                RegressionThreshold(0.05),
                 StdoutOutputter(NULL)
         {
 
@@ -174,6 +205,175 @@ namespace hayai
         bool ShuffleBenchmarks;
 
 
+        /// Run each benchmark in its own process.
+        bool Isolate;
+
+
+        /// Timeout of isolated benchmarks in nanoseconds.
+
+        /// 0 if isolated benchmarks may take any time.
+        uint64_t IsolationTimeout;
+
+
+        /// Number of isolated benchmarks to run at the same time.
+        std::size_t Jobs;
+
+
+        /// Processors to run the benchmarks on.
+
+        /// If empty, the affinity is left as is.
+        std::vector<int> Affinity;
+
+
+        /// SCHED_FIFO priority to run the benchmarks with.
+
+        /// If 0, the scheduling policy is left as is.
+        int RealtimePriority;
+
+
+        /// Lock the memory of the benchmarks.
+        bool LockMemory;
+
+
+        /// Placement of the threads of multi-threaded benchmarks.
+        ::hayai::ThreadPlacement ThreadPlacement;
+
+
+        /// Collect performance counters.
+        bool PerformanceCounters;
+
+
+        /// Raw performance counter events.
+
+        /// Counted in addition to the default events if
+        /// @ref PerformanceCounters is set.
+        std::vector< ::hayai::PerformanceCounterEvent> PerformanceCounterEvents;
+
+
+        /// Minimum run time in nanoseconds.
+
+        /// If non-zero, the number of iterations of every benchmark is
+        /// calibrated so that each run takes at least this long.
+        uint64_t MinimumRunTime;
+
+
+        /// Target relative confidence interval width for adaptive runs.
+
+        /// If non-zero, the number of runs is determined adaptively.
+        double AdaptiveTarget;
+
+
+        /// Statistic to determine the confidence interval for.
+        Statistic AdaptiveStatistic;
+
+
+        /// Minimum number of runs with adaptive run counts.
+        std::size_t AdaptiveMinimumRuns;
+
+
+        /// Maximum number of runs with adaptive run counts.
+        std::size_t AdaptiveMaximumRuns;
+
+
+        /// Time budget in nanoseconds per benchmark with adaptive run counts.
+        uint64_t AdaptiveTimeBudget;
+
+
+        /// Warm-up runs.
+
+        /// Minimum number of discarded runs before the runs of each
+        /// benchmark.
+        std::size_t WarmUpRuns;
+
+
+        /// Warm-up time in nanoseconds.
+
+        /// Minimum duration of the discarded runs before the runs of each
+        /// benchmark.
+        uint64_t WarmUpTime;
+
+
+        /// Ignore cached calibration.
+        bool Recalibrate;
+
+
+        /// Whether the calibration cache path has been set.
+
+        /// Otherwise, the calibration is cached in the file given by
+        /// @ref CalibrationCache::DefaultPath.
+        bool CalibrationCacheSet;
+
+
+        /// Calibration cache path.
+
+        /// Only used if @ref CalibrationCacheSet is true. If empty, the
+        /// calibration is not cached.
+        std::string CalibrationCachePath;
+
+
+        /// Number of significant decimal digits of result histograms.
+        int HistogramSignificantDigits;
+
+
+        /// Interval of sampled iterations.
+
+        /// If non-zero, every given iteration of each benchmark is timed
+        /// individually.
+        std::size_t SampleInterval;
+
+
+        /// Offered load in operations per second for open-loop runs.
+
+        /// If non-zero, benchmarks are run open-loop at this rate, or at
+        /// increasing rates up to @ref OpenLoopMaximumRate.
+        double OpenLoopRate;
+
+
+        /// Highest offered load of an open-loop sweep.
+
+        /// If non-zero, the offered load is swept from @ref OpenLoopRate.
+        double OpenLoopMaximumRate;
+
+
+        /// Number of offered loads of an open-loop sweep.
+        std::size_t OpenLoopSteps;
+
+
+        /// Perform runs with linearly increasing iteration counts.
+        bool LinearSampling;
+
+
+        /// Number of bootstrap resamples.
+
+        /// If non-zero, bootstrap confidence intervals are estimated for the
+        /// results of each benchmark.
+        std::size_t BootstrapResamples;
+
+
+        /// Confidence level of bootstrap confidence intervals.
+        double BootstrapLevel;
+
+
+        /// Seed of bootstrap resampling.
+        uint64_t BootstrapSeed;
+
+
+        /// Number of threads to resample on.
+        std::size_t BootstrapThreads;
+
+
+        /// Path of baseline results.
+
+        /// If not empty, results are compared with the results in the file,
+        /// which has been written by the JSON outputter.
+        std::string BaselinePath;
+
+
+        /// Relative slowdown above which a significant change from the
+        /// baseline fails the execution.
+        double RegressionThreshold;
+
+
         /// File outputters.
         ///
         /// Outputter will be freed by the class on destruction.
@@ -218,6 +418,343 @@ namespace hayai
                 // Shuffle flag.
                 else if ((!strcmp(arg, "-s")) || (!strcmp(arg, "--shuffle")))
                     ShuffleBenchmarks = true;
+                // Process isolation.
+                else if (!strcmp(arg, "--isolate"))
+                    Isolate = true;
+                else if (!strcmp(arg, "--timeout"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a duration to be specified");
+                    char* duration = argv[argI++];
+
+                    if ((!ParseDuration(duration, IsolationTimeout)) ||
+                        (!IsolationTimeout))
+                        HAYAI_MAIN_USAGE_ERROR("invalid duration: " <<
+                                               duration);
+
+                    Isolate = true;
+                }
+                else if ((!strcmp(arg, "-j")) || (!strcmp(arg, "--jobs")))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a count to be specified");
+                    char* count = argv[argI++];
+
+                    if (!ParseCount(count, Jobs))
+                        HAYAI_MAIN_USAGE_ERROR("invalid count: " << count);
+
+                    Isolate = true;
+                }
+                // Scheduling controls.
+                else if (!strcmp(arg, "--affinity"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a processor list to be "
+                                    "specified");
+                    char* cpus = argv[argI++];
+
+                    if ((!::hayai::CpuTopology::ParseCpuList(cpus,
+                                                             Affinity)) ||
+                        (Affinity.empty()))
+                        HAYAI_MAIN_USAGE_ERROR("invalid processor list: " <<
+                                               cpus);
+                }
+                else if (!strcmp(arg, "--realtime"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a priority to be specified");
+                    char* priority = argv[argI++];
+                    std::size_t value;
+
+                    if ((!ParseCount(priority, value)) || (value > 99))
+                        HAYAI_MAIN_USAGE_ERROR("invalid priority: " <<
+                                               priority);
+
+                    RealtimePriority = int(value);
+                }
+                else if (!strcmp(arg, "--lock-memory"))
+                    LockMemory = true;
+                else if (!strcmp(arg, "--thread-placement"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(
+                            HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                            " requires an argument " <<
+                            "of either " << HAYAI_MAIN_FORMAT_FLAG("compact") <<
+                            ", " << HAYAI_MAIN_FORMAT_FLAG("scatter") <<
+                            " or " << HAYAI_MAIN_FORMAT_FLAG("cores")
+                        );
+
+                    char* choice = argv[argI++];
+
+                    if (!strcmp(choice, "compact"))
+                        ThreadPlacement = ::hayai::ThreadPlacementCompact;
+                    else if (!strcmp(choice, "scatter"))
+                        ThreadPlacement = ::hayai::ThreadPlacementScatter;
+                    else if (!strcmp(choice, "cores"))
+                        ThreadPlacement = ::hayai::ThreadPlacementCores;
+                    else
+                        HAYAI_MAIN_USAGE_ERROR(
+                            "invalid argument to " <<
+                            HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                            ": " << choice
+                        );
+                }
+                // Minimum run time.
+                else if (!strcmp(arg, "--min-time"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a duration to be specified");
+                    char* duration = argv[argI++];
+
+                    if ((!ParseDuration(duration, MinimumRunTime)) ||
+                        (!MinimumRunTime))
+                        HAYAI_MAIN_USAGE_ERROR("invalid duration: " <<
+                                               duration);
+                }
+                // Adaptive run count.
+                else if (!strcmp(arg, "--adaptive"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a relative width to be " <<
+                                    "specified");
+                    char* width = argv[argI++];
+
+                    if ((!ParseRatio(width, AdaptiveTarget)) ||
+                        (AdaptiveTarget <= 0.0))
+                        HAYAI_MAIN_USAGE_ERROR("invalid relative width: " <<
+                                               width);
+                }
+                else if (!strcmp(arg, "--adaptive-statistic"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(
+                            HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                            " requires an argument " <<
+                            "of either " << HAYAI_MAIN_FORMAT_FLAG("mean") <<
+                            " or " << HAYAI_MAIN_FORMAT_FLAG("median")
+                        );
+
+                    char* choice = argv[argI++];
+
+                    if (!strcmp(choice, "mean"))
+                        AdaptiveStatistic = ::hayai::StatisticMean;
+                    else if (!strcmp(choice, "median"))
+                        AdaptiveStatistic = ::hayai::StatisticMedian;
+                    else
+                        HAYAI_MAIN_USAGE_ERROR(
+                            "invalid argument to " <<
+                            HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                            ": " << choice
+                        );
+                }
+                else if ((!strcmp(arg, "--min-runs")) ||
+                         (!strcmp(arg, "--max-runs")))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a count to be specified");
+                    char* count = argv[argI++];
+
+                    if (!ParseCount(count,
+                                    (arg[3] == 'i' ?
+                                     AdaptiveMinimumRuns :
+                                     AdaptiveMaximumRuns)))
+                        HAYAI_MAIN_USAGE_ERROR("invalid count: " << count);
+                }
+                else if (!strcmp(arg, "--max-time"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a duration to be specified");
+                    char* duration = argv[argI++];
+
+                    if (!ParseDuration(duration, AdaptiveTimeBudget))
+                        HAYAI_MAIN_USAGE_ERROR("invalid duration: " <<
+                                               duration);
+                }
+                // Calibration cache.
+                else if (!strcmp(arg, "--recalibrate"))
+                    Recalibrate = true;
+                else if (!strcmp(arg, "--calibration-cache"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a path to be specified");
+                    CalibrationCachePath = argv[argI++];
+                    CalibrationCacheSet = true;
+                }
+                // Histogram precision.
+                else if (!strcmp(arg, "--histogram-digits"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a count to be specified");
+                    char* digits = argv[argI++];
+                    std::size_t count;
+
+                    if ((!ParseCount(digits, count)) || (count > 5))
+                        HAYAI_MAIN_USAGE_ERROR("invalid number of digits: " <<
+                                               digits);
+
+                    HistogramSignificantDigits = int(count);
+                }
+                // Iteration sampling.
+                else if (!strcmp(arg, "--sample-iterations"))
+                {
+                    if ((!argLast) && (*argv[argI] != '-'))
+                    {
+                        char* interval = argv[argI++];
+
+                        if (!ParseCount(interval, SampleInterval))
+                            HAYAI_MAIN_USAGE_ERROR("invalid interval: " <<
+                                                   interval);
+                    }
+                    else
+                        SampleInterval = 1;
+                }
+                // Linearly sampled runs.
+                else if (!strcmp(arg, "--linear"))
+                    LinearSampling = true;
+                // Bootstrap confidence intervals.
+                else if (!strcmp(arg, "--bootstrap"))
+                {
+                    if ((!argLast) && (*argv[argI] != '-'))
+                    {
+                        char* resamples = argv[argI++];
+
+                        if (!ParseCount(resamples, BootstrapResamples))
+                            HAYAI_MAIN_USAGE_ERROR("invalid count: " <<
+                                                   resamples);
+                    }
+                    else
+                        BootstrapResamples = HAYAI_BOOTSTRAP_RESAMPLES;
+                }
+                else if (!strcmp(arg, "--bootstrap-level"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a ratio to be specified");
+                    char* level = argv[argI++];
+
+                    if ((!ParseRatio(level, BootstrapLevel)) ||
+                        (BootstrapLevel <= 0.0) ||
+                        (BootstrapLevel >= 1.0))
+                        HAYAI_MAIN_USAGE_ERROR("invalid ratio: " << level);
+                }
+                else if (!strcmp(arg, "--bootstrap-seed"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a seed to be specified");
+                    char* seed = argv[argI++];
+                    char* end;
+                    const unsigned long value = strtoul(seed, &end, 10);
+
+                    if ((end == seed) || (*end) || (*seed == '-'))
+                        HAYAI_MAIN_USAGE_ERROR("invalid seed: " << seed);
+
+                    BootstrapSeed = uint64_t(value);
+                }
+                else if (!strcmp(arg, "--bootstrap-threads"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a count to be specified");
+                    char* count = argv[argI++];
+
+                    if (!ParseCount(count, BootstrapThreads))
+                        HAYAI_MAIN_USAGE_ERROR("invalid count: " << count);
+                }
+                // Open-loop runs.
+                else if (!strcmp(arg, "--rate"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a rate to be specified");
+                    char* rate = argv[argI++];
+
+                    if (!ParseRate(rate, OpenLoopRate))
+                        HAYAI_MAIN_USAGE_ERROR("invalid rate: " << rate);
+
+                    OpenLoopMaximumRate = 0.0;
+                }
+                else if (!strcmp(arg, "--rate-sweep"))
+                {
+                    if (argI + 2 > argc)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a minimum and maximum rate "
+                                    "to be specified");
+                    char* minimum = argv[argI++];
+                    char* maximum = argv[argI++];
+
+                    if (!ParseRate(minimum, OpenLoopRate))
+                        HAYAI_MAIN_USAGE_ERROR("invalid rate: " << minimum);
+                    if ((!ParseRate(maximum, OpenLoopMaximumRate)) ||
+                        (OpenLoopMaximumRate <= OpenLoopRate))
+                        HAYAI_MAIN_USAGE_ERROR("invalid rate: " << maximum);
+                }
+                else if (!strcmp(arg, "--rate-steps"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a count to be specified");
+                    char* count = argv[argI++];
+
+                    if ((!ParseCount(count, OpenLoopSteps)) ||
+                        (OpenLoopSteps < 2))
+                        HAYAI_MAIN_USAGE_ERROR("invalid count: " << count);
+                }
+                // Warm-up.
+                else if (!strcmp(arg, "--warm-up-runs"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a count to be specified");
+                    char* count = argv[argI++];
+
+                    if (!ParseCount(count, WarmUpRuns))
+                        HAYAI_MAIN_USAGE_ERROR("invalid count: " << count);
+                }
+                else if (!strcmp(arg, "--warm-up-time"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a duration to be specified");
+                    char* duration = argv[argI++];
+
+                    if (!ParseDuration(duration, WarmUpTime))
+                        HAYAI_MAIN_USAGE_ERROR("invalid duration: " <<
+                                               duration);
+                }
+                // Performance counters flag.
+                else if (!strcmp(arg, "--perf"))
+                    PerformanceCounters = true;
+                // Raw performance counter events.
+                else if (!strcmp(arg, "--perf-event"))
+                {
+                    if ((argLast) || (*argv[argI] == 0))
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires an event to be specified");
+                    char* specification = argv[argI++];
+                    ::hayai::PerformanceCounterEvent event("", 0, 0);
+
+                    if (!::hayai::PerformanceCounterGroup::ParseRawEvent(
+                            specification,
+                            event
+                        ))
+                        HAYAI_MAIN_USAGE_ERROR("invalid raw event: " <<
+                                               specification);
+
+                    PerformanceCounters = true;
+                    PerformanceCounterEvents.push_back(event);
+                }
                 // Filter flag.
                 else if ((!strcmp(arg, "-f")) || (!strcmp(arg, "--filter")))
                 {
@@ -271,6 +808,25 @@ namespace hayai
 
 #undef ADD_OUTPUTTER
                 }
+                // Baseline comparison.
+                else if (!strcmp(arg, "--baseline"))
+                {
+                    if ((argLast) || (*argv[argI] == 0))
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a path to be specified");
+                    BaselinePath = argv[argI++];
+                }
+                else if (!strcmp(arg, "--regression-threshold"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                                    " requires a ratio to be specified");
+                    char* threshold = argv[argI++];
+
+                    if ((!ParseRatio(threshold, RegressionThreshold)) ||
+                        (RegressionThreshold < 0.0))
+                        HAYAI_MAIN_USAGE_ERROR("invalid ratio: " << threshold);
+                }
                 // Console coloring flag.
                 else if ((!strcmp(arg, "-c")) || (!strcmp(arg, "--color")))
                 {
@@ -304,6 +860,38 @@ namespace hayai
 
                     ::hayai::Console::SetFormattingEnabled(enabled);
                 }
+                // Clock backend.
+                else if (!strcmp(arg, "--clock"))
+                {
+                    if (argLast)
+                        HAYAI_MAIN_USAGE_ERROR(
+                            HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                            " requires an argument " <<
+                            "of either " << HAYAI_MAIN_FORMAT_FLAG("system") <<
+                            " or " << HAYAI_MAIN_FORMAT_FLAG("tsc")
+                        );
+
+                    char* choice = argv[argI++];
+                    ::hayai::ClockBackend backend;
+
+                    if (!strcmp(choice, "system"))
+                        backend = ::hayai::ClockBackendSystem;
+                    else if (!strcmp(choice, "tsc"))
+                        backend = ::hayai::ClockBackendTsc;
+                    else
+                        HAYAI_MAIN_USAGE_ERROR(
+                            "invalid argument to " <<
+                            HAYAI_MAIN_FORMAT_FLAG(arg) <<
+                            ": " << choice
+                        );
+
+                    if (!::hayai::Clock::SetBackend(backend))
+                        std::cerr << HAYAI_MAIN_FORMAT_WARNING(
+                            "clock backend " << choice << " is not " <<
+                            "supported on this system, falling back to " <<
+                            ::hayai::Clock::Description()
+                        ) << std::endl;
+                }
                 // Help.
                 else if ((!strcmp(arg, "-?")) ||
                          (!strcmp(arg, "-h")) ||
@@ -377,6 +965,193 @@ namespace hayai
                 ::hayai::Benchmarker::AddOutputter(fileOutputter.Outputter());
             }
 
+            // Load the baseline.
+            ::hayai::Baseline baseline;
+
+            if (!BaselinePath.empty())
+            {
+                try
+                {
+                    baseline.Load(BaselinePath);
+                }
+                catch (std::exception& e)
+                {
+                    std::cerr << HAYAI_MAIN_FORMAT_ERROR(e.what()) << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                ::hayai::Benchmarker::SetBaseline(baseline,
+                                                  RegressionThreshold);
+            }
+
+            if (MinimumRunTime)
+                ::hayai::Benchmarker::SetMinimumRunTime(MinimumRunTime);
+
+            ::hayai::Benchmarker::SetCalibrationCache(
+                CalibrationCacheSet ?
+                CalibrationCachePath :
+                ::hayai::CalibrationCache::DefaultPath()
+            );
+
+            if (Recalibrate)
+                ::hayai::Benchmarker::Recalibrate();
+
+            ::hayai::Benchmarker::SetHistogramSignificantDigits(
+                HistogramSignificantDigits
+            );
+
+            if (SampleInterval)
+                ::hayai::Benchmarker::SetIterationSampling(SampleInterval);
+
+            if (LinearSampling)
+                ::hayai::Benchmarker::SetLinearSampling(true);
+
+            if (BootstrapResamples)
+                ::hayai::Benchmarker::SetBootstrap(BootstrapResamples,
+                                                   BootstrapLevel,
+                                                   BootstrapSeed,
+                                                   BootstrapThreads);
+
+            if (OpenLoopMaximumRate > 0.0)
+                ::hayai::Benchmarker::SetOpenLoopSweep(OpenLoopRate,
+                                                       OpenLoopMaximumRate,
+                                                       OpenLoopSteps);
+            else if (OpenLoopRate > 0.0)
+                ::hayai::Benchmarker::SetOpenLoop(OpenLoopRate);
+
+            if ((WarmUpRuns) || (WarmUpTime))
+                ::hayai::Benchmarker::SetWarmUp(WarmUpRuns, WarmUpTime);
+
+            if (AdaptiveTarget > 0.0)
+                ::hayai::Benchmarker::EnableAdaptiveRuns(AdaptiveTarget,
+                                                         AdaptiveStatistic,
+                                                         AdaptiveMinimumRuns,
+                                                         AdaptiveMaximumRuns,
+                                                         AdaptiveTimeBudget);
+
+            // Enable performance counters.
+            if (PerformanceCounters)
+            {
+                std::vector< ::hayai::PerformanceCounterEvent> events =
+                    ::hayai::PerformanceCounterGroup::DefaultEvents();
+                events.insert(events.end(),
+                              PerformanceCounterEvents.begin(),
+                              PerformanceCounterEvents.end());
+
+                std::vector<std::string> errors;
+                bool available =
+                    ::hayai::Benchmarker::EnablePerformanceCounters(events,
+                                                                    &errors);
+
+                for (std::vector<std::string>::iterator it = errors.begin();
+                     it != errors.end();
+                     ++it)
+                    std::cerr << HAYAI_MAIN_FORMAT_WARNING(
+                        "performance counter unavailable: " << *it
+                    ) << std::endl;
+
+                if (!available)
+                    std::cerr << HAYAI_MAIN_FORMAT_WARNING(
+                        "running benchmarks without performance counters"
+                    ) << std::endl;
+            }
+
+            // Apply the scheduling controls before any thread or process is
+            // started, so that they inherit them, and record the outcome.
+            if (!Affinity.empty())
+            {
+                std::string error;
+
+                if (::hayai::Scheduling::SetAffinity(Affinity, &error))
+                {
+                    ::hayai::Scheduling::GetAffinity(Affinity);
+                    ::hayai::Benchmarker::AddMetadata(
+                        "affinity",
+                        ::hayai::Scheduling::FormatCpuList(Affinity)
+                    );
+                }
+                else
+                    ApplicationFailed(
+                        "affinity",
+                        ::hayai::Scheduling::FormatCpuList(Affinity),
+                        error
+                    );
+            }
+
+            if (RealtimePriority)
+            {
+                std::stringstream setting;
+                setting << "SCHED_FIFO priority " << RealtimePriority;
+                std::string error;
+
+                if (::hayai::Scheduling::SetRealtimePriority(RealtimePriority,
+                                                             &error))
+                    ::hayai::Benchmarker::AddMetadata("scheduling_policy",
+                                                      setting.str());
+                else
+                    ApplicationFailed("scheduling_policy",
+                                      setting.str(),
+                                      error);
+            }
+
+            if (LockMemory)
+            {
+                std::string error;
+
+                if (::hayai::Benchmarker::LockMemory(&error))
+                    ::hayai::Benchmarker::AddMetadata("memory_lock",
+                                                      "all pages");
+                else
+                    ApplicationFailed("memory_lock", "all pages", error);
+            }
+
+            if (ThreadPlacement != ::hayai::ThreadPlacementNone)
+            {
+                const char* setting =
+                    (ThreadPlacement == ::hayai::ThreadPlacementCompact ?
+                     "compact" :
+                     ThreadPlacement == ::hayai::ThreadPlacementScatter ?
+                     "scatter" :
+                     "cores");
+
+                if (::hayai::Benchmarker::SetThreadPlacement(ThreadPlacement))
+                    ::hayai::Benchmarker::AddMetadata("thread_placement",
+                                                      setting);
+                else
+                    ApplicationFailed("thread_placement",
+                                      setting,
+                                      "processor topology unavailable");
+            }
+
+            // Record the environment the benchmarks are run in, once the
+            // scheduling controls limit the processors they are run on.
+            const ::hayai::Environment::Entries environment =
+                ::hayai::Environment::Collect();
+
+            for (std::size_t index = 0; index < environment.size(); ++index)
+                ::hayai::Benchmarker::AddMetadata(environment[index].first,
+                                                  environment[index].second);
+
+            if ((Isolate) &&
+                (!::hayai::Benchmarker::SetIsolation(true, IsolationTimeout)))
+                std::cerr << HAYAI_MAIN_FORMAT_WARNING(
+                    "process isolation is not supported on this system, "
+                    "running benchmarks in process"
+                ) << std::endl;
+            else if (Jobs > 1)
+            {
+                const std::size_t jobs =
+                    ::hayai::Benchmarker::SetJobs(Jobs);
+
+                if (jobs < Jobs)
+                    std::cerr << HAYAI_MAIN_FORMAT_WARNING(
+                        "only " << jobs << " processor" <<
+                        (jobs == 1 ? " is" : "s are") << " available, "
+                        "running " << jobs << " benchmark" <<
+                        (jobs == 1 ? "" : "s") << " at a time"
+                    ) << std::endl;
+            }
+
             // Run the benchmarks.
             if (ShuffleBenchmarks)
             {
@@ -386,7 +1161,48 @@ namespace hayai
 
             ::hayai::Benchmarker::RunAllTests();
 
-            return EXIT_SUCCESS;
+            // Fail on failed benchmarks and regressions from the baseline.
+            const std::size_t failures = ::hayai::Benchmarker::Failures();
+            const std::size_t regressions =
+                ::hayai::Benchmarker::Regressions();
+
+            if (failures)
+                std::cerr << HAYAI_MAIN_FORMAT_ERROR(
+                    failures << " benchmark" <<
+                    (failures == 1 ? "" : "s") << " failed"
+                ) << std::endl;
+
+            if (regressions)
+                std::cerr << HAYAI_MAIN_FORMAT_ERROR(
+                    regressions << " benchmark" <<
+                    (regressions == 1 ? "" : "s") <<
+                    " regressed from the baseline"
+                ) << std::endl;
+
+            return ((failures) || (regressions) ?
+                    EXIT_FAILURE :
+                    EXIT_SUCCESS);
+        }
+
+
+        /// Report a scheduling control that could not be applied.
+
+        /// Warns about the failure and records it in the metadata.
+        ///
+        /// @param name Name of the metadata entry.
+        /// @param setting Requested setting.
+        /// @param reason Reason of the failure.
+        static void ApplicationFailed(const std::string& name,
+                                      const std::string& setting,
+                                      const std::string& reason)
+        {
+            std::cerr << HAYAI_MAIN_FORMAT_WARNING(
+                "failed to apply " << name << " " << setting << ": " << reason
+            ) << std::endl;
+
+            ::hayai::Benchmarker::AddMetadata(name,
+                                              setting + " not applied: " +
+                                              reason);
         }
 
 
@@ -427,6 +1243,112 @@ namespace hayai
         }
 
 
+        /// Parse a duration.
+
+        /// Durations are given as a decimal number followed by one of the
+        /// units ns, us, ms or s. Numbers without a unit are in seconds.
+        ///
+        /// @param str Duration string.
+        /// @param nanoseconds Duration in nanoseconds on success.
+        /// @returns true if the duration is valid.
+        static bool ParseDuration(const char* str, uint64_t& nanoseconds)
+        {
+            char* unit;
+            double value = strtod(str, &unit);
+            double scale;
+
+            if ((unit == str) || (value < 0.0))
+                return false;
+
+            if ((!*unit) || (!strcmp(unit, "s")))
+                scale = 1e9;
+            else if (!strcmp(unit, "ms"))
+                scale = 1e6;
+            else if (!strcmp(unit, "us"))
+                scale = 1e3;
+            else if (!strcmp(unit, "ns"))
+                scale = 1.0;
+            else
+                return false;
+
+            nanoseconds = static_cast<uint64_t>(value * scale);
+            return true;
+        }
+
+
+        /// Parse a ratio.
+
+        /// Ratios are given either as a decimal number, eg. 0.01, or as a
+        /// percentage, eg. 1%.
+        ///
+        /// @param str Ratio string.
+        /// @param ratio Ratio on success.
+        /// @returns true if the ratio is valid.
+        static bool ParseRatio(const char* str, double& ratio)
+        {
+            char* end;
+            double value = strtod(str, &end);
+
+            if (end == str)
+                return false;
+
+            if (!strcmp(end, "%"))
+                value /= 100.0;
+            else if (*end)
+                return false;
+
+            ratio = value;
+            return true;
+        }
+
+
+        /// Parse a rate.
+
+        /// Rates are given in operations per second as a decimal number,
+        /// optionally followed by k or M for thousands or millions, eg.
+        /// 200k.
+        ///
+        /// @param str Rate string.
+        /// @param rate Rate on success.
+        /// @returns true if the rate is valid and positive.
+        static bool ParseRate(const char* str, double& rate)
+        {
+            char* end;
+            double value = strtod(str, &end);
+
+            if ((end == str) || (!(value > 0.0)))
+                return false;
+
+            if (!strcmp(end, "k"))
+                value *= 1000.0;
+            else if (!strcmp(end, "M"))
+                value *= 1000000.0;
+            else if (*end)
+                return false;
+
+            rate = value;
+            return true;
+        }
+
+
+        /// Parse a count.
+
+        /// @param str Count string.
+        /// @param count Count on success.
+        /// @returns true if the count is a valid positive integer.
+        static bool ParseCount(const char* str, std::size_t& count)
+        {
+            char* end;
+            unsigned long value = strtoul(str, &end, 10);
+
+            if ((end == str) || (*end) || (!value) || (*str == '-'))
+                return false;
+
+            count = std::size_t(value);
+            return true;
+        }
+
+
         /// Show usage.
 
         /// @param execName Executable name.
@@ -465,6 +1387,222 @@ namespace hayai
                       << std::endl
                       << "    Randomize benchmark execution order."
                       << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--isolate")
+                      << std::endl
+                      << "    Run each benchmark in its own process, so that "
+                      << "it is not affected by the" << std::endl
+                      << "    state left behind by earlier benchmarks. A "
+                      << "benchmark that crashes is" << std::endl
+                      << "    reported as failed." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--timeout")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("duration") << ">"
+                      << std::endl
+                      << "    Kill an isolated benchmark and report it as "
+                      << "failed if it takes longer" << std::endl
+                      << "    than the given duration. Implies "
+                      << HAYAI_MAIN_FORMAT_FLAG("--isolate") << "."
+                      << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("-j") << ", "
+                      << HAYAI_MAIN_FORMAT_FLAG("--jobs")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">"
+                      << std::endl
+                      << "    Run up to the given number of isolated "
+                      << "benchmarks at the same time, each" << std::endl
+                      << "    pinned to its own core. Results are reported "
+                      << "in the usual order. Implies" << std::endl
+                      << "    " << HAYAI_MAIN_FORMAT_FLAG("--isolate") << "."
+                      << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--affinity")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("cpus") << ">"
+                      << std::endl
+                      << "    Run the benchmarks only on the given processors, "
+                      << "eg. " << HAYAI_MAIN_FORMAT_ARGUMENT("2-5,8") << "."
+                      << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--realtime")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("priority") << ">"
+                      << std::endl
+                      << "    Run the benchmarks with the SCHED_FIFO real-time "
+                      << "policy at the given" << std::endl
+                      << "    priority, so that they are not preempted by "
+                      << "other processes." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--lock-memory")
+                      << std::endl
+                      << "    Lock all pages of the benchmarks into memory, so "
+                      << "that runs do not incur" << std::endl
+                      << "    page faults from paging." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--thread-placement")
+                      << " ("
+                      << ::hayai::Console::TextGreen << "compact"
+                      << ::hayai::Console::TextDefault << "|"
+                      << ::hayai::Console::TextGreen << "scatter"
+                      << ::hayai::Console::TextDefault << "|"
+                      << ::hayai::Console::TextGreen << "cores"
+                      << ::hayai::Console::TextDefault << ")" << std::endl
+                      << "    Pin the threads of multi-threaded benchmarks to "
+                      << "processors sharing as" << std::endl
+                      << "    many caches as possible, as few as possible, or "
+                      << "to one hardware thread" << std::endl
+                      << "    of each core." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--min-time")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("duration") << ">"
+                      << std::endl
+                      << "    Calibrate the number of iterations of every "
+                      << "benchmark so that each run" << std::endl
+                      << "    takes at least the given duration, eg. "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("50ms")
+                      << ". Units are " << HAYAI_MAIN_FORMAT_ARGUMENT("ns")
+                      << ", " << HAYAI_MAIN_FORMAT_ARGUMENT("us") << ", "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("ms") << " and "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("s") << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--adaptive")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("width") << ">"
+                      << std::endl
+                      << "    Repeat runs until the width of the 95 % "
+                      << "confidence interval relative" << std::endl
+                      << "    to the estimate is at most "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("width") << ", eg. "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("1%")
+                      << ", instead of the fixed number of" << std::endl
+                      << "    runs of each benchmark." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--adaptive-statistic")
+                      << " ("
+                      << ::hayai::Console::TextGreen << "mean"
+                      << ::hayai::Console::TextDefault << "|"
+                      << ::hayai::Console::TextGreen << "median"
+                      << ::hayai::Console::TextDefault << ")" << std::endl
+                      << "    Statistic to determine the confidence interval "
+                      << "for. Default "
+                      << ::hayai::Console::TextGreen << "median"
+                      << ::hayai::Console::TextDefault << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--min-runs") << " <"
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">, "
+                      << HAYAI_MAIN_FORMAT_FLAG("--max-runs") << " <"
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">"
+                      << std::endl
+                      << "    Bounds on the number of adaptive runs. Default "
+                      << "5 and 1000." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--max-time")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("duration") << ">"
+                      << std::endl
+                      << "    Time budget for the adaptive runs of each "
+                      << "benchmark. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("10s") << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--warm-up-runs")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">"
+                      << std::endl
+                      << "    Perform at least the given number of discarded "
+                      << "runs before the runs" << std::endl
+                      << "    of each benchmark. Benchmarks with their own "
+                      << "warm-up are not affected." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--warm-up-time")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("duration") << ">"
+                      << std::endl
+                      << "    Perform discarded runs for at least the given "
+                      << "duration before the" << std::endl
+                      << "    runs of each benchmark." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--recalibrate")
+                      << std::endl
+                      << "    Determine the timing overhead calibration even "
+                      << "if it has been cached" << std::endl
+                      << "    by a previous invocation, and update the cache."
+                      << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--calibration-cache")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("path") << ">"
+                      << std::endl
+                      << "    File to cache the timing overhead calibration "
+                      << "in. An empty path" << std::endl
+                      << "    disables caching. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("~/.cache/hayai/calibration")
+                      << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--histogram-digits")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">"
+                      << std::endl
+                      << "    Number of significant digits, from 1 to 5, to "
+                      << "which run times are" << std::endl
+                      << "    preserved for percentiles. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("3") << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--sample-iterations")
+                      << " [" << HAYAI_MAIN_FORMAT_ARGUMENT("interval") << "]"
+                      << std::endl
+                      << "    Time every iteration, or every "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("interval")
+                      << "th iteration, individually and" << std::endl
+                      << "    report the distribution of the iteration times."
+                      << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--linear")
+                      << std::endl
+                      << "    Perform runs with linearly increasing iteration "
+                      << "counts and estimate the" << std::endl
+                      << "    time per iteration by linear regression, "
+                      << "separating it from the fixed" << std::endl
+                      << "    time of each run." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--bootstrap")
+                      << " [" << HAYAI_MAIN_FORMAT_ARGUMENT("resamples") << "]"
+                      << std::endl
+                      << "    Estimate confidence intervals of the average and "
+                      << "median times by" << std::endl
+                      << "    resampling the runs. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("10000")
+                      << " resamples." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--bootstrap-level")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("ratio") << ">"
+                      << std::endl
+                      << "    Confidence level of the intervals. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("95%") << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--bootstrap-seed")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("seed") << ">"
+                      << std::endl
+                      << "    Seed of the resampling. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("0") << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--bootstrap-threads")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">"
+                      << std::endl
+                      << "    Number of threads to resample on. The intervals "
+                      << "do not depend on it." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--rate")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("rate") << ">"
+                      << std::endl
+                      << "    Start iterations at a fixed rate per second, eg. "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("200k")
+                      << ", and report their" << std::endl
+                      << "    latency from the intended start time."
+                      << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--rate-sweep")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("min") << "> <"
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("max") << ">" << std::endl
+                      << "    Run each benchmark at increasing rates until "
+                      << "latency knees, and report" << std::endl
+                      << "    the saturation throughput." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--rate-steps")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("count") << ">"
+                      << std::endl
+                      << "    Number of rates of a sweep. Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("8") << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--perf")
+                      << std::endl
+                      << "    Collect hardware performance counters (cycles, "
+                      << "instructions, cache" << std::endl
+                      << "    references and misses, branch misses) for each "
+                      << "run." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--perf-event")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("rNNNN") << ">"
+                      << std::endl
+                      << "    Also collect the raw event with the given "
+                      << "hexadecimal configuration." << std::endl
+                      << "    Implies " << HAYAI_MAIN_FORMAT_FLAG("--perf")
+                      << ". Can be specified multiple times." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--clock") << " ("
+                      << ::hayai::Console::TextGreen << "system"
+                      << ::hayai::Console::TextDefault << "|"
+                      << ::hayai::Console::TextGreen << "tsc"
+                      << ::hayai::Console::TextDefault << ")" << std::endl
+                      << "    Clock used for timing. "
+                      << HAYAI_MAIN_FORMAT_FLAG("tsc")
+                      << " reads the time stamp counter if the" << std::endl
+                      << "    processor provides an invariant TSC, and "
+                      << "otherwise falls back to" << std::endl
+                      << "    " << HAYAI_MAIN_FORMAT_FLAG("system")
+                      << "." << std::endl
                       << std::endl
 
                       << "Benchmark output options:" << std::endl
@@ -504,6 +1642,24 @@ namespace hayai
                       << "    Enable colored output when available. Default "
                       << ::hayai::Console::TextGreen << "yes"
                       << ::hayai::Console::TextDefault << "." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--baseline")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("path") << ">"
+                      << std::endl
+                      << "    Compare results with the "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("json")
+                      << " output of a previous execution" << std::endl
+                      << "    and report significant improvements and "
+                      << "regressions." << std::endl
+                      << "  " << HAYAI_MAIN_FORMAT_FLAG("--regression-threshold")
+                      << " <" << HAYAI_MAIN_FORMAT_ARGUMENT("ratio") << ">"
+                      << std::endl
+                      << "    Fail if a benchmark is significantly slower than "
+                      << "its baseline by more" << std::endl
+                      << "    than "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("ratio") << ", eg. "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("10%")
+                      << ". Default "
+                      << HAYAI_MAIN_FORMAT_ARGUMENT("5%") << "." << std::endl
                       << std::endl
 
                       << "Miscellaneous options:" << std::endl
@@ -525,6 +1681,7 @@ namespace hayai
 #undef HAYAI_MAIN_FORMAT_FLAG
 #undef HAYAI_MAIN_FORMAT_ARGUMENT
 #undef HAYAI_MAIN_FORMAT_ERROR
+#undef HAYAI_MAIN_FORMAT_WARNING
 #undef HAYAI_MAIN_USAGE_ERROR
 
 #endif
@@ -2,7 +2,11 @@
 #define __HAYAI_OUTPUTTER
 #include <iostream>
 #include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "hayai_complexity.hpp"
 #include "hayai_test_result.hpp"
 
 
@@ -34,6 +38,21 @@ namespace hayai
                          const std::size_t& disabledCount) = 0;
 
 
+        /// Metadata describing the benchmarks.
+
+        /// Reported after @ref Begin and before the first test if there is
+        /// any metadata, eg. the settings the benchmarks are run with.
+        /// Ignored unless overridden.
+        ///
+        /// @param metadata Names and values of the metadata entries.
+        virtual void Metadata(const std::vector<
+                                  std::pair<std::string, std::string>
+                              >& metadata)
+        {
+            (void)metadata;
+        }
+
+
         /// Begin benchmark test run.
 
         /// @param fixtureName Fixture name.
@@ -75,6 +94,46 @@ namespace hayai
                                       const std::size_t& iterationsCount) = 0;
 
 
+        /// Fail benchmark test run.
+
+        /// Reported instead of @ref EndTest if the test did not produce a
+        /// result, eg. because its isolated process crashed or timed out.
+        /// Ignored unless overridden.
+        ///
+        /// @param fixtureName Fixture name.
+        /// @param testName Test name.
+        /// @param parameters Test parameter description.
+        /// @param reason Description of the failure.
+        virtual void FailTest(const std::string& fixtureName,
+                              const std::string& testName,
+                              const TestParametersDescriptor& parameters,
+                              const std::string& reason)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+            (void)reason;
+        }
+
+
+        /// Complexity of a parametrized benchmark.
+
+        /// Reported once all instances of a benchmark with a problem size
+        /// parameter have run. Ignored unless overridden.
+        ///
+        /// @param fixtureName Fixture name.
+        /// @param testName Test name.
+        /// @param fit Complexity fit over the instances.
+        virtual void Complexity(const std::string& fixtureName,
+                                const std::string& testName,
+                                const ComplexityFit& fit)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)fit;
+        }
+
+
         virtual ~Outputter()
         {
 
@@ -0,0 +1,448 @@
+//
+// Parameter generators.
+//
+// Implementation notes:
+//
+// Generated parameter values are held as doubles, which represent every
+// integer up to 2^53 exactly, and are converted to the declared types of the
+// parameters once per run by @ref InvokePayload, which deduces the types from
+// the signature of the test payload. The payload is called through a member
+// function pointer passed to @ref InvokePayload as a run-time argument. As
+// the pointer is a constant at the inline call site, optimizing compilers
+// usually resolve the call and inline the payload into the iteration loop,
+// but unlike the payload of a literal instance, this is not guaranteed.
+//
+// The combinations of a grid are enumerated like the digits of an odometer,
+// with the last dimension varying fastest, so the instances of a product
+// are registered in the same order as nested loops would produce them.
+//
+#ifndef __HAYAI_PARAMETER_GENERATOR
+#define __HAYAI_PARAMETER_GENERATOR
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "hayai_test_factory.hpp"
+
+
+namespace hayai
+{
+    /// Values of a single parameter.
+    class ParameterValues
+    {
+    public:
+        /// Initialize an empty list of values.
+        ParameterValues()
+        {
+
+        }
+
+
+        /// Initialize a list with a single value.
+
+        /// @param value Value.
+        ParameterValues(double value)
+        {
+            _values.push_back(value);
+        }
+
+
+        /// Append a value.
+
+        /// Allows lists to be written as Values(1)(5)(10).
+        ///
+        /// @param value Value.
+        ParameterValues& operator ()(double value)
+        {
+            _values.push_back(value);
+            return *this;
+        }
+
+
+        /// Values.
+        inline const std::vector<double>& Values() const
+        {
+            return _values;
+        }
+
+
+        /// Format a value as a parameter value.
+
+        /// Integral values are written without a fractional part.
+        static std::string Format(double value)
+        {
+            std::stringstream formatted;
+
+            if ((value == std::floor(value)) && (std::fabs(value) < 1e15))
+                formatted << std::fixed << std::setprecision(0) << value;
+            else
+                formatted << std::setprecision(15) << value;
+
+            return formatted.str();
+        }
+    private:
+        std::vector<double> _values;
+    };
+
+
+    /// Explicit list of values.
+
+    /// Further values are appended with the call operator, eg.
+    /// Values(1)(5)(10).
+    ///
+    /// @param value First value.
+    inline ParameterValues Values(double value)
+    {
+        return ParameterValues(value);
+    }
+
+
+    /// Explicit list of values from an array.
+
+    /// @param values Values.
+    template<class T, std::size_t N>
+    inline ParameterValues Values(const T (&values)[N])
+    {
+        ParameterValues list;
+
+        for (std::size_t i = 0; i < N; ++i)
+            list(double(values[i]));
+
+        return list;
+    }
+
+
+    /// Linear range of values.
+
+    /// @param first First value.
+    /// @param last Last value, included if it is reached by the steps.
+    /// @param step Step between values. Must be positive.
+    inline ParameterValues Range(double first, double last, double step = 1.0)
+    {
+        ParameterValues range;
+
+        if (step <= 0.0)
+            return range;
+
+        for (std::size_t i = 0; first + double(i) * step <= last; ++i)
+            range(first + double(i) * step);
+
+        return range;
+    }
+
+
+    /// Geometric range of values.
+
+    /// The values are the first value multiplied by powers of the factor up
+    /// to the last value, which is always included. Values are rounded to
+    /// integers if the first value is an integer, and repeated values are
+    /// left out.
+    ///
+    /// @param first First value. Must be positive.
+    /// @param last Last value.
+    /// @param factor Factor between values. Must be greater than 1.
+    inline ParameterValues Geometric(double first, double last, double factor)
+    {
+        ParameterValues range;
+
+        if ((first <= 0.0) || (factor <= 1.0) || (last < first))
+            return range;
+
+        const bool integral = (first == std::floor(first));
+        double previous = 0.0;
+
+        for (std::size_t i = 0; ; ++i)
+        {
+            double value = first * std::pow(factor, double(i));
+
+            if (value >= last)
+                value = last;
+            else if (integral)
+                value = std::floor(value + 0.5);
+
+            if ((!i) || (value != previous))
+                range(value);
+
+            if (value >= last)
+                break;
+
+            previous = value;
+        }
+
+        return range;
+    }
+
+
+    /// Range of powers of two.
+
+    /// Equivalent to Geometric(first, last, 2), so the values are the first
+    /// value multiplied by powers of two up to the last value, which is
+    /// always included.
+    ///
+    /// @param first First value. Must be positive.
+    /// @param last Last value.
+    inline ParameterValues PowersOfTwo(double first, double last)
+    {
+        return Geometric(first, last, 2.0);
+    }
+
+
+    /// Cartesian product of parameter values.
+    class ParameterGrid
+    {
+    public:
+        /// Initialize an empty grid.
+        ParameterGrid()
+        {
+
+        }
+
+
+        /// Initialize a grid of a single parameter.
+
+        /// @param values Values of the parameter.
+        ParameterGrid(const ParameterValues& values)
+        {
+            _dimensions.push_back(values);
+        }
+
+
+        /// Append the dimensions of another grid.
+
+        /// @param other Grid.
+        ParameterGrid& Append(const ParameterGrid& other)
+        {
+            _dimensions.insert(_dimensions.end(),
+                               other._dimensions.begin(),
+                               other._dimensions.end());
+            return *this;
+        }
+
+
+        /// Number of parameters.
+        inline std::size_t Dimensions() const
+        {
+            return _dimensions.size();
+        }
+
+
+        /// Values of each parameter.
+        inline const std::vector<ParameterValues>& Parameters() const
+        {
+            return _dimensions;
+        }
+
+
+        /// Combinations of the values.
+
+        /// @returns one value per parameter for each combination, with the
+        /// last parameter varying fastest. Empty if any parameter has no
+        /// values.
+        std::vector<std::vector<double> > Combinations() const
+        {
+            std::vector<std::vector<double> > combinations;
+
+            if (_dimensions.empty())
+                return combinations;
+
+            for (std::size_t i = 0; i < _dimensions.size(); ++i)
+                if (_dimensions[i].Values().empty())
+                    return combinations;
+
+            std::vector<std::size_t> indices(_dimensions.size(), 0);
+
+            while (true)
+            {
+                std::vector<double> combination(_dimensions.size());
+
+                for (std::size_t i = 0; i < _dimensions.size(); ++i)
+                    combination[i] = _dimensions[i].Values()[indices[i]];
+
+                combinations.push_back(combination);
+
+                // Advance the indices from the last parameter.
+                std::size_t dimension = _dimensions.size();
+
+                while (dimension--)
+                {
+                    if (++indices[dimension] <
+                        _dimensions[dimension].Values().size())
+                        break;
+
+                    indices[dimension] = 0;
+                }
+
+                if (dimension == std::size_t(-1))
+                    break;
+            }
+
+            return combinations;
+        }
+    private:
+        std::vector<ParameterValues> _dimensions;
+    };
+
+
+    /// Cartesian product of two grids.
+    inline ParameterGrid Product(const ParameterGrid& first,
+                                 const ParameterGrid& second)
+    {
+        return ParameterGrid(first).Append(second);
+    }
+
+
+    /// Cartesian product of three grids.
+    inline ParameterGrid Product(const ParameterGrid& first,
+                                 const ParameterGrid& second,
+                                 const ParameterGrid& third)
+    {
+        return Product(first, second).Append(third);
+    }
+
+
+    /// Cartesian product of four grids.
+    inline ParameterGrid Product(const ParameterGrid& first,
+                                 const ParameterGrid& second,
+                                 const ParameterGrid& third,
+                                 const ParameterGrid& fourth)
+    {
+        return Product(first, second, third).Append(fourth);
+    }
+
+
+    /// Value type of a payload parameter.
+
+    /// Removes references and constness from a parameter type.
+    template<class T>
+    struct PayloadArgument
+    {
+        typedef T Type;
+    };
+
+
+    template<class T>
+    struct PayloadArgument<const T>
+    {
+        typedef typename PayloadArgument<T>::Type Type;
+    };
+
+
+    template<class T>
+    struct PayloadArgument<T&>
+    {
+        typedef typename PayloadArgument<T>::Type Type;
+    };
+
+
+#define HAYAI_PAYLOAD_ARGUMENT_(index)                                  \
+    const typename PayloadArgument<A ## index>::Type a ## index =       \
+        static_cast<typename PayloadArgument<A ## index>::Type>(        \
+            arguments[index - 1]                                        \
+        )
+
+    /// Invoke a test payload with generated arguments.
+
+    /// The arguments are converted to the parameter types once, and the
+    /// payload is invoked the given number of times. Parameters must be of
+    /// arithmetic types.
+    ///
+    /// @param test Test.
+    /// @param payload Payload of the test.
+    /// @param arguments Arguments. At least as many as the payload takes.
+    /// @param iterations Number of times to invoke the payload.
+    template<class T, class C, class A1>
+    inline void InvokePayload(T& test,
+                              void (C::*payload)(A1),
+                              const std::vector<double>& arguments,
+                              std::size_t iterations)
+    {
+        HAYAI_PAYLOAD_ARGUMENT_(1);
+
+        while (iterations--)
+            (test.*payload)(a1);
+    }
+
+
+    template<class T, class C, class A1, class A2>
+    inline void InvokePayload(T& test,
+                              void (C::*payload)(A1, A2),
+                              const std::vector<double>& arguments,
+                              std::size_t iterations)
+    {
+        HAYAI_PAYLOAD_ARGUMENT_(1);
+        HAYAI_PAYLOAD_ARGUMENT_(2);
+
+        while (iterations--)
+            (test.*payload)(a1, a2);
+    }
+
+
+    template<class T, class C, class A1, class A2, class A3>
+    inline void InvokePayload(T& test,
+                              void (C::*payload)(A1, A2, A3),
+                              const std::vector<double>& arguments,
+                              std::size_t iterations)
+    {
+        HAYAI_PAYLOAD_ARGUMENT_(1);
+        HAYAI_PAYLOAD_ARGUMENT_(2);
+        HAYAI_PAYLOAD_ARGUMENT_(3);
+
+        while (iterations--)
+            (test.*payload)(a1, a2, a3);
+    }
+
+
+    template<class T, class C, class A1, class A2, class A3, class A4>
+    inline void InvokePayload(T& test,
+                              void (C::*payload)(A1, A2, A3, A4),
+                              const std::vector<double>& arguments,
+                              std::size_t iterations)
+    {
+        HAYAI_PAYLOAD_ARGUMENT_(1);
+        HAYAI_PAYLOAD_ARGUMENT_(2);
+        HAYAI_PAYLOAD_ARGUMENT_(3);
+        HAYAI_PAYLOAD_ARGUMENT_(4);
+
+        while (iterations--)
+            (test.*payload)(a1, a2, a3, a4);
+    }
+
+#undef HAYAI_PAYLOAD_ARGUMENT_
+
+
+    /// Test factory for tests with generated arguments.
+
+    /// Constructs an instance of the test of class @ref T with the arguments
+    /// of one combination of a parameter grid.
+    ///
+    /// @tparam T Test class.
+    template<class T>
+    class TestFactoryArguments
+        :   public TestFactory
+    {
+    public:
+        /// Initialize the factory.
+
+        /// @param arguments Arguments to construct tests with.
+        TestFactoryArguments(const std::vector<double>& arguments)
+            :   _arguments(arguments)
+        {
+
+        }
+
+
+        /// Create a test instance with the arguments.
+
+        /// @returns a pointer to an initialized test.
+        virtual Test* CreateTest()
+        {
+            return new T(_arguments);
+        }
+    private:
+        std::vector<double> _arguments;
+    };
+}
+#endif
@@ -0,0 +1,365 @@
+//
+// Hardware performance counters.
+//
+// Implementation notes:
+//
+// On Linux, the counters are opened through perf_event_open(2) as a single
+// group, so that all events are scheduled onto the PMU together and read
+// atomically. Only user space is counted, which is permitted for the calling
+// process with the default perf_event_paranoid setting of 2. If the PMU cannot
+// fit all events at once, the kernel multiplexes the group and the counts are
+// scaled by the ratio of enabled to running time.
+//
+// Events that the kernel or the hardware does not support (as is common in
+// virtual machines) are skipped. If no event can be opened at all, for
+// example because perf_event_paranoid forbids access, the group is reported
+// as unavailable and benchmarks are run without counters.
+//
+// On other platforms, the group is never available.
+//
+#ifndef __HAYAI_PERFORMANCECOUNTERS
+#define __HAYAI_PERFORMANCECOUNTERS
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace hayai
+{
+    /// Performance counter event.
+    struct PerformanceCounterEvent
+    {
+    public:
+        PerformanceCounterEvent(const std::string& name,
+                                uint32_t type,
+                                uint64_t config)
+            :   Name(name),
+                Type(type),
+                Config(config)
+        {
+
+        }
+
+
+        /// Name.
+
+        /// Used as the identifier of the event in the output.
+        std::string Name;
+
+
+        /// Event type.
+
+        /// One of the PERF_TYPE_* constants.
+        uint32_t Type;
+
+
+        /// Event configuration.
+        uint64_t Config;
+    };
+
+
+    /// Performance counter group.
+
+    /// Counts a set of hardware events for the calling thread while enabled.
+    class PerformanceCounterGroup
+    {
+    public:
+        /// Initialize a performance counter group.
+
+        /// The group is not opened until @ref Open is called.
+        ///
+        /// @param events Events to count.
+        PerformanceCounterGroup(
+            const std::vector<PerformanceCounterEvent>& events
+        )
+            :   _events(events)
+        {
+
+        }
+
+
+        ~PerformanceCounterGroup()
+        {
+            Close();
+        }
+
+
+        /// Default events.
+
+        /// @returns cycles, instructions, cache references, cache misses and
+        /// branch misses.
+        static std::vector<PerformanceCounterEvent> DefaultEvents()
+        {
+            std::vector<PerformanceCounterEvent> events;
+#if defined(__linux__)
+            events.push_back(PerformanceCounterEvent(
+                "cycles",
+                PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_CPU_CYCLES
+            ));
+            events.push_back(PerformanceCounterEvent(
+                "instructions",
+                PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_INSTRUCTIONS
+            ));
+            events.push_back(PerformanceCounterEvent(
+                "cache_references",
+                PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_CACHE_REFERENCES
+            ));
+            events.push_back(PerformanceCounterEvent(
+                "cache_misses",
+                PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_CACHE_MISSES
+            ));
+            events.push_back(PerformanceCounterEvent(
+                "branch_misses",
+                PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_BRANCH_MISSES
+            ));
+#endif
+            return events;
+        }
+
+
+        /// Parse a raw event specification.
+
+        /// Raw events are specified like for perf(1), ie. as "r" followed by
+        /// the hexadecimal event configuration, eg. "r01c2".
+        ///
+        /// @param specification Raw event specification.
+        /// @param event Event to populate on success.
+        /// @returns true if the specification is valid.
+        static bool ParseRawEvent(const char* specification,
+                                  PerformanceCounterEvent& event)
+        {
+            if ((specification[0] != 'r') || (specification[1] == 0))
+                return false;
+
+            char* end;
+            errno = 0;
+            unsigned long long config = strtoull(specification + 1, &end, 16);
+            if ((errno) || (*end != 0))
+                return false;
+
+#if defined(__linux__)
+            event.Type = PERF_TYPE_RAW;
+#else
+            event.Type = 4;
+#endif
+            event.Config = static_cast<uint64_t>(config);
+            event.Name = specification;
+            return true;
+        }
+
+
+        /// Open the group.
+
+        /// Events that cannot be opened are skipped, and a description of
+        /// the reason is added to @ref Errors.
+        ///
+        /// @returns true if at least one event is available.
+        bool Open()
+        {
+            Close();
+            _errors.clear();
+
+#if defined(__linux__)
+            for (std::vector<PerformanceCounterEvent>::const_iterator it =
+                     _events.begin();
+                 it != _events.end();
+                 ++it)
+            {
+                struct perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = it->Type;
+                attr.config = it->Config;
+                attr.disabled = (_descriptors.empty() ? 1 : 0);
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = (PERF_FORMAT_GROUP |
+                                    PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                    PERF_FORMAT_TOTAL_TIME_RUNNING);
+
+                int fd = int(syscall(__NR_perf_event_open,
+                                     &attr,
+                                     0,
+                                     -1,
+                                     (_descriptors.empty() ?
+                                      -1 :
+                                      _descriptors[0]),
+                                     0));
+
+                if (fd < 0)
+                {
+                    const int error = errno;
+                    std::stringstream message;
+                    message << it->Name << ": " << strerror(error);
+
+                    if ((error == EACCES) || (error == EPERM))
+                        message << " (perf_event_paranoid is "
+                                << ParanoidLevel() << ")";
+
+                    _errors.push_back(message.str());
+                    continue;
+                }
+
+                _descriptors.push_back(fd);
+                _names.push_back(it->Name);
+            }
+#else
+            _errors.push_back(
+                "performance counters are not supported on this platform"
+            );
+#endif
+
+            return IsOpen();
+        }
+
+
+        /// Test if the group is open.
+        inline bool IsOpen() const
+        {
+            return !_descriptors.empty();
+        }
+
+
+        /// Names of the events being counted.
+
+        /// Only contains the events that have been opened successfully, in
+        /// the order of the values returned by @ref Read.
+        inline const std::vector<std::string>& Names() const
+        {
+            return _names;
+        }
+
+
+        /// Reasons for events that could not be opened.
+        inline const std::vector<std::string>& Errors() const
+        {
+            return _errors;
+        }
+
+
+        /// Reset and enable counting.
+        inline void Enable()
+        {
+#if defined(__linux__)
+            if (_descriptors.empty())
+                return;
+
+            ioctl(_descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(_descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+
+        /// Disable counting.
+        inline void Disable()
+        {
+#if defined(__linux__)
+            if (_descriptors.empty())
+                return;
+
+            ioctl(_descriptors[0],
+                  PERF_EVENT_IOC_DISABLE,
+                  PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+
+        /// Read the counts since counting was last enabled.
+
+        /// @param values Vector to hold the counts in the order of
+        /// @ref Names. Counts are scaled if the group has been multiplexed.
+        /// @returns true if the counts were read.
+        bool Read(std::vector<uint64_t>& values) const
+        {
+            values.assign(_names.size(), 0);
+
+#if defined(__linux__)
+            if (_descriptors.empty())
+                return false;
+
+            std::vector<uint64_t> buffer(3 + _descriptors.size());
+            const ssize_t expected =
+                ssize_t(buffer.size() * sizeof(uint64_t));
+
+            if (read(_descriptors[0], &buffer[0], std::size_t(expected)) !=
+                expected)
+                return false;
+
+            const uint64_t timeEnabled = buffer[1];
+            const uint64_t timeRunning = buffer[2];
+
+            for (std::size_t i = 0; i < _names.size(); ++i)
+            {
+                uint64_t value = buffer[3 + i];
+
+                if ((timeRunning) && (timeRunning < timeEnabled))
+                    value = uint64_t(double(value) *
+                                     double(timeEnabled) /
+                                     double(timeRunning));
+
+                values[i] = value;
+            }
+
+            return true;
+#else
+            return false;
+#endif
+        }
+    private:
+        PerformanceCounterGroup(const PerformanceCounterGroup&);
+        PerformanceCounterGroup& operator =(const PerformanceCounterGroup&);
+
+
+        /// Close all event descriptors.
+        void Close()
+        {
+#if defined(__linux__)
+            std::size_t index = _descriptors.size();
+            while (index--)
+                close(_descriptors[index]);
+#endif
+
+            _descriptors.clear();
+            _names.clear();
+        }
+
+
+#if defined(__linux__)
+        /// Current perf_event_paranoid setting.
+        static std::string ParanoidLevel()
+        {
+            std::ifstream stream("/proc/sys/kernel/perf_event_paranoid");
+            std::string level;
+
+            if (!(stream >> level))
+                return "unknown";
+
+            return level;
+        }
+#endif
+
+
+        std::vector<PerformanceCounterEvent> _events;
+        std::vector<int> _descriptors;
+        std::vector<std::string> _names;
+        std::vector<std::string> _errors;
+    };
+}
+#endif
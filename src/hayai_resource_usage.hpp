@@ -0,0 +1,273 @@
+//
+// Resource usage.
+//
+// Implementation notes:
+//
+// Usage is sampled with getrusage(2). On Linux, the usage of single-threaded
+// tests is sampled for the calling thread only with RUSAGE_THREAD, so that
+// other threads of the process, eg. bootstrap workers, are not accounted to
+// the test. The usage of multi-threaded tests, and of all tests elsewhere,
+// is sampled for the whole process with RUSAGE_SELF, which includes the
+// usage of the threads the test started and joined.
+//
+// Usage is sampled around the iterations of a run only, so that the set up
+// and tear down of the fixture are not accounted to the run.
+//
+// The peak resident set size is the high water mark of the process, read
+// from VmHWM in /proc/self/status on Linux and from ru_maxrss elsewhere. As
+// the mark never decreases, its growth over the runs of a test is the memory
+// the runs touched beyond what the process had touched before. As reading
+// the mark on Linux means parsing a file, it is read once before and once
+// after the runs of a test rather than around every run.
+//
+// On Windows, resource usage is not available.
+//
+#ifndef __HAYAI_RESOURCEUSAGE
+#define __HAYAI_RESOURCEUSAGE
+#include <cstdlib>
+#include <string>
+#include <stdint.h>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+#if defined(__linux__)
+#include <fstream>
+#endif
+
+
+namespace hayai
+{
+    /// Resource usage of a run.
+    struct ResourceUsage
+    {
+    public:
+        ResourceUsage()
+            :   MinorFaults(0),
+                MajorFaults(0),
+                VoluntaryContextSwitches(0),
+                InvoluntaryContextSwitches(0),
+                UserTime(0),
+                SystemTime(0),
+                PeakResidentSetSize(0)
+        {
+
+        }
+
+
+        /// Sample the resource usage so far.
+
+        /// @param usage Usage on success.
+        /// @param process Whether to sample the usage of the whole process
+        /// rather than of the calling thread.
+        /// @returns true if the usage could be sampled.
+        static bool Sample(ResourceUsage& usage, bool process)
+        {
+#if !defined(_WIN32)
+            struct rusage sample;
+#   if defined(RUSAGE_THREAD)
+            const int who = (process ? RUSAGE_SELF : RUSAGE_THREAD);
+#   else
+            const int who = RUSAGE_SELF;
+            (void)process;
+#   endif
+
+            if (getrusage(who, &sample))
+                return false;
+
+            usage.MinorFaults = uint64_t(sample.ru_minflt);
+            usage.MajorFaults = uint64_t(sample.ru_majflt);
+            usage.VoluntaryContextSwitches = uint64_t(sample.ru_nvcsw);
+            usage.InvoluntaryContextSwitches = uint64_t(sample.ru_nivcsw);
+            usage.UserTime = Nanoseconds(sample.ru_utime);
+            usage.SystemTime = Nanoseconds(sample.ru_stime);
+
+            return true;
+#else
+            (void)usage;
+            (void)process;
+            return false;
+#endif
+        }
+
+
+        /// Sample the peak resident set size of the process.
+
+        /// @returns the peak resident set size in bytes, or 0 if it cannot
+        /// be sampled.
+        static uint64_t SamplePeakResidentSetSize()
+        {
+#if defined(__linux__)
+            std::ifstream stream("/proc/self/status");
+            std::string line;
+
+            while (std::getline(stream, line))
+                if (line.compare(0, 6, "VmHWM:") == 0)
+                    return uint64_t(strtoul(line.c_str() + 6, NULL, 10)) *
+                           1024;
+
+            return 0;
+#elif !defined(_WIN32)
+            struct rusage sample;
+
+            if (getrusage(RUSAGE_SELF, &sample))
+                return 0;
+
+#   if defined(__APPLE__)
+            // ru_maxrss is in bytes on Darwin.
+            return uint64_t(sample.ru_maxrss);
+#   else
+            return uint64_t(sample.ru_maxrss) * 1024;
+#   endif
+#else
+            return 0;
+#endif
+        }
+
+
+        /// Usage between two samples.
+
+        /// @param start Sample at the start.
+        /// @param end Sample at the end.
+        /// @returns the usage incurred between the samples.
+        static ResourceUsage Difference(const ResourceUsage& start,
+                                        const ResourceUsage& end)
+        {
+            ResourceUsage usage;
+            usage.MinorFaults = Subtract(end.MinorFaults, start.MinorFaults);
+            usage.MajorFaults = Subtract(end.MajorFaults, start.MajorFaults);
+            usage.VoluntaryContextSwitches =
+                Subtract(end.VoluntaryContextSwitches,
+                         start.VoluntaryContextSwitches);
+            usage.InvoluntaryContextSwitches =
+                Subtract(end.InvoluntaryContextSwitches,
+                         start.InvoluntaryContextSwitches);
+            usage.UserTime = Subtract(end.UserTime, start.UserTime);
+            usage.SystemTime = Subtract(end.SystemTime, start.SystemTime);
+            usage.PeakResidentSetSize =
+                Subtract(end.PeakResidentSetSize, start.PeakResidentSetSize);
+            return usage;
+        }
+
+
+        /// Add the usage of another run.
+        void Add(const ResourceUsage& other)
+        {
+            MinorFaults += other.MinorFaults;
+            MajorFaults += other.MajorFaults;
+            VoluntaryContextSwitches += other.VoluntaryContextSwitches;
+            InvoluntaryContextSwitches += other.InvoluntaryContextSwitches;
+            UserTime += other.UserTime;
+            SystemTime += other.SystemTime;
+            PeakResidentSetSize += other.PeakResidentSetSize;
+        }
+
+
+        /// Minor page faults, ie. served without I/O.
+        uint64_t MinorFaults;
+
+
+        /// Major page faults, ie. requiring I/O.
+        uint64_t MajorFaults;
+
+
+        /// Voluntary context switches, eg. blocking on I/O or a lock.
+        uint64_t VoluntaryContextSwitches;
+
+
+        /// Involuntary context switches, ie. preemptions.
+        uint64_t InvoluntaryContextSwitches;
+
+
+        /// CPU time spent in user mode in nanoseconds.
+        uint64_t UserTime;
+
+
+        /// CPU time spent in kernel mode in nanoseconds.
+        uint64_t SystemTime;
+
+
+        /// Peak resident set size in bytes.
+
+        /// Not sampled by @ref Sample. In the total usage of a test, the
+        /// growth of the peak over the runs.
+        uint64_t PeakResidentSetSize;
+    private:
+        /// Difference of two counts, clamped to 0.
+        static uint64_t Subtract(uint64_t end, uint64_t start)
+        {
+            return (end > start ? end - start : 0);
+        }
+
+
+#if !defined(_WIN32)
+        /// Convert a time value to nanoseconds.
+        static uint64_t Nanoseconds(const struct timeval& time)
+        {
+            return (uint64_t(time.tv_sec) * 1000000000 +
+                    uint64_t(time.tv_usec) * 1000);
+        }
+#endif
+    };
+
+
+    /// Resource usage probe.
+
+    /// Samples the resource usage at the start and the end of a section of
+    /// code, eg. the iterations of a run.
+    class ResourceUsageProbe
+    {
+    public:
+        /// Initialize a probe.
+
+        /// @param process Whether to sample the usage of the whole process
+        /// rather than of the calling thread.
+        ResourceUsageProbe(bool process)
+            :   _process(process),
+                _available(false)
+        {
+
+        }
+
+
+        /// Sample the usage at the start of the section.
+        void Start()
+        {
+            _available = ResourceUsage::Sample(_start, _process);
+        }
+
+
+        /// Sample the usage at the end of the section.
+        void Stop()
+        {
+            ResourceUsage end;
+
+            _available = ((_available) &&
+                          (ResourceUsage::Sample(end, _process)));
+
+            if (_available)
+                _usage = ResourceUsage::Difference(_start, end);
+        }
+
+
+        /// Whether the usage of the last section could be sampled.
+        inline bool IsAvailable() const
+        {
+            return _available;
+        }
+
+
+        /// Usage of the last section.
+        inline const ResourceUsage& Usage() const
+        {
+            return _usage;
+        }
+    private:
+        bool _process;
+        bool _available;
+        ResourceUsage _start;
+        ResourceUsage _usage;
+    };
+}
+#endif
@@ -0,0 +1,196 @@
+//
+// Scheduling controls.
+//
+// Implementation notes:
+//
+// The affinity is set with sched_setaffinity(2), which on Linux applies to
+// the calling thread only, so it is applied before any other thread is
+// started and inherited by the threads and processes created afterwards.
+//
+// The real-time policy is requested with pthread_setschedparam(3), which is
+// also inherited across fork(2). SCHED_FIFO threads are never preempted by
+// normal threads, so a benchmark that spins on a processor can starve the
+// rest of the system on it; the kernel's real-time throttling, which by
+// default reserves 5 % of each second for normal threads, is left alone.
+//
+// Memory is locked with mlockall(2) for both the current and future pages.
+// Locks are not inherited across fork(2), so isolated test processes have to
+// lock their memory again.
+//
+#ifndef __HAYAI_SCHEDULING
+#define __HAYAI_SCHEDULING
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
+
+namespace hayai
+{
+    /// Scheduling controls of the calling thread and process.
+    class Scheduling
+    {
+    public:
+        /// Get the processors the calling thread may run on.
+
+        /// @param cpus Processor numbers on success.
+        /// @returns true if the affinity could be determined.
+        static bool GetAffinity(std::vector<int>& cpus)
+        {
+            cpus.clear();
+
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            if (sched_getaffinity(0, sizeof(set), &set))
+                return false;
+
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+
+            return true;
+#else
+            return false;
+#endif
+        }
+
+
+        /// Set the processors the calling thread may run on.
+
+        /// @param cpus Processor numbers.
+        /// @param error Optional string to hold the reason of a failure.
+        /// @returns true if the affinity has been set.
+        static bool SetAffinity(const std::vector<int>& cpus,
+                                std::string* error = NULL)
+        {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            for (std::size_t index = 0; index < cpus.size(); ++index)
+            {
+                if ((cpus[index] < 0) || (cpus[index] >= CPU_SETSIZE))
+                    return Fail(error, "invalid processor number");
+
+                CPU_SET(cpus[index], &set);
+            }
+
+            if (sched_setaffinity(0, sizeof(set), &set))
+                return Fail(error, strerror(errno));
+
+            return true;
+#else
+            (void)cpus;
+            return Fail(error, "not supported on this platform");
+#endif
+        }
+
+
+        /// Run the calling thread with the SCHED_FIFO real-time policy.
+
+        /// @param priority Real-time priority, usually between 1 and 99.
+        /// @param error Optional string to hold the reason of a failure.
+        /// @returns true if the policy has been set.
+        static bool SetRealtimePriority(int priority,
+                                        std::string* error = NULL)
+        {
+#if !defined(_WIN32)
+            const int minimum = sched_get_priority_min(SCHED_FIFO);
+            const int maximum = sched_get_priority_max(SCHED_FIFO);
+
+            if ((priority < minimum) || (priority > maximum))
+            {
+                std::stringstream message;
+                message << "priority must be between " << minimum
+                        << " and " << maximum;
+                return Fail(error, message.str());
+            }
+
+            struct sched_param parameters;
+            memset(&parameters, 0, sizeof(parameters));
+            parameters.sched_priority = priority;
+
+            const int result =
+                pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+
+            if (result)
+                return Fail(error, strerror(result));
+
+            return true;
+#else
+            (void)priority;
+            return Fail(error, "not supported on this platform");
+#endif
+        }
+
+
+        /// Lock all current and future pages of the process into memory.
+
+        /// @param error Optional string to hold the reason of a failure.
+        /// @returns true if the memory has been locked.
+        static bool LockMemory(std::string* error = NULL)
+        {
+#if !defined(_WIN32)
+            if (mlockall(MCL_CURRENT | MCL_FUTURE))
+                return Fail(error, strerror(errno));
+
+            return true;
+#else
+            return Fail(error, "not supported on this platform");
+#endif
+        }
+
+
+        /// Format a processor list.
+
+        /// @param cpus Processor numbers in ascending order.
+        /// @returns the list in the format of sysfs, eg. "0-3,8,10-11".
+        static std::string FormatCpuList(const std::vector<int>& cpus)
+        {
+            std::stringstream list;
+            std::size_t index = 0;
+
+            while (index < cpus.size())
+            {
+                std::size_t last = index;
+
+                while ((last + 1 < cpus.size()) &&
+                       (cpus[last + 1] == cpus[last] + 1))
+                    ++last;
+
+                if (index)
+                    list << ",";
+
+                list << cpus[index];
+
+                if (last > index)
+                    list << "-" << cpus[last];
+
+                index = last + 1;
+            }
+
+            return list.str();
+        }
+    private:
+        /// Report a failure.
+        static bool Fail(std::string* error, const std::string& reason)
+        {
+            if (error)
+                *error = reason;
+
+            return false;
+        }
+    };
+}
+#endif
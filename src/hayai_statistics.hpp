@@ -0,0 +1,644 @@
+#ifndef __HAYAI_STATISTICS
+#define __HAYAI_STATISTICS
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+
+namespace hayai
+{
+    /// Statistic used to summarize run times.
+    enum Statistic
+    {
+        /// Arithmetic mean.
+        StatisticMean,
+
+
+        /// Median.
+        StatisticMedian
+    };
+
+
+    /// Ordinary least-squares fit of a line.
+    struct LinearRegression
+    {
+        LinearRegression()
+            :   Slope(0.0),
+                Intercept(0.0),
+                RSquared(0.0),
+                SlopeLower(0.0),
+                SlopeUpper(0.0)
+        {
+
+        }
+
+
+        /// Slope.
+        double Slope;
+
+
+        /// Intercept.
+        double Intercept;
+
+
+        /// Coefficient of determination.
+        double RSquared;
+
+
+        /// Lower bound of the confidence interval of the slope.
+        double SlopeLower;
+
+
+        /// Upper bound of the confidence interval of the slope.
+        double SlopeUpper;
+    };
+
+
+    /// Pseudo-random number generator.
+
+    /// SplitMix64 generator by Sebastiano Vigna. Seeded explicitly, so that
+    /// resampling is reproducible across invocations and platforms.
+    class Random
+    {
+    public:
+        /// Initialize a generator.
+
+        /// @param seed Seed.
+        Random(uint64_t seed)
+            :   _state(seed)
+        {
+
+        }
+
+
+        /// Next pseudo-random value.
+        uint64_t Next()
+        {
+            uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+
+        /// Pseudo-random index.
+
+        /// Scales the upper 53 bits of the next value instead of taking the
+        /// remainder, which avoids a 64-bit division in resampling loops.
+        /// The bias is negligible for any practical number of indices.
+        ///
+        /// @param count Number of indices. Must be non-zero.
+        /// @returns an index in [0, @p count).
+        inline std::size_t Index(std::size_t count)
+        {
+            const std::size_t index = std::size_t(
+                double(Next() >> 11) * (double(count) / 9007199254740992.0)
+            );
+
+            return (index < count ? index : count - 1);
+        }
+    private:
+        uint64_t _state;
+    };
+
+
+    /// Static statistical helper functions.
+    class Statistics
+    {
+    public:
+        /// Cumulative distribution function of the standard normal
+        /// distribution.
+
+        /// Uses the complementary error function approximation from
+        /// Numerical Recipes, which has a relative error of less than
+        /// 1.2e-7.
+        ///
+        /// @param z Value.
+        /// @returns P(Z <= z).
+        static double NormalCdf(double z)
+        {
+            const double x = std::fabs(z) / std::sqrt(2.0);
+            const double t = 1.0 / (1.0 + 0.5 * x);
+            const double erfc = t * std::exp(
+                -x * x - 1.26551223 +
+                t * (1.00002368 +
+                t * (0.37409196 +
+                t * (0.09678418 +
+                t * (-0.18628806 +
+                t * (0.27886807 +
+                t * (-1.13520398 +
+                t * (1.48851587 +
+                t * (-0.82215223 +
+                t * 0.17087277))))))))
+            );
+
+            return (z >= 0.0 ? 1.0 - erfc / 2.0 : erfc / 2.0);
+        }
+
+
+        /// Median of sorted values.
+
+        /// @param sortedValues Values in ascending order. Must not be empty.
+        template<typename T>
+        static double SortedMedian(const std::vector<T>& sortedValues)
+        {
+            return SortedMedian(sortedValues, 0, sortedValues.size());
+        }
+
+
+        /// Median of a range of sorted values.
+
+        /// @param sortedValues Values in ascending order.
+        /// @param first Index of the first value of the range.
+        /// @param count Number of values in the range. Must not be zero.
+        template<typename T>
+        static double SortedMedian(const std::vector<T>& sortedValues,
+                                   std::size_t first,
+                                   std::size_t count)
+        {
+            const std::size_t middle = first + count / 2;
+
+            return ((count % 2) ?
+                    double(sortedValues[middle]) :
+                    (double(sortedValues[middle - 1]) +
+                     double(sortedValues[middle])) / 2.0);
+        }
+
+
+        /// Mann-Whitney U test.
+
+        /// Tests whether values of one sample tend to be larger than values
+        /// of the other, without assuming a distribution of the values.
+        /// Uses the normal approximation of the distribution of U with
+        /// correction for ties and continuity, which is adequate for samples
+        /// of eight or more values each.
+        ///
+        /// @param first First sample.
+        /// @param second Second sample.
+        /// @returns the two-sided p-value, ie. the probability of observing
+        /// a difference at least as extreme if neither sample tends to be
+        /// larger. 1 if either sample is empty.
+        static double MannWhitneyU(const std::vector<double>& first,
+                                   const std::vector<double>& second)
+        {
+            const std::size_t n1 = first.size();
+            const std::size_t n2 = second.size();
+
+            if ((!n1) || (!n2))
+                return 1.0;
+
+            // Rank the pooled values, assigning tied values their average
+            // rank.
+            std::vector<std::pair<double, bool> > pooled;
+            pooled.reserve(n1 + n2);
+
+            for (std::size_t i = 0; i < n1; ++i)
+                pooled.push_back(std::make_pair(first[i], true));
+            for (std::size_t i = 0; i < n2; ++i)
+                pooled.push_back(std::make_pair(second[i], false));
+
+            std::sort(pooled.begin(), pooled.end());
+
+            double firstRankSum = 0.0;
+            double tieCorrection = 0.0;
+            std::size_t start = 0;
+
+            while (start < pooled.size())
+            {
+                std::size_t end = start + 1;
+                while ((end < pooled.size()) &&
+                       (pooled[end].first == pooled[start].first))
+                    ++end;
+
+                const double rank = double(start + end + 1) / 2.0;
+                const double ties = double(end - start);
+
+                for (std::size_t i = start; i < end; ++i)
+                    if (pooled[i].second)
+                        firstRankSum += rank;
+
+                tieCorrection += ties * ties * ties - ties;
+                start = end;
+            }
+
+            const double a = double(n1);
+            const double b = double(n2);
+            const double n = a + b;
+            const double u = firstRankSum - a * (a + 1.0) / 2.0;
+            const double mean = a * b / 2.0;
+            const double variance =
+                a * b / 12.0 * ((n + 1.0) - tieCorrection / (n * (n - 1.0)));
+
+            if (variance <= 0.0)
+                return 1.0;
+
+            const double deviation = std::fabs(u - mean) - 0.5;
+            if (deviation <= 0.0)
+                return 1.0;
+
+            return 2.0 * (1.0 - NormalCdf(deviation / std::sqrt(variance)));
+        }
+
+
+        /// Bootstrap confidence interval of the relative change of the
+        /// median.
+
+        /// Resamples both samples with replacement and takes the
+        /// percentiles of the relative change of the median of the
+        /// resamples.
+        ///
+        /// @param baseline Baseline sample. Must not be empty.
+        /// @param current Current sample. Must not be empty.
+        /// @param level Confidence level, eg. 0.95.
+        /// @param resamples Number of resamples.
+        /// @param seed Seed of the pseudo-random number generator.
+        /// @param lower Lower bound of the interval.
+        /// @param upper Upper bound of the interval.
+        static void BootstrapRelativeMedianChange(
+            const std::vector<double>& baseline,
+            const std::vector<double>& current,
+            double level,
+            std::size_t resamples,
+            uint64_t seed,
+            double& lower,
+            double& upper
+        )
+        {
+            Random random(seed);
+            std::vector<double> changes;
+            std::vector<double> baselineResample(baseline.size());
+            std::vector<double> currentResample(current.size());
+
+            changes.reserve(resamples);
+
+            for (std::size_t resample = 0; resample < resamples; ++resample)
+            {
+                for (std::size_t i = 0; i < baseline.size(); ++i)
+                    baselineResample[i] =
+                        baseline[random.Index(baseline.size())];
+                for (std::size_t i = 0; i < current.size(); ++i)
+                    currentResample[i] =
+                        current[random.Index(current.size())];
+
+                std::sort(baselineResample.begin(), baselineResample.end());
+                std::sort(currentResample.begin(), currentResample.end());
+
+                const double baselineMedian = SortedMedian(baselineResample);
+
+                if (baselineMedian > 0.0)
+                    changes.push_back(SortedMedian(currentResample) /
+                                      baselineMedian - 1.0);
+            }
+
+            if (changes.empty())
+            {
+                lower = upper = 0.0;
+                return;
+            }
+
+            std::sort(changes.begin(), changes.end());
+
+            const double tail = (1.0 - level) / 2.0;
+            const std::size_t last = changes.size() - 1;
+
+            lower = changes[std::size_t(tail * double(last) + 0.5)];
+            upper = changes[std::size_t((1.0 - tail) * double(last) + 0.5)];
+        }
+
+
+        /// Quantile function of the standard normal distribution.
+
+        /// Uses the rational approximation by Peter J. Acklam, which has a
+        /// relative error of less than 1.15e-9.
+        ///
+        /// @param p Probability in the open interval (0, 1).
+        /// @returns z such that P(Z <= z) = p.
+        static double NormalQuantile(double p)
+        {
+            static const double a[] = {
+                -3.969683028665376e+01,  2.209460984245205e+02,
+                -2.759285104469687e+02,  1.383577518672690e+02,
+                -3.066479806614716e+01,  2.506628277459239e+00
+            };
+            static const double b[] = {
+                -5.447609879822406e+01,  1.615858368580409e+02,
+                -1.556989798598866e+02,  6.680131188771972e+01,
+                -1.328068155288572e+01
+            };
+            static const double c[] = {
+                -7.784894002430293e-03, -3.223964580411365e-01,
+                -2.400758277161838e+00, -2.549732539343734e+00,
+                 4.374664141464968e+00,  2.938163982698783e+00
+            };
+            static const double d[] = {
+                 7.784695709041462e-03,  3.224671290700398e-01,
+                 2.445134137142996e+00,  3.754408661907416e+00
+            };
+
+            if (p <= 0.0)
+                return -std::numeric_limits<double>::infinity();
+            if (p >= 1.0)
+                return std::numeric_limits<double>::infinity();
+
+            const double pLow = 0.02425;
+
+            if (p < pLow)
+            {
+                const double q = std::sqrt(-2.0 * std::log(p));
+                return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q +
+                         c[4]) * q + c[5]) /
+                    ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            }
+
+            if (p > 1.0 - pLow)
+            {
+                const double q = std::sqrt(-2.0 * std::log(1.0 - p));
+                return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q +
+                          c[4]) * q + c[5]) /
+                    ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            }
+
+            const double q = p - 0.5;
+            const double r = q * q;
+            return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r +
+                     a[4]) * r + a[5]) * q /
+                (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r +
+                  b[4]) * r + 1.0);
+        }
+
+
+        /// Quantile function of Student's t-distribution.
+
+        /// Exact for one to three degrees of freedom, where the expansion is
+        /// too inaccurate for the confidence intervals of few runs. Uses the
+        /// Cornish-Fisher expansion around the normal quantile otherwise,
+        /// which is accurate to within 1 % for four or more degrees of
+        /// freedom at the usual confidence levels.
+        ///
+        /// @param p Probability in the open interval (0, 1).
+        /// @param degreesOfFreedom Degrees of freedom.
+        /// @returns t such that P(T <= t) = p.
+        static double StudentTQuantile(double p, double degreesOfFreedom)
+        {
+            const double pi = 3.14159265358979323846;
+
+            // Closed forms of the Cauchy distribution and of two degrees of
+            // freedom.
+            if (degreesOfFreedom == 1.0)
+                return std::tan(pi * (p - 0.5));
+
+            if (degreesOfFreedom == 2.0)
+                return (2.0 * p - 1.0) / std::sqrt(2.0 * p * (1.0 - p));
+
+            const double t = StudentTQuantileExpansion(p, degreesOfFreedom);
+
+            if (degreesOfFreedom != 3.0)
+                return t;
+
+            // Refine the expansion by Newton's method on the closed form of
+            // the distribution function for three degrees of freedom.
+            const double root3 = std::sqrt(3.0);
+            double x = t;
+
+            for (std::size_t step = 0; step < 8; ++step)
+            {
+                const double u = 1.0 + x * x / 3.0;
+                const double cdf = 0.5 + (x / (root3 * u) +
+                                          std::atan(x / root3)) / pi;
+                const double pdf = 2.0 / (pi * root3 * u * u);
+
+                x -= (cdf - p) / pdf;
+            }
+
+            return x;
+        }
+
+
+        /// Approximate the quantile function of Student's t-distribution.
+
+        /// Cornish-Fisher expansion around the normal quantile.
+        ///
+        /// @param p Probability in the open interval (0, 1).
+        /// @param degreesOfFreedom Degrees of freedom.
+        /// @returns an approximation of t such that P(T <= t) = p.
+        static double StudentTQuantileExpansion(double p,
+                                                double degreesOfFreedom)
+        {
+            const double z = NormalQuantile(p);
+            const double n = degreesOfFreedom;
+            const double z2 = z * z;
+            const double z3 = z2 * z;
+            const double z5 = z3 * z2;
+            const double z7 = z5 * z2;
+            const double z9 = z7 * z2;
+
+            return z +
+                (z3 + z) / (4.0 * n) +
+                (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * n * n) +
+                (3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z) /
+                (384.0 * n * n * n) +
+                (79.0 * z9 + 776.0 * z7 + 1482.0 * z5 - 1920.0 * z3 -
+                 945.0 * z) /
+                (92160.0 * n * n * n * n);
+        }
+
+
+        /// Confidence interval of the mean.
+
+        /// Based on Student's t-distribution.
+        ///
+        /// @param values Sample values. At least two are required.
+        /// @param level Confidence level, eg. 0.95.
+        /// @param lower Lower bound of the interval.
+        /// @param upper Upper bound of the interval.
+        /// @returns the mean.
+        static double MeanConfidenceInterval(
+            const std::vector<uint64_t>& values,
+            double level,
+            double& lower,
+            double& upper
+        )
+        {
+            const double n = double(values.size());
+            double sum = 0.0;
+            double squares = 0.0;
+
+            for (std::size_t i = 0; i < values.size(); ++i)
+                sum += double(values[i]);
+
+            const double mean = sum / n;
+
+            for (std::size_t i = 0; i < values.size(); ++i)
+            {
+                const double diff = double(values[i]) - mean;
+                squares += diff * diff;
+            }
+
+            const double halfWidth =
+                StudentTQuantile(1.0 - (1.0 - level) / 2.0, n - 1.0) *
+                std::sqrt(squares / (n - 1.0)) / std::sqrt(n);
+
+            lower = mean - halfWidth;
+            upper = mean + halfWidth;
+            return mean;
+        }
+
+
+        /// Confidence interval of the median.
+
+        /// Distribution free interval between two order statistics, with
+        /// ranks determined by the normal approximation of the binomial
+        /// distribution, ie. n / 2 - z sqrt(n) / 2 and
+        /// 1 + n / 2 + z sqrt(n) / 2 rounded to the nearest rank.
+        ///
+        /// @param sortedValues Sample values in ascending order.
+        /// @param level Confidence level, eg. 0.95.
+        /// @param lower Lower bound of the interval.
+        /// @param upper Upper bound of the interval.
+        /// @returns the median.
+        static double MedianConfidenceInterval(
+            const std::vector<uint64_t>& sortedValues,
+            double level,
+            double& lower,
+            double& upper
+        )
+        {
+            const std::size_t size = sortedValues.size();
+            const double n = double(size);
+            const double z = NormalQuantile(1.0 - (1.0 - level) / 2.0);
+            const double spread = z * std::sqrt(n) / 2.0;
+
+            double lowerRank = std::floor(n / 2.0 - spread + 0.5);
+            double upperRank = std::floor(n / 2.0 + spread + 1.5);
+
+            if (lowerRank < 1.0)
+                lowerRank = 1.0;
+            if (upperRank > n)
+                upperRank = n;
+
+            lower = double(sortedValues[std::size_t(lowerRank) - 1]);
+            upper = double(sortedValues[std::size_t(upperRank) - 1]);
+
+            return ((size % 2) ?
+                    double(sortedValues[size / 2]) :
+                    (double(sortedValues[size / 2 - 1]) +
+                     double(sortedValues[size / 2])) / 2.0);
+        }
+
+
+        /// Relative width of a confidence interval.
+
+        /// @param values Sample values. At least two are required.
+        /// @param statistic Statistic to determine the interval for.
+        /// @param level Confidence level, eg. 0.95.
+        /// @returns the width of the confidence interval relative to the
+        /// estimate, or infinity if the estimate is zero.
+        static double RelativeConfidenceIntervalWidth(
+            const std::vector<uint64_t>& values,
+            Statistic statistic,
+            double level
+        )
+        {
+            double estimate, lower, upper;
+
+            if (statistic == StatisticMean)
+                estimate = MeanConfidenceInterval(values, level, lower, upper);
+            else
+            {
+                std::vector<uint64_t> sortedValues(values);
+                std::sort(sortedValues.begin(), sortedValues.end());
+                estimate = MedianConfidenceInterval(sortedValues,
+                                                    level,
+                                                    lower,
+                                                    upper);
+            }
+
+            if (estimate <= 0.0)
+                return std::numeric_limits<double>::infinity();
+
+            return (upper - lower) / estimate;
+        }
+
+
+        /// Fit a line by ordinary least squares.
+
+        /// The confidence interval of the slope is based on Student's
+        /// t-distribution of the slope estimate with n - 2 degrees of
+        /// freedom, and collapses to the slope for fewer than three points.
+        ///
+        /// @param x Independent values. At least two distinct values are
+        /// required.
+        /// @param y Dependent values, one for each independent value.
+        /// @param level Confidence level, eg. 0.95.
+        /// @returns the fit.
+        static LinearRegression FitLine(const std::vector<double>& x,
+                                        const std::vector<double>& y,
+                                        double level)
+        {
+            LinearRegression fit;
+            const std::size_t size = std::min(x.size(), y.size());
+
+            if (size < 2)
+                return fit;
+
+            // Center the values before summing products, so that large
+            // iteration counts and durations do not lose precision.
+            const double n = double(size);
+            double meanX = 0.0;
+            double meanY = 0.0;
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                meanX += x[i];
+                meanY += y[i];
+            }
+
+            meanX /= n;
+            meanY /= n;
+
+            double sxx = 0.0;
+            double sxy = 0.0;
+            double syy = 0.0;
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const double dx = x[i] - meanX;
+                const double dy = y[i] - meanY;
+
+                sxx += dx * dx;
+                sxy += dx * dy;
+                syy += dy * dy;
+            }
+
+            if (sxx <= 0.0)
+                return fit;
+
+            fit.Slope = sxy / sxx;
+            fit.Intercept = meanY - fit.Slope * meanX;
+
+            const double residuals =
+                std::max(syy - fit.Slope * sxy, 0.0);
+
+            fit.RSquared = (syy > 0.0 ? 1.0 - residuals / syy : 1.0);
+            fit.SlopeLower = fit.Slope;
+            fit.SlopeUpper = fit.Slope;
+
+            if (size > 2)
+            {
+                const double halfWidth =
+                    StudentTQuantile(1.0 - (1.0 - level) / 2.0, n - 2.0) *
+                    std::sqrt(residuals / (n - 2.0) / sxx);
+
+                fit.SlopeLower -= halfWidth;
+                fit.SlopeUpper += halfWidth;
+            }
+
+            return fit;
+        }
+    };
+}
+#endif
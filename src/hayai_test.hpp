@@ -1,9 +1,24 @@
 #ifndef __HAYAI_TEST
 #define __HAYAI_TEST
 #include <cstddef>
+#include <vector>
 
 #include "hayai_clock.hpp"
+#include "hayai_cpu_topology.hpp"
+#include "hayai_performance_counters.hpp"
+#include "hayai_resource_usage.hpp"
+#include "hayai_scheduling.hpp"
 #include "hayai_test_result.hpp"
+#include "hayai_threading.hpp"
+
+
+/// Distance in bytes to keep between data written by different threads.
+
+/// Twice the common cache line size of 64 bytes, as processors that
+/// prefetch pairs of adjacent lines share data between them too.
+#ifndef HAYAI_CACHE_LINE_SIZE
+#   define HAYAI_CACHE_LINE_SIZE 128
+#endif
 
 
 namespace hayai
@@ -17,9 +32,22 @@ namespace hayai
     /// The default test class does not contain any actual code in the
     /// SetUp and TearDown methods, which means that tests can inherit
     /// this class directly for non-fixture based benchmarking tests.
+    ///
+    /// Running the iterations of a run is a single virtual call to
+    /// @ref RunIterations. The benchmark macros override it with a loop
+    /// that calls the test body of the concrete class non-virtually, so that
+    /// the body can be inlined into the loop.
     class Test
     {
     public:
+        Test()
+            :   _pauseOverhead(0),
+                _resourceUsage(NULL)
+        {
+
+        }
+
+
         /// Set up the testing fixture for execution of a run.
         virtual void SetUp()
         {
@@ -35,34 +63,354 @@ namespace hayai
         }
 
 
+        /// Set the overhead of pausing and resuming timing.
+
+        /// The overhead is subtracted from the run time for each time the
+        /// timing is paused with @ref PauseTiming.
+        ///
+        /// @param nanoseconds Overhead in nanoseconds of a pair of calls to
+        /// @ref PauseTiming and @ref ResumeTiming.
+        void SetPauseOverhead(uint64_t nanoseconds)
+        {
+            _pauseOverhead = nanoseconds;
+        }
+
+
+        /// Set the resource usage probe.
+
+        /// The probe samples the resource usage around the iterations of
+        /// each run, excluding the set up and tear down of the fixture.
+        ///
+        /// @param probe Probe, or NULL to not sample the resource usage.
+        void SetResourceUsageProbe(ResourceUsageProbe* probe)
+        {
+            _resourceUsage = probe;
+        }
+
+
         /// Run the test.
 
         /// @param iterations Number of iterations to gather data for.
-        /// @returns the number of nanoseconds the run took.
-        uint64_t Run(std::size_t iterations)
+        /// @param counters Optional open performance counter group, which is
+        /// reset and enabled around the iterations only.
+        /// @returns the number of nanoseconds the run took, excluding the
+        /// time during which timing was paused.
+        uint64_t Run(std::size_t iterations,
+                     PerformanceCounterGroup* counters = NULL)
         {
-            std::size_t iteration = iterations;
-            
+            TimingState timing(_pauseOverhead);
+
             // Set up the testing fixture.
             SetUp();
 
+            if (_resourceUsage)
+                _resourceUsage->Start();
+
+            if (counters)
+                counters->Enable();
+
             // Get the starting time.
             Clock::TimePoint startTime, endTime;
 
+            CurrentTimingState() = &timing;
             startTime = Clock::Now();
 
             // Run the test body for each iteration.
-            while (iteration--)
-                TestBody();
+            RunIterations(iterations);
+
+            // Get the ending time.
+            endTime = Clock::Now();
+            CurrentTimingState() = NULL;
+
+            if (counters)
+                counters->Disable();
+
+            if (_resourceUsage)
+                _resourceUsage->Stop();
+
+            // Tear down the testing fixture.
+            TearDown();
+
+            // Return the duration in nanoseconds.
+            return timing.Exclude(Clock::Duration(startTime, endTime));
+        }
+
+
+        /// Run the test, timing individual iterations.
+
+        /// Every @p interval th iteration, starting with the first, is timed
+        /// on its own, and the remaining iterations are run in batches
+        /// between the timed iterations. The samples are stored in a buffer
+        /// allocated before the run, so that sampling does not allocate
+        /// memory while timing.
+        ///
+        /// @param iterations Number of iterations to gather data for.
+        /// @param interval Interval of the timed iterations. At least 1.
+        /// @param sampleOverhead Overhead in nanoseconds of timing a single
+        /// iteration, which is subtracted from each sample.
+        /// @param samples Vector to hold the time of each timed iteration in
+        /// nanoseconds, excluding the time during which timing was paused.
+        /// @param counters Optional open performance counter group, which is
+        /// reset and enabled around the iterations only.
+        /// @returns the number of nanoseconds the run took, including the
+        /// overhead of timing the samples and excluding the time during
+        /// which timing was paused.
+        uint64_t RunSampled(std::size_t iterations,
+                            std::size_t interval,
+                            uint64_t sampleOverhead,
+                            std::vector<uint64_t>& samples,
+                            PerformanceCounterGroup* counters = NULL)
+        {
+            TimingState timing(_pauseOverhead);
+
+            samples.clear();
+            samples.reserve((iterations + interval - 1) / interval);
+
+            // Set up the testing fixture.
+            SetUp();
+
+            if (_resourceUsage)
+                _resourceUsage->Start();
+
+            if (counters)
+                counters->Enable();
+
+            // Get the starting time.
+            Clock::TimePoint startTime, endTime;
+
+            CurrentTimingState() = &timing;
+            startTime = Clock::Now();
+
+            // Alternate between timed iterations and batches of untimed
+            // iterations.
+            std::size_t remaining = iterations;
+
+            while (remaining)
+            {
+                const uint64_t pausedTime = timing.PausedTime;
+                const Clock::TimePoint sampleStartTime = Clock::Now();
+
+                RunIterations(1);
+
+                const Clock::TimePoint sampleEndTime = Clock::Now();
+                const uint64_t paused = timing.PausedTime - pausedTime;
+                const uint64_t excluded = paused + sampleOverhead;
+                const uint64_t sample =
+                    Clock::Duration(sampleStartTime, sampleEndTime);
+
+                samples.push_back(sample > excluded ? sample - excluded : 0);
+                --remaining;
+
+                const std::size_t batch = (remaining < interval - 1 ?
+                                           remaining :
+                                           interval - 1);
+
+                if (batch)
+                {
+                    RunIterations(batch);
+                    remaining -= batch;
+                }
+            }
+
+            // Get the ending time.
+            endTime = Clock::Now();
+            CurrentTimingState() = NULL;
+
+            if (counters)
+                counters->Disable();
+
+            if (_resourceUsage)
+                _resourceUsage->Stop();
+
+            // Tear down the testing fixture.
+            TearDown();
+
+            // Return the duration in nanoseconds.
+            return timing.Exclude(Clock::Duration(startTime, endTime));
+        }
+
+
+        /// Run the test at a fixed rate.
+
+        /// Rather than starting each iteration as soon as the previous
+        /// iteration has finished, iterations are started at fixed intervals
+        /// given by the target rate. If an iteration takes longer than the
+        /// interval, the following iterations start late and catch up as
+        /// fast as possible. The latency of each iteration is measured from
+        /// its intended start time, so that the queueing delay caused by
+        /// slow iterations is included in the latency of the iterations
+        /// that had to wait for them, which avoids coordinated omission.
+        ///
+        /// @param iterations Number of iterations to gather data for.
+        /// @param rate Target rate in iterations per second.
+        /// @param latencyOverhead Overhead in nanoseconds of timing a single
+        /// iteration, which is subtracted from each latency.
+        /// @param latencies Vector to hold the latency of each iteration in
+        /// nanoseconds, excluding the time during which timing was paused.
+        /// @param counters Optional open performance counter group, which is
+        /// reset and enabled around the iterations only.
+        /// @returns the number of nanoseconds the run took, excluding the
+        /// time during which timing was paused.
+        uint64_t RunOpenLoop(std::size_t iterations,
+                             double rate,
+                             uint64_t latencyOverhead,
+                             std::vector<uint64_t>& latencies,
+                             PerformanceCounterGroup* counters = NULL)
+        {
+            TimingState timing(_pauseOverhead);
+            const double interval = 1000000000.0 / rate;
+
+            latencies.clear();
+            latencies.reserve(iterations);
+
+            // Set up the testing fixture.
+            SetUp();
+
+            if (_resourceUsage)
+                _resourceUsage->Start();
+
+            if (counters)
+                counters->Enable();
+
+            // Get the starting time.
+            Clock::TimePoint startTime, endTime;
+
+            CurrentTimingState() = &timing;
+            startTime = Clock::Now();
+
+            for (std::size_t iteration = 0;
+                 iteration < iterations;
+                 ++iteration)
+            {
+                const uint64_t intendedTime =
+                    uint64_t(double(iteration) * interval);
+
+                // Wait for the intended start time of the iteration.
+                while (Clock::Duration(startTime, Clock::Now()) < intendedTime)
+                    ;
+
+                const uint64_t pausedTime = timing.PausedTime;
+
+                RunIterations(1);
+
+                const uint64_t completionTime =
+                    Clock::Duration(startTime, Clock::Now());
+                const uint64_t excluded =
+                    (timing.PausedTime - pausedTime) + latencyOverhead;
+                const uint64_t latency = (completionTime > intendedTime ?
+                                          completionTime - intendedTime :
+                                          0);
+
+                latencies.push_back(latency > excluded ?
+                                    latency - excluded :
+                                    0);
+            }
 
             // Get the ending time.
             endTime = Clock::Now();
+            CurrentTimingState() = NULL;
+
+            if (counters)
+                counters->Disable();
+
+            if (_resourceUsage)
+                _resourceUsage->Stop();
 
             // Tear down the testing fixture.
             TearDown();
 
             // Return the duration in nanoseconds.
-            return Clock::Duration(startTime, endTime);
+            return timing.Exclude(Clock::Duration(startTime, endTime));
+        }
+
+
+        /// Run the test on multiple threads.
+
+        /// The fixture is set up once and shared by all threads, so the test
+        /// body must be safe to execute concurrently. The calling thread is
+        /// one of the threads. All threads are released from a spinning
+        /// start barrier at the same time, after which each thread performs
+        /// the given number of iterations. If processors are given, each
+        /// thread is pinned to its processor before the barrier, and the
+        /// affinity of the calling thread is restored afterwards.
+        ///
+        /// @param iterations Number of iterations to gather data for on each
+        /// thread.
+        /// @param threads Number of threads.
+        /// @param threadTimes Vector to hold the number of nanoseconds each
+        /// thread took, excluding the time during which timing was paused.
+        /// @param cpus Processor to pin each thread to, or empty to leave the
+        /// placement of the threads to the operating system.
+        /// @returns the number of nanoseconds the slowest thread took.
+        uint64_t RunThreaded(std::size_t iterations,
+                             std::size_t threads,
+                             std::vector<uint64_t>& threadTimes,
+                             const std::vector<int>& cpus = std::vector<int>())
+        {
+            SpinBarrier barrier(threads);
+            std::vector<ThreadContext> contexts(
+                threads,
+                ThreadContext(this, &barrier, iterations, _pauseOverhead)
+            );
+            std::vector<Thread*> workers;
+
+            for (std::size_t index = 0;
+                 (index < threads) && (index < cpus.size());
+                 ++index)
+                contexts[index].Cpu = cpus[index];
+
+            std::vector<int> affinity;
+            const bool restoreAffinity =
+                ((!cpus.empty()) && (Scheduling::GetAffinity(affinity)));
+
+            // Set up the testing fixture.
+            SetUp();
+
+            // The usage of the threads is accounted to the process once they
+            // have been joined, including the cost of starting them.
+            if (_resourceUsage)
+                _resourceUsage->Start();
+
+            // Start the other threads, which wait at the barrier for the
+            // calling thread.
+            try
+            {
+                for (std::size_t index = 1; index < threads; ++index)
+                    workers.push_back(new Thread(&Test::RunThread,
+                                                 &contexts[index]));
+            }
+            catch (...)
+            {
+                barrier.Abandon(threads - workers.size());
+                JoinThreads(workers);
+                TearDown();
+                throw;
+            }
+
+            RunThread(&contexts[0]);
+            JoinThreads(workers);
+
+            if (_resourceUsage)
+                _resourceUsage->Stop();
+
+            if (restoreAffinity)
+                Scheduling::SetAffinity(affinity);
+
+            // Tear down the testing fixture.
+            TearDown();
+
+            // Gather the durations.
+            uint64_t slowest = 0;
+            threadTimes.resize(threads);
+
+            for (std::size_t index = 0; index < threads; ++index)
+            {
+                threadTimes[index] = contexts[index].Time;
+                if (contexts[index].Time > slowest)
+                    slowest = contexts[index].Time;
+            }
+
+            return slowest;
         }
 
 
@@ -78,6 +426,170 @@ namespace hayai
         {
 
         }
+
+
+        /// Run the iterations of a run.
+
+        /// Invokes @ref TestBody once for each iteration. Overridden by the
+        /// benchmark macros to avoid the virtual call per iteration.
+        ///
+        /// @param iterations Number of iterations.
+        virtual void RunIterations(std::size_t iterations)
+        {
+            while (iterations--)
+                TestBody();
+        }
+
+
+        /// Pause timing.
+
+        /// Excludes the time until @ref ResumeTiming is called from the
+        /// duration of the run, eg. to prepare the input of the next
+        /// iteration. In multi-threaded tests, only the calling thread is
+        /// affected. Has no effect if timing is already paused.
+        void PauseTiming()
+        {
+            TimingState* timing = CurrentTimingState();
+
+            if ((timing) && (!timing->Paused))
+            {
+                timing->Paused = true;
+                timing->PauseTime = Clock::Now();
+            }
+        }
+
+
+        /// Resume timing.
+
+        /// Has no effect if timing is not paused.
+        void ResumeTiming()
+        {
+            TimingState* timing = CurrentTimingState();
+
+            if ((timing) && (timing->Paused))
+            {
+                timing->PausedTime += Clock::Duration(timing->PauseTime,
+                                                      Clock::Now());
+                timing->PausedTime += timing->PauseOverhead;
+                timing->Paused = false;
+            }
+        }
+    private:
+        /// Timing state of a thread during a run.
+        struct TimingState
+        {
+            TimingState(uint64_t pauseOverhead)
+                :   PauseOverhead(pauseOverhead),
+                    PausedTime(0),
+                    Paused(false)
+            {
+
+            }
+
+
+            /// Exclude the paused time from a duration.
+            uint64_t Exclude(uint64_t duration) const
+            {
+                return (duration > PausedTime ? duration - PausedTime : 0);
+            }
+
+
+            uint64_t PauseOverhead;
+            uint64_t PausedTime;
+            Clock::TimePoint PauseTime;
+            bool Paused;
+        };
+
+
+        /// Timing state of the run in progress on the calling thread.
+
+        /// @returns a reference to the pointer to the timing state, which is
+        /// NULL if no run is in progress.
+        static TimingState*& CurrentTimingState()
+        {
+            static HAYAI_THREAD_LOCAL TimingState* timing = NULL;
+            return timing;
+        }
+
+
+        /// State of a single thread of a multi-threaded run.
+
+        /// The state is written by its thread while it is timed, eg. when
+        /// pausing timing, so it is padded on both sides to keep the
+        /// contexts of different threads, which are stored next to each
+        /// other, off each other's cache lines.
+        struct ThreadContext
+        {
+            ThreadContext(Test* testInstance,
+                          SpinBarrier* barrier,
+                          std::size_t iterations,
+                          uint64_t pauseOverhead)
+                :   TestInstance(testInstance),
+                    Barrier(barrier),
+                    Iterations(iterations),
+                    Cpu(-1),
+                    Time(0),
+                    Timing(pauseOverhead)
+            {
+
+            }
+
+
+            char LeadingPadding[HAYAI_CACHE_LINE_SIZE];
+            Test* TestInstance;
+            SpinBarrier* Barrier;
+            std::size_t Iterations;
+            int Cpu;
+            uint64_t Time;
+            TimingState Timing;
+            char TrailingPadding[HAYAI_CACHE_LINE_SIZE];
+        };
+
+
+        /// Run the iterations of a single thread.
+
+        /// @param context Pointer to the @ref ThreadContext of the thread.
+        static void RunThread(void* context)
+        {
+            ThreadContext& thread = *static_cast<ThreadContext*>(context);
+
+            if (thread.Cpu >= 0)
+                CpuTopology::Pin(thread.Cpu);
+
+            // Wait for all threads to be ready.
+            thread.Barrier->Wait();
+
+            // Time the iterations of this thread.
+            Clock::TimePoint startTime, endTime;
+
+            CurrentTimingState() = &thread.Timing;
+            startTime = Clock::Now();
+
+            thread.TestInstance->RunIterations(thread.Iterations);
+
+            endTime = Clock::Now();
+            CurrentTimingState() = NULL;
+
+            thread.Time =
+                thread.Timing.Exclude(Clock::Duration(startTime, endTime));
+        }
+
+
+        /// Join and dispose of threads.
+        static void JoinThreads(std::vector<Thread*>& threads)
+        {
+            for (std::size_t index = 0; index < threads.size(); ++index)
+            {
+                threads[index]->Join();
+                delete threads[index];
+            }
+
+            threads.clear();
+        }
+
+
+        uint64_t _pauseOverhead;
+        ResourceUsageProbe* _resourceUsage;
     };
 }
 #endif
@@ -11,6 +11,22 @@
 
 namespace hayai
 {
+    /// Automatic iteration count.
+
+    /// Passing this as the number of iterations of a benchmark causes the
+    /// number of iterations per run to be calibrated before the benchmark is
+    /// run, so that each run takes at least the minimum run time.
+    const std::size_t AutoIterations = 0;
+
+
+    /// Thread count sweep.
+
+    /// Passing this as the number of threads of a multi-threaded benchmark
+    /// registers the benchmark for 1, 2, 4, ... threads up to and including
+    /// the number of hardware threads.
+    const std::size_t ThreadSweep = 0;
+
+
     /// Parameter declaration.
 
     /// Describes parameter type and name.
@@ -284,6 +300,18 @@ namespace hayai
         {
             return _parameters;
         }
+
+
+        /// Add a parameter.
+
+        /// @param declaration Declaration of the parameter, eg.
+        /// "std::size_t size".
+        /// @param value Value of the parameter.
+        void AddParameter(const std::string& declaration,
+                          const std::string& value)
+        {
+            _parameters.push_back(TestParameterDescriptor(declaration, value));
+        }
     private:
         std::vector<TestParameterDescriptor> _parameters;
     };
@@ -301,13 +329,17 @@ namespace hayai
         /// @param iterations Number of iterations per run.
         /// @param testFactory Test factory implementation for the test.
         /// @param parameters Parametrized test parameters.
+        /// @param isDisabled Whether the test is disabled.
+        /// @param threads Number of threads to run the test on, or 0 to run
+        /// the test on the calling thread only.
         TestDescriptor(const char* fixtureName,
                        const char* testName,
                        std::size_t runs,
                        std::size_t iterations,
                        TestFactory* testFactory,
                        TestParametersDescriptor parameters,
-                       bool isDisabled = false)
+                       bool isDisabled = false,
+                       std::size_t threads = 0)
             :   FixtureName(fixtureName),
                 TestName(testName),
                 CanonicalName(std::string(fixtureName) + "." + testName),
@@ -315,7 +347,8 @@ namespace hayai
                 Iterations(iterations),
                 Factory(testFactory),
                 Parameters(parameters),
-                IsDisabled(isDisabled)
+                IsDisabled(isDisabled),
+                Threads(threads)
         {
 
         }
@@ -347,6 +380,8 @@ namespace hayai
 
 
         /// Iterations per test run.
+
+        /// @ref AutoIterations if the iteration count is calibrated.
         std::size_t Iterations;
 
 
@@ -360,6 +395,21 @@ namespace hayai
 
         /// Disabled.
         bool IsDisabled;
+
+
+        /// Threads.
+
+        /// Number of threads the test is run on, or 0 if the test is not a
+        /// multi-threaded test.
+        std::size_t Threads;
+
+
+        /// Registration error.
+
+        /// Describes why the test could not be registered as declared, eg.
+        /// a parameter grid that does not match the parameters of the test.
+        /// A test with an error is reported as failed instead of being run.
+        std::string Error;
     };
 }
 #endif
@@ -1,15 +1,122 @@
 #ifndef __HAYAI_TESTRESULT
 #define __HAYAI_TESTRESULT
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 #include <limits>
 #include <cmath>
+#include <string>
 
+#include "hayai_bootstrap.hpp"
 #include "hayai_clock.hpp"
+#include "hayai_histogram.hpp"
+#include "hayai_resource_usage.hpp"
+#include "hayai_statistics.hpp"
+
+
+/// Modified z-score above which a run is an outlier by its median absolute
+/// deviation.
+#ifndef HAYAI_OUTLIER_MAD_THRESHOLD
+#   define HAYAI_OUTLIER_MAD_THRESHOLD 3.5
+#endif
+
+/// Factor by which the 99th percentile latency of an open-loop test may grow
+/// relative to the lowest offered load before the test is saturated.
+#ifndef HAYAI_OPEN_LOOP_KNEE_LATENCY
+#   define HAYAI_OPEN_LOOP_KNEE_LATENCY 10.0
+#endif
+
+/// Fraction of the offered load an open-loop test must achieve to not be
+/// saturated.
+#ifndef HAYAI_OPEN_LOOP_KNEE_THROUGHPUT
+#   define HAYAI_OPEN_LOOP_KNEE_THROUGHPUT 0.9
+#endif
 
 
 namespace hayai
 {
+    /// Classification of a run by the Tukey fences.
+    enum Outlier
+    {
+        /// Within the inner fences, 1.5 interquartile ranges beyond the
+        /// quartiles.
+        OutlierNone,
+
+
+        /// Between the inner and outer fences.
+        OutlierMild,
+
+
+        /// Beyond the outer fences, 3 interquartile ranges beyond the
+        /// quartiles.
+        OutlierSevere
+    };
+
+
+    /// Outcome of a comparison with a baseline result.
+    enum BaselineChange
+    {
+        /// No significant change.
+        BaselineUnchanged,
+
+
+        /// Significantly faster than the baseline.
+        BaselineImproved,
+
+
+        /// Significantly slower than the baseline.
+        BaselineRegressed
+    };
+
+
+    /// Comparison of a test result with a baseline result.
+
+    /// All times are per iteration and expressed in nanoseconds. Relative
+    /// changes are positive if the test has become slower.
+    struct BaselineComparison
+    {
+        BaselineComparison()
+            :   BaselineMedian(0.0),
+                Median(0.0),
+                RelativeChange(0.0),
+                RelativeChangeLower(0.0),
+                RelativeChangeUpper(0.0),
+                PValue(1.0),
+                Change(BaselineUnchanged)
+        {
+
+        }
+
+
+        /// Median time per iteration of the baseline.
+        double BaselineMedian;
+
+
+        /// Median time per iteration of the test.
+        double Median;
+
+
+        /// Relative change of the median.
+        double RelativeChange;
+
+
+        /// Lower bound of the confidence interval of the relative change.
+        double RelativeChangeLower;
+
+
+        /// Upper bound of the confidence interval of the relative change.
+        double RelativeChangeUpper;
+
+
+        /// Two-sided p-value of the Mann-Whitney U test.
+        double PValue;
+
+
+        /// Classification of the change.
+        BaselineChange Change;
+    };
+
+
     /// Test result descriptor.
 
     /// All durations are expressed in nanoseconds.
@@ -20,96 +127,49 @@ namespace hayai
 
         /// @param runTimes Timing for the individual runs.
         /// @param iterations Number of iterations per run.
+        /// @param significantDigits Number of significant decimal digits of
+        /// the run time histogram.
         TestResult(const std::vector<uint64_t>& runTimes,
-                   std::size_t iterations)
+                   std::size_t iterations,
+                   int significantDigits = HAYAI_HISTOGRAM_SIGNIFICANT_DIGITS)
             :   _runTimes(runTimes),
                 _iterations(iterations),
+                _runTimeHistogram(significantDigits),
+                _iterationTimeHistogram(significantDigits),
+                _sampleInterval(0),
+                _latencyHistogram(significantDigits),
+                _offeredRate(0.0),
+                _saturationRate(0.0),
                 _timeTotal(0),
                 _timeRunMin(std::numeric_limits<uint64_t>::max()),
                 _timeRunMax(std::numeric_limits<uint64_t>::min()),
+                _timeAverage(0.0),
                 _timeStdDev(0.0),
                 _timeMedian(0.0),
                 _timeQuartile1(0.0),
-                _timeQuartile3(0.0)
+                _timeQuartile3(0.0),
+                _timeMedianAbsoluteDeviation(0.0),
+                _mildOutliers(0),
+                _severeOutliers(0),
+                _madOutliers(0),
+                _timeTrimmedAverage(0.0),
+                _timeTrimmedStdDev(0.0),
+                _peakResidentSetSizeGrowth(0),
+                _adaptive(false),
+                _converged(false),
+                _relativeConfidenceIntervalWidth(0.0),
+                _targetRelativeConfidenceIntervalWidth(0.0),
+                _threads(1),
+                _warmUpRuns(0),
+                _hasBaseline(false),
+                _bootstrapResamples(0),
+                _bootstrapLevel(0.0),
+                _regressionLevel(0.0)
         {
-            // Summarize under the assumption of values being accessed more
-            // than once.
-            std::vector<uint64_t>::iterator runIt = _runTimes.begin();
-
-            while (runIt != _runTimes.end())
-            {
-                const uint64_t run = *runIt;
-
-                _timeTotal += run;
-                if ((runIt == _runTimes.begin()) || (run > _timeRunMax))
-                    _timeRunMax = run;
-                if ((runIt == _runTimes.begin()) || (run < _timeRunMin))
-                    _timeRunMin = run;
-
-                ++runIt;
-            }
-
-            // Calculate standard deviation.
-            const double mean = RunTimeAverage();
-            double accu = 0.0;
-
-            runIt = _runTimes.begin();
-
-            while (runIt != _runTimes.end())
-            {
-                const uint64_t run = *runIt;
-                const double diff = double(run) - mean;
-                accu += (diff * diff);
+            for (std::size_t run = 0; run < _runTimes.size(); ++run)
+                _timeTotal += _runTimes[run];
 
-                ++runIt;
-            }
-
-            _timeStdDev = std::sqrt(accu / (_runTimes.size() - 1));
-
-            // Calculate quartiles.
-            std::vector<uint64_t> sortedRunTimes(_runTimes);
-            std::sort(sortedRunTimes.begin(), sortedRunTimes.end());
-
-            const std::size_t sortedSize = sortedRunTimes.size();
-            const std::size_t sortedSizeHalf = sortedSize / 2;
-
-            if (sortedSize >= 2)
-            {
-                const std::size_t quartile = sortedSizeHalf / 2;
-
-                if ((sortedSize % 2) == 0)
-                {
-                    _timeMedian =
-                        (double(sortedRunTimes[sortedSizeHalf - 1]) +
-                         double(sortedRunTimes[sortedSizeHalf])) / 2;
-
-                    _timeQuartile1 =
-                        double(sortedRunTimes[quartile]);
-                    _timeQuartile3 =
-                        double(sortedRunTimes[sortedSizeHalf + quartile]);
-                }
-                else
-                {
-                    _timeMedian = double(sortedRunTimes[sortedSizeHalf]);
-
-                    _timeQuartile1 =
-                        (double(sortedRunTimes[quartile - 1]) +
-                         double(sortedRunTimes[quartile])) / 2;
-                    _timeQuartile3 = (
-                        double(
-                            sortedRunTimes[sortedSizeHalf + (quartile - 1)]
-                        ) +
-                        double(
-                            sortedRunTimes[sortedSizeHalf + quartile]
-                        )
-                    ) / 2;
-                }
-            }
-            else if (sortedSize > 0)
-            {
-                _timeQuartile1 = double(sortedRunTimes[0]);
-                _timeQuartile3 = _timeQuartile1;
-            }
+            Summarize();
         }
 
 
@@ -127,10 +187,17 @@ namespace hayai
         }
 
 
+        /// Number of iterations per run.
+        inline std::size_t Iterations() const
+        {
+            return _iterations;
+        }
+
+
         /// Average time per run.
         inline double RunTimeAverage() const
         {
-            return double(_timeTotal) / double(_runTimes.size());
+            return _timeAverage;
         }
 
         /// Standard deviation time per run.
@@ -157,6 +224,148 @@ namespace hayai
             return _timeQuartile3;
         }
 
+        /// Number of iterations of a run.
+
+        /// Differs between runs if @ref IsLinear is true.
+        ///
+        /// @param run Index of the run.
+        inline std::size_t RunIterations(std::size_t run) const
+        {
+            return (_runIterations.empty() ? _iterations : _runIterations[run]);
+        }
+
+
+        /// Median absolute deviation of the time per run.
+        inline double RunTimeMedianAbsoluteDeviation() const
+        {
+            return _timeMedianAbsoluteDeviation;
+        }
+
+
+        /// Average time per run excluding outliers.
+
+        /// Runs beyond the inner Tukey fences are excluded.
+        inline double RunTimeTrimmedAverage() const
+        {
+            return _timeTrimmedAverage;
+        }
+
+
+        /// Standard deviation of the time per run excluding outliers.
+
+        /// Runs beyond the inner Tukey fences are excluded.
+        inline double RunTimeTrimmedStdDev() const
+        {
+            return _timeTrimmedStdDev;
+        }
+
+
+        /// Classify a run by the Tukey fences.
+
+        /// @param run Index of the run.
+        Outlier RunOutlier(std::size_t run) const
+        {
+            const double time = double(SummarizedRunTimes()[run]);
+            const double range = _timeQuartile3 - _timeQuartile1;
+
+            if ((time < _timeQuartile1 - 3.0 * range) ||
+                (time > _timeQuartile3 + 3.0 * range))
+                return OutlierSevere;
+
+            if ((time < _timeQuartile1 - 1.5 * range) ||
+                (time > _timeQuartile3 + 1.5 * range))
+                return OutlierMild;
+
+            return OutlierNone;
+        }
+
+
+        /// Modified z-score of a run.
+
+        /// The absolute deviation of the run time from the median relative
+        /// to the median absolute deviation, scaled to be comparable to a
+        /// z-score for normally distributed run times.
+        ///
+        /// @param run Index of the run.
+        /// @returns the modified z-score, or 0 if the median absolute
+        /// deviation is 0.
+        double RunMadZScore(std::size_t run) const
+        {
+            if (_timeMedianAbsoluteDeviation <= 0.0)
+                return 0.0;
+
+            return 0.6745 *
+                std::fabs(double(SummarizedRunTimes()[run]) - _timeMedian) /
+                _timeMedianAbsoluteDeviation;
+        }
+
+
+        /// Number of mild outliers by the Tukey fences.
+        inline std::size_t MildOutliers() const
+        {
+            return _mildOutliers;
+        }
+
+
+        /// Number of severe outliers by the Tukey fences.
+        inline std::size_t SevereOutliers() const
+        {
+            return _severeOutliers;
+        }
+
+
+        /// Number of outliers by the modified z-score.
+
+        /// Runs with a modified z-score above
+        /// @ref HAYAI_OUTLIER_MAD_THRESHOLD are outliers.
+        inline std::size_t MadOutliers() const
+        {
+            return _madOutliers;
+        }
+
+
+        /// Fraction of runs that are outliers by the Tukey fences.
+        inline double OutlierFraction() const
+        {
+            return (_runTimes.empty() ?
+                    0.0 :
+                    double(_mildOutliers + _severeOutliers) /
+                    double(_runTimes.size()));
+        }
+
+
+        /// Time per run at a percentile.
+
+        /// Determined from the run times with the convention of the median,
+        /// ie. the smallest run time that is greater than or equal to the
+        /// given percentage of the run times, or the mean of two adjacent
+        /// run times if the percentage falls exactly between them. The 50th
+        /// percentile therefore equals @ref RunTimeMedian.
+        ///
+        /// @param percentile Percentile between 0 and 100, eg. 99.9.
+        double RunTimePercentile(double percentile) const
+        {
+            const std::size_t size = _sortedRunTimes.size();
+
+            if (!size)
+                return 0.0;
+
+            const double rank = percentile / 100.0 * double(size);
+
+            if (rank <= 0.0)
+                return double(_sortedRunTimes[0]);
+            if (rank >= double(size))
+                return double(_sortedRunTimes[size - 1]);
+
+            const std::size_t index = std::size_t(std::ceil(rank)) - 1;
+
+            if (double(index + 1) == rank)
+                return (double(_sortedRunTimes[index]) +
+                        double(_sortedRunTimes[index + 1])) / 2.0;
+
+            return double(_sortedRunTimes[index]);
+        }
+
         /// Maximum time per run.
         inline double RunTimeMaximum() const
         {
@@ -239,6 +448,36 @@ namespace hayai
             return RunTimeQuartile3() / double(_iterations);
         }
 
+        /// Average time per iteration excluding outliers.
+        inline double IterationTimeTrimmedAverage() const
+        {
+            return RunTimeTrimmedAverage() / double(_iterations);
+        }
+
+
+        /// Standard deviation of the time per iteration excluding outliers.
+        inline double IterationTimeTrimmedStdDev() const
+        {
+            return RunTimeTrimmedStdDev() / double(_iterations);
+        }
+
+
+        /// Time per iteration at a percentile.
+
+        /// Determined from the sampled iterations if @ref IsSampled is true,
+        /// and from the average time per iteration of each run otherwise.
+        ///
+        /// @param percentile Percentile between 0 and 100, eg. 99.9.
+        inline double IterationTimePercentile(double percentile) const
+        {
+            if (_sampleInterval)
+                return double(
+                    _iterationTimeHistogram.ValueAtPercentile(percentile)
+                );
+
+            return RunTimePercentile(percentile) / double(_iterations);
+        }
+
         /// Minimum time per iteration.
         inline double IterationTimeMinimum() const
         {
@@ -289,16 +528,768 @@ namespace hayai
         {
             return 1000000000.0 / IterationTimeMinimum();
         }
+
+
+        /// Run time histogram.
+
+        /// Holds the time of each run. Histograms of the same test from
+        /// several invocations can be merged with @ref Histogram::Merge.
+        inline const Histogram& RunTimeHistogram() const
+        {
+            return _runTimeHistogram;
+        }
+
+
+        /// Set the samples of individual iterations.
+
+        /// @param samples Histogram of the time of the sampled iterations.
+        /// @param interval Interval of the sampled iterations.
+        void SetIterationSamples(const Histogram& samples,
+                                 std::size_t interval)
+        {
+            _iterationTimeHistogram = samples;
+            _sampleInterval = interval;
+        }
+
+
+        /// Whether individual iterations were sampled.
+        inline bool IsSampled() const
+        {
+            return (_sampleInterval != 0);
+        }
+
+
+        /// Interval of the sampled iterations.
+
+        /// 0 if @ref IsSampled is false.
+        inline std::size_t SampleInterval() const
+        {
+            return _sampleInterval;
+        }
+
+
+        /// Iteration time histogram.
+
+        /// Holds the time of each sampled iteration, with the overhead of
+        /// timing the iteration subtracted. Empty if @ref IsSampled is
+        /// false.
+        inline const Histogram& IterationTimeHistogram() const
+        {
+            return _iterationTimeHistogram;
+        }
+
+
+        /// Set the outcome of an open-loop test.
+
+        /// @param offeredRate Offered load in iterations per second.
+        /// @param latencies Histogram of the latency of each iteration,
+        /// measured from its intended start time.
+        void SetOpenLoop(double offeredRate, const Histogram& latencies)
+        {
+            _offeredRate = offeredRate;
+            _latencyHistogram = latencies;
+        }
+
+
+        /// Whether the test was run open-loop at a fixed rate.
+        inline bool IsOpenLoop() const
+        {
+            return (_offeredRate > 0.0);
+        }
+
+
+        /// Offered load in iterations per second.
+
+        /// 0 if @ref IsOpenLoop is false.
+        inline double OfferedRate() const
+        {
+            return _offeredRate;
+        }
+
+
+        /// Achieved throughput in iterations per second.
+        inline double AchievedRate() const
+        {
+            return IterationsPerSecondAverage();
+        }
+
+
+        /// Latency histogram.
+
+        /// Holds the latency of each iteration of an open-loop test,
+        /// measured from the intended start time of the iteration. Empty if
+        /// @ref IsOpenLoop is false.
+        inline const Histogram& LatencyHistogram() const
+        {
+            return _latencyHistogram;
+        }
+
+
+        /// Set the saturation throughput of an open-loop sweep.
+
+        /// Set on the result of the first offered load at which the test was
+        /// saturated.
+        ///
+        /// @param rate Highest throughput in iterations per second achieved
+        /// at a lower offered load.
+        void SetSaturationRate(double rate)
+        {
+            _saturationRate = rate;
+        }
+
+
+        /// Whether the offered load is beyond the knee of an open-loop sweep.
+
+        /// The load is beyond the knee if the test achieves less than
+        /// @ref HAYAI_OPEN_LOOP_KNEE_THROUGHPUT of the offered load, or its
+        /// 99th percentile latency exceeds @ref HAYAI_OPEN_LOOP_KNEE_LATENCY
+        /// times the latency at the lowest offered load.
+        ///
+        /// @param baselineLatency 99th percentile latency at the lowest
+        /// offered load in nanoseconds.
+        /// @param minimumLatency Smallest meaningful latency in nanoseconds,
+        /// eg. the resolution of the clock, which the baseline latency is
+        /// raised to.
+        bool IsBeyondKnee(double baselineLatency, double minimumLatency) const
+        {
+            const double latency =
+                double(_latencyHistogram.ValueAtPercentile(99.0));
+
+            return ((AchievedRate() <
+                     _offeredRate * HAYAI_OPEN_LOOP_KNEE_THROUGHPUT) ||
+                    (latency > std::max(baselineLatency, minimumLatency) *
+                               HAYAI_OPEN_LOOP_KNEE_LATENCY));
+        }
+
+
+        /// Whether the test was saturated at the offered load.
+        inline bool IsSaturated() const
+        {
+            return (_saturationRate > 0.0);
+        }
+
+
+        /// Saturation throughput in iterations per second.
+
+        /// 0 if @ref IsSaturated is false.
+        inline double SaturationRate() const
+        {
+            return _saturationRate;
+        }
+
+
+        /// Set performance counter values.
+
+        /// @param names Names of the counted events.
+        /// @param runValues Counts for each run, in the order of the run
+        /// times, each in the order of @p names.
+        void SetPerformanceCounters(
+            const std::vector<std::string>& names,
+            const std::vector<std::vector<uint64_t> >& runValues
+        )
+        {
+            _counterNames = names;
+            _counterValues = runValues;
+        }
+
+
+        /// Names of the performance counters.
+
+        /// Empty if no performance counters were collected.
+        inline const std::vector<std::string>& PerformanceCounterNames() const
+        {
+            return _counterNames;
+        }
+
+
+        /// Performance counter values.
+
+        /// @returns the counts for each run, each in the order of
+        /// @ref PerformanceCounterNames.
+        inline const std::vector<std::vector<uint64_t> >&
+            PerformanceCounterValues() const
+        {
+            return _counterValues;
+        }
+
+
+        /// Average performance counter value per iteration.
+
+        /// @param counter Index of the counter in
+        /// @ref PerformanceCounterNames.
+        double PerformanceCounterIterationAverage(std::size_t counter) const
+        {
+            double total = 0.0;
+
+            for (std::size_t run = 0; run < _counterValues.size(); ++run)
+                total += double(_counterValues[run][counter]);
+
+            return total / (double(_counterValues.size()) *
+                            double(_iterations));
+        }
+
+
+        /// Set the resource usage of the runs.
+
+        /// @param runUsage Usage of each run, in the order of the run times.
+        /// @param peakResidentSetSizeGrowth Growth of the peak resident set
+        /// size of the process over all runs in bytes.
+        void SetResourceUsage(const std::vector<ResourceUsage>& runUsage,
+                              uint64_t peakResidentSetSizeGrowth)
+        {
+            _resourceUsage = runUsage;
+            _peakResidentSetSizeGrowth = peakResidentSetSizeGrowth;
+        }
+
+
+        /// Whether the resource usage of the runs was sampled.
+        inline bool HasResourceUsage() const
+        {
+            return !_resourceUsage.empty();
+        }
+
+
+        /// Resource usage of each run.
+
+        /// Empty if @ref HasResourceUsage is false. The peak resident set
+        /// size is not sampled per run.
+        inline const std::vector<ResourceUsage>& RunResourceUsage() const
+        {
+            return _resourceUsage;
+        }
+
+
+        /// Total resource usage of the runs.
+
+        /// The peak resident set size is the growth of the peak over all
+        /// runs.
+        ResourceUsage TotalResourceUsage() const
+        {
+            ResourceUsage total;
+
+            for (std::size_t run = 0; run < _resourceUsage.size(); ++run)
+                total.Add(_resourceUsage[run]);
+
+            total.PeakResidentSetSize = _peakResidentSetSizeGrowth;
+
+            return total;
+        }
+
+
+        /// Set the outcome of an adaptive run count.
+
+        /// @param converged Whether the confidence interval converged before
+        /// reaching the maximum number of runs or the time budget.
+        /// @param relativeWidth Final relative width of the confidence
+        /// interval.
+        /// @param targetRelativeWidth Relative width of the confidence
+        /// interval at which runs are stopped.
+        void SetConvergence(bool converged,
+                            double relativeWidth,
+                            double targetRelativeWidth)
+        {
+            _adaptive = true;
+            _converged = converged;
+            _relativeConfidenceIntervalWidth = relativeWidth;
+            _targetRelativeConfidenceIntervalWidth = targetRelativeWidth;
+        }
+
+
+        /// Whether the number of runs was determined adaptively.
+        inline bool IsAdaptive() const
+        {
+            return _adaptive;
+        }
+
+
+        /// Whether the adaptive run count converged.
+
+        /// Always false if @ref IsAdaptive is false.
+        inline bool Converged() const
+        {
+            return _converged;
+        }
+
+
+        /// Final relative width of the confidence interval.
+
+        /// Only meaningful if @ref IsAdaptive is true.
+        inline double RelativeConfidenceIntervalWidth() const
+        {
+            return _relativeConfidenceIntervalWidth;
+        }
+
+
+        /// Target relative width of the confidence interval.
+
+        /// Only meaningful if @ref IsAdaptive is true.
+        inline double TargetRelativeConfidenceIntervalWidth() const
+        {
+            return _targetRelativeConfidenceIntervalWidth;
+        }
+
+
+        /// Set the per-thread timing of a multi-threaded test.
+
+        /// @param threads Number of threads the test was run on.
+        /// @param threadRunTimes Time taken by each thread for each run, in
+        /// the order of the run times, each in the order of the threads.
+        void SetThreads(
+            std::size_t threads,
+            const std::vector<std::vector<uint64_t> >& threadRunTimes
+        )
+        {
+            _threads = threads;
+            _threadRunTimes = threadRunTimes;
+        }
+
+
+        /// Whether the test was run on multiple threads.
+        inline bool IsThreaded() const
+        {
+            return !_threadRunTimes.empty();
+        }
+
+
+        /// Number of threads the test was run on.
+
+        /// The number of iterations per run is per thread, and the time of a
+        /// run is the time taken by the slowest thread.
+        inline std::size_t Threads() const
+        {
+            return _threads;
+        }
+
+
+        /// Thread run times.
+
+        /// @returns the time taken by each thread for each run, each in the
+        /// order of the threads. Empty if @ref IsThreaded is false.
+        inline const std::vector<std::vector<uint64_t> >&
+            ThreadRunTimes() const
+        {
+            return _threadRunTimes;
+        }
+
+
+        /// Average iterations per second of a single thread.
+
+        /// @param thread Index of the thread.
+        double ThreadIterationsPerSecondAverage(std::size_t thread) const
+        {
+            double total = 0.0;
+
+            for (std::size_t run = 0; run < _threadRunTimes.size(); ++run)
+                total += double(_threadRunTimes[run][thread]);
+
+            return 1000000000.0 *
+                double(_threadRunTimes.size()) * double(_iterations) / total;
+        }
+
+
+        /// Average iterations per second across all threads.
+        inline double AggregateIterationsPerSecondAverage() const
+        {
+            return double(_threads) * IterationsPerSecondAverage();
+        }
+
+
+        /// Set the comparison with a baseline result.
+
+        /// @param comparison Comparison.
+        void SetBaselineComparison(const BaselineComparison& comparison)
+        {
+            _hasBaseline = true;
+            _baselineComparison = comparison;
+        }
+
+
+        /// Whether the result has been compared with a baseline result.
+        inline bool HasBaselineComparison() const
+        {
+            return _hasBaseline;
+        }
+
+
+        /// Comparison with a baseline result.
+
+        /// Only meaningful if @ref HasBaselineComparison is true.
+        inline const BaselineComparison& BaselineComparisonResult() const
+        {
+            return _baselineComparison;
+        }
+
+
+        /// Set the iteration counts of runs with linearly increasing
+        /// iteration counts.
+
+        /// Fits the run times to the iteration counts, so that the slope is
+        /// the time per iteration without the fixed overhead of each run.
+        /// The per-run statistics are recalculated from the run times scaled
+        /// to @ref Iterations, as runs of different lengths cannot be
+        /// compared directly.
+        ///
+        /// @param runIterations Number of iterations of each run.
+        /// @param level Confidence level of the interval of the slope.
+        void SetRunIterations(const std::vector<std::size_t>& runIterations,
+                              double level)
+        {
+            if (runIterations.size() != _runTimes.size())
+                return;
+
+            std::vector<double> x;
+            std::vector<double> y;
+            _normalizedRunTimes.clear();
+
+            for (std::size_t run = 0; run < _runTimes.size(); ++run)
+            {
+                const std::size_t iterations =
+                    std::max<std::size_t>(runIterations[run], 1);
+
+                x.push_back(double(iterations));
+                y.push_back(double(_runTimes[run]));
+                _normalizedRunTimes.push_back(uint64_t(
+                    double(_runTimes[run]) * double(_iterations) /
+                    double(iterations) + 0.5
+                ));
+            }
+
+            _runIterations = runIterations;
+            _regressionLevel = level;
+            _iterationTimeRegression = Statistics::FitLine(x, y, level);
+
+            Summarize();
+        }
+
+
+        /// Whether runs were performed with linearly increasing iteration
+        /// counts.
+        inline bool IsLinear() const
+        {
+            return !_runIterations.empty();
+        }
+
+
+        /// Linear regression of the run times on the iteration counts.
+
+        /// The slope is the time per iteration and the intercept the fixed
+        /// time per run. Only meaningful if @ref IsLinear is true.
+        inline const LinearRegression& IterationTimeRegression() const
+        {
+            return _iterationTimeRegression;
+        }
+
+
+        /// Confidence level of the interval of the regression slope.
+        inline double RegressionConfidenceLevel() const
+        {
+            return _regressionLevel;
+        }
+
+
+        /// Estimate bootstrap confidence intervals.
+
+        /// Resamples the run times to estimate confidence intervals of the
+        /// average and median time without assuming a distribution of the
+        /// run times.
+        ///
+        /// @param bootstrap Bootstrap to resample with.
+        void EstimateConfidenceIntervals(const Bootstrap& bootstrap)
+        {
+            if ((_runTimes.empty()) || (!bootstrap.Resamples()))
+                return;
+
+            bootstrap.Estimate(SummarizedRunTimes(),
+                               _timeAverageInterval,
+                               _timeMedianInterval);
+
+            _bootstrapResamples = bootstrap.Resamples();
+            _bootstrapLevel = bootstrap.Level();
+        }
+
+
+        /// Whether bootstrap confidence intervals have been estimated.
+        inline bool HasConfidenceIntervals() const
+        {
+            return (_bootstrapResamples != 0);
+        }
+
+
+        /// Number of bootstrap resamples of the confidence intervals.
+        inline std::size_t BootstrapResamples() const
+        {
+            return _bootstrapResamples;
+        }
+
+
+        /// Confidence level of the confidence intervals.
+        inline double ConfidenceLevel() const
+        {
+            return _bootstrapLevel;
+        }
+
+
+        /// Confidence interval of the average time per run.
+
+        /// Only meaningful if @ref HasConfidenceIntervals is true.
+        inline const ConfidenceInterval& RunTimeAverageInterval() const
+        {
+            return _timeAverageInterval;
+        }
+
+
+        /// Confidence interval of the median time per run.
+
+        /// Only meaningful if @ref HasConfidenceIntervals is true.
+        inline const ConfidenceInterval& RunTimeMedianInterval() const
+        {
+            return _timeMedianInterval;
+        }
+
+
+        /// Confidence interval of the average time per iteration.
+
+        /// Only meaningful if @ref HasConfidenceIntervals is true.
+        inline ConfidenceInterval IterationTimeAverageInterval() const
+        {
+            return ConfidenceInterval(
+                _timeAverageInterval.Lower / double(_iterations),
+                _timeAverageInterval.Upper / double(_iterations)
+            );
+        }
+
+
+        /// Confidence interval of the median time per iteration.
+
+        /// Only meaningful if @ref HasConfidenceIntervals is true.
+        inline ConfidenceInterval IterationTimeMedianInterval() const
+        {
+            return ConfidenceInterval(
+                _timeMedianInterval.Lower / double(_iterations),
+                _timeMedianInterval.Upper / double(_iterations)
+            );
+        }
+
+
+        /// Set the number of warm-up runs.
+
+        /// @param runs Number of warm-up runs performed before the runs and
+        /// discarded.
+        void SetWarmUpRuns(std::size_t runs)
+        {
+            _warmUpRuns = runs;
+        }
+
+
+        /// Number of warm-up runs.
+
+        /// Warm-up runs are not included in the run times.
+        inline std::size_t WarmUpRuns() const
+        {
+            return _warmUpRuns;
+        }
     private:
+        /// Run times the per-run statistics are computed from.
+
+        /// Runs with linearly increasing iteration counts are scaled to the
+        /// number of iterations per run, so that runs of different lengths
+        /// are comparable.
+        inline const std::vector<uint64_t>& SummarizedRunTimes() const
+        {
+            return (_runIterations.empty() ?
+                    _runTimes :
+                    _normalizedRunTimes);
+        }
+
+
+        /// Calculate the per-run statistics.
+        void Summarize()
+        {
+            const std::vector<uint64_t>& runTimes = SummarizedRunTimes();
+
+            _runTimeHistogram =
+                Histogram(_runTimeHistogram.SignificantDigits());
+            _timeRunMin = std::numeric_limits<uint64_t>::max();
+            _timeRunMax = std::numeric_limits<uint64_t>::min();
+            _timeAverage = 0.0;
+            _timeStdDev = 0.0;
+            _timeMedian = 0.0;
+            _timeQuartile1 = 0.0;
+            _timeQuartile3 = 0.0;
+            _timeMedianAbsoluteDeviation = 0.0;
+            _mildOutliers = 0;
+            _severeOutliers = 0;
+            _madOutliers = 0;
+            _timeTrimmedAverage = 0.0;
+            _timeTrimmedStdDev = 0.0;
+
+            // Summarize under the assumption of values being accessed more
+            // than once.
+            double total = 0.0;
+
+            for (std::size_t run = 0; run < runTimes.size(); ++run)
+            {
+                const uint64_t time = runTimes[run];
+
+                total += double(time);
+                if ((run == 0) || (time > _timeRunMax))
+                    _timeRunMax = time;
+                if ((run == 0) || (time < _timeRunMin))
+                    _timeRunMin = time;
+
+                _runTimeHistogram.Record(time);
+            }
+
+            _timeAverage = total / double(runTimes.size());
+
+            // Calculate standard deviation.
+            double accu = 0.0;
+
+            for (std::size_t run = 0; run < runTimes.size(); ++run)
+            {
+                const double diff = double(runTimes[run]) - _timeAverage;
+                accu += (diff * diff);
+            }
+
+            _timeStdDev = std::sqrt(accu / (runTimes.size() - 1));
+
+            // Calculate quartiles as the medians of the lower and upper
+            // half of the runs, excluding the median if the number of runs
+            // is odd.
+            _sortedRunTimes = runTimes;
+            std::sort(_sortedRunTimes.begin(), _sortedRunTimes.end());
+            const std::vector<uint64_t>& sortedRunTimes = _sortedRunTimes;
+
+            const std::size_t sortedSize = sortedRunTimes.size();
+            const std::size_t sortedSizeHalf = sortedSize / 2;
+
+            if (sortedSize >= 2)
+            {
+                _timeMedian = Statistics::SortedMedian(sortedRunTimes);
+                _timeQuartile1 = Statistics::SortedMedian(sortedRunTimes,
+                                                          0,
+                                                          sortedSizeHalf);
+                _timeQuartile3 =
+                    Statistics::SortedMedian(sortedRunTimes,
+                                             sortedSize - sortedSizeHalf,
+                                             sortedSizeHalf);
+            }
+            else if (sortedSize > 0)
+            {
+                _timeMedian = double(sortedRunTimes[0]);
+                _timeQuartile1 = _timeMedian;
+                _timeQuartile3 = _timeMedian;
+            }
+
+            // Calculate the median absolute deviation.
+            if (sortedSize > 0)
+            {
+                std::vector<double> deviations;
+                deviations.reserve(sortedSize);
+
+                for (std::size_t run = 0; run < sortedSize; ++run)
+                    deviations.push_back(
+                        std::fabs(double(runTimes[run]) - _timeMedian)
+                    );
+
+                std::sort(deviations.begin(), deviations.end());
+                _timeMedianAbsoluteDeviation =
+                    Statistics::SortedMedian(deviations);
+            }
+
+            // Classify outliers and summarize the remaining runs.
+            double trimmedTotal = 0.0;
+            std::size_t trimmedCount = 0;
+
+            for (std::size_t run = 0; run < sortedSize; ++run)
+            {
+                if (RunMadZScore(run) > HAYAI_OUTLIER_MAD_THRESHOLD)
+                    ++_madOutliers;
+
+                switch (RunOutlier(run))
+                {
+                case OutlierMild:
+                    ++_mildOutliers;
+                    break;
+
+                case OutlierSevere:
+                    ++_severeOutliers;
+                    break;
+
+                default:
+                    trimmedTotal += double(runTimes[run]);
+                    ++trimmedCount;
+                    break;
+                }
+            }
+
+            if (trimmedCount)
+                _timeTrimmedAverage = trimmedTotal / double(trimmedCount);
+
+            if (trimmedCount > 1)
+            {
+                double trimmedAccu = 0.0;
+
+                for (std::size_t run = 0; run < sortedSize; ++run)
+                {
+                    if (RunOutlier(run) != OutlierNone)
+                        continue;
+
+                    const double diff =
+                        double(runTimes[run]) - _timeTrimmedAverage;
+                    trimmedAccu += diff * diff;
+                }
+
+                _timeTrimmedStdDev =
+                    std::sqrt(trimmedAccu / double(trimmedCount - 1));
+            }
+        }
+
+
         std::vector<uint64_t> _runTimes;
+        std::vector<uint64_t> _normalizedRunTimes;
+        std::vector<uint64_t> _sortedRunTimes;
         std::size_t _iterations;
+        Histogram _runTimeHistogram;
+        Histogram _iterationTimeHistogram;
+        std::size_t _sampleInterval;
+        Histogram _latencyHistogram;
+        double _offeredRate;
+        double _saturationRate;
         uint64_t _timeTotal;
         uint64_t _timeRunMin;
         uint64_t _timeRunMax;
+        double _timeAverage;
         double _timeStdDev;
         double _timeMedian;
         double _timeQuartile1;
         double _timeQuartile3;
+        double _timeMedianAbsoluteDeviation;
+        std::size_t _mildOutliers;
+        std::size_t _severeOutliers;
+        std::size_t _madOutliers;
+        double _timeTrimmedAverage;
+        double _timeTrimmedStdDev;
+        std::vector<std::string> _counterNames;
+        std::vector<std::vector<uint64_t> > _counterValues;
+        std::vector<ResourceUsage> _resourceUsage;
+        uint64_t _peakResidentSetSizeGrowth;
+        bool _adaptive;
+        bool _converged;
+        double _relativeConfidenceIntervalWidth;
+        double _targetRelativeConfidenceIntervalWidth;
+        std::size_t _threads;
+        std::vector<std::vector<uint64_t> > _threadRunTimes;
+        std::size_t _warmUpRuns;
+        bool _hasBaseline;
+        BaselineComparison _baselineComparison;
+        std::size_t _bootstrapResamples;
+        double _bootstrapLevel;
+        ConfidenceInterval _timeAverageInterval;
+        ConfidenceInterval _timeMedianInterval;
+        std::vector<std::size_t> _runIterations;
+        double _regressionLevel;
+        LinearRegression _iterationTimeRegression;
     };
 }
 #endif
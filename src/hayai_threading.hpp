@@ -0,0 +1,240 @@
+//
+// Threading primitives for multi-threaded benchmarks.
+//
+// Implementation notes:
+//
+// Threads are created through the native API of the platform, ie. pthreads
+// on POSIX systems and the Win32 API on Windows, as hayai must compile as
+// C++98.
+//
+// The start barrier spins rather than blocks, so that all threads are
+// released within a few cycles of the last thread arriving instead of having
+// to be woken up by the scheduler one by one. To remain usable when there
+// are more threads than processors, waiting threads yield their time slice
+// after a short period of spinning.
+//
+#ifndef __HAYAI_THREADING
+#define __HAYAI_THREADING
+#include <cstddef>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+
+/// Thread local storage class specifier.
+#if __cplusplus > 201100L
+#   define HAYAI_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#   define HAYAI_THREAD_LOCAL __declspec(thread)
+#else
+#   define HAYAI_THREAD_LOCAL __thread
+#endif
+
+
+namespace hayai
+{
+    /// Number of hardware threads.
+
+    /// @returns the number of processors available, or 1 if it cannot be
+    /// determined.
+    inline std::size_t HardwareConcurrency()
+    {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return (info.dwNumberOfProcessors > 0 ?
+                std::size_t(info.dwNumberOfProcessors) :
+                1);
+#elif defined(_SC_NPROCESSORS_ONLN)
+        const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        return (processors > 0 ? std::size_t(processors) : 1);
+#else
+        return 1;
+#endif
+    }
+
+
+    /// Single use spinning barrier.
+
+    /// Releases all waiting threads once the given number of threads have
+    /// arrived.
+    class SpinBarrier
+    {
+    public:
+        /// Initialize a barrier.
+
+        /// @param count Number of threads to wait for.
+        SpinBarrier(std::size_t count)
+            :   _count(long(count)),
+                _arrived(0)
+        {
+
+        }
+
+
+        /// Wait for all threads to arrive.
+        void Wait()
+        {
+            Increment(&_arrived);
+
+            std::size_t spins = 0;
+
+            while (Load(&_arrived) < _count)
+            {
+                if (++spins % 1024 == 0)
+                    Relax();
+            }
+        }
+
+
+        /// Count threads as arrived without waiting.
+
+        /// Used to release the waiting threads if not all threads could be
+        /// started.
+        ///
+        /// @param count Number of threads that will not arrive.
+        void Abandon(std::size_t count)
+        {
+            while (count--)
+                Increment(&_arrived);
+        }
+    private:
+        SpinBarrier(const SpinBarrier&);
+        SpinBarrier& operator =(const SpinBarrier&);
+
+
+        /// Atomically increment a value with full memory ordering.
+        static void Increment(volatile long* value)
+        {
+#if defined(_MSC_VER)
+            InterlockedIncrement(value);
+#else
+            __sync_fetch_and_add(value, 1);
+#endif
+        }
+
+
+        /// Load a value with full memory ordering.
+        static long Load(volatile long* value)
+        {
+#if defined(_MSC_VER)
+            return InterlockedCompareExchange(value, 0, 0);
+#else
+            return __sync_fetch_and_add(value, 0);
+#endif
+        }
+
+
+        /// Yield the time slice of the calling thread.
+        static void Relax()
+        {
+#if defined(_WIN32)
+            SwitchToThread();
+#else
+            sched_yield();
+#endif
+        }
+
+
+        const long _count;
+        volatile long _arrived;
+    };
+
+
+    /// Thread.
+
+    /// Runs a function on a new thread from construction until the thread
+    /// has been joined.
+    class Thread
+    {
+    public:
+        /// Thread function.
+        typedef void (*Function)(void* argument);
+
+
+        /// Start a thread.
+
+        /// @param function Function to run on the thread.
+        /// @param argument Argument to pass to @p function.
+        /// @throws std::runtime_error if the thread cannot be created.
+        Thread(Function function, void* argument)
+            :   _function(function),
+                _argument(argument),
+                _joined(false)
+        {
+#if defined(_WIN32)
+            _handle = CreateThread(NULL, 0, &Thread::Entry, this, 0, NULL);
+            if (_handle == NULL)
+                throw std::runtime_error("failed to create thread");
+#else
+            if (pthread_create(&_handle, NULL, &Thread::Entry, this))
+                throw std::runtime_error("failed to create thread");
+#endif
+        }
+
+
+        /// Join the thread if it has not already been joined.
+        ~Thread()
+        {
+            Join();
+        }
+
+
+        /// Wait for the thread to finish.
+        void Join()
+        {
+            if (_joined)
+                return;
+
+#if defined(_WIN32)
+            WaitForSingleObject(_handle, INFINITE);
+            CloseHandle(_handle);
+#else
+            pthread_join(_handle, NULL);
+#endif
+            _joined = true;
+        }
+    private:
+        Thread(const Thread&);
+        Thread& operator =(const Thread&);
+
+
+#if defined(_WIN32)
+        static DWORD WINAPI Entry(LPVOID thread)
+        {
+            static_cast<Thread*>(thread)->_function(
+                static_cast<Thread*>(thread)->_argument
+            );
+            return 0;
+        }
+#else
+        static void* Entry(void* thread)
+        {
+            static_cast<Thread*>(thread)->_function(
+                static_cast<Thread*>(thread)->_argument
+            );
+            return NULL;
+        }
+#endif
+
+
+        Function _function;
+        void* _argument;
+        bool _joined;
+#if defined(_WIN32)
+        HANDLE _handle;
+#else
+        pthread_t _handle;
+#endif
+    };
+}
+#endif
@@ -0,0 +1,97 @@
+//
+// Type lists of type-parametrized benchmarks.
+//
+// Implementation notes:
+//
+// Without variadic templates, a type list is a template with a fixed number
+// of type parameters defaulting to a placeholder. The list is traversed by
+// its head and a tail that shifts the remaining types down by one, until
+// the tail is the empty list.
+//
+// Type names are derived from std::type_info, demangled where the compiler
+// provides the Itanium C++ ABI demangler. As the names of standard library
+// containers spell out every default template argument, @ref TypeName can
+// be specialized to give a type a shorter name.
+//
+#ifndef __HAYAI_TYPES
+#define __HAYAI_TYPES
+#include <cstdlib>
+#include <string>
+#include <typeinfo>
+#if defined(__GNUC__) || defined(__clang__)
+#   include <cxxabi.h>
+#   define HAYAI_DEMANGLE
+#endif
+
+
+namespace hayai
+{
+    /// Placeholder for unused types of a type list.
+    struct NoType
+    {
+
+    };
+
+
+    /// List of up to ten types.
+
+    /// Passed to the type-parametrized benchmark macros as a typedef, eg.
+    /// typedef hayai::Types<std::map<int, int>, FlatMap> MapTypes;
+    template<class T1 = NoType,
+             class T2 = NoType,
+             class T3 = NoType,
+             class T4 = NoType,
+             class T5 = NoType,
+             class T6 = NoType,
+             class T7 = NoType,
+             class T8 = NoType,
+             class T9 = NoType,
+             class T10 = NoType>
+    struct Types
+    {
+        /// First type.
+        typedef T1 Head;
+
+
+        /// Remaining types.
+        typedef Types<T2, T3, T4, T5, T6, T7, T8, T9, T10> Tail;
+    };
+
+
+    /// Name of a type.
+
+    /// Specialize to give a type a name other than the demangled name of
+    /// its std::type_info, eg.
+    ///
+    /// template<> struct TypeName<FlatMap<int, int> >
+    /// {
+    ///     static std::string Name() { return "FlatMap"; }
+    /// };
+    template<class T>
+    struct TypeName
+    {
+        /// Name of the type.
+        static std::string Name()
+        {
+            const char* mangled = typeid(T).name();
+
+#ifdef HAYAI_DEMANGLE
+            int status = 0;
+            char* demangled =
+                abi::__cxa_demangle(mangled, NULL, NULL, &status);
+
+            if ((status == 0) && (demangled))
+            {
+                const std::string name(demangled);
+                free(demangled);
+                return name;
+            }
+#endif
+
+            return mangled;
+        }
+    };
+}
+
+#undef HAYAI_DEMANGLE
+#endif
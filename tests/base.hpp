@@ -15,9 +15,19 @@ using namespace hayai;
     }
 
 
-std::ostream& operator <<(std::ostream& s,
-                          const TestParameterDescriptor& desc)
+inline std::ostream& operator <<(std::ostream& s,
+                                 const TestParameterDescriptor& desc)
 {
     return s << "::hayai::TestParameterDescriptor(Declaration="
              << desc.Declaration << ", Value=" << desc.Value << ")";
 }
+
+
+/// Spin for a duration, eg. to stand in for a payload of known duration.
+inline void SpinFor(uint64_t nanoseconds)
+{
+    const Clock::TimePoint startTime = Clock::Now();
+
+    while (Clock::Duration(startTime, Clock::Now()) < nanoseconds)
+        ;
+}
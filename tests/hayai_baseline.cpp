@@ -0,0 +1,215 @@
+#include <cstdio>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "base.hpp"
+
+
+// The baseline files are created with mkstemp, which only POSIX systems
+// provide.
+#if !defined(_WIN32)
+namespace
+{
+    /// Number of runs of the results.
+    const std::size_t Runs = 20;
+
+
+    /// Run times of about 1 ms per iteration, scaled by a factor.
+    std::vector<uint64_t> RunTimes(std::size_t iterations, double factor)
+    {
+        std::vector<uint64_t> runTimes;
+
+        for (std::size_t run = 0; run < Runs; ++run)
+            runTimes.push_back(uint64_t(double(iterations) * factor *
+                                        double(1000000 + 1000 * run)));
+
+        return runTimes;
+    }
+
+
+    /// Result of runs with linearly increasing iteration counts.
+    TestResult LinearResult(double factor)
+    {
+        std::vector<std::size_t> runIterations;
+        std::vector<uint64_t> runTimes;
+
+        for (std::size_t run = 0; run < Runs; ++run)
+        {
+            runIterations.push_back(run + 1);
+            runTimes.push_back(uint64_t(double(run + 1) * factor *
+                                        double(1000000 + 1000 * run)));
+        }
+
+        TestResult result(runTimes, 1);
+        result.SetRunIterations(runIterations, 0.95);
+        return result;
+    }
+
+
+    /// Parameters of the parameterized benchmark.
+    TestParametersDescriptor SpeedParameters()
+    {
+        TestParametersDescriptor parameters;
+        parameters.AddParameter("std::size_t speed", "2");
+        return parameters;
+    }
+
+
+    /// Temporary baseline file, removed on destruction.
+    class TemporaryBaseline
+    {
+    public:
+        TemporaryBaseline()
+        {
+            char path[] = "/tmp/hayai_baseline_XXXXXX";
+            const int descriptor = mkstemp(path);
+
+            if (descriptor >= 0)
+            {
+                close(descriptor);
+                Path = path;
+            }
+        }
+
+
+        ~TemporaryBaseline()
+        {
+            if ((!Path.empty()) && (remove(Path.c_str())))
+                ADD_FAILURE() << "failed to remove " << Path;
+        }
+
+
+        /// Write results with the JSON outputter.
+        void Write()
+        {
+            std::ofstream stream(Path.c_str());
+            JsonOutputter outputter(stream);
+            const TestParametersDescriptor none;
+            const TestParametersDescriptor speed = SpeedParameters();
+            const TestResult plain(RunTimes(10, 1.0), 10);
+            const TestResult parameterized(RunTimes(5, 1.0), 5);
+            const TestResult linear = LinearResult(1.0);
+
+            outputter.Begin(3, 0);
+            outputter.BeginTest("Baseline", "Plain", none, Runs, 10);
+            outputter.EndTest("Baseline", "Plain", none, plain);
+            outputter.BeginTest("Baseline", "Speed", speed, Runs, 5);
+            outputter.EndTest("Baseline", "Speed", speed, parameterized);
+            outputter.BeginTest("Baseline", "Linear", none, Runs, 1);
+            outputter.EndTest("Baseline", "Linear", none, linear);
+            outputter.End(3, 0);
+        }
+
+
+        std::string Path;
+    };
+}
+
+
+TEST(Baseline, LoadsJsonResults)
+{
+    TemporaryBaseline file;
+    ASSERT_FALSE(file.Path.empty());
+    file.Write();
+
+    Baseline baseline;
+    baseline.Load(file.Path);
+
+    EXPECT_EQ(std::size_t(3), baseline.Size());
+
+    const std::string speed =
+        Baseline::CanonicalName("Baseline", "Speed", SpeedParameters());
+    EXPECT_EQ(std::string("Baseline.Speed(std::size_t speed = 2)"), speed);
+
+    // 20 runs of 5 iterations of 1 ms to 1.019 ms.
+    EXPECT_NEAR(5.0 * (20.0 * 1000000.0 + 190.0 * 1000.0),
+                baseline.Duration(speed),
+                1.0);
+    EXPECT_EQ(0.0, baseline.Duration("Baseline.Speed"));
+    EXPECT_EQ(0.0, baseline.Duration("Baseline.Missing"));
+}
+
+
+TEST(Baseline, ComparesPerIteration)
+{
+    TemporaryBaseline file;
+    ASSERT_FALSE(file.Path.empty());
+    file.Write();
+
+    Baseline baseline;
+    baseline.Load(file.Path);
+
+    BaselineComparison comparison;
+
+    // The same times per iteration with a different number of iterations
+    // per run are unchanged.
+    ASSERT_TRUE(baseline.Compare("Baseline.Plain",
+                                 TestResult(RunTimes(4, 1.0), 4),
+                                 comparison));
+    EXPECT_NEAR(1009500.0, comparison.BaselineMedian, 1.0);
+    EXPECT_NEAR(1009500.0, comparison.Median, 1.0);
+    EXPECT_NEAR(0.0, comparison.RelativeChange, 0.000001);
+    EXPECT_EQ(BaselineUnchanged, comparison.Change);
+
+    // Runs of linearly increasing iteration counts are compared by their
+    // own counts, both in the baseline and in the result.
+    ASSERT_TRUE(baseline.Compare("Baseline.Linear",
+                                 LinearResult(1.0),
+                                 comparison));
+    EXPECT_NEAR(1009500.0, comparison.BaselineMedian, 1.0);
+    EXPECT_NEAR(1009500.0, comparison.Median, 1.0);
+    EXPECT_EQ(BaselineUnchanged, comparison.Change);
+
+    ASSERT_TRUE(baseline.Compare("Baseline.Plain",
+                                 TestResult(RunTimes(10, 1.0), 10),
+                                 comparison));
+    EXPECT_EQ(BaselineUnchanged, comparison.Change);
+
+    // Unknown benchmarks and results without runs are not compared.
+    EXPECT_FALSE(baseline.Compare("Baseline.Missing",
+                                  TestResult(RunTimes(10, 1.0), 10),
+                                  comparison));
+    EXPECT_FALSE(baseline.Compare("Baseline.Plain",
+                                  TestResult(std::vector<uint64_t>(), 10),
+                                  comparison));
+}
+
+
+TEST(Baseline, DetectsChanges)
+{
+    TemporaryBaseline file;
+    ASSERT_FALSE(file.Path.empty());
+    file.Write();
+
+    Baseline baseline;
+    baseline.Load(file.Path);
+
+    const std::string speed =
+        Baseline::CanonicalName("Baseline", "Speed", SpeedParameters());
+    BaselineComparison comparison;
+
+    ASSERT_TRUE(baseline.Compare(speed,
+                                 TestResult(RunTimes(5, 1.2), 5),
+                                 comparison));
+    EXPECT_NEAR(0.2, comparison.RelativeChange, 0.000001);
+    EXPECT_GT(comparison.RelativeChangeLower, 0.0);
+    EXPECT_LT(comparison.PValue, HAYAI_BASELINE_SIGNIFICANCE);
+    EXPECT_EQ(BaselineRegressed, comparison.Change);
+
+    ASSERT_TRUE(baseline.Compare(speed,
+                                 TestResult(RunTimes(5, 0.8), 5),
+                                 comparison));
+    EXPECT_NEAR(-0.2, comparison.RelativeChange, 0.000001);
+    EXPECT_LT(comparison.RelativeChangeUpper, 0.0);
+    EXPECT_LT(comparison.PValue, HAYAI_BASELINE_SIGNIFICANCE);
+    EXPECT_EQ(BaselineImproved, comparison.Change);
+
+    ASSERT_TRUE(baseline.Compare("Baseline.Linear",
+                                 LinearResult(1.2),
+                                 comparison));
+    EXPECT_EQ(BaselineRegressed, comparison.Change);
+}
+#endif
@@ -0,0 +1,169 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Iterations of 100 us.
+    class SpinningTest
+        :   public Test
+    {
+    protected:
+        virtual void TestBody()
+        {
+            SpinFor(100000);
+        }
+    };
+
+
+    /// Test counting its runs and iterations over all instances.
+    class CountingTest
+        :   public Test
+    {
+    public:
+        static std::size_t Runs;
+        static std::size_t Calls;
+    protected:
+        virtual void SetUp()
+        {
+            ++Runs;
+        }
+
+
+        virtual void TestBody()
+        {
+            ++Calls;
+        }
+    };
+
+
+    std::size_t CountingTest::Runs = 0;
+    std::size_t CountingTest::Calls = 0;
+
+
+    /// Outputter recording the described tests.
+    class RecordingOutputter
+        :   public Outputter
+    {
+    public:
+        RecordingOutputter()
+            :   Iterations(0)
+        {
+
+        }
+
+
+        virtual void Begin(const std::size_t& enabledCount,
+                           const std::size_t& disabledCount)
+        {
+            (void)enabledCount;
+            (void)disabledCount;
+        }
+
+
+        virtual void End(const std::size_t& executedCount,
+                         const std::size_t& disabledCount)
+        {
+            (void)executedCount;
+            (void)disabledCount;
+        }
+
+
+        virtual void BeginTest(const std::string& fixtureName,
+                               const std::string& testName,
+                               const TestParametersDescriptor& parameters,
+                               const std::size_t& runsCount,
+                               const std::size_t& iterationsCount)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+            (void)runsCount;
+            Iterations = iterationsCount;
+        }
+
+
+        virtual void EndTest(const std::string& fixtureName,
+                             const std::string& testName,
+                             const TestParametersDescriptor& parameters,
+                             const TestResult& result)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+            Results.push_back(result);
+        }
+
+
+        virtual void SkipDisabledTest(const std::string& fixtureName,
+                                      const std::string& testName,
+                                      const TestParametersDescriptor&
+                                          parameters,
+                                      const std::size_t& runsCount,
+                                      const std::size_t& iterationsCount)
+        {
+            (void)fixtureName;
+            (void)testName;
+            (void)parameters;
+            (void)runsCount;
+            (void)iterationsCount;
+        }
+
+
+        std::size_t Iterations;
+        std::vector<TestResult> Results;
+    };
+
+
+    /// Run the tests matching a pattern, recording their description.
+    void RunRecorded(const char* pattern, RecordingOutputter& outputter)
+    {
+        Benchmarker::RunTests(pattern,
+                              std::vector<Outputter*>(1, &outputter));
+    }
+}
+
+
+TEST(Benchmarker, CalibratesIterationsToMinimumRunTime)
+{
+    Benchmarker::RegisterTest("Benchmarker",
+                              "Calibrated",
+                              1,
+                              AutoIterations,
+                              new TestFactoryDefault<SpinningTest>(),
+                              TestParametersDescriptor());
+
+    // A run of 5 ms takes at least 50 iterations of 100 us. Calibration
+    // aims 40 % above the target once a pilot run is long enough to
+    // extrapolate from, so it overshoots by at most one such step.
+    RecordingOutputter outputter;
+    Benchmarker::SetMinimumRunTime(5000000);
+    RunRecorded("Benchmarker.Calibrated", outputter);
+    Benchmarker::SetMinimumRunTime(0);
+
+    ASSERT_EQ(std::size_t(1), outputter.Results.size());
+    EXPECT_GE(outputter.Iterations, std::size_t(50));
+    EXPECT_LE(outputter.Iterations, std::size_t(70));
+    EXPECT_GE(outputter.Results[0].TimeTotal(), 5000000.0);
+}
+
+
+TEST(Benchmarker, PerformsWarmUpRuns)
+{
+    Benchmarker::RegisterTest("Benchmarker",
+                              "WarmedUp",
+                              5,
+                              2,
+                              new TestFactoryDefault<CountingTest>(),
+                              TestParametersDescriptor());
+    Benchmarker::SetTestWarmUp("Benchmarker", "WarmedUp", 3, 0);
+
+    // The warm-up runs are performed in addition to the runs, with the same
+    // number of iterations, and are not reported.
+    RecordingOutputter outputter;
+    RunRecorded("Benchmarker.WarmedUp", outputter);
+
+    ASSERT_EQ(std::size_t(1), outputter.Results.size());
+    EXPECT_EQ(std::size_t(5), outputter.Results[0].RunTimes().size());
+    EXPECT_EQ(std::size_t(3 + 5), CountingTest::Runs);
+    EXPECT_EQ(std::size_t((3 + 5) * 2), CountingTest::Calls);
+}
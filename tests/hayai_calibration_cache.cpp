@@ -0,0 +1,171 @@
+#include <ctime>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "base.hpp"
+
+
+namespace
+{
+    /// Plausible calibration values.
+    std::vector<uint64_t> PlausibleValues()
+    {
+        std::vector<uint64_t> values;
+        values.push_back(1000000);
+        values.push_back(250000);
+        values.push_back(40);
+        values.push_back(20);
+        values.push_back(30);
+        return values;
+    }
+
+
+#if !defined(_WIN32)
+    /// Temporary cache file, removed with its directory on destruction.
+    class TemporaryCache
+    {
+    public:
+        TemporaryCache()
+        {
+            char directory[] = "/tmp/hayai_calibration_XXXXXX";
+
+            if (mkdtemp(directory))
+                _directory = directory;
+
+            Path = _directory + "/hayai/calibration";
+        }
+
+
+        ~TemporaryCache()
+        {
+            // The cache file is only created by a successful store.
+            unlink(Path.c_str());
+
+            if ((rmdir((_directory + "/hayai").c_str())) ||
+                (rmdir(_directory.c_str())))
+                ADD_FAILURE() << "failed to remove " << _directory;
+        }
+
+
+        std::string Path;
+    private:
+        std::string _directory;
+    };
+#endif
+}
+
+
+#if !defined(_WIN32)
+TEST(CalibrationCache, RoundTripsValues)
+{
+    TemporaryCache cache;
+    std::vector<uint64_t> values;
+
+    EXPECT_FALSE(CalibrationCache::Load(cache.Path, "host|cpu", values));
+
+    CalibrationCache::Store(cache.Path, "host|cpu", PlausibleValues());
+    ASSERT_TRUE(CalibrationCache::Load(cache.Path, "host|cpu", values));
+    EXPECT_EQ(PlausibleValues(), values);
+
+    // Storing again replaces the entry.
+    std::vector<uint64_t> replaced = PlausibleValues();
+    replaced[1] = 300000;
+    CalibrationCache::Store(cache.Path, "host|cpu", replaced);
+    ASSERT_TRUE(CalibrationCache::Load(cache.Path, "host|cpu", values));
+    EXPECT_EQ(replaced, values);
+}
+
+
+TEST(CalibrationCache, MatchesKeys)
+{
+    TemporaryCache cache;
+    std::vector<uint64_t> other = PlausibleValues();
+    other[2] = 50;
+
+    CalibrationCache::Store(cache.Path,
+                            "host|cpu|build 1",
+                            PlausibleValues());
+    CalibrationCache::Store(cache.Path, "host|cpu|build 2", other);
+
+    std::vector<uint64_t> values;
+    ASSERT_TRUE(CalibrationCache::Load(cache.Path,
+                                       "host|cpu|build 1",
+                                       values));
+    EXPECT_EQ(PlausibleValues(), values);
+    ASSERT_TRUE(CalibrationCache::Load(cache.Path,
+                                       "host|cpu|build 2",
+                                       values));
+    EXPECT_EQ(other, values);
+    EXPECT_FALSE(CalibrationCache::Load(cache.Path,
+                                        "host|cpu|build 3",
+                                        values));
+}
+
+
+TEST(CalibrationCache, ExpiresEntries)
+{
+    TemporaryCache cache;
+    CalibrationCache::Store(cache.Path, "current", PlausibleValues());
+
+    // Append an entry written longer ago than the lifetime.
+    {
+        std::ofstream stream(cache.Path.c_str(), std::ios::app);
+        stream << (uint64_t(time(NULL)) -
+                   HAYAI_CALIBRATION_CACHE_LIFETIME - 60)
+               << "\texpired\t1000000 250000 40 20 30\n";
+    }
+
+    std::vector<uint64_t> values;
+    EXPECT_TRUE(CalibrationCache::Load(cache.Path, "current", values));
+    EXPECT_FALSE(CalibrationCache::Load(cache.Path, "expired", values));
+}
+#endif
+
+
+TEST(CalibrationCache, RejectsImplausibleValues)
+{
+    EXPECT_TRUE(CalibrationCache::IsPlausible(PlausibleValues()));
+
+    // The slope of a fit whose unsigned residuals wrapped around.
+    std::vector<uint64_t> wrapped = PlausibleValues();
+    wrapped[1] = uint64_t(2443277360) * 1000000 + 756228;
+    EXPECT_FALSE(CalibrationCache::IsPlausible(wrapped));
+
+    std::vector<uint64_t> overhead = PlausibleValues();
+    overhead[3] = HAYAI_CALIBRATION_MAXIMUM_OVERHEAD + 1;
+    EXPECT_FALSE(CalibrationCache::IsPlausible(overhead));
+
+    std::vector<uint64_t> unscaled = PlausibleValues();
+    unscaled[0] = 0;
+    EXPECT_FALSE(CalibrationCache::IsPlausible(unscaled));
+    EXPECT_FALSE(CalibrationCache::IsPlausible(std::vector<uint64_t>(4, 1)));
+}
+
+
+#if !defined(_WIN32)
+TEST(CalibrationCache, IgnoresImplausibleValues)
+{
+    std::vector<uint64_t> wrapped = PlausibleValues();
+    wrapped[1] = uint64_t(2443277360) * 1000000 + 756228;
+
+    // Implausible values are not stored.
+    TemporaryCache cache;
+    std::vector<uint64_t> values;
+    CalibrationCache::Store(cache.Path, "wrapped", wrapped);
+    EXPECT_FALSE(CalibrationCache::Load(cache.Path, "wrapped", values));
+
+    // Nor loaded if they were stored by an earlier version.
+    CalibrationCache::Store(cache.Path, "current", PlausibleValues());
+    {
+        std::ofstream stream(cache.Path.c_str(), std::ios::app);
+        stream << uint64_t(time(NULL))
+               << "\twrapped\t1000000 2443277360756228 95 0 44\n";
+    }
+
+    EXPECT_TRUE(CalibrationCache::Load(cache.Path, "current", values));
+    EXPECT_FALSE(CalibrationCache::Load(cache.Path, "wrapped", values));
+}
+#endif
@@ -0,0 +1,76 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Measure a spin of the system clock with the clock.
+
+    /// @returns the ratio of the duration measured by the clock to the
+    /// duration measured by the system clock.
+    double MeasureSpin(uint64_t nanoseconds)
+    {
+        const SystemClock::TimePoint systemStart = SystemClock::Now();
+        const Clock::TimePoint start = Clock::Now();
+        uint64_t elapsed;
+
+        do
+            elapsed = SystemClock::Duration(systemStart, SystemClock::Now());
+        while (elapsed < nanoseconds);
+
+        const Clock::TimePoint end = Clock::Now();
+        return double(Clock::Duration(start, end)) / double(elapsed);
+    }
+}
+
+
+TEST(Clock, SystemBackend)
+{
+    EXPECT_TRUE(Clock::SetBackend(ClockBackendSystem));
+    EXPECT_EQ(ClockBackendSystem, Clock::Backend());
+    EXPECT_EQ(std::string(SystemClock::Description()), Clock::Description());
+    EXPECT_NEAR(1.0, MeasureSpin(20000000), 0.05);
+}
+
+
+#if defined(HAYAI_TSC_CLOCK_AVAILABLE)
+TEST(Clock, TscBackend)
+{
+    // Unsupported processors fall back to the system clock.
+    const bool supported = TscClock::IsSupported();
+    EXPECT_EQ(supported, Clock::SetBackend(ClockBackendTsc));
+
+    if (supported)
+    {
+        EXPECT_EQ(ClockBackendTsc, Clock::Backend());
+        EXPECT_EQ(0u, Clock::Description().find("rdtscp (invariant TSC, "));
+        EXPECT_NEAR(1.0, MeasureSpin(20000000), 0.05);
+
+        // Consecutive readings do not go backwards.
+        const Clock::TimePoint first = Clock::Now();
+        const Clock::TimePoint second = Clock::Now();
+        EXPECT_LE(first, second);
+        EXPECT_LT(Clock::Duration(first, second), uint64_t(1000000));
+    }
+    else
+    {
+        EXPECT_EQ(ClockBackendSystem, Clock::Backend());
+        EXPECT_EQ(std::string(SystemClock::Description()),
+                  Clock::Description());
+    }
+
+    Clock::SetBackend(ClockBackendSystem);
+}
+
+
+TEST(Clock, TscCalibration)
+{
+    if (!TscClock::IsSupported())
+        return;
+
+    // Processors with an invariant TSC tick at a rate between 100 MHz and
+    // 10 GHz.
+    const double nanosecondsPerTick = TscClock::CalibrateNanosecondsPerTick();
+    EXPECT_GT(nanosecondsPerTick, 0.1);
+    EXPECT_LT(nanosecondsPerTick, 10.0);
+}
+#endif
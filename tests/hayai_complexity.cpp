@@ -0,0 +1,76 @@
+#include "base.hpp"
+
+
+namespace
+{
+    double Cubic(double n)
+    {
+        return n * n * n;
+    }
+}
+
+
+TEST(Complexity, FitsBestOrder)
+{
+    const double sizes[] = {8.0, 64.0, 512.0, 4096.0, 32768.0};
+
+    for (int order = ComplexityConstant; order <= ComplexityQuadratic; ++order)
+    {
+        ComplexityFit fit("size");
+
+        for (std::size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+        {
+            const double n = sizes[i];
+            const double log = std::log(n) / std::log(2.0);
+            const double g[] = {1.0, log, n, n * log, n * n};
+
+            // Perturb the times by +/- 2 %.
+            fit.AddPoint(n, 3.0 * g[order] * (i % 2 ? 1.02 : 0.98));
+        }
+
+        ASSERT_TRUE(fit.Fit());
+        EXPECT_EQ(std::size_t(5), fit.Candidates().size());
+        EXPECT_EQ(order, int(fit.Best().Order)) << fit.Best().Name;
+        EXPECT_NEAR(3.0, fit.Best().Coefficient, 0.1);
+        EXPECT_LT(fit.Best().RmsError, 0.03);
+    }
+}
+
+
+TEST(Complexity, UserFunction)
+{
+    ComplexityFit fit("size");
+
+    for (double n = 1.0; n <= 1000.0; n *= 10.0)
+        fit.AddPoint(n, 0.5 * Cubic(n));
+
+    ASSERT_TRUE(fit.Fit(Cubic, "Cubic"));
+    EXPECT_EQ(ComplexityUser, fit.Best().Order);
+    EXPECT_EQ("O(Cubic(n))", fit.Best().Name);
+    EXPECT_DOUBLE_EQ(0.5, fit.Best().Coefficient);
+    EXPECT_NEAR(0.0, fit.Best().RmsError, 1e-12);
+
+    // A single problem size cannot be fitted.
+    ComplexityFit single("size");
+    single.AddPoint(10.0, 1.0);
+    single.AddPoint(10.0, 2.0);
+    EXPECT_FALSE(single.Fit());
+}
+
+
+TEST(Complexity, ProblemSize)
+{
+    TestParametersDescriptor parameters("(std::size_t speed, "
+                                        "const std::size_t& size)",
+                                        "(1, 1000UL)");
+    double size = 0.0;
+
+    EXPECT_TRUE(ComplexityFit::ProblemSize(parameters, "size", size));
+    EXPECT_DOUBLE_EQ(1000.0, size);
+    EXPECT_TRUE(ComplexityFit::ProblemSize(parameters, "speed", size));
+    EXPECT_DOUBLE_EQ(1.0, size);
+    EXPECT_FALSE(ComplexityFit::ProblemSize(parameters, "siz", size));
+
+    TestParametersDescriptor expression("(std::size_t size)", "(1 << 10)");
+    EXPECT_FALSE(ComplexityFit::ProblemSize(expression, "size", size));
+}
@@ -0,0 +1,114 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Two packages of two cores with two hardware threads each, numbered
+    /// like Linux does, ie. the second threads of the cores come last.
+    CpuTopology TwoPackages()
+    {
+        CpuTopology topology;
+
+        for (int id = 0; id < 8; ++id)
+        {
+            const int core = id % 4;
+            topology.AddCpu(CpuDescriptor(id, core, core, core < 2 ? 0 : 2));
+        }
+
+        return topology;
+    }
+}
+
+
+TEST(CpuTopology, ParsesCpuLists)
+{
+    std::vector<int> cpus;
+
+    ASSERT_TRUE(CpuTopology::ParseCpuList("0-3,8,10-11\n", cpus));
+    ASSERT_EQ(std::size_t(7), cpus.size());
+    EXPECT_EQ(0, cpus[0]);
+    EXPECT_EQ(3, cpus[3]);
+    EXPECT_EQ(8, cpus[4]);
+    EXPECT_EQ(11, cpus[6]);
+
+    ASSERT_TRUE(CpuTopology::ParseCpuList("5", cpus));
+    ASSERT_EQ(std::size_t(1), cpus.size());
+    EXPECT_EQ(5, cpus[0]);
+
+    EXPECT_FALSE(CpuTopology::ParseCpuList("3-1", cpus));
+    EXPECT_FALSE(CpuTopology::ParseCpuList("0,a", cpus));
+    EXPECT_FALSE(CpuTopology::ParseCpuList("0 1", cpus));
+}
+
+
+TEST(CpuTopology, SpreadsOverCachesBeforeCores)
+{
+    const CpuTopology topology = TwoPackages();
+
+    // One processor per L3 cache first.
+    std::vector<int> cpus = topology.Spread(2);
+    ASSERT_EQ(std::size_t(2), cpus.size());
+    EXPECT_EQ(0, cpus[0]);
+    EXPECT_EQ(2, cpus[1]);
+
+    // Then one per core.
+    cpus = topology.Spread(4);
+    ASSERT_EQ(std::size_t(4), cpus.size());
+    EXPECT_EQ(1, cpus[2]);
+    EXPECT_EQ(3, cpus[3]);
+
+    // Hardware threads of used cores last.
+    cpus = topology.Spread(6);
+    ASSERT_EQ(std::size_t(6), cpus.size());
+    EXPECT_EQ(4, cpus[4]);
+    EXPECT_EQ(6, cpus[5]);
+
+    EXPECT_EQ(std::size_t(8), topology.Spread(16).size());
+}
+
+
+TEST(CpuTopology, DetectsAvailableProcessors)
+{
+    const CpuTopology topology = CpuTopology::Detect();
+
+    EXPECT_LE(topology.Cpus().size(), HardwareConcurrency());
+
+    for (std::size_t index = 0; index < topology.Cpus().size(); ++index)
+    {
+        const CpuDescriptor& cpu = topology.Cpus()[index];
+
+        EXPECT_LE(cpu.Core, cpu.Id);
+        EXPECT_LE(cpu.L2Cache, cpu.Id);
+        EXPECT_LE(cpu.L3Cache, cpu.Id);
+    }
+}
+
+
+TEST(CpuTopology, PlacesThreads)
+{
+    const CpuTopology topology = TwoPackages();
+
+    // Compact placement fills the cores of a cache before the next one.
+    std::vector<int> cpus = topology.Place(ThreadPlacementCompact, 4);
+    ASSERT_EQ(std::size_t(4), cpus.size());
+    EXPECT_EQ(0, cpus[0]);
+    EXPECT_EQ(4, cpus[1]);
+    EXPECT_EQ(1, cpus[2]);
+    EXPECT_EQ(5, cpus[3]);
+
+    cpus = topology.Place(ThreadPlacementScatter, 3);
+    ASSERT_EQ(std::size_t(3), cpus.size());
+    EXPECT_EQ(0, cpus[0]);
+    EXPECT_EQ(2, cpus[1]);
+    EXPECT_EQ(1, cpus[2]);
+
+    // Placement on cores wraps around once every core has a thread.
+    cpus = topology.Place(ThreadPlacementCores, 6);
+    ASSERT_EQ(std::size_t(6), cpus.size());
+    EXPECT_EQ(3, cpus[3]);
+    EXPECT_EQ(0, cpus[4]);
+    EXPECT_EQ(2, cpus[5]);
+
+    EXPECT_TRUE(topology.Place(ThreadPlacementNone, 4).empty());
+    EXPECT_TRUE(CpuTopology().Place(ThreadPlacementScatter, 4).empty());
+}
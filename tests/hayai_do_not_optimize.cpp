@@ -0,0 +1,62 @@
+#include "base.hpp"
+
+
+/// Number of iterations of the computation loops.
+
+/// Large enough for even the fastest processor to take well over a
+/// millisecond if the loop is actually executed.
+#define LOOP_ITERATIONS 50000000
+
+
+/// Time a loop computing a result that is otherwise never used.
+
+/// @returns the number of nanoseconds the loop took.
+uint64_t TimeUnusedComputation()
+{
+    Clock::TimePoint startTime = Clock::Now();
+
+    for (uint64_t i = 0; i < LOOP_ITERATIONS; ++i)
+    {
+        uint64_t result = i * i;
+        DoNotOptimize(result);
+    }
+
+    return Clock::Duration(startTime, Clock::Now());
+}
+
+
+TEST(DoNotOptimize, KeepsUnusedResult)
+{
+    const uint64_t duration = TimeUnusedComputation();
+
+    EXPECT_GT(duration, uint64_t(1000000))
+        << "Loop took " << duration << " ns, so the computation has been "
+        << "optimized away";
+}
+
+
+TEST(DoNotOptimize, PreservesValue)
+{
+    std::size_t value = 42;
+    DoNotOptimize(value);
+    EXPECT_EQ(std::size_t(42), value);
+
+    const double constant = 1.5;
+    DoNotOptimize(constant);
+    EXPECT_EQ(1.5, constant);
+}
+
+
+TEST(ClobberMemory, PerformsWrites)
+{
+    std::vector<int> values(16, 0);
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = int(i);
+        ClobberMemory();
+    }
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(int(i), values[i]);
+}
@@ -0,0 +1,181 @@
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "base.hpp"
+
+
+namespace
+{
+    /// Value of a metadata entry, or an empty string if there is none.
+    std::string Find(const Environment::Entries& entries,
+                     const std::string& name)
+    {
+        for (std::size_t index = 0; index < entries.size(); ++index)
+            if (entries[index].first == name)
+                return entries[index].second;
+
+        return std::string();
+    }
+
+
+#if !defined(_WIN32)
+    /// Temporary directory tree, removed on destruction.
+    class TemporaryTree
+    {
+    public:
+        TemporaryTree()
+        {
+            char root[] = "/tmp/hayai_environment_XXXXXX";
+
+            if (mkdtemp(root))
+                Root = root;
+        }
+
+
+        ~TemporaryTree()
+        {
+            // Remove the files and directories in the reverse order of
+            // their creation, so that directories are empty when removed.
+            std::size_t index = _files.size();
+            while (index--)
+                if (unlink(_files[index].c_str()))
+                    ADD_FAILURE() << "failed to remove " << _files[index];
+
+            index = _directories.size();
+            while (index--)
+                if (rmdir(_directories[index].c_str()))
+                    ADD_FAILURE() << "failed to remove "
+                                  << _directories[index];
+
+            if ((!Root.empty()) && (rmdir(Root.c_str())))
+                ADD_FAILURE() << "failed to remove " << Root;
+        }
+
+
+        /// Write a file, creating the directories leading to it.
+
+        /// @param path Path of the file relative to the root.
+        /// @param contents Contents of the file.
+        void WriteFile(const std::string& path, const std::string& contents)
+        {
+            for (std::string::size_type slash = path.find('/', 1);
+                 slash != std::string::npos;
+                 slash = path.find('/', slash + 1))
+            {
+                const std::string directory =
+                    Root + "/" + path.substr(0, slash);
+
+                if (!mkdir(directory.c_str(), 0700))
+                    _directories.push_back(directory);
+            }
+
+            const std::string file = Root + "/" + path;
+            std::ofstream stream(file.c_str());
+            stream << contents;
+
+            if (stream)
+                _files.push_back(file);
+        }
+
+
+        std::string Root;
+    private:
+        std::vector<std::string> _directories;
+        std::vector<std::string> _files;
+    };
+#endif
+}
+
+
+#if !defined(_WIN32)
+TEST(Environment, CollectsFromSysfsAndProcfs)
+{
+    std::vector<int> affinity;
+
+    if ((!Scheduling::GetAffinity(affinity)) || (affinity.empty()))
+        return;
+
+    TemporaryTree tree;
+    ASSERT_FALSE(tree.Root.empty());
+
+    // A single processor, which must be in the affinity mask to be
+    // described.
+    std::stringstream cpuPath;
+    cpuPath << "cpu/cpu" << affinity[0];
+    const std::string cpu = cpuPath.str();
+    std::stringstream id;
+    id << affinity[0];
+    const std::string online = id.str() + "\n";
+
+    tree.WriteFile("cpu/online", online);
+    tree.WriteFile("cpu/smt/control", "off\n");
+    tree.WriteFile("cpu/intel_pstate/no_turbo", "0\n");
+    tree.WriteFile(cpu + "/topology/thread_siblings_list", online);
+    tree.WriteFile(cpu + "/cache/index0/level", "1\n");
+    tree.WriteFile(cpu + "/cache/index0/type", "Data\n");
+    tree.WriteFile(cpu + "/cache/index0/size", "48K\n");
+    tree.WriteFile(cpu + "/cache/index1/level", "3\n");
+    tree.WriteFile(cpu + "/cache/index1/type", "Unified\n");
+    tree.WriteFile(cpu + "/cache/index1/size", "30720K\n");
+    tree.WriteFile(cpu + "/cache/index1/shared_cpu_list", "0-7\n");
+    tree.WriteFile(cpu + "/cpufreq/scaling_governor", "powersave\n");
+    tree.WriteFile(cpu + "/cpufreq/scaling_cur_freq", "2100000\n");
+    tree.WriteFile(cpu + "/cpufreq/cpuinfo_max_freq", "3900000\n");
+    tree.WriteFile("proc/cpuinfo",
+                   "processor\t: 0\n"
+                   "model name\t: Example CPU @ 2.10GHz\n");
+    tree.WriteFile("proc/loadavg", "0.25 0.50 1.00 1/75 100\n");
+
+    const Environment::Entries entries =
+        Environment::Collect(tree.Root + "/cpu", tree.Root + "/proc");
+
+    EXPECT_EQ(std::string("Example CPU @ 2.10GHz"),
+              Find(entries, "cpu_model"));
+    EXPECT_EQ("1 (" + id.str() + ")", Find(entries, "cpus"));
+    EXPECT_EQ(std::string("1 core, 1 hardware thread, 1 last-level cache"),
+              Find(entries, "topology"));
+    EXPECT_EQ(std::string("disabled"), Find(entries, "smt"));
+    EXPECT_EQ(std::string("enabled"), Find(entries, "turbo"));
+    EXPECT_EQ(std::string("L1d 48K, L3 30720K shared by 8"),
+              Find(entries, "caches"));
+    EXPECT_EQ(std::string("powersave"), Find(entries, "scaling_governor"));
+    EXPECT_EQ(std::string("current 2100 MHz, maximum 3900 MHz"),
+              Find(entries, "cpu_frequency"));
+    EXPECT_EQ(std::string("0.25 0.50 1.00"), Find(entries, "load_average"));
+    EXPECT_FALSE(Find(entries, "kernel").empty());
+    EXPECT_FALSE(Find(entries, "compiler").empty());
+    EXPECT_FALSE(Find(entries, "build_type").empty());
+    EXPECT_EQ(Clock::Description(), Find(entries, "clock"));
+}
+#endif
+
+
+TEST(Environment, WarnsAboutHostileSettings)
+{
+    Environment::Entries entries;
+    entries.push_back(std::make_pair(std::string("cpus"),
+                                     std::string("4 (0-3)")));
+    entries.push_back(std::make_pair(std::string("scaling_governor"),
+                                     std::string("performance")));
+    entries.push_back(std::make_pair(std::string("load_average"),
+                                     std::string("1.50 1.00 0.50")));
+    entries.push_back(std::make_pair(std::string("build_type"),
+                                     std::string("Release")));
+
+    EXPECT_TRUE(Environment::Warnings(entries).empty());
+
+    entries[1].second = "performance, powersave";
+    entries[2].second = "3.00 1.00 0.50";
+    entries[3].second = "Debug";
+
+    const std::vector<std::string> warnings =
+        Environment::Warnings(entries);
+    ASSERT_EQ(std::size_t(3), warnings.size());
+    EXPECT_NE(std::string::npos, warnings[0].find("powersave"));
+    EXPECT_NE(std::string::npos, warnings[1].find("3.00 1.00 0.50"));
+    EXPECT_NE(std::string::npos, warnings[2].find("Debug"));
+}
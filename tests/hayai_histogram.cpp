@@ -0,0 +1,98 @@
+#include "base.hpp"
+
+
+TEST(Histogram, PreservesSignificantDigits)
+{
+    for (int digits = 1; digits <= 5; ++digits)
+    {
+        Histogram histogram(digits);
+        double resolution = 1.0;
+
+        for (int digit = 0; digit < digits; ++digit)
+            resolution /= 10.0;
+
+        for (uint64_t value = 1;
+             value < uint64_t(1) << 62;
+             value = value * 3 + 1)
+        {
+            const uint64_t lowest = histogram.LowestEquivalentValue(value);
+            const uint64_t highest = histogram.HighestEquivalentValue(value);
+
+            EXPECT_LE(lowest, value);
+            EXPECT_GE(highest, value);
+            EXPECT_LE(double(highest - lowest), double(value) * resolution)
+                << "Value " << value << " with " << digits << " digits";
+        }
+    }
+}
+
+
+TEST(Histogram, Percentiles)
+{
+    Histogram histogram(3);
+
+    for (uint64_t value = 1; value <= 10000; ++value)
+        histogram.Record(value * 1000);
+
+    EXPECT_EQ(uint64_t(10000), histogram.TotalCount());
+    EXPECT_EQ(uint64_t(1000), histogram.Minimum());
+    EXPECT_EQ(uint64_t(10000000), histogram.Maximum());
+    EXPECT_DOUBLE_EQ(5000500.0, histogram.Mean());
+
+    EXPECT_EQ(uint64_t(1000), histogram.ValueAtPercentile(0.0));
+    EXPECT_EQ(uint64_t(10000000), histogram.ValueAtPercentile(100.0));
+    EXPECT_NEAR(5000000.0, double(histogram.ValueAtPercentile(50.0)), 5000.0);
+    EXPECT_NEAR(9900000.0, double(histogram.ValueAtPercentile(99.0)), 9900.0);
+    EXPECT_NEAR(9990000.0, double(histogram.ValueAtPercentile(99.9)), 9990.0);
+    EXPECT_NEAR(9999000.0,
+                double(histogram.ValueAtPercentile(99.99)),
+                9999.0);
+}
+
+
+TEST(Histogram, Empty)
+{
+    Histogram histogram;
+
+    EXPECT_EQ(uint64_t(0), histogram.TotalCount());
+    EXPECT_EQ(uint64_t(0), histogram.ValueAtPercentile(50.0));
+    EXPECT_TRUE(histogram.Buckets().empty());
+}
+
+
+TEST(Histogram, MergeIsLossless)
+{
+    Histogram combined(2);
+    Histogram first(2);
+    Histogram second(2);
+
+    for (uint64_t value = 0; value < 100000; value += 7)
+    {
+        combined.Record(value);
+        ((value % 2) ? first : second).Record(value);
+    }
+
+    first.Merge(second);
+
+    EXPECT_EQ(combined.TotalCount(), first.TotalCount());
+    EXPECT_EQ(combined.Minimum(), first.Minimum());
+    EXPECT_EQ(combined.Maximum(), first.Maximum());
+    EXPECT_TRUE(combined.Buckets() == first.Buckets());
+
+    for (double percentile = 0.0; percentile <= 100.0; percentile += 0.5)
+        EXPECT_EQ(combined.ValueAtPercentile(percentile),
+                  first.ValueAtPercentile(percentile));
+
+    // Recording the buckets reproduces the histogram.
+    const std::vector<std::pair<uint64_t, uint64_t> > buckets =
+        combined.Buckets();
+    Histogram reproduced(2);
+
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+        reproduced.Record(buckets[bucket].first, buckets[bucket].second);
+
+    EXPECT_TRUE(combined.Buckets() == reproduced.Buckets());
+
+    Histogram otherPrecision(3);
+    EXPECT_THROW(first.Merge(otherPrecision), std::invalid_argument);
+}
@@ -0,0 +1,242 @@
+#include <cstdlib>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "base.hpp"
+
+
+TEST(Isolation, RoundTripsValues)
+{
+    IsolationEncoder encoder;
+    encoder.WriteUnsigned(0);
+    encoder.WriteUnsigned(127);
+    encoder.WriteUnsigned(128);
+    encoder.WriteUnsigned(~uint64_t(0));
+    encoder.WriteDouble(-1.5e-300);
+    encoder.WriteString("DeliveryMan.DeliverPackage");
+
+    // Small integers take a single byte.
+    EXPECT_EQ(std::size_t(1 + 1 + 2 + 10 + 8 + 1 + 26),
+              encoder.Buffer().size());
+
+    IsolationDecoder decoder(encoder.Buffer());
+    EXPECT_EQ(uint64_t(0), decoder.ReadUnsigned());
+    EXPECT_EQ(uint64_t(127), decoder.ReadUnsigned());
+    EXPECT_EQ(uint64_t(128), decoder.ReadUnsigned());
+    EXPECT_EQ(~uint64_t(0), decoder.ReadUnsigned());
+    EXPECT_EQ(-1.5e-300, decoder.ReadDouble());
+    EXPECT_EQ(std::string("DeliveryMan.DeliverPackage"), decoder.ReadString());
+    EXPECT_TRUE(decoder.AtEnd());
+}
+
+
+TEST(Isolation, RejectsTruncatedMessages)
+{
+    IsolationEncoder encoder;
+    encoder.WriteString("truncated");
+
+    const std::string truncated =
+        encoder.Buffer().substr(0, encoder.Buffer().size() - 1);
+    IsolationDecoder decoder(truncated);
+
+    EXPECT_THROW(decoder.ReadString(), std::runtime_error);
+}
+
+
+TEST(Isolation, RoundTripsHistograms)
+{
+    Histogram histogram(3);
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+        histogram.Record(value * 1237);
+
+    IsolationEncoder encoder;
+    encoder.WriteHistogram(histogram);
+
+    IsolationDecoder decoder(encoder.Buffer());
+    const Histogram decoded = decoder.ReadHistogram();
+
+    EXPECT_EQ(histogram.SignificantDigits(), decoded.SignificantDigits());
+    EXPECT_EQ(histogram.TotalCount(), decoded.TotalCount());
+    EXPECT_EQ(histogram.Minimum(), decoded.Minimum());
+    EXPECT_EQ(histogram.Maximum(), decoded.Maximum());
+    EXPECT_EQ(histogram.Mean(), decoded.Mean());
+    EXPECT_EQ(histogram.StdDev(), decoded.StdDev());
+    EXPECT_EQ(histogram.ValueAtPercentile(99.0),
+              decoded.ValueAtPercentile(99.0));
+}
+
+
+TEST(Isolation, RoundTripsResults)
+{
+    std::vector<uint64_t> runTimes;
+    std::vector<std::size_t> runIterations;
+    std::vector<std::vector<uint64_t> > threadRunTimes;
+    std::vector<std::vector<uint64_t> > counterValues;
+    std::vector<std::string> counterNames;
+    counterNames.push_back("cycles");
+    std::vector<ResourceUsage> resourceUsage;
+    Histogram samples(2);
+
+    for (uint64_t run = 1; run <= 10; ++run)
+    {
+        runTimes.push_back(run * 1000 + run * run);
+        runIterations.push_back(std::size_t(run * 10));
+        threadRunTimes.push_back(std::vector<uint64_t>(2, run * 900));
+        counterValues.push_back(std::vector<uint64_t>(1, run * 3000));
+        samples.Record(run * 100);
+
+        ResourceUsage usage;
+        usage.MinorFaults = run;
+        usage.InvoluntaryContextSwitches = run * 2;
+        usage.UserTime = run * 1000000;
+        resourceUsage.push_back(usage);
+    }
+
+    TestResult result(runTimes, 55, 2);
+    result.SetRunIterations(runIterations, 0.9);
+    result.SetWarmUpRuns(3);
+    result.SetConvergence(true, 0.01, 0.02);
+    result.SetIterationSamples(samples, 4);
+    result.SetThreads(2, threadRunTimes);
+    result.SetPerformanceCounters(counterNames, counterValues);
+    result.SetResourceUsage(resourceUsage, 8192);
+
+    IsolationEncoder encoder;
+    encoder.WriteResult(result);
+
+    IsolationDecoder decoder(encoder.Buffer());
+    const TestResult decoded = decoder.ReadResult();
+    EXPECT_TRUE(decoder.AtEnd());
+
+    EXPECT_EQ(result.RunTimes(), decoded.RunTimes());
+    EXPECT_EQ(result.Iterations(), decoded.Iterations());
+    EXPECT_EQ(result.RunTimeHistogram().SignificantDigits(),
+              decoded.RunTimeHistogram().SignificantDigits());
+    EXPECT_EQ(std::size_t(3), decoded.WarmUpRuns());
+
+    ASSERT_TRUE(decoded.IsLinear());
+    EXPECT_EQ(std::size_t(70), decoded.RunIterations(6));
+    EXPECT_EQ(result.IterationTimeRegression().Slope,
+              decoded.IterationTimeRegression().Slope);
+    EXPECT_EQ(0.9, decoded.RegressionConfidenceLevel());
+
+    ASSERT_TRUE(decoded.IsAdaptive());
+    EXPECT_TRUE(decoded.Converged());
+    EXPECT_EQ(0.01, decoded.RelativeConfidenceIntervalWidth());
+    EXPECT_EQ(0.02, decoded.TargetRelativeConfidenceIntervalWidth());
+
+    ASSERT_TRUE(decoded.IsSampled());
+    EXPECT_EQ(std::size_t(4), decoded.SampleInterval());
+    EXPECT_EQ(samples.Mean(), decoded.IterationTimeHistogram().Mean());
+    EXPECT_FALSE(decoded.IsOpenLoop());
+
+    ASSERT_TRUE(decoded.IsThreaded());
+    EXPECT_EQ(std::size_t(2), decoded.Threads());
+    EXPECT_EQ(threadRunTimes, decoded.ThreadRunTimes());
+
+    EXPECT_EQ(counterNames, decoded.PerformanceCounterNames());
+    EXPECT_EQ(counterValues, decoded.PerformanceCounterValues());
+
+    ASSERT_TRUE(decoded.HasResourceUsage());
+    const ResourceUsage total = decoded.TotalResourceUsage();
+    EXPECT_EQ(uint64_t(55), total.MinorFaults);
+    EXPECT_EQ(uint64_t(110), total.InvoluntaryContextSwitches);
+    EXPECT_EQ(uint64_t(55000000), total.UserTime);
+    EXPECT_EQ(uint64_t(8192), total.PeakResidentSetSize);
+}
+
+
+// Child processes are only supported on POSIX systems.
+#if !defined(_WIN32)
+TEST(Isolation, ReceivesMessagesFromChild)
+{
+    IsolatedProcess process;
+
+    if (process.Fork())
+    {
+        IsolationEncoder message;
+        message.WriteUnsigned(42);
+        process.Send(IsolationBegin, message);
+        process.Exit(EXIT_SUCCESS);
+    }
+
+    IsolationMessage tag;
+    std::string payload;
+
+    ASSERT_TRUE(process.Receive(tag, payload));
+    EXPECT_EQ(IsolationBegin, tag);
+
+    IsolationDecoder decoder(payload);
+    EXPECT_EQ(uint64_t(42), decoder.ReadUnsigned());
+
+    EXPECT_FALSE(process.Receive(tag, payload));
+    EXPECT_EQ(std::string(), process.Wait());
+}
+
+
+TEST(Isolation, ReportsCrashedChild)
+{
+    IsolatedProcess process;
+
+    if (process.Fork())
+        abort();
+
+    IsolationMessage tag;
+    std::string payload;
+
+    EXPECT_FALSE(process.Receive(tag, payload));
+    EXPECT_EQ(std::string::size_type(0),
+              process.Wait().find("terminated by signal"));
+}
+
+
+TEST(Isolation, KillsChildOnTimeout)
+{
+    IsolatedProcess process(50000000);
+
+    if (process.Fork())
+        while (true)
+            sleep(1);
+
+    IsolationMessage tag;
+    std::string payload;
+
+    EXPECT_FALSE(process.Receive(tag, payload));
+    EXPECT_EQ(std::string::size_type(0), process.Wait().find("timed out"));
+}
+
+
+TEST(Isolation, WaitsForAnyChild)
+{
+    IsolatedProcess fast;
+    IsolatedProcess slow;
+
+    if (fast.Fork())
+        fast.Exit(EXIT_SUCCESS);
+
+    if (slow.Fork())
+        while (true)
+            sleep(1);
+
+    IsolationMessage tag;
+    std::string payload;
+    std::vector<IsolatedProcess*> processes;
+    processes.push_back(&fast);
+    processes.push_back(&slow);
+
+    while (!fast.Finished())
+    {
+        IsolatedProcess::WaitForAny(processes);
+        EXPECT_FALSE(fast.Receive(tag, payload, false));
+    }
+
+    EXPECT_FALSE(slow.Receive(tag, payload, false));
+    EXPECT_FALSE(slow.Finished());
+
+    EXPECT_EQ(std::string(), fast.Wait());
+    EXPECT_FALSE(slow.Wait().empty());
+}
+#endif
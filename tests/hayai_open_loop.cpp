@@ -0,0 +1,118 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Test whose iterations take a known service time.
+    class ServiceTest
+        :   public Test
+    {
+    public:
+        ServiceTest(uint64_t serviceTime)
+            :   _serviceTime(serviceTime)
+        {
+
+        }
+    protected:
+        virtual void TestBody()
+        {
+            SpinFor(_serviceTime);
+        }
+    private:
+        uint64_t _serviceTime;
+    };
+
+
+    /// Open-loop result with iterations of a latency.
+    TestResult OpenLoopResult(double offeredRate,
+                              double achievedRate,
+                              uint64_t latency)
+    {
+        // 100 iterations per run at the achieved rate.
+        const std::vector<uint64_t> runTimes(
+            1,
+            uint64_t(100.0 * 1000000000.0 / achievedRate)
+        );
+        TestResult result(runTimes, 100);
+        Histogram latencies;
+
+        for (std::size_t iteration = 0; iteration < 100; ++iteration)
+            latencies.Record(latency);
+
+        result.SetOpenLoop(offeredRate, latencies);
+        return result;
+    }
+}
+
+
+TEST(OpenLoop, StartsIterationsOnSchedule)
+{
+    // Iterations of 10 us every 100 us wait for their start times, so the
+    // run takes at least until the start of the last iteration and none of
+    // them is delayed by another.
+    ServiceTest test(10000);
+    std::vector<uint64_t> latencies;
+    const uint64_t time = test.RunOpenLoop(20, 10000.0, 0, latencies);
+
+    ASSERT_EQ(std::size_t(20), latencies.size());
+    EXPECT_GE(time, uint64_t(19 * 100000 + 10000));
+
+    for (std::size_t iteration = 0; iteration < latencies.size(); ++iteration)
+        EXPECT_GE(latencies[iteration], uint64_t(10000));
+}
+
+
+TEST(OpenLoop, IncludesQueueingInLatency)
+{
+    // Iterations of 200 us every 100 us fall behind, so the k-th iteration
+    // completes no earlier than (k + 1) * 200 us while it was due at
+    // k * 100 us.
+    ServiceTest test(200000);
+    std::vector<uint64_t> latencies;
+    test.RunOpenLoop(10, 10000.0, 0, latencies);
+
+    ASSERT_EQ(std::size_t(10), latencies.size());
+
+    for (std::size_t iteration = 0; iteration < latencies.size(); ++iteration)
+        EXPECT_GE(latencies[iteration], uint64_t(iteration + 2) * 100000);
+}
+
+
+TEST(OpenLoop, SubtractsLatencyOverhead)
+{
+    ServiceTest test(0);
+    std::vector<uint64_t> latencies;
+    test.RunOpenLoop(10, 10000.0, 1000000000, latencies);
+
+    ASSERT_EQ(std::size_t(10), latencies.size());
+
+    for (std::size_t iteration = 0; iteration < latencies.size(); ++iteration)
+        EXPECT_EQ(uint64_t(0), latencies[iteration]);
+}
+
+
+TEST(OpenLoop, DetectsKnee)
+{
+    // Keeping up with the offered load at the baseline latency.
+    EXPECT_FALSE(OpenLoopResult(1000.0, 1000.0, 1000)
+                 .IsBeyondKnee(1000.0, 1.0));
+
+    // Falling behind the offered load.
+    EXPECT_TRUE(OpenLoopResult(1000.0, 800.0, 1000)
+                .IsBeyondKnee(1000.0, 1.0));
+
+    // Latency beyond ten times the baseline latency.
+    EXPECT_TRUE(OpenLoopResult(1000.0, 1000.0, 20000)
+                .IsBeyondKnee(1000.0, 1.0));
+}
+
+
+TEST(OpenLoop, FloorsBaselineLatency)
+{
+    // A baseline latency of 0, eg. measured with a coarse clock, does not
+    // make any later latency a knee by itself.
+    const TestResult result = OpenLoopResult(1000.0, 1000.0, 1000);
+
+    EXPECT_TRUE(result.IsBeyondKnee(0.0, 1.0));
+    EXPECT_FALSE(result.IsBeyondKnee(0.0, 1000.0));
+}
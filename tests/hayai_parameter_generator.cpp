@@ -0,0 +1,193 @@
+#include <cstdio>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "base.hpp"
+
+
+namespace
+{
+    std::vector<double> Expected(const double* values, std::size_t count)
+    {
+        return std::vector<double>(values, values + count);
+    }
+
+
+    class Payload
+    {
+    public:
+        Payload()
+            :   Calls(0),
+                Sum(0)
+        {
+
+        }
+
+
+        void Run(std::size_t size, const int& offset, bool flag)
+        {
+            ++Calls;
+            Sum += size + std::size_t(offset) + (flag ? 1 : 0);
+        }
+
+
+        std::size_t Calls;
+        std::size_t Sum;
+    };
+
+
+    class GeneratedTest
+        :   public Test
+    {
+    public:
+        GeneratedTest(const std::vector<double>& arguments)
+            :   Arguments(arguments)
+        {
+
+        }
+
+
+        std::vector<double> Arguments;
+    };
+}
+
+
+TEST(ParameterGenerator, Ranges)
+{
+    const double linear[] = {1.0, 4.0, 7.0, 10.0};
+    EXPECT_EQ(Expected(linear, 4), Range(1, 11, 3).Values());
+    EXPECT_TRUE(Range(1, 0).Values().empty());
+
+    const double powers[] = {1.0, 2.0, 4.0, 8.0, 16.0, 20.0};
+    EXPECT_EQ(Expected(powers, 6), PowersOfTwo(1, 20).Values());
+
+    const double geometric[] = {10.0, 15.0, 23.0, 34.0, 50.0};
+    EXPECT_EQ(Expected(geometric, 5), Geometric(10, 50, 1.5).Values());
+
+    const double list[] = {3.0, 1.0, 2.0};
+    EXPECT_EQ(Expected(list, 3), Values(3)(1)(2).Values());
+
+    const int array[] = {3, 1, 2};
+    EXPECT_EQ(Expected(list, 3), Values(array).Values());
+
+    EXPECT_EQ(std::size_t(21), PowersOfTwo(1, 1 << 20).Values().size());
+    EXPECT_EQ("1048576", ParameterValues::Format(1048576.0));
+    EXPECT_EQ("0.5", ParameterValues::Format(0.5));
+}
+
+
+TEST(ParameterGenerator, Product)
+{
+    const ParameterGrid grid = Product(Values(1)(2), Range(10, 30, 10));
+    const std::vector<std::vector<double> > combinations =
+        grid.Combinations();
+
+    ASSERT_EQ(std::size_t(2), grid.Dimensions());
+    ASSERT_EQ(std::size_t(6), combinations.size());
+
+    // The last parameter varies fastest.
+    const double expected[][2] = {
+        {1.0, 10.0}, {1.0, 20.0}, {1.0, 30.0},
+        {2.0, 10.0}, {2.0, 20.0}, {2.0, 30.0}
+    };
+
+    for (std::size_t i = 0; i < combinations.size(); ++i)
+        EXPECT_EQ(Expected(expected[i], 2), combinations[i]);
+
+    EXPECT_TRUE(Product(Values(1), ParameterValues()).Combinations()
+                .empty());
+    EXPECT_EQ(std::size_t(3),
+              Product(Values(1), Values(2), Values(3)).Dimensions());
+}
+
+
+TEST(ParameterGenerator, InvokePayload)
+{
+    Payload payload;
+    std::vector<double> arguments;
+    arguments.push_back(100.0);
+    arguments.push_back(20.0);
+    arguments.push_back(1.0);
+
+    InvokePayload(payload, &Payload::Run, arguments, 3);
+
+    EXPECT_EQ(std::size_t(3), payload.Calls);
+    EXPECT_EQ(std::size_t(3 * 121), payload.Sum);
+}
+
+
+TEST(ParameterGenerator, RegistersMismatchedGridAsFailure)
+{
+    // Registration happens during static initialization, so a grid that
+    // does not match the declaration must not throw.
+    TestDescriptor* descriptor =
+        Benchmarker::RegisterGeneratedTests<GeneratedTest>(
+            "ParameterGenerator",
+            "Mismatched",
+            1,
+            1,
+            "(std::size_t size, int offset)",
+            Values(1)(2)
+        );
+
+    ASSERT_TRUE(descriptor != NULL);
+    EXPECT_NE(std::string::npos,
+              descriptor->Error.find("has 1 parameters instead of 2"));
+    EXPECT_TRUE(descriptor->Parameters.Parameters().empty());
+
+    descriptor = Benchmarker::RegisterGeneratedTests<GeneratedTest>(
+        "ParameterGenerator",
+        "Matched",
+        1,
+        1,
+        "(std::size_t size)",
+        Values(1)(2)
+    );
+
+    ASSERT_TRUE(descriptor != NULL);
+    EXPECT_TRUE(descriptor->Error.empty());
+}
+
+
+#if !defined(_WIN32)
+TEST(ParameterGenerator, ReportsMismatchedGridAsValidJson)
+{
+    Benchmarker::RegisterGeneratedTests<GeneratedTest>(
+        "ParameterGenerator",
+        "MismatchedJson",
+        1,
+        1,
+        "(std::size_t size, int offset)",
+        Values(1)(2)
+    );
+
+    char path[] = "/tmp/hayai_parameter_generator_XXXXXX";
+    const int descriptor = mkstemp(path);
+    ASSERT_GE(descriptor, 0);
+    close(descriptor);
+
+    {
+        std::ofstream stream(path);
+        JsonOutputter outputter(stream);
+        Benchmarker::RunTests("ParameterGenerator.MismatchedJson",
+                              std::vector<Outputter*>(1, &outputter));
+    }
+
+    std::ifstream stream(path);
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    EXPECT_NE(std::string::npos,
+              buffer.str().find("\"failure\":\"parameter grid of "));
+    EXPECT_EQ(std::size_t(1), Benchmarker::Failures());
+
+    // The output parses as a whole, while the failed test has no runs.
+    Baseline baseline;
+    EXPECT_NO_THROW(baseline.Load(path));
+    EXPECT_EQ(std::size_t(0), baseline.Size());
+
+    EXPECT_EQ(0, remove(path));
+}
+#endif
@@ -0,0 +1,45 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Event of a type that no kernel supports.
+    std::vector<PerformanceCounterEvent> UnsupportedEvents()
+    {
+        return std::vector<PerformanceCounterEvent>(
+            1,
+            PerformanceCounterEvent("unsupported", 0x7fff, 0)
+        );
+    }
+}
+
+
+TEST(PerformanceCounters, UnavailableEventsFailGracefully)
+{
+    PerformanceCounterGroup group(UnsupportedEvents());
+
+    EXPECT_FALSE(group.Open());
+    EXPECT_FALSE(group.IsOpen());
+    EXPECT_TRUE(group.Names().empty());
+    ASSERT_EQ(std::size_t(1), group.Errors().size());
+#if defined(__linux__)
+    EXPECT_EQ(0u, group.Errors()[0].find("unsupported: "));
+#endif
+
+    // A group that is not open can still be used, but reads nothing.
+    std::vector<uint64_t> values(3, 1);
+    group.Enable();
+    group.Disable();
+    EXPECT_FALSE(group.Read(values));
+    EXPECT_TRUE(values.empty());
+}
+
+
+TEST(PerformanceCounters, UnavailableEventsAreNotEnabled)
+{
+    std::vector<std::string> errors;
+
+    EXPECT_FALSE(Benchmarker::EnablePerformanceCounters(UnsupportedEvents(),
+                                                        &errors));
+    EXPECT_EQ(std::size_t(1), errors.size());
+}
@@ -0,0 +1,117 @@
+#include <cstring>
+
+#include "base.hpp"
+
+
+namespace
+{
+    /// Test spending CPU time in its fixture or in its body.
+    class SpinningTest
+        :   public Test
+    {
+    public:
+        SpinningTest(bool inBody)
+            :   _inBody(inBody)
+        {
+
+        }
+
+
+        virtual void SetUp()
+        {
+            if (!_inBody)
+                SpinFor(50000000);
+        }
+
+
+        virtual void TearDown()
+        {
+            if (!_inBody)
+                SpinFor(50000000);
+        }
+    protected:
+        virtual void TestBody()
+        {
+            if (_inBody)
+                SpinFor(50000000);
+        }
+    private:
+        bool _inBody;
+    };
+}
+
+
+TEST(ResourceUsage, SubtractsSamples)
+{
+    ResourceUsage start;
+    start.MinorFaults = 10;
+    start.UserTime = 5000;
+    start.PeakResidentSetSize = 4096;
+
+    ResourceUsage end;
+    end.MinorFaults = 25;
+    end.MajorFaults = 1;
+    end.UserTime = 4000;
+    end.PeakResidentSetSize = 12288;
+
+    const ResourceUsage usage = ResourceUsage::Difference(start, end);
+    EXPECT_EQ(uint64_t(15), usage.MinorFaults);
+    EXPECT_EQ(uint64_t(1), usage.MajorFaults);
+    EXPECT_EQ(uint64_t(0), usage.UserTime);
+    EXPECT_EQ(uint64_t(8192), usage.PeakResidentSetSize);
+
+    ResourceUsage total(usage);
+    total.Add(usage);
+    EXPECT_EQ(uint64_t(30), total.MinorFaults);
+    EXPECT_EQ(uint64_t(16384), total.PeakResidentSetSize);
+}
+
+
+TEST(ResourceUsage, CountsFaultsOfTouchedMemory)
+{
+    ResourceUsage start;
+
+    if (!ResourceUsage::Sample(start, false))
+        return;
+
+    // Touch fresh pages, which faults them in.
+    const std::size_t size = 16 * 1024 * 1024;
+    char* memory = new char[size];
+    memset(memory, 1, size);
+    DoNotOptimize(memory[size / 2]);
+
+    ResourceUsage end;
+    ASSERT_TRUE(ResourceUsage::Sample(end, false));
+    delete[] memory;
+
+    const ResourceUsage usage = ResourceUsage::Difference(start, end);
+    EXPECT_GT(usage.MinorFaults, uint64_t(0));
+    EXPECT_GT(usage.UserTime + usage.SystemTime, uint64_t(0));
+#if defined(__linux__)
+    EXPECT_GE(ResourceUsage::SamplePeakResidentSetSize(), uint64_t(size));
+#endif
+}
+
+
+TEST(ResourceUsage, SamplesIterationsOnly)
+{
+    ResourceUsageProbe probe(false);
+    SpinningTest fixture(false);
+    SpinningTest body(true);
+
+    fixture.SetResourceUsageProbe(&probe);
+    fixture.Run(1);
+
+    if (!probe.IsAvailable())
+        return;
+
+    // The CPU time spent by the fixture is not accounted to the run.
+    EXPECT_LT(probe.Usage().UserTime + probe.Usage().SystemTime,
+              uint64_t(25000000));
+
+    body.SetResourceUsageProbe(&probe);
+    body.Run(1);
+    ASSERT_TRUE(probe.IsAvailable());
+    EXPECT_GE(probe.Usage().UserTime + probe.Usage().SystemTime,
+              uint64_t(25000000));
+}
@@ -0,0 +1,52 @@
+#include "base.hpp"
+
+
+TEST(Scheduling, FormatsCpuLists)
+{
+    std::vector<int> cpus;
+    EXPECT_EQ(std::string(), Scheduling::FormatCpuList(cpus));
+
+    cpus.push_back(0);
+    cpus.push_back(1);
+    cpus.push_back(2);
+    cpus.push_back(3);
+    cpus.push_back(8);
+    cpus.push_back(10);
+    cpus.push_back(11);
+    EXPECT_EQ(std::string("0-3,8,10-11"), Scheduling::FormatCpuList(cpus));
+
+    std::vector<int> parsed;
+    ASSERT_TRUE(CpuTopology::ParseCpuList(Scheduling::FormatCpuList(cpus),
+                                          parsed));
+    EXPECT_EQ(cpus, parsed);
+}
+
+
+TEST(Scheduling, RestoresAffinity)
+{
+    std::vector<int> affinity;
+
+    if (!Scheduling::GetAffinity(affinity))
+        return;
+
+    ASSERT_FALSE(affinity.empty());
+    EXPECT_TRUE(Scheduling::SetAffinity(std::vector<int>(1, affinity[0])));
+
+    std::vector<int> pinned;
+    ASSERT_TRUE(Scheduling::GetAffinity(pinned));
+    EXPECT_EQ(std::vector<int>(1, affinity[0]), pinned);
+
+    std::string error;
+    EXPECT_TRUE(Scheduling::SetAffinity(affinity, &error)) << error;
+    EXPECT_FALSE(Scheduling::SetAffinity(std::vector<int>(1, -1), &error));
+    EXPECT_FALSE(error.empty());
+}
+
+
+TEST(Scheduling, RejectsInvalidRealtimePriority)
+{
+    std::string error;
+
+    EXPECT_FALSE(Scheduling::SetRealtimePriority(1000, &error));
+    EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "base.hpp"
+
+
+TEST(Statistics, NormalCdf)
+{
+    EXPECT_NEAR(0.5, Statistics::NormalCdf(0.0), 1e-7);
+    EXPECT_NEAR(0.975, Statistics::NormalCdf(1.959964), 1e-6);
+    EXPECT_NEAR(0.025, Statistics::NormalCdf(-1.959964), 1e-6);
+}
+
+
+TEST(Statistics, NormalQuantile)
+{
+    EXPECT_NEAR(0.0, Statistics::NormalQuantile(0.5), 1e-9);
+    EXPECT_NEAR(1.959964, Statistics::NormalQuantile(0.975), 1e-6);
+    EXPECT_NEAR(-2.326348, Statistics::NormalQuantile(0.01), 1e-6);
+    EXPECT_NEAR(3.090232, Statistics::NormalQuantile(0.999), 1e-6);
+    EXPECT_NEAR(0.8, Statistics::NormalCdf(Statistics::NormalQuantile(0.8)),
+                1e-6);
+}
+
+
+TEST(Statistics, StudentTQuantile)
+{
+    // Tabulated quantiles, to the accuracy of the expansion.
+    EXPECT_NEAR(2.228, Statistics::StudentTQuantile(0.975, 10.0), 0.005);
+    EXPECT_NEAR(2.776, Statistics::StudentTQuantile(0.975, 4.0), 0.03);
+
+    // Exact quantiles for few degrees of freedom.
+    EXPECT_NEAR(12.7062, Statistics::StudentTQuantile(0.975, 1.0), 0.0001);
+    EXPECT_NEAR(6.3138, Statistics::StudentTQuantile(0.95, 1.0), 0.0001);
+    EXPECT_NEAR(4.3027, Statistics::StudentTQuantile(0.975, 2.0), 0.0001);
+    EXPECT_NEAR(9.9248, Statistics::StudentTQuantile(0.995, 2.0), 0.0001);
+    EXPECT_NEAR(3.1824, Statistics::StudentTQuantile(0.975, 3.0), 0.0001);
+    EXPECT_NEAR(5.8409, Statistics::StudentTQuantile(0.995, 3.0), 0.0001);
+    EXPECT_NEAR(-3.1824, Statistics::StudentTQuantile(0.025, 3.0), 0.0001);
+    EXPECT_NEAR(1.697, Statistics::StudentTQuantile(0.95, 30.0), 0.002);
+    EXPECT_NEAR(2.861, Statistics::StudentTQuantile(0.995, 19.0), 0.01);
+
+    // The distribution approaches the normal distribution.
+    EXPECT_NEAR(Statistics::NormalQuantile(0.975),
+                Statistics::StudentTQuantile(0.975, 100000.0),
+                1e-4);
+}
+
+
+TEST(Statistics, MeanConfidenceInterval)
+{
+    std::vector<uint64_t> values;
+    values.push_back(10);
+    values.push_back(12);
+    values.push_back(14);
+    values.push_back(16);
+    values.push_back(18);
+
+    // Standard error sqrt(10 / 5) and t(0.975, 4) = 2.776.
+    double lower, upper;
+    EXPECT_DOUBLE_EQ(14.0, Statistics::MeanConfidenceInterval(values,
+                                                              0.95,
+                                                              lower,
+                                                              upper));
+    EXPECT_NEAR(14.0 - 2.776 * std::sqrt(2.0), lower, 0.05);
+    EXPECT_NEAR(14.0 + 2.776 * std::sqrt(2.0), upper, 0.05);
+
+    EXPECT_NEAR((upper - lower) / 14.0,
+                Statistics::RelativeConfidenceIntervalWidth(values,
+                                                            StatisticMean,
+                                                            0.95),
+                1e-12);
+}
+
+
+TEST(Statistics, MedianConfidenceInterval)
+{
+    // Ranks of the 95 % interval from the binomial distribution: 1 and n
+    // for n = 6, 2 and 9 for n = 10, 6 and 15 for n = 20, and 10 and 21
+    // for n = 30.
+    const std::size_t sizes[] = {6, 10, 20, 30};
+    const uint64_t lowerRanks[] = {1, 2, 6, 10};
+    const uint64_t upperRanks[] = {6, 9, 15, 21};
+
+    for (std::size_t index = 0; index < 4; ++index)
+    {
+        std::vector<uint64_t> values;
+
+        for (uint64_t rank = 1; rank <= sizes[index]; ++rank)
+            values.push_back(rank);
+
+        double lower, upper;
+        const double median =
+            Statistics::MedianConfidenceInterval(values, 0.95, lower, upper);
+
+        EXPECT_DOUBLE_EQ(double(sizes[index] + 1) / 2.0, median);
+        EXPECT_DOUBLE_EQ(double(lowerRanks[index]), lower);
+        EXPECT_DOUBLE_EQ(double(upperRanks[index]), upper);
+    }
+
+    // The interval is clamped to the sample, and an odd sample has a
+    // middle value.
+    std::vector<uint64_t> small;
+    small.push_back(30);
+    small.push_back(10);
+    small.push_back(20);
+
+    double lower, upper;
+    std::vector<uint64_t> sorted(small);
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_DOUBLE_EQ(20.0, Statistics::MedianConfidenceInterval(sorted,
+                                                                0.95,
+                                                                lower,
+                                                                upper));
+    EXPECT_DOUBLE_EQ(10.0, lower);
+    EXPECT_DOUBLE_EQ(30.0, upper);
+
+    // The relative width sorts the values itself.
+    EXPECT_DOUBLE_EQ(1.0,
+                     Statistics::RelativeConfidenceIntervalWidth(
+                         small,
+                         StatisticMedian,
+                         0.95
+                     ));
+
+    // A zero estimate has no relative width.
+    EXPECT_EQ(std::numeric_limits<double>::infinity(),
+              Statistics::RelativeConfidenceIntervalWidth(
+                  std::vector<uint64_t>(4, 0),
+                  StatisticMedian,
+                  0.95
+              ));
+}
+
+
+TEST(Statistics, MannWhitneyU)
+{
+    std::vector<double> first;
+    std::vector<double> second;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        first.push_back(100.0 + i);
+        second.push_back(100.5 + i);
+    }
+
+    // Interleaved samples do not differ.
+    EXPECT_GT(Statistics::MannWhitneyU(first, second), 0.5);
+
+    // Disjoint samples differ, in either order.
+    std::vector<double> shifted;
+
+    for (int i = 0; i < 20; ++i)
+        shifted.push_back(200.0 + i);
+
+    EXPECT_LT(Statistics::MannWhitneyU(first, shifted), 1e-6);
+    EXPECT_DOUBLE_EQ(Statistics::MannWhitneyU(first, shifted),
+                     Statistics::MannWhitneyU(shifted, first));
+
+    // Identical values are not a difference.
+    std::vector<double> constant(10, 1.0);
+    EXPECT_DOUBLE_EQ(1.0, Statistics::MannWhitneyU(constant, constant));
+    EXPECT_DOUBLE_EQ(1.0, Statistics::MannWhitneyU(constant,
+                                                   std::vector<double>()));
+}
+
+
+TEST(Statistics, BootstrapRelativeMedianChange)
+{
+    std::vector<double> baseline;
+    std::vector<double> current;
+
+    for (int i = 0; i < 30; ++i)
+    {
+        baseline.push_back(100.0 + (i % 5));
+        current.push_back(110.0 + (i % 5));
+    }
+
+    double lower;
+    double upper;
+    Statistics::BootstrapRelativeMedianChange(baseline,
+                                              current,
+                                              0.95,
+                                              1000,
+                                              1,
+                                              lower,
+                                              upper);
+
+    EXPECT_LE(lower, 0.1 + 1e-9);
+    EXPECT_GE(upper, 0.1 - 1e-9);
+    EXPECT_GT(lower, 0.0);
+
+    // Resampling is reproducible.
+    double repeatedLower;
+    double repeatedUpper;
+    Statistics::BootstrapRelativeMedianChange(baseline,
+                                              current,
+                                              0.95,
+                                              1000,
+                                              1,
+                                              repeatedLower,
+                                              repeatedUpper);
+
+    EXPECT_DOUBLE_EQ(lower, repeatedLower);
+    EXPECT_DOUBLE_EQ(upper, repeatedUpper);
+}
+
+
+TEST(Statistics, FitLine)
+{
+    std::vector<double> x;
+    std::vector<double> y;
+
+    for (int i = 1; i <= 10; ++i)
+    {
+        x.push_back(1000.0 * i);
+        y.push_back(500.0 + 2.5 * 1000.0 * i + ((i % 2) ? 10.0 : -10.0));
+    }
+
+    const LinearRegression fit = Statistics::FitLine(x, y, 0.95);
+
+    EXPECT_NEAR(2.5, fit.Slope, 0.01);
+    EXPECT_NEAR(500.0, fit.Intercept, 20.0);
+    EXPECT_GT(fit.RSquared, 0.999);
+    EXPECT_LT(fit.SlopeLower, fit.Slope);
+    EXPECT_GT(fit.SlopeUpper, fit.Slope);
+    EXPECT_LT(fit.SlopeUpper - fit.SlopeLower, 0.02);
+
+    // A perfect fit has no uncertainty.
+    std::vector<double> exact;
+
+    for (std::size_t i = 0; i < x.size(); ++i)
+        exact.push_back(3.0 * x[i] + 7.0);
+
+    const LinearRegression exactFit = Statistics::FitLine(x, exact, 0.95);
+
+    EXPECT_DOUBLE_EQ(3.0, exactFit.Slope);
+    EXPECT_NEAR(7.0, exactFit.Intercept, 1e-6);
+    EXPECT_DOUBLE_EQ(1.0, exactFit.RSquared);
+    EXPECT_NEAR(exactFit.SlopeLower, exactFit.SlopeUpper, 1e-9);
+}
+
+
+TEST(Bootstrap, Intervals)
+{
+    std::vector<uint64_t> values;
+
+    for (uint64_t value = 0; value < 1001; ++value)
+        values.push_back(1000 + (value * 7919) % 1001);
+
+    ConfidenceInterval mean;
+    ConfidenceInterval median;
+    Bootstrap(2000, 0.95, 42).Estimate(values, mean, median);
+
+    EXPECT_LT(mean.Lower, 1500.0);
+    EXPECT_GT(mean.Upper, 1500.0);
+    EXPECT_LT(median.Lower, 1500.0);
+    EXPECT_GT(median.Upper, 1500.0);
+    EXPECT_LT(mean.Upper - mean.Lower, 100.0);
+
+    // The intervals do not depend on the number of threads.
+    ConfidenceInterval threadedMean;
+    ConfidenceInterval threadedMedian;
+    Bootstrap(2000, 0.95, 42, 3).Estimate(values,
+                                           threadedMean,
+                                           threadedMedian);
+
+    EXPECT_DOUBLE_EQ(mean.Lower, threadedMean.Lower);
+    EXPECT_DOUBLE_EQ(mean.Upper, threadedMean.Upper);
+    EXPECT_DOUBLE_EQ(median.Lower, threadedMedian.Lower);
+    EXPECT_DOUBLE_EQ(median.Upper, threadedMedian.Upper);
+}
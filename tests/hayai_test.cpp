@@ -0,0 +1,212 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Number of calls of the body of the benchmark below.
+    std::size_t BenchmarkBodyCalls = 0;
+}
+
+
+BENCHMARK(Test, Inlined, 1, 1)
+{
+    ++BenchmarkBodyCalls;
+}
+
+
+namespace
+{
+    /// Test that pauses timing around part of each iteration.
+    class PausingTest
+        :   public Test
+    {
+    public:
+        PausingTest(uint64_t timed, uint64_t paused)
+            :   _timed(timed),
+                _paused(paused)
+        {
+
+        }
+    protected:
+        virtual void TestBody()
+        {
+            SpinFor(_timed);
+            PauseTiming();
+            SpinFor(_paused);
+            ResumeTiming();
+        }
+    private:
+        uint64_t _timed;
+        uint64_t _paused;
+    };
+
+
+    /// Test counting the iterations of a single thread.
+    class SpinningTest
+        :   public Test
+    {
+    public:
+        SpinningTest(uint64_t duration)
+            :   Calls(0),
+                _duration(duration)
+        {
+
+        }
+
+
+        std::size_t Calls;
+    protected:
+        virtual void TestBody()
+        {
+            ++Calls;
+            SpinFor(_duration);
+        }
+    private:
+        uint64_t _duration;
+    };
+
+    /// Atomically increment a counter, returning the incremented value.
+    long Increment(volatile long* counter)
+    {
+#if defined(_MSC_VER)
+        return InterlockedIncrement(counter);
+#else
+        return __sync_add_and_fetch(counter, 1);
+#endif
+    }
+
+
+    /// Test counting the iterations of each thread.
+    class CountingTest
+        :   public Test
+    {
+    public:
+        CountingTest()
+            :   BodyCalls(0),
+                Threads(0)
+        {
+
+        }
+
+
+        volatile long BodyCalls;
+        volatile long Threads;
+        std::size_t ThreadIterations[8];
+    protected:
+        virtual void TestBody()
+        {
+            Increment(&BodyCalls);
+        }
+
+
+        virtual void RunIterations(std::size_t iterations)
+        {
+            const long thread = Increment(&Threads) - 1;
+            ThreadIterations[thread] = iterations;
+
+            Test::RunIterations(iterations);
+        }
+    };
+}
+
+
+TEST(Test, ExcludesPausedTime)
+{
+    // 1 ms timed and 20 ms paused in each of 5 iterations.
+    PausingTest test(1000000, 20000000);
+
+    const uint64_t time = test.Run(5);
+    EXPECT_GE(time, uint64_t(5 * 1000000));
+    EXPECT_LT(time, uint64_t(20000000));
+}
+
+
+TEST(Test, ExcludesPausedTimeFromSamples)
+{
+    PausingTest test(1000000, 20000000);
+    std::vector<uint64_t> samples;
+
+    const uint64_t time = test.RunSampled(4, 2, 0, samples);
+    EXPECT_LT(time, uint64_t(20000000));
+    ASSERT_EQ(std::size_t(2), samples.size());
+
+    for (std::size_t sample = 0; sample < samples.size(); ++sample)
+    {
+        EXPECT_GE(samples[sample], uint64_t(1000000));
+        EXPECT_LT(samples[sample], uint64_t(20000000));
+    }
+}
+
+
+TEST(Test, RunsIterationsOnEachThread)
+{
+    CountingTest test;
+    std::vector<uint64_t> threadTimes;
+
+    test.RunThreaded(1000, 4, threadTimes);
+
+    ASSERT_EQ(4, test.Threads);
+    EXPECT_EQ(std::size_t(4), threadTimes.size());
+    EXPECT_EQ(4 * 1000, test.BodyCalls);
+
+    for (std::size_t thread = 0; thread < 4; ++thread)
+        EXPECT_EQ(std::size_t(1000), test.ThreadIterations[thread]);
+}
+
+
+TEST(Test, SamplesEveryIntervalthIteration)
+{
+    SpinningTest test(0);
+    std::vector<uint64_t> samples;
+
+    test.RunSampled(10, 3, 0, samples);
+    EXPECT_EQ(std::size_t(4), samples.size());
+    EXPECT_EQ(std::size_t(10), test.Calls);
+
+    test.RunSampled(9, 3, 0, samples);
+    EXPECT_EQ(std::size_t(3), samples.size());
+
+    test.RunSampled(10, 1, 0, samples);
+    EXPECT_EQ(std::size_t(10), samples.size());
+
+    test.RunSampled(10, 20, 0, samples);
+    EXPECT_EQ(std::size_t(1), samples.size());
+    EXPECT_EQ(std::size_t(39), test.Calls);
+}
+
+
+TEST(Test, SubtractsSampleOverhead)
+{
+    SpinningTest test(1000000);
+    std::vector<uint64_t> samples;
+
+    // The run includes the full duration of its only sample.
+    const uint64_t time = test.RunSampled(1, 1, 400000, samples);
+    ASSERT_EQ(std::size_t(1), samples.size());
+    EXPECT_GE(samples[0], uint64_t(1000000 - 400000));
+    EXPECT_LE(samples[0], time - 400000);
+
+    // Samples shorter than the overhead are clamped to zero.
+    test.RunSampled(3, 1, 1000000000, samples);
+    ASSERT_EQ(std::size_t(3), samples.size());
+
+    for (std::size_t sample = 0; sample < samples.size(); ++sample)
+        EXPECT_EQ(uint64_t(0), samples[sample]);
+}
+
+
+TEST(Test, InlinedLoopRunsBodyForEachIteration)
+{
+    // The iteration loop of the benchmark macros calls the body directly.
+    BENCHMARK_CLASS_NAME_(Test, Inlined) test;
+
+    test.Run(0);
+    EXPECT_EQ(std::size_t(0), BenchmarkBodyCalls);
+
+    test.Run(1000);
+    EXPECT_EQ(std::size_t(1000), BenchmarkBodyCalls);
+
+    std::vector<uint64_t> samples;
+    test.RunSampled(10, 4, 0, samples);
+    EXPECT_EQ(std::size_t(1010), BenchmarkBodyCalls);
+}
@@ -0,0 +1,121 @@
+#include "base.hpp"
+
+
+namespace
+{
+    TestResult MakeResult(const uint64_t* runTimes, std::size_t runs)
+    {
+        return TestResult(std::vector<uint64_t>(runTimes, runTimes + runs),
+                          1);
+    }
+}
+
+
+TEST(TestResult, Quartiles)
+{
+    static const uint64_t three[] = {30, 10, 20};
+    const TestResult odd = MakeResult(three, 3);
+
+    EXPECT_DOUBLE_EQ(20.0, odd.RunTimeMedian());
+    EXPECT_DOUBLE_EQ(10.0, odd.RunTimeQuartile1());
+    EXPECT_DOUBLE_EQ(30.0, odd.RunTimeQuartile3());
+
+    static const uint64_t eight[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const TestResult even = MakeResult(eight, 8);
+
+    EXPECT_DOUBLE_EQ(4.5, even.RunTimeMedian());
+    EXPECT_DOUBLE_EQ(2.5, even.RunTimeQuartile1());
+    EXPECT_DOUBLE_EQ(6.5, even.RunTimeQuartile3());
+
+    static const uint64_t one[] = {7};
+    const TestResult single = MakeResult(one, 1);
+
+    EXPECT_DOUBLE_EQ(7.0, single.RunTimeMedian());
+    EXPECT_DOUBLE_EQ(7.0, single.RunTimeQuartile1());
+    EXPECT_DOUBLE_EQ(7.0, single.RunTimeQuartile3());
+}
+
+
+TEST(TestResult, Outliers)
+{
+    // Quartiles 100 and 110, so the inner fences are 85 and 125 and the
+    // outer fences 70 and 140.
+    static const uint64_t runTimes[] = {
+        100, 100, 100, 105, 105, 105, 110, 110, 110, 130, 200
+    };
+    const TestResult result = MakeResult(runTimes, 11);
+
+    EXPECT_DOUBLE_EQ(100.0, result.RunTimeQuartile1());
+    EXPECT_DOUBLE_EQ(110.0, result.RunTimeQuartile3());
+    EXPECT_EQ(OutlierNone, result.RunOutlier(0));
+    EXPECT_EQ(OutlierMild, result.RunOutlier(9));
+    EXPECT_EQ(OutlierSevere, result.RunOutlier(10));
+    EXPECT_EQ(std::size_t(1), result.MildOutliers());
+    EXPECT_EQ(std::size_t(1), result.SevereOutliers());
+    EXPECT_DOUBLE_EQ(2.0 / 11.0, result.OutlierFraction());
+
+    // The median absolute deviation is 5, so only the severe outlier has a
+    // modified z-score above 3.5.
+    EXPECT_DOUBLE_EQ(5.0, result.RunTimeMedianAbsoluteDeviation());
+    EXPECT_NEAR(3.373, result.RunMadZScore(9), 0.001);
+    EXPECT_EQ(std::size_t(1), result.MadOutliers());
+
+    EXPECT_DOUBLE_EQ(105.0, result.RunTimeTrimmedAverage());
+    EXPECT_NEAR(4.330, result.RunTimeTrimmedStdDev(), 0.001);
+    EXPECT_GT(result.RunTimeAverage(), result.RunTimeTrimmedAverage());
+}
+
+
+TEST(TestResult, LinearRunsAreScaled)
+{
+    // 100 ns per iteration over 1 to 5 iterations, averaging 3.
+    static const uint64_t runTimes[] = {100, 200, 300, 400, 500};
+    std::vector<std::size_t> runIterations;
+
+    for (std::size_t run = 0; run < 5; ++run)
+        runIterations.push_back(run + 1);
+
+    TestResult result(std::vector<uint64_t>(runTimes, runTimes + 5), 3);
+    EXPECT_DOUBLE_EQ(100.0, result.RunTimeMinimum());
+
+    result.SetRunIterations(runIterations, 0.95);
+
+    // The run times and their total are kept, while the statistics of the
+    // runs are calculated from runs of 3 iterations.
+    EXPECT_TRUE(result.IsLinear());
+    EXPECT_EQ(uint64_t(500), result.RunTimes()[4]);
+    EXPECT_DOUBLE_EQ(1500.0, result.TimeTotal());
+    EXPECT_DOUBLE_EQ(300.0, result.RunTimeMinimum());
+    EXPECT_DOUBLE_EQ(300.0, result.RunTimeMaximum());
+    EXPECT_DOUBLE_EQ(300.0, result.RunTimeAverage());
+    EXPECT_DOUBLE_EQ(300.0, result.RunTimeMedian());
+    EXPECT_DOUBLE_EQ(0.0, result.RunTimeStdDev());
+    EXPECT_DOUBLE_EQ(100.0, result.IterationTimeAverage());
+    EXPECT_EQ(std::size_t(0), result.MildOutliers() + result.SevereOutliers());
+    EXPECT_NEAR(100.0, result.IterationTimeRegression().Slope, 0.000001);
+}
+
+
+TEST(TestResult, PercentilesFollowMedian)
+{
+    static const uint64_t eight[] = {80, 10, 70, 20, 60, 30, 50, 40};
+    const TestResult even = MakeResult(eight, 8);
+
+    // The 50th percentile falls between the middle runs, like the median.
+    EXPECT_DOUBLE_EQ(even.RunTimeMedian(), even.RunTimePercentile(50.0));
+    EXPECT_DOUBLE_EQ(45.0, even.RunTimePercentile(50.0));
+    EXPECT_DOUBLE_EQ(25.0, even.RunTimePercentile(25.0));
+    EXPECT_DOUBLE_EQ(80.0, even.RunTimePercentile(90.0));
+    EXPECT_DOUBLE_EQ(80.0, even.RunTimePercentile(100.0));
+    EXPECT_DOUBLE_EQ(10.0, even.RunTimePercentile(0.0));
+    EXPECT_DOUBLE_EQ(10.0, even.RunTimePercentile(10.0));
+
+    static const uint64_t two[] = {20, 10};
+    const TestResult pair = MakeResult(two, 2);
+    EXPECT_DOUBLE_EQ(pair.RunTimeMedian(), pair.RunTimePercentile(50.0));
+
+    static const uint64_t three[] = {30, 10, 20};
+    const TestResult odd = MakeResult(three, 3);
+    EXPECT_DOUBLE_EQ(20.0, odd.RunTimePercentile(50.0));
+    EXPECT_DOUBLE_EQ(30.0, odd.RunTimePercentile(99.9));
+}
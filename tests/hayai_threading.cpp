@@ -0,0 +1,130 @@
+#include "base.hpp"
+
+
+namespace
+{
+    /// Number of threads of the tests.
+    const std::size_t Threads = 4;
+
+
+    /// State shared by the threads waiting at a barrier.
+    struct BarrierState
+    {
+        BarrierState()
+            :   Barrier(Threads)
+        {
+            for (std::size_t index = 0; index < Threads; ++index)
+            {
+                Arrived[index] = 0;
+                ArrivedBeforeRelease[index] = 0;
+            }
+        }
+
+
+        SpinBarrier Barrier;
+        volatile int Arrived[Threads];
+        std::size_t ArrivedBeforeRelease[Threads];
+    };
+
+
+    /// Thread waiting at the barrier of a state.
+    struct BarrierThread
+    {
+        BarrierState* State;
+        std::size_t Index;
+    };
+
+
+    /// Wait at the barrier, counting the threads arrived when released.
+    void WaitAtBarrier(void* argument)
+    {
+        BarrierThread* thread = static_cast<BarrierThread*>(argument);
+        BarrierState& state = *thread->State;
+
+        state.Arrived[thread->Index] = 1;
+        state.Barrier.Wait();
+
+        for (std::size_t index = 0; index < Threads; ++index)
+            state.ArrivedBeforeRelease[thread->Index] +=
+                std::size_t(state.Arrived[index]);
+    }
+
+
+    /// Test registered for the thread sweep.
+    class SweptTest
+        :   public Test
+    {
+
+    };
+}
+
+
+TEST(Threading, BarrierReleasesAllThreads)
+{
+    BarrierState state;
+    BarrierThread contexts[Threads];
+    std::vector<Thread*> threads;
+
+    for (std::size_t index = 0; index < Threads; ++index)
+    {
+        contexts[index].State = &state;
+        contexts[index].Index = index;
+        threads.push_back(new Thread(&WaitAtBarrier, &contexts[index]));
+    }
+
+    for (std::size_t index = 0; index < threads.size(); ++index)
+    {
+        threads[index]->Join();
+        delete threads[index];
+    }
+
+    // No thread is released before all threads have arrived.
+    for (std::size_t index = 0; index < Threads; ++index)
+        EXPECT_EQ(Threads, state.ArrivedBeforeRelease[index]);
+}
+
+
+TEST(Threading, AbandonedBarrierReleasesWaitingThreads)
+{
+    BarrierState state;
+    BarrierThread context = {&state, 0};
+    Thread thread(&WaitAtBarrier, &context);
+
+    state.Barrier.Abandon(Threads - 1);
+    thread.Join();
+
+    EXPECT_EQ(std::size_t(1), state.ArrivedBeforeRelease[0]);
+}
+
+
+TEST(Threading, SweepRegistersEachThreadCount)
+{
+    const TestDescriptor* first =
+        Benchmarker::RegisterThreadedTest<SweptTest>("Threading",
+                                                     "Sweep",
+                                                     1,
+                                                     1,
+                                                     ThreadSweep);
+
+    // Powers of two below the hardware concurrency, and the hardware
+    // concurrency itself.
+    std::vector<std::size_t> expected;
+    const std::size_t hardwareThreads = HardwareConcurrency();
+
+    for (std::size_t count = 1; count < hardwareThreads; count *= 2)
+        expected.push_back(count);
+
+    expected.push_back(hardwareThreads);
+
+    std::vector<std::size_t> registered;
+    const std::vector<const TestDescriptor*> tests =
+        Benchmarker::ListTests();
+
+    for (std::size_t index = 0; index < tests.size(); ++index)
+        if (tests[index]->CanonicalName == "Threading.Sweep")
+            registered.push_back(tests[index]->Threads);
+
+    ASSERT_TRUE(first != NULL);
+    EXPECT_EQ(std::size_t(1), first->Threads);
+    EXPECT_EQ(expected, registered);
+}
@@ -0,0 +1,48 @@
+#include "base.hpp"
+
+#include <vector>
+
+
+namespace
+{
+    struct Named
+    {
+
+    };
+
+
+    std::size_t CountTypes(Types<>)
+    {
+        return 0;
+    }
+
+
+    template<class TypeList>
+    std::size_t CountTypes(TypeList)
+    {
+        return 1 + CountTypes(typename TypeList::Tail());
+    }
+}
+
+
+BENCHMARK_TYPE_NAME(Named, "named");
+
+
+TEST(Types, Traversal)
+{
+    EXPECT_EQ(std::size_t(0), CountTypes(Types<>()));
+    EXPECT_EQ(std::size_t(3), CountTypes(Types<int, long, Named>()));
+}
+
+
+TEST(Types, Names)
+{
+    EXPECT_EQ("named", TypeName<Named>::Name());
+
+#if defined(__GNUC__) || defined(__clang__)
+    EXPECT_EQ("int", TypeName<int>::Name());
+    EXPECT_EQ(0u, TypeName<std::vector<int> >::Name().find("std::vector<int"));
+#else
+    EXPECT_FALSE(TypeName<int>::Name().empty());
+#endif
+}